@@ -40,6 +40,7 @@
 #include "clang/Tooling/ReplacementsYaml.h"
 #include "clang/Tooling/Tooling.h"
 #include "llvm/Support/Process.h"
+#include "llvm/Support/Regex.h"
 #include <algorithm>
 #include <utility>
 
@@ -310,17 +311,58 @@ public:
   ClangTidyASTConsumer(std::vector<std::unique_ptr<ASTConsumer>> Consumers,
                        std::unique_ptr<ClangTidyProfiling> Profiling,
                        std::unique_ptr<ast_matchers::MatchFinder> Finder,
-                       std::vector<std::unique_ptr<ClangTidyCheck>> Checks)
+                       std::vector<std::unique_ptr<ClangTidyCheck>> Checks,
+                       const ClangTidyOptions &Options)
       : MultiplexConsumer(std::move(Consumers)),
         Profiling(std::move(Profiling)), Finder(std::move(Finder)),
-        Checks(std::move(Checks)) {}
+        Checks(std::move(Checks)), SystemHeaders(*Options.SystemHeaders) {
+    if (Options.SkipNonReportedHeaders.value_or(false) &&
+        llvm::none_of(this->Checks, [](const auto &Check) {
+          return Check->requiresWholeTranslationUnit();
+        }))
+      HeaderFilter = std::make_unique<llvm::Regex>(*Options.HeaderFilterRegex);
+  }
+
+  void HandleTranslationUnit(ASTContext &Ctx) override {
+    if (!HeaderFilter) {
+      MultiplexConsumer::HandleTranslationUnit(Ctx);
+      return;
+    }
+
+    // Warnings from other files are discarded by the diagnostic consumer, so
+    // only traverse the top-level declarations they can come from.
+    const SourceManager &SM = Ctx.getSourceManager();
+    std::vector<Decl *> Scope;
+    for (Decl *D : Ctx.getTranslationUnitDecl()->decls())
+      if (isInReportedFile(D->getLocation(), SM))
+        Scope.push_back(D);
+    Ctx.setTraversalScope(Scope);
+    MultiplexConsumer::HandleTranslationUnit(Ctx);
+    Ctx.setTraversalScope({Ctx.getTranslationUnitDecl()});
+  }
 
 private:
+  /// Mirrors the filtering of ClangTidyDiagnosticConsumer::checkFilters.
+  bool isInReportedFile(SourceLocation Loc, const SourceManager &SM) const {
+    if (Loc.isInvalid())
+      return true;
+    if (!SystemHeaders && SM.isInSystemHeader(Loc))
+      return false;
+    FileID FID = SM.getDecomposedExpansionLoc(Loc).first;
+    const FileEntry *File = SM.getFileEntryForID(FID);
+    if (!File)
+      return true;
+    return SM.isInMainFile(Loc) || HeaderFilter->match(File->getName());
+  }
+
   // Destructor order matters! Profiling must be destructed last.
   // Or at least after Finder.
   std::unique_ptr<ClangTidyProfiling> Profiling;
   std::unique_ptr<ast_matchers::MatchFinder> Finder;
   std::vector<std::unique_ptr<ClangTidyCheck>> Checks;
+  bool SystemHeaders;
+  /// Set if matching is restricted to the files warnings are output from.
+  std::unique_ptr<llvm::Regex> HeaderFilter;
 };
 
 } // namespace
@@ -410,7 +452,8 @@ ClangTidyASTConsumerFactory::createASTConsumer(
   if (Context.getEnableProfiling()) {
     Profiling = std::make_unique<ClangTidyProfiling>(
         Context.getProfileStorageParams());
-    FinderOptions.CheckProfiling.emplace(Profiling->Records);
+    FinderOptions.CheckProfiling.emplace(Profiling->Records,
+                                         &Profiling->MemoizationRecords);
   }
 
   std::unique_ptr<ast_matchers::MatchFinder> Finder(
@@ -452,7 +495,7 @@ ClangTidyASTConsumerFactory::createASTConsumer(
 #endif // CLANG_TIDY_ENABLE_STATIC_ANALYZER
   return std::make_unique<ClangTidyASTConsumer>(
       std::move(Consumers), std::move(Profiling), std::move(Finder),
-      std::move(Checks));
+      std::move(Checks), Context.getOptions());
 }
 
 std::vector<std::string> ClangTidyASTConsumerFactory::getCheckNames() {
@@ -69,6 +69,14 @@ public:
     return true;
   }
 
+  /// Override this to return true if the check needs to match declarations
+  /// in headers that no warnings are output from, e.g. to compare them with
+  /// declarations in the main file.
+  ///
+  /// While such a check is enabled, the ``SkipNonReportedHeaders`` option has
+  /// no effect.
+  virtual bool requiresWholeTranslationUnit() const { return false; }
+
   /// Override this to register ``PPCallbacks`` in the preprocessor.
   ///
   /// This should be used for clang-tidy checks that analyze preprocessor-
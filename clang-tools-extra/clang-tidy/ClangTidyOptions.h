@@ -79,6 +79,11 @@ struct ClangTidyOptions {
   /// Output warnings from system headers matching \c HeaderFilterRegex.
   llvm::Optional<bool> SystemHeaders;
 
+  /// Only run the AST matchers over declarations in the main file and in the
+  /// headers warnings are output from, unless an enabled check requires the
+  /// whole translation unit.
+  llvm::Optional<bool> SkipNonReportedHeaders;
+
   /// Format code around applied fixes with clang-format using this
   /// style.
   ///
@@ -7,8 +7,10 @@
 //===----------------------------------------------------------------------===//
 
 #include "ClangTidyProfiling.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/SmallString.h"
 #include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Format.h"
 #include "llvm/Support/Path.h"
 #include "llvm/Support/raw_ostream.h"
 #include <system_error>
@@ -36,8 +38,43 @@ ClangTidyProfiling::StorageParams::StorageParams(llvm::StringRef ProfilePrefix,
                       .str();
 }
 
+using MemoizationRecord =
+    llvm::StringMapEntry<ClangTidyProfiling::MemoizationStats>;
+
+// The checks with memoized matches, by name.
+static std::vector<const MemoizationRecord *> getSortedMemoizationRecords(
+    const llvm::StringMap<ClangTidyProfiling::MemoizationStats> &Records) {
+  std::vector<const MemoizationRecord *> Sorted;
+  for (const auto &Record : Records)
+    if (Record.second.Hits || Record.second.Misses)
+      Sorted.push_back(&Record);
+  llvm::sort(Sorted, [](const auto *LHS, const auto *RHS) {
+    return LHS->first() < RHS->first();
+  });
+  return Sorted;
+}
+
+void ClangTidyProfiling::printMemoizationTable(llvm::raw_ostream &OS) {
+  auto Sorted = getSortedMemoizationRecords(MemoizationRecords);
+  if (Sorted.empty())
+    return;
+
+  OS << "===" << std::string(73, '-') << "===\n"
+     << "                   AST matcher memoization cache statistics\n"
+     << "===" << std::string(73, '-') << "===\n"
+     << "        Hits       Misses    Evictions  Name\n";
+  for (const auto *Record : Sorted) {
+    const MemoizationStats &Stats = Record->second;
+    OS << llvm::format("%12" PRIu64 " %12" PRIu64 " %12" PRIu64 "  ",
+                       Stats.Hits, Stats.Misses, Stats.Evictions)
+       << Record->first() << "\n";
+  }
+  OS << "\n";
+}
+
 void ClangTidyProfiling::printUserFriendlyTable(llvm::raw_ostream &OS) {
   TG->print(OS);
+  printMemoizationTable(OS);
   OS.flush();
 }
 
@@ -47,6 +84,16 @@ void ClangTidyProfiling::printAsJSON(llvm::raw_ostream &OS) {
   OS << "\"timestamp\": \"" << Storage->Timestamp << "\",\n";
   OS << "\"profile\": {\n";
   TG->printJSONValues(OS, "");
+  OS << "\n},\n";
+  OS << "\"memoization\": {";
+  const char *Delim = "\n";
+  for (const auto *Record : getSortedMemoizationRecords(MemoizationRecords)) {
+    const MemoizationStats &Stats = Record->second;
+    OS << Delim << "\t\"" << Record->first() << "\": {\"hits\": " << Stats.Hits
+       << ", \"misses\": " << Stats.Misses
+       << ", \"evictions\": " << Stats.Evictions << "}";
+    Delim = ",\n";
+  }
   OS << "\n}\n";
   OS << "}\n";
   OS.flush();
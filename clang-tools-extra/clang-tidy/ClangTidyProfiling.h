@@ -9,6 +9,7 @@
 #ifndef LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_CLANGTIDYPROFILING_H
 #define LLVM_CLANG_TOOLS_EXTRA_CLANG_TIDY_CLANGTIDYPROFILING_H
 
+#include "clang/ASTMatchers/ASTMatchFinder.h"
 #include "llvm/ADT/Optional.h"
 #include "llvm/ADT/StringMap.h"
 #include "llvm/Support/Chrono.h"
@@ -40,12 +41,17 @@ private:
   llvm::Optional<StorageParams> Storage;
 
   void printUserFriendlyTable(llvm::raw_ostream &OS);
+  void printMemoizationTable(llvm::raw_ostream &OS);
   void printAsJSON(llvm::raw_ostream &OS);
 
   void storeProfileData();
 
 public:
+  using MemoizationStats = ast_matchers::MatchFinder::MatchFinderOptions::
+      Profiling::MemoizationStats;
+
   llvm::StringMap<llvm::TimeRecord> Records;
+  llvm::StringMap<MemoizationStats> MemoizationRecords;
 
   ClangTidyProfiling() = default;
 
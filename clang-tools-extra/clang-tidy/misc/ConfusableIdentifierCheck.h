@@ -27,6 +27,7 @@ public:
 
   void registerMatchers(ast_matchers::MatchFinder *Finder) override;
   void check(const ast_matchers::MatchFinder::MatchResult &Result) override;
+  bool requiresWholeTranslationUnit() const override { return true; }
 
 private:
   std::string skeleton(StringRef);
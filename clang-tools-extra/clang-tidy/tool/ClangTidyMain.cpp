@@ -100,6 +100,19 @@ static cl::opt<bool>
     SystemHeaders("system-headers",
                   cl::desc("Display the errors from system headers."),
                   cl::init(false), cl::cat(ClangTidyCategory));
+
+static cl::opt<bool> SkipNonReportedHeaders("skip-non-reported-headers",
+                                            cl::desc(R"(
+Only match declarations in the main file and in
+the headers selected by -header-filter and
+-system-headers, instead of the whole translation
+unit. Checks that need the whole translation unit
+disable this.
+This option overrides the 'SkipNonReportedHeaders'
+option in .clang-tidy file, if any.
+)"),
+                                            cl::init(false),
+                                            cl::cat(ClangTidyCategory));
 static cl::opt<std::string> LineFilter("line-filter", cl::desc(R"(
 List of files with line ranges to filter the
 warnings. Can be used together with
@@ -307,6 +320,7 @@ static std::unique_ptr<ClangTidyOptionsProvider> createOptionsProvider(
   DefaultOptions.WarningsAsErrors = "";
   DefaultOptions.HeaderFilterRegex = HeaderFilter;
   DefaultOptions.SystemHeaders = SystemHeaders;
+  DefaultOptions.SkipNonReportedHeaders = SkipNonReportedHeaders;
   DefaultOptions.FormatStyle = FormatStyle;
   DefaultOptions.User = llvm::sys::Process::GetEnv("USER");
   // USERNAME is used on Windows.
@@ -322,6 +336,8 @@ static std::unique_ptr<ClangTidyOptionsProvider> createOptionsProvider(
     OverrideOptions.HeaderFilterRegex = HeaderFilter;
   if (SystemHeaders.getNumOccurrences() > 0)
     OverrideOptions.SystemHeaders = SystemHeaders;
+  if (SkipNonReportedHeaders.getNumOccurrences() > 0)
+    OverrideOptions.SkipNonReportedHeaders = SkipNonReportedHeaders;
   if (FormatStyle.getNumOccurrences() > 0)
     OverrideOptions.FormatStyle = FormatStyle;
   if (UseColor.getNumOccurrences() > 0)
@@ -0,0 +1 @@
+class Reported { Reported(int); };
@@ -0,0 +1 @@
+class Skipped { Skipped(int); };
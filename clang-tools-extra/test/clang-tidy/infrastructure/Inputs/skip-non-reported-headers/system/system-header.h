@@ -0,0 +1 @@
+class System { System(int); };
@@ -0,0 +1,29 @@
+// RUN: clang-tidy -checks='-*,google-explicit-constructor' -header-filter='reported\.h' %s -- -I %S/Inputs/skip-non-reported-headers -isystem %S/Inputs/skip-non-reported-headers/system 2>&1 | FileCheck --check-prefix=CHECK-WHOLE-TU %s
+// RUN: clang-tidy -checks='-*,google-explicit-constructor' -header-filter='reported\.h' -skip-non-reported-headers %s -- -I %S/Inputs/skip-non-reported-headers -isystem %S/Inputs/skip-non-reported-headers/system 2>&1 | FileCheck --check-prefix=CHECK-SKIP %s
+// RUN: clang-tidy -checks='-*,google-explicit-constructor,misc-confusable-identifiers' -header-filter='reported\.h' -skip-non-reported-headers %s -- -I %S/Inputs/skip-non-reported-headers -isystem %S/Inputs/skip-non-reported-headers/system 2>&1 | FileCheck --check-prefix=CHECK-WHOLE-TU %s
+// RUN: clang-tidy -checks='-*,google-explicit-constructor' -header-filter='reported\.h|system-header\.h' -system-headers -skip-non-reported-headers %s -- -I %S/Inputs/skip-non-reported-headers -isystem %S/Inputs/skip-non-reported-headers/system 2>&1 | FileCheck --check-prefix=CHECK-SYSTEM %s
+
+#include "reported.h"
+// CHECK-WHOLE-TU: reported.h:1:18: warning: single-argument constructors must be marked explicit
+// CHECK-SKIP: reported.h:1:18: warning: single-argument constructors must be marked explicit
+// CHECK-SYSTEM: reported.h:1:18: warning: single-argument constructors must be marked explicit
+
+// Without a check requiring the whole translation unit, the headers no
+// warnings are output from are not matched at all.
+#include "skipped.h"
+#include <system-header.h>
+// CHECK-WHOLE-TU-NOT: skipped.h
+// CHECK-WHOLE-TU-NOT: system-header.h
+// CHECK-SKIP-NOT: skipped.h
+// CHECK-SKIP-NOT: system-header.h
+// CHECK-SYSTEM-NOT: skipped.h
+// CHECK-SYSTEM: system-header.h:1:16: warning: single-argument constructors
+
+class A { A(int); };
+// CHECK-WHOLE-TU: :[[@LINE-1]]:11: warning: single-argument constructors
+// CHECK-SKIP: :[[@LINE-2]]:11: warning: single-argument constructors
+// CHECK-SYSTEM: :[[@LINE-3]]:11: warning: single-argument constructors
+
+// CHECK-WHOLE-TU: Suppressed 2 warnings (2 in non-user code)
+// CHECK-SKIP-NOT: Suppressed
+// CHECK-SYSTEM-NOT: Suppressed
@@ -127,11 +127,26 @@ public:
 
   struct MatchFinderOptions {
     struct Profiling {
-      Profiling(llvm::StringMap<llvm::TimeRecord> &Records)
-          : Records(Records) {}
+      /// Statistics of the memoized matches of children, descendants and
+      /// ancestors (e.g. \c has, \c hasDescendant and \c hasAncestor).
+      struct MemoizationStats {
+        /// Matches found in the cache.
+        uint64_t Hits = 0;
+        /// Matches not found in the cache, which are computed and added.
+        uint64_t Misses = 0;
+        /// Matches evicted from the full cache to make room for others.
+        uint64_t Evictions = 0;
+      };
+
+      Profiling(llvm::StringMap<llvm::TimeRecord> &Records,
+                llvm::StringMap<MemoizationStats> *MemoizationRecords = nullptr)
+          : Records(Records), MemoizationRecords(MemoizationRecords) {}
 
       /// Per bucket timing information.
       llvm::StringMap<llvm::TimeRecord> &Records;
+
+      /// Per bucket memoization statistics, if not null.
+      llvm::StringMap<MemoizationStats> *MemoizationRecords;
     };
 
     /// Enables per-check timers.
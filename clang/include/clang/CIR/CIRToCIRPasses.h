@@ -13,19 +13,34 @@
 #define CLANG_CIR_CIRTOCIRPASSES_H
 
 #include "mlir/Pass/Pass.h"
+#include "llvm/ADT/StringRef.h"
 
 #include <memory>
 
 namespace mlir {
 class MLIRContext;
 class ModuleOp;
+class OpPassManager;
 } // namespace mlir
 
 namespace cir {
 
-// Run set of cleanup/prepare/etc passes CIR <-> CIR.
+// Add the CIR <-> CIR passes for the given optimization level (0-3) and size
+// level (0 for none, 1 for -Os, 2 for -Oz) to `pm`. Coroutine frames are only
+// elided if `enableCoroElide` is set.
+void buildCIRToCIRPipeline(mlir::OpPassManager &pm, unsigned optLevel,
+                           unsigned sizeLevel, bool enableCoroElide);
+
+// Run set of cleanup/prepare/etc passes CIR <-> CIR, as built by
+// buildCIRToCIRPipeline.
 void runCIRToCIRPasses(mlir::ModuleOp theModule, mlir::MLIRContext *mlirCtx,
-                       bool enableVerifier);
+                       unsigned optLevel, unsigned sizeLevel,
+                       bool enableCoroElide, bool enableVerifier);
+
+// Report performance anti-patterns through the MLIR diagnostics and, if
+// `reportFile` is not empty, as YAML remarks into that file.
+void runCIRPerfLint(mlir::ModuleOp theModule, mlir::MLIRContext *mlirCtx,
+                    llvm::StringRef reportFile);
 } // namespace cir
 
 #endif // CLANG_CIR_CIRTOCIRPASSES_H_
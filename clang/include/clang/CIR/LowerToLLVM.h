@@ -33,6 +33,16 @@ std::unique_ptr<llvm::Module>
 lowerFromCIRToLLVMIR(mlir::ModuleOp theModule,
                      std::unique_ptr<mlir::MLIRContext> mlirCtx,
                      llvm::LLVMContext &llvmCtx);
+
+// Same as above, one function at a time: each function definition is moved
+// out of `theModule`, lowered and translated on its own, and linked into the
+// resulting module. Only declarations of the symbols it uses are copied, so
+// the whole module never exists twice. Function declarations are lowered
+// once, before the definitions. Globals are not supported yet.
+std::unique_ptr<llvm::Module>
+lowerFromCIRToLLVMIRStreaming(mlir::ModuleOp theModule,
+                              std::unique_ptr<mlir::MLIRContext> mlirCtx,
+                              llvm::LLVMContext &llvmCtx);
 } // namespace cir
 
 #endif // CLANG_CIR_LOWERTOLLVM_H_
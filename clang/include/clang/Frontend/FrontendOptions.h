@@ -367,6 +367,15 @@ public:
   /// Disable Clang IR (CIR) verifier
   unsigned DisableCIRVerifier : 1;
 
+  /// Lower Clang IR (CIR) to LLVM IR one function at a time
+  unsigned CIRStreamingLowering : 1;
+
+  /// Elide coroutine frames in Clang IR (CIR)
+  unsigned CIRCoroElide : 1;
+
+  /// Report performance anti-patterns found in the Clang IR (CIR)
+  unsigned CIRPerfLint : 1;
+
   CodeCompleteOptions CodeCompleteOpts;
 
   /// Specifies the output format of the AST.
@@ -535,7 +544,8 @@ public:
         IncludeTimestamps(true), UseTemporary(true),
         OutputPathIndependentPCM(false), AllowPCMWithCompilerErrors(false),
         UseClangIRPipeline(false), DisableCIRPasses(false),
-        DisableCIRVerifier(false), TimeTraceGranularity(500) {}
+        DisableCIRVerifier(false), CIRStreamingLowering(false),
+        CIRCoroElide(false), CIRPerfLint(false), TimeTraceGranularity(500) {}
 
   /// getInputKindForExtension - Return the appropriate input kind for a file
   /// extension. For example, "c" would return Language::C.
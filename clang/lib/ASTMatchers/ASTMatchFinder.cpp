@@ -34,7 +34,8 @@ namespace {
 
 typedef MatchFinder::MatchCallback MatchCallback;
 
-// The maximum number of memoization entries to store.
+// The maximum number of memoization entries to store, beyond which entries
+// are evicted.
 // 10k has been experimentally found to give a good trade-off
 // of performance vs. memory consumption by running matcher
 // that match on every statement over a very large codebase.
@@ -83,6 +84,75 @@ struct MemoizedMatchResult {
   BoundNodesTreeBuilder Nodes;
 };
 
+using MemoizationStats =
+    MatchFinder::MatchFinderOptions::Profiling::MemoizationStats;
+
+// Maps (matcher, node) -> the match result for memoization, holding at most
+// MaxMemoizationEntries results.
+//
+// Once full, entries are evicted with the clock algorithm: they are kept on a
+// ring in insertion order, and the hand evicts the first entry that has not
+// been looked up since the hand last passed it. Unlike dropping the whole
+// cache, this keeps the results that are looked up over and over, such as
+// the ancestors matched from every node of a large function.
+class MemoizationCache {
+public:
+  // Returns the result memoized for \p Key, or null. The result is only
+  // valid until the next call to insert().
+  const MemoizedMatchResult *find(const MatchKey &Key) {
+    auto I = Entries.find(Key);
+    if (I == Entries.end()) {
+      if (Stats)
+        ++Stats->Misses;
+      return nullptr;
+    }
+    if (Stats)
+      ++Stats->Hits;
+    I->second.Referenced = true;
+    return &I->second.Result;
+  }
+
+  // Memoizes \p Result for \p Key, evicting another entry if full.
+  void insert(const MatchKey &Key, MemoizedMatchResult Result) {
+    auto I = Entries.find(Key);
+    if (I != Entries.end()) {
+      I->second.Result = std::move(Result);
+      return;
+    }
+
+    if (Clock.size() < MaxMemoizationEntries) {
+      Clock.push_back(Entries.insert({Key, {std::move(Result)}}).first);
+      return;
+    }
+
+    while (Clock[Hand]->second.Referenced) {
+      Clock[Hand]->second.Referenced = false;
+      Hand = (Hand + 1) % Clock.size();
+    }
+    Entries.erase(Clock[Hand]);
+    if (Stats)
+      ++Stats->Evictions;
+    Clock[Hand] = Entries.insert({Key, {std::move(Result)}}).first;
+    Hand = (Hand + 1) % Clock.size();
+  }
+
+  // Counts the hits, misses and evictions in \p NewStats from now on.
+  void setStats(MemoizationStats *NewStats) { Stats = NewStats; }
+
+private:
+  struct Entry {
+    MemoizedMatchResult Result;
+    // Whether the entry was looked up since the hand last passed it.
+    bool Referenced = false;
+  };
+  typedef std::map<MatchKey, Entry> MemoizationMap;
+
+  MemoizationMap Entries;
+  std::vector<MemoizationMap::iterator> Clock;
+  size_t Hand = 0;
+  MemoizationStats *Stats = nullptr;
+};
+
 // A RecursiveASTVisitor that traverses all children or all descendants of
 // a node.
 class MatchChildASTVisitor
@@ -425,6 +495,9 @@ public:
   ~MatchASTVisitor() override {
     if (Options.CheckProfiling) {
       Options.CheckProfiling->Records = std::move(TimeByBucket);
+      if (Options.CheckProfiling->MemoizationRecords)
+        *Options.CheckProfiling->MemoizationRecords =
+            std::move(MemoizationByBucket);
     }
   }
 
@@ -607,10 +680,9 @@ public:
     Key.Traversal = Ctx.getParentMapContext().getTraversalKind();
     // Memoize result even doing a single-level match, it might be expensive.
     Key.Type = MaxDepth == 1 ? MatchType::Child : MatchType::Descendants;
-    MemoizationMap::iterator I = ResultCache.find(Key);
-    if (I != ResultCache.end()) {
-      *Builder = I->second.Nodes;
-      return I->second.ResultOfMatch;
+    if (const MemoizedMatchResult *Cached = ResultCache.find(Key)) {
+      *Builder = Cached->Nodes;
+      return Cached->ResultOfMatch;
     }
 
     MemoizedMatchResult Result;
@@ -618,11 +690,10 @@ public:
     Result.ResultOfMatch =
         matchesRecursively(Node, Matcher, &Result.Nodes, MaxDepth, Bind);
 
-    MemoizedMatchResult &CachedResult = ResultCache[Key];
-    CachedResult = std::move(Result);
-
-    *Builder = CachedResult.Nodes;
-    return CachedResult.ResultOfMatch;
+    *Builder = Result.Nodes;
+    bool Matched = Result.ResultOfMatch;
+    ResultCache.insert(Key, std::move(Result));
+    return Matched;
   }
 
   // Matches children or descendants of 'Node' with 'BaseMatcher'.
@@ -660,8 +731,6 @@ public:
   bool matchesChildOf(const DynTypedNode &Node, ASTContext &Ctx,
                       const DynTypedMatcher &Matcher,
                       BoundNodesTreeBuilder *Builder, BindKind Bind) override {
-    if (ResultCache.size() > MaxMemoizationEntries)
-      ResultCache.clear();
     return memoizedMatchesRecursively(Node, Ctx, Matcher, Builder, 1, Bind);
   }
   // Implements ASTMatchFinder::matchesDescendantOf.
@@ -669,8 +738,6 @@ public:
                            const DynTypedMatcher &Matcher,
                            BoundNodesTreeBuilder *Builder,
                            BindKind Bind) override {
-    if (ResultCache.size() > MaxMemoizationEntries)
-      ResultCache.clear();
     return memoizedMatchesRecursively(Node, Ctx, Matcher, Builder, INT_MAX,
                                       Bind);
   }
@@ -679,10 +746,6 @@ public:
                          const DynTypedMatcher &Matcher,
                          BoundNodesTreeBuilder *Builder,
                          AncestorMatchMode MatchMode) override {
-    // Reset the cache outside of the recursive call to make sure we
-    // don't invalidate any iterators.
-    if (ResultCache.size() > MaxMemoizationEntries)
-      ResultCache.clear();
     if (MatchMode == AncestorMatchMode::AMM_ParentOnly)
       return matchesParentOf(Node, Matcher, Builder);
     return matchesAnyAncestorOf(Node, Ctx, Matcher, Builder);
@@ -1005,6 +1068,19 @@ private:
     llvm::TimeRecord *Bucket;
   };
 
+  /// Counts the memoization statistics of the matches run in the scope in the
+  /// bucket of the matcher being run, like \c TimeBucketRegion.
+  class MemoizationStatsRegion {
+  public:
+    MemoizationStatsRegion(MemoizationCache &Cache) : Cache(Cache) {}
+    ~MemoizationStatsRegion() { setBucket(nullptr); }
+
+    void setBucket(MemoizationStats *NewBucket) { Cache.setStats(NewBucket); }
+
+  private:
+    MemoizationCache &Cache;
+  };
+
   /// Runs all the \p Matchers on \p Node.
   ///
   /// Used by \c matchDispatch() below.
@@ -1012,9 +1088,12 @@ private:
   void matchWithoutFilter(const T &Node, const MC &Matchers) {
     const bool EnableCheckProfiling = Options.CheckProfiling.has_value();
     TimeBucketRegion Timer;
+    MemoizationStatsRegion Stats(ResultCache);
     for (const auto &MP : Matchers) {
-      if (EnableCheckProfiling)
+      if (EnableCheckProfiling) {
         Timer.setBucket(&TimeByBucket[MP.second->getID()]);
+        Stats.setBucket(&MemoizationByBucket[MP.second->getID()]);
+      }
       BoundNodesTreeBuilder Builder;
       CurMatchRAII RAII(*this, MP.second, Node);
       if (MP.first.matches(Node, this, &Builder)) {
@@ -1035,11 +1114,14 @@ private:
 
     const bool EnableCheckProfiling = Options.CheckProfiling.has_value();
     TimeBucketRegion Timer;
+    MemoizationStatsRegion Stats(ResultCache);
     auto &Matchers = this->Matchers->DeclOrStmt;
     for (unsigned short I : Filter) {
       auto &MP = Matchers[I];
-      if (EnableCheckProfiling)
+      if (EnableCheckProfiling) {
         Timer.setBucket(&TimeByBucket[MP.second->getID()]);
+        Stats.setBucket(&MemoizationByBucket[MP.second->getID()]);
+      }
       BoundNodesTreeBuilder Builder;
 
       {
@@ -1145,11 +1227,8 @@ private:
     std::vector<MatchKey> Keys;
     // When returning, update the memoization cache.
     auto Finish = [&](bool Matched) {
-      for (const auto &Key : Keys) {
-        MemoizedMatchResult &CachedResult = ResultCache[Key];
-        CachedResult.ResultOfMatch = Matched;
-        CachedResult.Nodes = *Builder;
-      }
+      for (const auto &Key : Keys)
+        ResultCache.insert(Key, {Matched, *Builder});
       return Matched;
     };
 
@@ -1166,11 +1245,10 @@ private:
         Keys.back().Type = MatchType::Ancestors;
 
         // Check the cache.
-        MemoizationMap::iterator I = ResultCache.find(Keys.back());
-        if (I != ResultCache.end()) {
+        if (const MemoizedMatchResult *Cached = ResultCache.find(Keys.back())) {
           Keys.pop_back(); // Don't populate the cache for the matching node!
-          *Builder = I->second.Nodes;
-          return Finish(I->second.ResultOfMatch);
+          *Builder = Cached->Nodes;
+          return Finish(Cached->ResultOfMatch);
         }
       }
 
@@ -1307,6 +1385,9 @@ private:
   /// Used to get the appropriate bucket for each matcher.
   llvm::StringMap<llvm::TimeRecord> TimeByBucket;
 
+  /// Bucket to memoization statistics map, filled like \c TimeByBucket.
+  llvm::StringMap<MemoizationStats> MemoizationByBucket;
+
   const MatchFinder::MatchersByType *Matchers;
 
   /// Filtered list of matcher indices for each matcher kind.
@@ -1328,9 +1409,7 @@ private:
                  llvm::SmallPtrSet<const ObjCCompatibleAliasDecl *, 2>>
       CompatibleAliases;
 
-  // Maps (matcher, node) -> the match result for memoization.
-  typedef std::map<MatchKey, MemoizedMatchResult> MemoizationMap;
-  MemoizationMap ResultCache;
+  MemoizationCache ResultCache;
 };
 
 static CXXRecordDecl *
@@ -11,6 +11,8 @@
 
 #include "clang/AST/Type.h"
 
+#include "mlir/IR/Types.h"
+
 namespace cir {
 
 class ABIArgInfo;
@@ -31,9 +33,16 @@ public:
   virtual ~ABIInfo();
 
   CIRGenCXXABI &getCXXABI() const;
+  clang::ASTContext &getContext() const;
 
   virtual void computeInfo(CIRGenFunctionInfo &FI) const = 0;
 
+  /// A convenience method to return an indirect ABIArgInfo with an expected
+  /// alignment equal to the ABI alignment of the given type.
+  ABIArgInfo getNaturalAlignIndirect(clang::QualType Ty, bool ByVal = true,
+                                     bool Realign = false,
+                                     mlir::Type Padding = nullptr) const;
+
   // Implement the Type::IsPromotableIntegerType for ABI specific needs. The
   // only difference is that this consideres bit-precise integer types as well.
   bool isPromotableIntegerTypeForABI(clang::QualType Ty) const;
@@ -102,6 +102,10 @@ public:
   }
 
   bool hasSRetArg() const { return SRetArgNo != InvalidIndex; }
+  unsigned getSRetArgNo() const {
+    assert(hasSRetArg());
+    return SRetArgNo;
+  }
 
   bool hasInallocaArg() const { return InallocaArgNo != InvalidIndex; }
 
@@ -132,7 +136,9 @@ void ClangToCIRArgMapping::construct(const ASTContext &Context,
   bool SwapThisWithSRet = false;
   const ABIArgInfo &RetAI = FI.getReturnInfo();
 
-  assert(RetAI.getKind() != ABIArgInfo::Indirect && "NYI");
+  // Handle sret.
+  if (RetAI.getKind() == ABIArgInfo::Indirect)
+    SRetArgNo = CIRArgNo++;
 
   unsigned ArgNo = 0;
   unsigned NumArgs = OnlyRequiredArgs ? FI.getNumRequiredArgs() : FI.arg_size();
@@ -150,12 +156,21 @@ void ClangToCIRArgMapping::construct(const ASTContext &Context,
       assert(false && "NYI");
     case ABIArgInfo::Extend:
     case ABIArgInfo::Direct: {
-      assert(!AI.getCoerceToType().dyn_cast<mlir::cir::StructType>() && "NYI");
       // FIXME: handle sseregparm someday...
-      // FIXME: handle structs
+      // Unlike LLVM's CodeGen, a coerced struct (e.g. the {lo, hi} pair of an
+      // x86-64 argument split across two eightbytes) is not flattened: it is
+      // passed as a single first-class value and the lowering to LLVM
+      // assigns its members to registers.
       CIRArgs.NumberOfArgs = 1;
       break;
     }
+    case ABIArgInfo::Indirect:
+      CIRArgs.NumberOfArgs = 1;
+      break;
+    case ABIArgInfo::Ignore:
+      // ignore and inalloca doesn't have matching CIR types.
+      CIRArgs.NumberOfArgs = 0;
+      break;
     }
 
     if (CIRArgs.NumberOfArgs > 0) {
@@ -195,6 +210,7 @@ mlir::FunctionType CIRGenTypes::GetFunctionType(const CIRGenFunctionInfo &FI) {
   mlir::Type resultType = nullptr;
   const ABIArgInfo &retAI = FI.getReturnInfo();
   switch (retAI.getKind()) {
+  case ABIArgInfo::Indirect:
   case ABIArgInfo::Ignore:
     // TODO(CIR): This should probably be the None type from the builtin
     // dialect.
@@ -213,7 +229,13 @@ mlir::FunctionType CIRGenTypes::GetFunctionType(const CIRGenFunctionInfo &FI) {
   ClangToCIRArgMapping CIRFunctionArgs(getContext(), FI, true);
   SmallVector<mlir::Type, 8> ArgTypes(CIRFunctionArgs.totalCIRArgs());
 
-  assert(!CIRFunctionArgs.hasSRetArg() && "NYI");
+  // Add type for sret argument.
+  if (CIRFunctionArgs.hasSRetArg()) {
+    QualType Ret = FI.getReturnType();
+    ArgTypes[CIRFunctionArgs.getSRetArgNo()] = mlir::cir::PointerType::get(
+        Builder.getContext(), convertTypeForMem(Ret));
+  }
+
   assert(!CIRFunctionArgs.hasInallocaArg() && "NYI");
 
   // Add in all of the required arguments.
@@ -240,6 +262,15 @@ mlir::FunctionType CIRGenTypes::GetFunctionType(const CIRGenFunctionInfo &FI) {
       ArgTypes[FirstCIRArg] = argType;
       break;
     }
+    case ABIArgInfo::Indirect: {
+      assert(NumCIRArgs == 1);
+      ArgTypes[FirstCIRArg] = mlir::cir::PointerType::get(
+          Builder.getContext(), convertTypeForMem(it->type));
+      break;
+    }
+    case ABIArgInfo::Ignore:
+      assert(NumCIRArgs == 0);
+      break;
     }
   }
 
@@ -251,11 +282,252 @@ mlir::FunctionType CIRGenTypes::GetFunctionType(const CIRGenFunctionInfo &FI) {
                                  resultType ? resultType : mlir::TypeRange());
 }
 
+void CIRGenModule::constructAttributeList(const CIRGenFunctionInfo &FI,
+                                          mlir::cir::FuncOp F) {
+  ClangToCIRArgMapping CIRFunctionArgs(getASTContext(), FI, true);
+  assert(F.getNumArguments() == CIRFunctionArgs.totalCIRArgs() &&
+         "Function type does not match its arrangement");
+
+  auto setAlign = [&](unsigned CIRArgNo, CharUnits Align) {
+    F.setArgAttr(CIRArgNo, mlir::cir::FuncOp::getAlignArgAttrName(),
+                 builder.getI64IntegerAttr(Align.getQuantity()));
+  };
+
+  // The result is returned through memory the caller provides.
+  if (CIRFunctionArgs.hasSRetArg()) {
+    unsigned SRetArgNo = CIRFunctionArgs.getSRetArgNo();
+    F.setArgAttr(SRetArgNo, mlir::cir::FuncOp::getSRetArgAttrName(),
+                 builder.getUnitAttr());
+    setAlign(SRetArgNo, FI.getReturnInfo().getIndirectAlign());
+  }
+
+  unsigned ArgNo = 0;
+  CIRGenFunctionInfo::const_arg_iterator it = FI.arg_begin(),
+                                         ie = it + FI.getNumRequiredArgs();
+  for (; it != ie; ++it, ++ArgNo) {
+    const auto &ArgInfo = it->info;
+    if (!ArgInfo.isIndirect())
+      continue;
+
+    unsigned FirstCIRArg, NumCIRArgs;
+    std::tie(FirstCIRArg, NumCIRArgs) = CIRFunctionArgs.getCIRArgs(ArgNo);
+    assert(NumCIRArgs == 1);
+    if (ArgInfo.getIndirectByVal())
+      F.setArgAttr(FirstCIRArg, mlir::cir::FuncOp::getByValArgAttrName(),
+                   builder.getUnitAttr());
+    setAlign(FirstCIRArg, ArgInfo.getIndirectAlign());
+  }
+}
+
 CIRGenCallee CIRGenCallee::prepareConcreteCallee(CIRGenFunction &CGF) const {
   assert(!isVirtual() && "Virtual NYI");
   return *this;
 }
 
+/// Return a pointer to the memory \p Offset bytes into \p Addr, viewed as an
+/// object of type \p Ty.
+///
+/// This is how values are moved between their memory representation and the
+/// type an ABI coerced them to. Callers make sure \p Ty does not cover more
+/// bytes than the object, see coercionMayOverrun.
+static mlir::Value buildCoercedAddress(CIRGenFunction &CGF, Address Addr,
+                                       mlir::Type Ty, unsigned Offset,
+                                       mlir::Location Loc) {
+  auto &builder = CGF.getBuilder();
+  mlir::Value Ptr = Addr.getPointer();
+
+  if (Offset) {
+    auto BytePtrTy =
+        mlir::cir::PointerType::get(builder.getContext(), builder.getI8Type());
+    Ptr = builder.create<mlir::cir::CastOp>(Loc, BytePtrTy,
+                                            mlir::cir::CastKind::bitcast, Ptr);
+    auto OffsetTy = builder.getI64Type();
+    auto Idx = builder.create<mlir::cir::ConstantOp>(
+        Loc, OffsetTy, builder.getIntegerAttr(OffsetTy, Offset));
+    Ptr = builder.create<mlir::cir::PtrStrideOp>(Loc, BytePtrTy, Ptr, Idx);
+  }
+
+  auto PtrTy = mlir::cir::PointerType::get(builder.getContext(), Ty);
+  if (Ptr.getType() != PtrTy)
+    Ptr = builder.create<mlir::cir::CastOp>(Loc, PtrTy,
+                                            mlir::cir::CastKind::bitcast, Ptr);
+  return Ptr;
+}
+
+/// Whether an access of the coerced type \p Ty may cover bytes past the end
+/// of the object it stands for.
+///
+/// Scalar coercions never do, but the {lo, hi} pair of an argument split
+/// across two eightbytes spans both of them in full: for an object like
+/// struct { double d; int i; } its second member reads the tail padding.
+static bool coercionMayOverrun(mlir::Type Ty) {
+  return Ty.isa<mlir::cir::StructType>();
+}
+
+/// The alignment of a temporary holding the coerced pair for an object
+/// aligned to \p ObjAlign; the pair starts with a full eightbyte.
+static CharUnits getCoercedPairAlign(CharUnits ObjAlign) {
+  return std::max(ObjAlign, CharUnits::fromQuantity(8));
+}
+
+/// Load a value of the coerced type \p Ty from \p Src.
+static mlir::Value buildCoercedLoad(CIRGenFunction &CGF, Address Src,
+                                    mlir::Type Ty, unsigned Offset,
+                                    mlir::Location Loc) {
+  auto &builder = CGF.getBuilder();
+  if (coercionMayOverrun(Ty)) {
+    // Copy the object into a temporary of the coerced size and load from
+    // there.
+    assert(Offset == 0 && "Coerced pair at an offset");
+    Address Tmp = CGF.CreateTempAlloca(
+        Ty, getCoercedPairAlign(Src.getAlignment()), Loc, "coerce");
+    auto Obj = builder.create<mlir::cir::LoadOp>(Loc, Src.getElementType(),
+                                                 Src.getPointer());
+    builder.create<mlir::cir::StoreOp>(
+        Loc, Obj,
+        buildCoercedAddress(CGF, Tmp, Src.getElementType(), /*Offset=*/0,
+                            Loc));
+    Src = Tmp;
+  }
+  auto Ptr = buildCoercedAddress(CGF, Src, Ty, Offset, Loc);
+  return builder.create<mlir::cir::LoadOp>(Loc, Ty, Ptr);
+}
+
+/// Store \p Val, whose type is the coerced type of the object at \p Dst.
+static void buildCoercedStore(CIRGenFunction &CGF, mlir::Value Val, Address Dst,
+                              unsigned Offset, mlir::Location Loc) {
+  auto &builder = CGF.getBuilder();
+  if (coercionMayOverrun(Val.getType())) {
+    // Store to a temporary of the coerced size and copy the object out of it.
+    assert(Offset == 0 && "Coerced pair at an offset");
+    Address Tmp = CGF.CreateTempAlloca(
+        Val.getType(), getCoercedPairAlign(Dst.getAlignment()), Loc, "coerce");
+    builder.create<mlir::cir::StoreOp>(Loc, Val, Tmp.getPointer());
+    auto Obj = builder.create<mlir::cir::LoadOp>(
+        Loc, Dst.getElementType(),
+        buildCoercedAddress(CGF, Tmp, Dst.getElementType(), /*Offset=*/0,
+                            Loc));
+    builder.create<mlir::cir::StoreOp>(Loc, Obj, Dst.getPointer());
+    return;
+  }
+  auto Ptr = buildCoercedAddress(CGF, Dst, Val.getType(), Offset, Loc);
+  builder.create<mlir::cir::StoreOp>(Loc, Val, Ptr);
+}
+
+mlir::LogicalResult
+CIRGenFunction::buildFunctionProlog(const CIRGenFunctionInfo &FI,
+                                    mlir::cir::FuncOp Fn,
+                                    const FunctionArgList &Args,
+                                    mlir::Location FnBodyBegin) {
+  mlir::Block *EntryBB = &Fn.getBlocks().front();
+  ClangToCIRArgMapping CIRFunctionArgs(CGM.getASTContext(), FI);
+  assert(EntryBB->getNumArguments() == CIRFunctionArgs.totalCIRArgs());
+
+  // The sret argument is picked up by buildAndUpdateRetAlloca.
+  assert(!CIRFunctionArgs.hasInallocaArg() && "NYI");
+
+  assert(FI.arg_size() == Args.size() &&
+         "Mismatch between function signature & arguments.");
+  unsigned ArgNo = 0;
+  CIRGenFunctionInfo::const_arg_iterator info_it = FI.arg_begin();
+  for (FunctionArgList::const_iterator i = Args.begin(), e = Args.end();
+       i != e; ++i, ++info_it, ++ArgNo) {
+    const VarDecl *Arg = *i;
+    const ABIArgInfo &ArgI = info_it->info;
+
+    assert(!CIRFunctionArgs.hasPaddingArg(ArgNo) && "Padding args NYI");
+
+    unsigned FirstCIRArg, NumCIRArgs;
+    std::tie(FirstCIRArg, NumCIRArgs) = CIRFunctionArgs.getCIRArgs(ArgNo);
+
+    auto alignment = getContext().getDeclAlign(Arg);
+    auto paramLoc = getLoc(Arg->getSourceRange());
+
+    switch (ArgI.getKind()) {
+    case ABIArgInfo::Indirect: {
+      assert(NumCIRArgs == 1);
+      auto paramVal = EntryBB->getArgument(FirstCIRArg);
+      paramVal.setLoc(paramLoc);
+      assert(!ArgI.getIndirectRealign() && "NYI");
+
+      // The caller passed the address of a copy of the argument; use it as
+      // the storage of the parameter.
+      symbolTable.insert(Arg, paramVal);
+      setAddrOfLocalVar(Arg, Address(paramVal, ArgI.getIndirectAlign()));
+      break;
+    }
+
+    case ABIArgInfo::Extend:
+    case ABIArgInfo::Direct: {
+      assert(NumCIRArgs == 1);
+      auto paramVal = EntryBB->getArgument(FirstCIRArg);
+      paramVal.setLoc(paramLoc);
+
+      mlir::Value addr;
+      if (failed(declare(Arg, Arg->getType(), paramLoc, alignment, addr,
+                         true /*param*/)))
+        return mlir::failure();
+
+      auto address = Address(addr, alignment);
+      setAddrOfLocalVar(Arg, address);
+
+      // Location of the store to the param storage tracked as beginning of
+      // the function body.
+      if (paramVal.getType() == address.getElementType() &&
+          ArgI.getDirectOffset() == 0)
+        builder.create<mlir::cir::StoreOp>(FnBodyBegin, paramVal, addr);
+      else
+        buildCoercedStore(*this, paramVal, address, ArgI.getDirectOffset(),
+                          FnBodyBegin);
+      break;
+    }
+
+    case ABIArgInfo::Ignore: {
+      assert(NumCIRArgs == 0);
+      // Initialize the local variable appropriately.
+      mlir::Value addr;
+      if (failed(declare(Arg, Arg->getType(), paramLoc, alignment, addr,
+                         true /*param*/)))
+        return mlir::failure();
+      setAddrOfLocalVar(Arg, Address(addr, alignment));
+      break;
+    }
+
+    default:
+      llvm_unreachable("NYI");
+    }
+  }
+  return mlir::success();
+}
+
+mlir::cir::ReturnOp CIRGenFunction::buildFunctionEpilog(mlir::Location Loc) {
+  // Functions with no result always return void.
+  if (!FnRetCIRTy.hasValue())
+    return builder.create<mlir::cir::ReturnOp>(Loc);
+
+  const ABIArgInfo &RetAI = CurFnInfo->getReturnInfo();
+  switch (RetAI.getKind()) {
+  case ABIArgInfo::Indirect:
+    // The result was already stored through the sret argument.
+  case ABIArgInfo::Ignore:
+    return builder.create<mlir::cir::ReturnOp>(Loc);
+
+  case ABIArgInfo::Extend:
+  case ABIArgInfo::Direct: {
+    mlir::Value val;
+    if (RetAI.getCoerceToType() == *FnRetCIRTy && RetAI.getDirectOffset() == 0)
+      val = builder.create<mlir::cir::LoadOp>(Loc, *FnRetCIRTy, *FnRetAlloca);
+    else
+      val = buildCoercedLoad(*this, ReturnValue, RetAI.getCoerceToType(),
+                             RetAI.getDirectOffset(), Loc);
+    return builder.create<mlir::cir::ReturnOp>(Loc, llvm::makeArrayRef(val));
+  }
+
+  default:
+    llvm_unreachable("NYI");
+  }
+}
+
 RValue CIRGenFunction::buildCall(const CIRGenFunctionInfo &CallInfo,
                                  const CIRGenCallee &Callee,
                                  ReturnValueSlot ReturnValue,
@@ -304,10 +576,19 @@ RValue CIRGenFunction::buildCall(const CIRGenFunctionInfo &CallInfo,
   ClangToCIRArgMapping CIRFunctionArgs(CGM.getASTContext(), CallInfo);
   SmallVector<mlir::Value, 16> CIRCallArgs(CIRFunctionArgs.totalCIRArgs());
 
+  auto callLoc = CGM.getLoc(Loc);
+
   // If the call returns a temporary with struct return, create a temporary
   // alloca to hold the result, unless one is given to us.
-  assert(!RetAI.isIndirect() && !RetAI.isInAlloca() &&
-         !RetAI.isCoerceAndExpand() && "NYI");
+  assert(!RetAI.isInAlloca() && !RetAI.isCoerceAndExpand() && "NYI");
+  Address SRetPtr = Address::invalid();
+  if (RetAI.isIndirect()) {
+    if (!ReturnValue.isNull())
+      SRetPtr = ReturnValue.getValue();
+    else
+      SRetPtr = CreateMemTemp(RetTy, callLoc, "tmp");
+    CIRCallArgs[CIRFunctionArgs.getSRetArgNo()] = SRetPtr.getPointer();
+  }
 
   // When passing arguments using temporary allocas, we need to add the
   // appropriate lifetime markers. This vector keeps track of all the lifetime
@@ -329,14 +610,52 @@ RValue CIRGenFunction::buildCall(const CIRGenFunctionInfo &CallInfo,
     std::tie(FirstCIRArg, NumCIRArgs) = CIRFunctionArgs.getCIRArgs(ArgNo);
 
     switch (ArgInfo.getKind()) {
+    case ABIArgInfo::Indirect: {
+      assert(NumCIRArgs == 1);
+      if (I->isAggregate()) {
+        // Aggregate arguments are evaluated into a temporary of their own
+        // (see buildCallArg), which the callee may use as its copy unless it
+        // expects more alignment.
+        Address Addr = I->getKnownRValue().getAggregateAddress();
+        if (Addr.getAlignment() < ArgInfo.getIndirectAlign()) {
+          Address AlignedTmp = CreateMemTemp(
+              I->Ty, ArgInfo.getIndirectAlign(), callLoc, "byval-temp");
+          buildAggregateCopy(makeAddrLValue(AlignedTmp, I->Ty),
+                             makeAddrLValue(Addr, I->Ty), I->Ty,
+                             AggValueSlot::DoesNotOverlap);
+          Addr = AlignedTmp;
+        }
+        CIRCallArgs[FirstCIRArg] = Addr.getPointer();
+        break;
+      }
+
+      // Make a temporary copy of the argument and pass its address.
+      Address Addr = CreateMemTemp(I->Ty, ArgInfo.getIndirectAlign(), callLoc,
+                                   "indirect-arg-temp");
+      builder.create<mlir::cir::StoreOp>(
+          callLoc, I->getKnownRValue().getScalarVal(), Addr.getPointer());
+      CIRCallArgs[FirstCIRArg] = Addr.getPointer();
+      break;
+    }
+
+    case ABIArgInfo::Ignore:
+      assert(NumCIRArgs == 0);
+      break;
+
+    case ABIArgInfo::Extend:
     case ABIArgInfo::Direct: {
       if (!ArgInfo.getCoerceToType().isa<mlir::cir::StructType>() &&
           ArgInfo.getCoerceToType() == convertType(info_it->type) &&
           ArgInfo.getDirectOffset() == 0) {
         assert(NumCIRArgs == 1);
         mlir::Value V;
-        assert(!I->isAggregate() && "Aggregate NYI");
-        V = I->getKnownRValue().getScalarVal();
+        if (!I->isAggregate()) {
+          V = I->getKnownRValue().getScalarVal();
+        } else {
+          Address Addr = I->getKnownRValue().getAggregateAddress();
+          V = builder.create<mlir::cir::LoadOp>(callLoc, Addr.getElementType(),
+                                                Addr.getPointer());
+        }
 
         assert(CallInfo.getExtParameterInfo(ArgNo).getABI() !=
                    ParameterABI::SwiftErrorResult &&
@@ -354,10 +673,25 @@ RValue CIRGenFunction::buildCall(const CIRGenFunctionInfo &CallInfo,
         CIRCallArgs[FirstCIRArg] = V;
         break;
       }
-      assert(false && "this code path shouldn't be hit yet");
+
+      // The argument was coerced by the ABI: get it in memory and load it
+      // back as the coerced type.
+      assert(NumCIRArgs == 1);
+      Address Src = Address::invalid();
+      if (!I->isAggregate()) {
+        Src = CreateMemTemp(I->Ty, callLoc, "coerce");
+        builder.create<mlir::cir::StoreOp>(
+            callLoc, I->getKnownRValue().getScalarVal(), Src.getPointer());
+      } else {
+        Src = I->getKnownRValue().getAggregateAddress();
+      }
+      CIRCallArgs[FirstCIRArg] =
+          buildCoercedLoad(*this, Src, ArgInfo.getCoerceToType(),
+                           ArgInfo.getDirectOffset(), callLoc);
+      break;
     }
     default:
-      assert(false && "Only Direct support so far");
+      llvm_unreachable("NYI");
     }
   }
 
@@ -395,8 +729,6 @@ RValue CIRGenFunction::buildCall(const CIRGenFunctionInfo &CallInfo,
   // TODO: alignment attributes
 
   // Emit the actual call op.
-  auto callLoc = CGM.getLoc(Loc);
-
   // FIXME: Used to be:
   // auto theCall = CGM.getBuilder().create<mlir::cir::CallOp>(
   //     callLoc, mlir::SymbolRefAttr::get(CalleePtr),
@@ -441,6 +773,21 @@ RValue CIRGenFunction::buildCall(const CIRGenFunctionInfo &CallInfo,
   // Extract the return value.
   RValue ret = [&] {
     switch (RetAI.getKind()) {
+    case ABIArgInfo::Indirect: {
+      // The callee stored the result through the sret argument.
+      switch (getEvaluationKind(RetTy)) {
+      case TEK_Scalar:
+        return RValue::get(builder.create<mlir::cir::LoadOp>(
+            callLoc, SRetPtr.getElementType(), SRetPtr.getPointer()));
+      case TEK_Aggregate:
+        return RValue::getAggregate(SRetPtr);
+      case TEK_Complex:
+        llvm_unreachable("NYI");
+      }
+      llvm_unreachable("bad evaluation kind");
+    }
+
+    case ABIArgInfo::Extend:
     case ABIArgInfo::Direct: {
       mlir::Type RetCIRTy = convertType(RetTy);
       if (RetAI.getCoerceToType() == RetCIRTy && RetAI.getDirectOffset() == 0) {
@@ -456,9 +803,25 @@ RValue CIRGenFunction::buildCall(const CIRGenFunctionInfo &CallInfo,
         default:
           llvm_unreachable("NYI");
         }
-      } else {
-        llvm_unreachable("No other forms implemented yet.");
       }
+
+      // The result was coerced by the ABI: store it to a temporary and load
+      // it back as the source type.
+      auto Results = theCall.getResults();
+      assert(Results.size() == 1 && "Expected a coerced result");
+      Address DestPtr = CreateMemTemp(RetTy, callLoc, "coerce");
+      buildCoercedStore(*this, Results[0], DestPtr, RetAI.getDirectOffset(),
+                        callLoc);
+      switch (getEvaluationKind(RetTy)) {
+      case TEK_Scalar:
+        return RValue::get(builder.create<mlir::cir::LoadOp>(
+            callLoc, DestPtr.getElementType(), DestPtr.getPointer()));
+      case TEK_Aggregate:
+        return RValue::getAggregate(DestPtr);
+      case TEK_Complex:
+        llvm_unreachable("NYI");
+      }
+      llvm_unreachable("bad evaluation kind");
     }
 
     case ABIArgInfo::Ignore:
@@ -506,11 +869,20 @@ void CIRGenFunction::buildCallArg(CallArgList &args, const Expr *E,
   // In the Microsoft C++ ABI, aggregate arguments are destructed by the callee.
   // However, we still have to push an EH-only cleanup in case we unwind before
   // we make it to the call.
-  assert(!type->isRecordType() && "Record type args NYI");
+  if (type->isRecordType())
+    assert(!type->castAs<RecordType>()->getDecl()->isParamDestroyedInCallee() &&
+           "Arguments destroyed in the callee NYI");
+  assert(!type.isDestructedType() && "Argument temporary cleanups NYI");
 
   if (HasAggregateEvalKind && isa<ImplicitCastExpr>(E) &&
       cast<CastExpr>(E)->getCastKind() == CK_LValueToRValue) {
-    assert(0 && "NYI");
+    // Copy the l-value into the temporary passed to the callee.
+    LValue L = buildLValue(cast<CastExpr>(E)->getSubExpr());
+    assert(L.isSimple() && "Non-simple aggregate l-value NYI");
+    Address Tmp = CreateMemTemp(type, getLoc(E->getSourceRange()), "agg.tmp");
+    buildAggregateCopy(makeAddrLValue(Tmp, type), L, type,
+                       AggValueSlot::DoesNotOverlap, L.isVolatile());
+    return args.add(RValue::getAggregate(Tmp), type);
   }
 
   args.add(buildAnyExprToTemp(E), type);
@@ -521,7 +893,9 @@ void CIRGenFunction::buildCallArg(CallArgList &args, const Expr *E,
 RValue CIRGenFunction::buildAnyExprToTemp(const Expr *E) {
   AggValueSlot AggSlot = AggValueSlot::ignored();
 
-  assert(!hasAggregateEvaluationKind(E->getType()) && "aggregate args NYI");
+  if (hasAggregateEvaluationKind(E->getType()))
+    AggSlot =
+        CreateAggTemp(E->getType(), getLoc(E->getSourceRange()), "agg.tmp");
   return buildAnyExpr(E, AggSlot);
 }
 
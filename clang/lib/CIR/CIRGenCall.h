@@ -197,6 +197,10 @@ public:
   //   IsUnused(false),
   //   IsExternallyDestructed(false)
   {}
+  ReturnValueSlot(Address Addr) : Addr(Addr) {}
+
+  bool isNull() const { return !Addr.isValid(); }
+  Address getValue() const { return Addr; }
 };
 
 } // namespace cir
@@ -0,0 +1,417 @@
+//===----- CIRGenCoroutine.cpp - Emit CIR Code for C++ coroutines ---------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// This contains code dealing with C++ code generation of coroutines.
+//
+// Unlike LLVM codegen, which emits the coro.* intrinsics and the control flow
+// of the suspend points right away, the coroutine structure is kept in CIR:
+// the frame is allocated by `cir.coro.alloc_frame`, freed by
+// `cir.coro.free_frame` and every suspend point is a `cir.await`. This lets
+// CIR passes reason about coroutine lifetimes, see CoroElide.cpp.
+//
+//===----------------------------------------------------------------------===//
+
+#include "CIRGenFunction.h"
+
+#include "clang/AST/StmtCXX.h"
+#include "clang/AST/StmtVisitor.h"
+#include "clang/Basic/Builtins.h"
+#include "llvm/ADT/ScopeExit.h"
+
+using namespace clang;
+using namespace cir;
+
+struct cir::CGCoroData {
+  // What is the current await expression kind.
+  mlir::cir::AwaitKind CurrentAwaitKind = mlir::cir::AwaitKind::init;
+
+  // The coroutine being emitted, whose end every co_return reaches.
+  const CoroutineBodyStmt *Body = nullptr;
+
+  // The co_return ending the user authored body, which falls through to the
+  // final suspend point.
+  const CoreturnStmt *FinalCoreturn = nullptr;
+
+  // Stores the result of the cir.coro.alloc_frame emitted in the function,
+  // which is what __builtin_coro_frame and __builtin_coro_free refer to.
+  mlir::Value CoroFrame = nullptr;
+
+  // The frame size argument of the alloc and dealloc regions, while they are
+  // being emitted, for __builtin_coro_size.
+  mlir::Value CoroFrameSize = nullptr;
+};
+
+// Defining these here allows to keep CGCoroData private to this file.
+CIRGenFunction::CGCoroInfo::CGCoroInfo() {}
+CIRGenFunction::CGCoroInfo::~CGCoroInfo() {}
+
+// Hunts for the parameter reference in the parameter copy/move declaration.
+namespace {
+struct GetParamRef : public StmtVisitor<GetParamRef> {
+public:
+  DeclRefExpr *Expr = nullptr;
+  GetParamRef() {}
+  void VisitDeclRefExpr(DeclRefExpr *E) {
+    assert(Expr == nullptr && "multilple declref in param move");
+    Expr = E;
+  }
+  void VisitStmt(Stmt *S) {
+    for (auto *C : S->children()) {
+      if (C)
+        Visit(C);
+    }
+  }
+};
+} // namespace
+
+// This class replaces references to parameters to their copies by changing
+// the addresses in CGF.LocalDeclMap and restoring back the original values in
+// its destructor.
+namespace {
+struct ParamReferenceReplacerRAII {
+  CIRGenFunction::DeclMapTy SavedLocals;
+  CIRGenFunction::DeclMapTy &LocalDeclMap;
+
+  ParamReferenceReplacerRAII(CIRGenFunction::DeclMapTy &LocalDeclMap)
+      : LocalDeclMap(LocalDeclMap) {}
+
+  void addCopy(DeclStmt const *PM) {
+    // Figure out what param it refers to.
+    assert(PM->isSingleDecl());
+    VarDecl const *VD = static_cast<VarDecl const *>(PM->getSingleDecl());
+    Expr const *InitExpr = VD->getInit();
+    GetParamRef Visitor;
+    Visitor.Visit(const_cast<Expr *>(InitExpr));
+    assert(Visitor.Expr);
+    DeclRefExpr *DREOrig = Visitor.Expr;
+    auto *PD = DREOrig->getDecl();
+
+    auto it = LocalDeclMap.find(PD);
+    assert(it != LocalDeclMap.end() && "parameter is not found");
+    SavedLocals.insert({PD, it->second});
+
+    auto copyIt = LocalDeclMap.find(VD);
+    assert(copyIt != LocalDeclMap.end() && "parameter copy is not found");
+    it->second = copyIt->getSecond();
+  }
+
+  ~ParamReferenceReplacerRAII() {
+    for (auto &&SavedLocal : SavedLocals) {
+      LocalDeclMap.insert({SavedLocal.first, SavedLocal.second});
+    }
+  }
+};
+} // namespace
+
+// Emit suspend expression which roughly looks like:
+//
+//   auto && x = CommonExpr();
+//   cir.await(kind, ready : {
+//     x.await_ready()
+//   }, suspend : {
+//     x.await_suspend(...)
+//   }, resume : {
+//     x.await_resume()
+//   })
+//
+// where the result of the entire expression is the result of x.await_resume()
+static RValue buildSuspendExpression(CIRGenFunction &CGF, CGCoroData &Coro,
+                                     CoroutineSuspendExpr const &S,
+                                     mlir::cir::AwaitKind Kind,
+                                     bool ignoreResult) {
+  auto *E = S.getCommonExpr();
+  auto *OV = S.getOpaqueValue();
+
+  // Bind the awaiter to the opaque value the await_* calls refer to.
+  if (OV->isGLValue() || CIRGenFunction::hasAggregateEvaluationKind(
+                             OV->getType()))
+    CGF.OpaqueLValues.insert({OV, CGF.buildLValue(E)});
+  else
+    CGF.OpaqueRValues.insert({OV, CGF.buildAnyExpr(E)});
+  auto UnbindOnExit = llvm::make_scope_exit([&] {
+    CGF.OpaqueLValues.erase(OV);
+    CGF.OpaqueRValues.erase(OV);
+  });
+
+  auto *ResumeExpr = S.getResumeExpr();
+  QualType ResumeTy = ResumeExpr->getType();
+  assert(!CIRGenFunction::hasAggregateEvaluationKind(ResumeTy) &&
+         !ResumeTy->isAnyComplexType() && "NYI");
+  llvm::SmallVector<mlir::Type, 1> ResultTypes;
+  if (!ignoreResult && !ResumeTy->isVoidType())
+    ResultTypes.push_back(CGF.getCIRType(ResumeTy));
+
+  auto &builder = CGF.getBuilder();
+  auto awaitOp = builder.create<mlir::cir::AwaitOp>(
+      CGF.getLoc(S.getSourceRange()), Kind, ResultTypes,
+      /*readyBuilder=*/
+      [&](mlir::OpBuilder &b, mlir::Location loc) {
+        // If expression is ready, no need to suspend.
+        mlir::Value ready = CGF.evaluateExprAsBool(S.getReadyExpr());
+        b.create<mlir::cir::YieldOp>(loc, mlir::cir::YieldOpKindAttr(),
+                                     ready);
+      },
+      /*suspendBuilder=*/
+      [&](mlir::OpBuilder &b, mlir::Location loc) {
+        mlir::Value suspendRet = CGF.buildScalarExpr(S.getSuspendExpr());
+        // Veto suspension if requested by bool returning await_suspend.
+        if (suspendRet && suspendRet.getType().isa<mlir::cir::BoolType>())
+          b.create<mlir::cir::YieldOp>(loc, mlir::cir::YieldOpKindAttr(),
+                                       suspendRet);
+        else
+          b.create<mlir::cir::YieldOp>(loc);
+      },
+      /*resumeBuilder=*/
+      [&](mlir::OpBuilder &b, mlir::Location loc) {
+        if (ResultTypes.empty()) {
+          CGF.buildIgnoredExpr(ResumeExpr);
+          b.create<mlir::cir::YieldOp>(loc);
+          return;
+        }
+        mlir::Value resumeRet = CGF.buildScalarExpr(ResumeExpr);
+        b.create<mlir::cir::YieldOp>(loc, mlir::cir::YieldOpKindAttr(),
+                                     resumeRet);
+      });
+
+  if (ResultTypes.empty())
+    return RValue::get(nullptr);
+  return RValue::get(awaitOp.getResult(0));
+}
+
+RValue CIRGenFunction::buildCoawaitExpr(const CoawaitExpr &E,
+                                        bool ignoreResult) {
+  return buildSuspendExpression(*this, *CurCoro.Data, E,
+                                CurCoro.Data->CurrentAwaitKind, ignoreResult);
+}
+
+RValue CIRGenFunction::buildCoyieldExpr(const CoyieldExpr &E,
+                                        bool ignoreResult) {
+  return buildSuspendExpression(*this, *CurCoro.Data, E,
+                                mlir::cir::AwaitKind::yield, ignoreResult);
+}
+
+// Emit a region of the frame operations, which takes the frame size as its
+// argument.
+static mlir::LogicalResult buildFrameRegion(CIRGenFunction &CGF,
+                                            mlir::Region &region,
+                                            mlir::Location loc,
+                                            const Stmt *S) {
+  auto &builder = CGF.getBuilder();
+  mlir::OpBuilder::InsertionGuard guard(builder);
+  auto sizeTy = CGF.getCIRType(CGF.getContext().getSizeType());
+  auto *entry = builder.createBlock(&region, {}, {sizeTy}, {loc});
+
+  CGF.CurCoro.Data->CoroFrameSize = entry->getArgument(0);
+  auto sizeReset = llvm::make_scope_exit(
+      [&] { CGF.CurCoro.Data->CoroFrameSize = nullptr; });
+
+  // The allocation yields the memory it returns, the deallocation is a plain
+  // call to operator delete.
+  const auto *E = dyn_cast<Expr>(S);
+  if (E && !E->getType()->isVoidType()) {
+    mlir::Value mem = CGF.buildScalarExpr(E);
+    builder.create<mlir::cir::YieldOp>(loc, mlir::cir::YieldOpKindAttr(), mem);
+    return mlir::success();
+  }
+
+  if (CGF.buildStmt(S, /*useCurrentScope=*/true).failed())
+    return mlir::failure();
+  builder.create<mlir::cir::YieldOp>(loc);
+  return mlir::success();
+}
+
+// Emit the end of the coroutine: the final suspend point and, once the
+// coroutine completes or is destroyed, the deallocation of its frame.
+static mlir::LogicalResult buildCoroutineEnd(CIRGenFunction &CGF,
+                                             mlir::Location loc) {
+  auto &Data = *CGF.CurCoro.Data;
+  const CoroutineBodyStmt &S = *Data.Body;
+
+  auto SavedKind = Data.CurrentAwaitKind;
+  Data.CurrentAwaitKind = mlir::cir::AwaitKind::final;
+  auto KindReset =
+      llvm::make_scope_exit([&] { Data.CurrentAwaitKind = SavedKind; });
+  if (CGF.buildStmt(S.getFinalSuspendStmt(), /*useCurrentScope=*/true)
+          .failed())
+    return mlir::failure();
+
+  auto freeFrame = CGF.getBuilder().create<mlir::cir::CoroFreeFrameOp>(
+      loc, Data.CoroFrame);
+  return buildFrameRegion(CGF, freeFrame.dealloc(), loc, S.getDeallocate());
+}
+
+mlir::LogicalResult CIRGenFunction::buildCoreturnStmt(CoreturnStmt const &S) {
+  const Expr *RV = S.getOperand();
+  if (RV && RV->getType()->isVoidType() && !isa<InitListExpr>(RV)) {
+    // Make sure to evaluate the non initlist expression of a co_return
+    // with a void expression for side effects.
+    buildIgnoredExpr(RV);
+  }
+  if (buildStmt(S.getPromiseCall(), /*useCurrentScope=*/true).failed())
+    return mlir::failure();
+
+  // The co_return ending the body falls through to the final suspend point.
+  if (&S == CurCoro.Data->FinalCoreturn)
+    return mlir::success();
+
+  // Any other co_return ends the coroutine where it stands, which leaves the
+  // enclosing scopes like a return statement.
+  auto loc = getLoc(S.getSourceRange());
+  if (buildCoroutineEnd(*this, loc).failed())
+    return mlir::failure();
+  auto *retBlock = currLexScope->getOrCreateRetBlock(*this, loc);
+  builder.create<mlir::cir::BrOp>(loc, retBlock);
+
+  // Insert the new block to continue codegen after the branch.
+  builder.createBlock(builder.getBlock()->getParent());
+  return mlir::success();
+}
+
+mlir::LogicalResult
+CIRGenFunction::buildCoroutineBody(const CoroutineBodyStmt &S) {
+  auto loc = getLoc(S.getSourceRange());
+  auto voidPtrTy = getCIRType(getContext().VoidPtrTy);
+
+  assert(!CurCoro.Data && "buildCoroutineBody called twice?");
+  CurCoro.Data = std::make_unique<CGCoroData>();
+  CurCoro.Data->Body = &S;
+  CurFn.coroutineAttr(builder.getUnitAttr());
+
+  // The return object built on allocation failure needs a control flow edge
+  // from the allocation to the function return.
+  if (S.getReturnStmtOnAllocFailure())
+    llvm_unreachable("NYI");
+
+  // Backend is allowed to elide memory allocations, that is why the heap
+  // allocation lives in its own region.
+  auto allocFrame = builder.create<mlir::cir::CoroAllocFrameOp>(
+      loc, voidPtrTy, /*storage=*/mlir::Value(), /*storage_size=*/nullptr);
+  if (buildFrameRegion(*this, allocFrame.alloc(), loc, S.getAllocate())
+          .failed())
+    return mlir::failure();
+  CurCoro.Data->CoroFrame = allocFrame;
+
+  {
+    ParamReferenceReplacerRAII ParamReplacer(LocalDeclMap);
+
+    // Create parameter copies. We do it before creating a promise, since an
+    // evolution of coroutine TS may allow promise constructor to observe
+    // parameter copies.
+    for (auto *PM : S.getParamMoves()) {
+      if (buildStmt(PM, /*useCurrentScope=*/true).failed())
+        return mlir::failure();
+      ParamReplacer.addCopy(cast<DeclStmt>(PM));
+    }
+
+    if (buildStmt(S.getPromiseDeclStmt(), /*useCurrentScope=*/true).failed())
+      return mlir::failure();
+
+    // The frame can be recovered from the address of the promise, which CIR
+    // passes need to know about.
+    mlir::Value Promise = GetAddrOfLocalVar(S.getPromiseDecl()).getPointer();
+    if (auto PromiseAlloca = Promise.getDefiningOp<mlir::cir::AllocaOp>())
+      PromiseAlloca->setAttr(mlir::cir::AllocaOp::getCoroPromiseAttrName(),
+                             builder.getUnitAttr());
+
+    // ReturnValue should be valid as long as the coroutine's return type
+    // is not void. The assertion could help us to reduce the check later.
+    assert(ReturnValue.isValid() == (bool)S.getReturnStmt());
+    // Now we have the promise, initialize the GRO.
+    // We need to emit `get_return_object` first. According to:
+    // [dcl.fct.def.coroutine]p7
+    // The call to get_return_­object is sequenced before the call to
+    // initial_suspend and is invoked at most once.
+    //
+    // The function epilog returns it, so the ReturnStmt of the coroutine body
+    // is not emitted.
+    if (ReturnValue.isValid())
+      buildAnyExprToMem(S.getReturnValue(), ReturnValue,
+                        S.getReturnValue()->getType().getQualifiers(),
+                        /*IsInit*/ true);
+
+    // The promise type's 'unhandled_exception' handler requires a try/catch
+    // around the body and the initial await_resume.
+    if (S.getExceptionHandler())
+      llvm_unreachable("NYI");
+
+    CurCoro.Data->CurrentAwaitKind = mlir::cir::AwaitKind::init;
+    if (buildStmt(S.getInitSuspendStmt(), /*useCurrentScope=*/true).failed())
+      return mlir::failure();
+
+    CurCoro.Data->CurrentAwaitKind = mlir::cir::AwaitKind::user;
+    const auto *Body = dyn_cast<CompoundStmt>(S.getBody());
+    if (Body && !Body->body_empty())
+      CurCoro.Data->FinalCoreturn = dyn_cast<CoreturnStmt>(Body->body_back());
+    if (buildStmt(S.getBody(), /*useCurrentScope=*/false).failed())
+      return mlir::failure();
+
+    // Falling off the body calls return_void, unless it ends in a co_return.
+    if (Stmt *OnFallthrough = S.getFallthroughHandler())
+      if (!CurCoro.Data->FinalCoreturn &&
+          buildStmt(OnFallthrough, /*useCurrentScope=*/true).failed())
+        return mlir::failure();
+
+    // Completing or destroying the coroutine ends here, where the frame goes
+    // away.
+    if (buildCoroutineEnd(*this, loc).failed())
+      return mlir::failure();
+  }
+  return mlir::success();
+}
+
+RValue CIRGenFunction::buildCoroutineIntrinsic(const CallExpr *E,
+                                               unsigned BuiltinID) {
+  switch (BuiltinID) {
+  // The frame builtins refer to the frame of the current coroutine, as given
+  // by its cir.coro.alloc_frame.
+  case Builtin::BI__builtin_coro_frame:
+  case Builtin::BI__builtin_coro_free:
+    if (CurCoro.Data && CurCoro.Data->CoroFrame) {
+      if (BuiltinID == Builtin::BI__builtin_coro_free)
+        buildIgnoredExpr(E->getArg(0));
+      return RValue::get(CurCoro.Data->CoroFrame);
+    }
+    CGM.emitError("this builtin is only supported in the body of a "
+                  "coroutine");
+    return GetUndefRValue(E->getType());
+  case Builtin::BI__builtin_coro_size:
+    if (CurCoro.Data && CurCoro.Data->CoroFrameSize)
+      return RValue::get(CurCoro.Data->CoroFrameSize);
+    CGM.emitError("this builtin is only supported in the allocation of a "
+                  "coroutine frame");
+    return GetUndefRValue(E->getType());
+  // The handle builtins work on the frame of any coroutine, as given by the
+  // std::coroutine_handle they are called on.
+  case Builtin::BI__builtin_coro_resume:
+    builder.create<mlir::cir::CoroResumeOp>(getLoc(E->getExprLoc()),
+                                            buildScalarExpr(E->getArg(0)));
+    return RValue::get(nullptr);
+  case Builtin::BI__builtin_coro_destroy:
+    builder.create<mlir::cir::CoroDestroyOp>(getLoc(E->getExprLoc()),
+                                             buildScalarExpr(E->getArg(0)));
+    return RValue::get(nullptr);
+  case Builtin::BI__builtin_coro_done:
+    return RValue::get(builder.create<mlir::cir::CoroDoneOp>(
+        getLoc(E->getExprLoc()), getCIRType(E->getType()),
+        buildScalarExpr(E->getArg(0))));
+  case Builtin::BI__builtin_coro_promise: {
+    // Sema makes sure the alignment and direction are constants.
+    mlir::Value Ptr = buildScalarExpr(E->getArg(0));
+    uint64_t Alignment =
+        E->getArg(1)->EvaluateKnownConstInt(getContext()).getZExtValue();
+    bool FromPromise =
+        E->getArg(2)->EvaluateKnownConstInt(getContext()).getBoolValue();
+    return RValue::get(builder.create<mlir::cir::CoroPromiseOp>(
+        getLoc(E->getExprLoc()), getCIRType(E->getType()), Ptr,
+        builder.getI64IntegerAttr(Alignment),
+        FromPromise ? builder.getUnitAttr() : mlir::UnitAttr()));
+  }
+  default:
+    llvm_unreachable("not a coroutine builtin handled by CIRGen");
+  }
+}
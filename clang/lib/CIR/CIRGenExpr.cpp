@@ -17,6 +17,7 @@
 #include "UnimplementedFeatureGuarding.h"
 
 #include "clang/AST/GlobalDecl.h"
+#include "clang/Basic/Builtins.h"
 
 #include "mlir/Dialect/CIR/IR/CIRDialect.h"
 #include "mlir/Dialect/Func/IR/FuncOps.h"
@@ -550,8 +551,13 @@ RValue CIRGenFunction::buildAnyExpr(const Expr *E, AggValueSlot aggSlot,
     return RValue::get(buildScalarExpr(E));
   case TEK_Complex:
     assert(0 && "not implemented");
-  case TEK_Aggregate:
-    assert(0 && "not implemented");
+  case TEK_Aggregate: {
+    if (aggSlot.isIgnored())
+      aggSlot = CreateAggTemp(E->getType(), getLoc(E->getSourceRange()),
+                              "agg-temp");
+    buildAggExpr(E, aggSlot);
+    return RValue::getAggregate(aggSlot.getAddress());
+  }
   }
   llvm_unreachable("bad evaluation kind");
 }
@@ -569,6 +575,23 @@ RValue CIRGenFunction::buildCallExpr(const clang::CallExpr *E,
             dyn_cast_or_null<CXXMethodDecl>(CE->getCalleeDecl()))
       return buildCXXOperatorMemberCallExpr(CE, MD, ReturnValue);
 
+  // Only the coroutine builtins used by the C++ library are supported for
+  // now, the ones lowering the coroutine in LLVM are not meant for CIR.
+  if (const auto *FD = E->getDirectCallee()) {
+    switch (unsigned BuiltinID = FD->getBuiltinID()) {
+    case Builtin::BI__builtin_coro_resume:
+    case Builtin::BI__builtin_coro_destroy:
+    case Builtin::BI__builtin_coro_done:
+    case Builtin::BI__builtin_coro_promise:
+    case Builtin::BI__builtin_coro_size:
+    case Builtin::BI__builtin_coro_frame:
+    case Builtin::BI__builtin_coro_free:
+      return buildCoroutineIntrinsic(E, BuiltinID);
+    default:
+      break;
+    }
+  }
+
   CIRGenCallee callee = buildCallee(E->getCallee());
 
   assert(!callee.isBuiltin() && "builtins NYI");
@@ -1407,6 +1430,8 @@ LValue CIRGenFunction::buildLValue(const Expr *E) {
     assert(0 && "should fallback below, remove assert when testcase available");
   case Expr::CXXOperatorCallExprClass:
     return buildCallExprLValue(cast<CallExpr>(E));
+  case Expr::OpaqueValueExprClass:
+    return getOpaqueLValueMapping(cast<OpaqueValueExpr>(E));
   case Expr::ExprWithCleanupsClass: {
     const auto *cleanups = cast<ExprWithCleanups>(E);
     // RunCleanupsScope Scope(*this);
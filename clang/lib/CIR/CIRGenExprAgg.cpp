@@ -78,7 +78,7 @@ public:
 
   // Operators.
   void VisitCastExpr(CastExpr *E);
-  void VisitCallExpr(const CallExpr *E) { llvm_unreachable("NYI"); }
+  void VisitCallExpr(const CallExpr *E);
   void VisitStmtExpr(const StmtExpr *E) { llvm_unreachable("NYI"); }
   void VisitBinaryOperator(const BinaryOperator *E) { llvm_unreachable("NYI"); }
   void VisitPointerToDataMemberBinaryOperator(const BinaryOperator *E) {
@@ -158,6 +158,25 @@ void AggExprEmitter::VisitMaterializeTemporaryExpr(
   Visit(E->getSubExpr());
 }
 
+void AggExprEmitter::VisitCallExpr(const CallExpr *E) {
+  if (E->getCallReturnType(CGF.getContext())->isReferenceType())
+    llvm_unreachable("NYI");
+
+  // A call returning through an sret pointer stores its result straight to
+  // the destination, the result of other calls is copied there.
+  RValue RV = CGF.buildCallExpr(E, ReturnValueSlot(Dest.getAddress()));
+  if (Dest.isIgnored())
+    return;
+
+  Address Src = RV.getAggregateAddress();
+  if (Src.getPointer() == Dest.getAddress().getPointer())
+    return;
+  QualType Ty = E->getType();
+  CGF.buildAggregateCopy(CGF.makeAddrLValue(Dest.getAddress(), Ty),
+                         CGF.makeAddrLValue(Src, Ty), Ty, Dest.mayOverlap(),
+                         Dest.isVolatile());
+}
+
 void AggExprEmitter::VisitCXXConstructExpr(const CXXConstructExpr *E) {
   AggValueSlot Slot = EnsureSlot(E->getType());
   CGF.buildCXXConstructExpr(E, Slot);
@@ -299,7 +318,8 @@ static void CheckAggExprForMemSetUse(AggValueSlot &Slot, const Expr *E,
         return;
     }
 
-  llvm_unreachable("NYI");
+  // TODO(cir): LLVM codegen zeroes large initializers that are mostly zeros
+  // with a memset before storing the non-zero fields, CIR has no memset yet.
 }
 
 void CIRGenFunction::buildAggExpr(const Expr *E, AggValueSlot Slot) {
@@ -317,12 +337,10 @@ void CIRGenFunction::buildAggExpr(const Expr *E, AggValueSlot Slot) {
 void CIRGenFunction::buildAggregateCopy(LValue Dest, LValue Src, QualType Ty,
                                         AggValueSlot::Overlap_t MayOverlap,
                                         bool isVolatile) {
-  // TODO(cir): this function needs improvements, commented code for now since
-  // this will be touched again soon.
   assert(!Ty->isAnyComplexType() && "Shouldn't happen for complex");
 
-  // Address DestPtr = Dest.getAddress();
-  // Address SrcPtr = Src.getAddress();
+  Address DestPtr = Dest.getAddress();
+  Address SrcPtr = Src.getAddress();
 
   if (getLangOpts().CPlusPlus) {
     if (const RecordType *RT = Ty->getAs<RecordType>()) {
@@ -344,34 +362,18 @@ void CIRGenFunction::buildAggregateCopy(LValue Dest, LValue Src, QualType Ty,
     assert(0 && "NYI");
   }
 
-  // Aggregate assignment turns into llvm.memcpy.  This is almost valid per
-  // C99 6.5.16.1p3, which states "If the value being stored in an object is
-  // read from another object that overlaps in anyway the storage of the first
-  // object, then the overlap shall be exact and the two objects shall have
-  // qualified or unqualified versions of a compatible type."
-  //
-  // memcpy is not defined if the source and destination pointers are exactly
-  // equal, but other compilers do this optimization, and almost every memcpy
-  // implementation handles this case safely.  If there is a libc that does not
-  // safely handle this, we can add a target hook.
-
-  // Get data size info for this aggregate. Don't copy the tail padding if this
-  // might be a potentially-overlapping subobject, since the tail padding might
-  // be occupied by a different object. Otherwise, copying it is fine.
-  TypeInfoChars TypeInfo;
-  if (MayOverlap)
-    TypeInfo = getContext().getTypeInfoDataSizeInChars(Ty);
-  else
-    TypeInfo = getContext().getTypeInfoInChars(Ty);
-
-  llvm::Value *SizeVal = nullptr;
-  if (TypeInfo.Width.isZero()) {
-    assert(0 && "NYI");
-  }
-  if (!SizeVal) {
-    assert(0 && "NYI");
-    // SizeVal = llvm::ConstantInt::get(SizeTy, TypeInfo.Width.getQuantity());
-  }
+  // Aggregate assignment turns into a load and a store of the whole object.
+  // This is almost valid per C99 6.5.16.1p3, which states "If the value being
+  // stored in an object is read from another object that overlaps in anyway
+  // the storage of the first object, then the overlap shall be exact and the
+  // two objects shall have qualified or unqualified versions of a compatible
+  // type."
+
+  // Storing the whole object writes its tail padding, which might be occupied
+  // by a different object if this is a potentially-overlapping subobject.
+  if (MayOverlap && getContext().getTypeInfoDataSizeInChars(Ty).Width !=
+                        getContext().getTypeInfoInChars(Ty).Width)
+    llvm_unreachable("NYI");
 
   // FIXME: If we have a volatile struct, the optimizer can remove what might
   // appear to be `extra' memory ops:
@@ -385,10 +387,8 @@ void CIRGenFunction::buildAggregateCopy(LValue Dest, LValue Src, QualType Ty,
   //
   // we need to use a different call here.  We use isVolatile to indicate when
   // either the source or the destination is volatile.
-
-  assert(0 && "NYI");
-  // DestPtr = Builder.CreateElementBitCast(DestPtr, Int8Ty);
-  // SrcPtr = Builder.CreateElementBitCast(SrcPtr, Int8Ty);
+  if (isVolatile)
+    llvm_unreachable("NYI");
 
   // Don't do any of the memmove_collectable tests if GC isn't set.
   if (CGM.getLangOpts().getGC() == LangOptions::NonGC) {
@@ -399,11 +399,13 @@ void CIRGenFunction::buildAggregateCopy(LValue Dest, LValue Src, QualType Ty,
     assert(0 && "NYI");
   }
 
-  assert(0 && "NYI");
-  // auto Inst = Builder.CreateMemCpy(DestPtr, SrcPtr, SizeVal, isVolatile);
+  auto Loc = DestPtr.getPointer().getLoc();
+  auto Val = builder.create<mlir::cir::LoadOp>(Loc, SrcPtr.getElementType(),
+                                               SrcPtr.getPointer());
+  builder.create<mlir::cir::StoreOp>(Loc, Val, DestPtr.getPointer());
 
   // Determine the metadata to describe the position of any padding in this
-  // memcpy, as well as the TBAA tags for the members of the struct, in case
+  // copy, as well as the TBAA tags for the members of the struct, in case
   // the optimizer wishes to expand it in to scalar memory operations.
   assert(!UnimplementedFeature::tbaa());
   if (CGM.getCodeGenOpts().NewStructPathTBAA) {
@@ -76,8 +76,12 @@ public:
   mlir::Value VisitGenericSelectionExpr(GenericSelectionExpr *GE) {
     llvm_unreachable("NYI");
   }
-  mlir::Value VisitCoawaitExpr(CoawaitExpr *S) { llvm_unreachable("NYI"); }
-  mlir::Value VisitCoyieldExpr(CoyieldExpr *S) { llvm_unreachable("NYI"); }
+  mlir::Value VisitCoawaitExpr(CoawaitExpr *S) {
+    return CGF.buildCoawaitExpr(*S).getScalarVal();
+  }
+  mlir::Value VisitCoyieldExpr(CoyieldExpr *S) {
+    return CGF.buildCoyieldExpr(*S).getScalarVal();
+  }
   mlir::Value VisitUnaryCoawait(const UnaryOperator *E) {
     llvm_unreachable("NYI");
   }
@@ -131,7 +135,13 @@ public:
     llvm_unreachable("NYI");
   }
   mlir::Value VisitOpaqueValueExpr(OpaqueValueExpr *E) {
-    llvm_unreachable("NYI");
+    if (E->isGLValue())
+      return CGF
+          .buildLoadOfLValue(CGF.getOpaqueLValueMapping(E), E->getExprLoc())
+          .getScalarVal();
+
+    // Otherwise, assume the mapping is the scalar directly.
+    return CGF.getOpaqueRValueMapping(E).getScalarVal();
   }
 
   /// Emits the address of the l-value, then loads and returns the result.
@@ -276,7 +286,9 @@ public:
   }
 
   mlir::Value VisitExprWithCleanups(ExprWithCleanups *E) {
-    llvm_unreachable("NYI");
+    if (UnimplementedFeature::cleanups())
+      llvm_unreachable("NYI");
+    return Visit(E->getSubExpr());
   }
   mlir::Value VisitCXXNewExpr(const CXXNewExpr *E) {
     return CGF.buildCXXNewExpr(E);
@@ -765,8 +777,19 @@ mlir::Value ScalarExprEmitter::VisitCastExpr(CastExpr *CE) {
     llvm_unreachable("NYI");
   case CK_AnyPointerToBlockPointerCast:
     llvm_unreachable("NYI");
-  case CK_BitCast:
-    llvm_unreachable("NYI");
+  case CK_BitCast: {
+    // Pointer conversions, like the ones to and from void *, are the only
+    // scalar bitcasts CIR knows about.
+    auto Src = Visit(const_cast<Expr *>(E));
+    auto DstTy = CGF.getCIRType(DestTy);
+    assert(Src.getType().isa<mlir::cir::PointerType>() &&
+           DstTy.isa<mlir::cir::PointerType>() && "NYI");
+    if (Src.getType() == DstTy)
+      return Src;
+    return Builder.create<mlir::cir::CastOp>(CGF.getLoc(CE->getExprLoc()),
+                                             DstTy,
+                                             mlir::cir::CastKind::bitcast, Src);
+  }
   case CK_AddressSpaceConversion:
     llvm_unreachable("NYI");
   case CK_AtomicToNonAtomic:
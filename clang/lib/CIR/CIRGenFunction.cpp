@@ -225,9 +225,13 @@ void CIRGenFunction::buildAndUpdateRetAlloca(QualType ty, mlir::Location loc,
     if (!endsWithReturn(CurFuncDecl))
       ++NumReturnExprs;
   } else if (CurFnInfo->getReturnInfo().getKind() == ABIArgInfo::Indirect) {
-    // TODO(CIR): Consider this implementation in CIRtoLLVM
-    llvm_unreachable("NYI");
-    // TODO(CIR): Consider this implementation in CIRtoLLVM
+    // Indirect return; emit returned value directly into sret slot.
+    // This reduces code size, and affects correctness in C++.
+    // TODO(CIR): the sret argument is always first until 'this' can be
+    // swapped with it.
+    auto sret = CurFn.getArgument(0);
+    FnRetAlloca = sret;
+    ReturnValue = Address(sret, CurFnInfo->getReturnInfo().getIndirectAlign());
   } else if (CurFnInfo->getReturnInfo().getKind() == ABIArgInfo::InAlloca) {
     llvm_unreachable("NYI");
   } else {
@@ -267,15 +271,6 @@ void CIRGenFunction::LexicalScopeGuard::cleanup() {
   auto &builder = CGF.builder;
   auto *localScope = CGF.currLexScope;
 
-  auto buildReturn = [&](mlir::Location loc) {
-    if (CGF.FnRetCIRTy.hasValue()) {
-      // If there's anything to return, load it first.
-      auto val = builder.create<LoadOp>(loc, *CGF.FnRetCIRTy, *CGF.FnRetAlloca);
-      return builder.create<ReturnOp>(loc, llvm::makeArrayRef(val.result()));
-    }
-    return builder.create<ReturnOp>(loc);
-  };
-
   // Handle pending gotos and the solved labels in this scope.
   while (!localScope->PendingGotos.empty()) {
     auto gotoInfo = localScope->PendingGotos.back();
@@ -303,7 +298,7 @@ void CIRGenFunction::LexicalScopeGuard::cleanup() {
 
     // TODO(cir): insert actual scope cleanup HERE (dtors and etc)
 
-    (void)buildReturn(retLoc);
+    (void)CGF.buildFunctionEpilog(retLoc);
   }
 
   auto insertCleanupAndLeave = [&](mlir::Block *InsPt) {
@@ -313,7 +308,7 @@ void CIRGenFunction::LexicalScopeGuard::cleanup() {
     if (localScope->Depth != 0) // end of any local scope != function
       builder.create<YieldOp>(localScope->EndLoc);
     else
-      (void)buildReturn(localScope->EndLoc);
+      (void)CGF.buildFunctionEpilog(localScope->EndLoc);
   };
 
   // If a cleanup block has been created at some point, branch to it
@@ -415,9 +410,8 @@ CIRGenFunction::generateCode(clang::GlobalDecl GD, mlir::cir::FuncOp Fn,
   Stmt *Body = FD->getBody();
 
   if (Body) {
-    // Coroutines always emit lifetime markers
-    if (isa<CoroutineBodyStmt>(Body))
-      llvm_unreachable("Coroutines NYI");
+    // Coroutines always emit lifetime markers. In CIR, lifetimes are carried
+    // by the enclosing scopes, nothing to do here.
 
     // Initialize helper which will detect jumps which can cause invalid
     // lifetime markers.
@@ -444,9 +438,8 @@ CIRGenFunction::generateCode(clang::GlobalDecl GD, mlir::cir::FuncOp Fn,
 
     // Initialize lexical scope information.
 
-    // Save parameters for coroutine function.
-    if (Body && isa_and_nonnull<CoroutineBodyStmt>(Body))
-      llvm_unreachable("Coroutines NYI");
+    // Parameters of coroutine functions are copied into the frame by
+    // buildCoroutineBody.
 
     // Generate the body of the function.
     // TODO: PGO.assignRegionCounters
@@ -556,7 +549,17 @@ void CIRGenFunction::buildCXXConstructorCall(const clang::CXXConstructorDecl *D,
 
   Args.add(RValue::get(ThisPtr), D->getThisType());
 
-  assert(!isMemcpyEquivalentSpecialMember(D) && "NYI");
+  // If this is a trivial constructor, copy the object now before we lose the
+  // alignment information on the argument.
+  if (isMemcpyEquivalentSpecialMember(D)) {
+    const Expr *Arg = E->getArg(0);
+    LValue Src = buildLValue(Arg);
+    QualType DestTy = getContext().getTypeDeclType(D->getParent());
+    LValue Dest = makeAddrLValue(This, DestTy);
+    buildAggregateCopy(Dest, Src, DestTy, ThisAVS.mayOverlap(),
+                       Dest.isVolatile() || Src.isVolatile());
+    return;
+  }
 
   const FunctionProtoType *FPT = D->getType()->castAs<FunctionProtoType>();
   EvaluationOrder Order = E->isListInitialization()
@@ -583,9 +586,20 @@ void CIRGenFunction::buildCXXConstructorCall(
     buildTypeCheck(CIRGenFunction::TCK_ConstructorCall, Loc, This.getPointer(),
                    getContext().getRecordType(ClassDecl), CharUnits::Zero());
 
-  assert(!D->isTrivial() && "Trivial ctor decl NYI");
+  if (isMemcpyEquivalentSpecialMember(D)) {
+    assert(Args.size() == 2 && "unexpected argcount for trivial ctor");
+    QualType SrcTy = D->getParamDecl(0)->getType().getNonReferenceType();
+    Address Src(Args[1].getKnownRValue().getScalarVal(),
+                CGM.getNaturalTypeAlignment(SrcTy));
+    LValue SrcLVal = makeAddrLValue(Src, SrcTy);
+    QualType DestTy = getContext().getTypeDeclType(ClassDecl);
+    LValue DestLVal = makeAddrLValue(This, DestTy);
+    buildAggregateCopy(DestLVal, SrcLVal, DestTy, Overlap,
+                       DestLVal.isVolatile() || SrcLVal.isVolatile());
+    return;
+  }
 
-  assert(!isMemcpyEquivalentSpecialMember(D) && "NYI");
+  assert(!D->isTrivial() && "Trivial ctor decl NYI");
 
   bool PassPrototypeArgs = true;
 
@@ -849,36 +863,16 @@ void CIRGenFunction::StartFunction(GlobalDecl GD, QualType RetTy,
   if (getLangOpts().OpenMP && CurCodeDecl)
     llvm_unreachable("NYI");
 
-  // TODO: buildFunctionProlog
-
   {
     // Set the insertion point in the builder to the beginning of the
     // function body, it will be used throughout the codegen to create
     // operations in this function.
     builder.setInsertionPointToStart(EntryBB);
 
-    // TODO: this should live in `buildFunctionProlog
     // Declare all the function arguments in the symbol table.
-    for (const auto nameValue : llvm::zip(Args, EntryBB->getArguments())) {
-      auto *paramVar = std::get<0>(nameValue);
-      auto paramVal = std::get<1>(nameValue);
-      auto alignment = getContext().getDeclAlign(paramVar);
-      auto paramLoc = getLoc(paramVar->getSourceRange());
-      paramVal.setLoc(paramLoc);
-
-      mlir::Value addr;
-      if (failed(declare(paramVar, paramVar->getType(), paramLoc, alignment,
-                         addr, true /*param*/)))
-        return;
-
-      auto address = Address(addr, alignment);
-      setAddrOfLocalVar(paramVar, address);
-
-      // Location of the store to the param storage tracked as beginning of
-      // the function body.
-      auto fnBodyBegin = getLoc(FD->getBody()->getBeginLoc());
-      builder.create<mlir::cir::StoreOp>(fnBodyBegin, paramVal, addr);
-    }
+    if (failed(buildFunctionProlog(*CurFnInfo, Fn, Args,
+                                   getLoc(FD->getBody()->getBeginLoc()))))
+      return;
     assert(builder.getInsertionBlock() && "Should be valid");
 
     auto FnEndLoc = getLoc(FD->getBody()->getEndLoc());
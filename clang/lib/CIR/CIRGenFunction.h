@@ -44,6 +44,8 @@ class ScalarExprEmitter;
 
 namespace cir {
 
+struct CGCoroData;
+
 // FIXME: for now we are reusing this from lib/Clang/CodeGenFunction.h, which
 // isn't available in the include dir. Same for getEvaluationKind below.
 enum TypeEvaluationKind { TEK_Scalar, TEK_Complex, TEK_Aggregate };
@@ -365,6 +367,11 @@ public:
   /// delcs.
   DeclMapTy LocalDeclMap;
 
+  /// OpaqueLValues/OpaqueRValues - Keeps track of the current set of opaque
+  /// value expressions, see getOpaqueLValueMapping/getOpaqueRValueMapping.
+  llvm::DenseMap<const clang::OpaqueValueExpr *, LValue> OpaqueLValues;
+  llvm::DenseMap<const clang::OpaqueValueExpr *, RValue> OpaqueRValues;
+
   /// DidCallStackSave - Whether llvm.stacksave has been called. Used to avoid
   /// calling llvm.stacksave for multiple VLAs in the same scope.
   /// TODO: Translate to MLIR
@@ -411,6 +418,41 @@ public:
   // as soon as we add a DebugInfo type to this class.
   std::nullptr_t *getDebugInfo() { return nullptr; }
 
+  /// -------
+  /// Coroutines
+  /// -------
+
+  struct CGCoroInfo {
+    std::unique_ptr<CGCoroData> Data;
+    CGCoroInfo();
+    ~CGCoroInfo();
+  };
+  CGCoroInfo CurCoro;
+
+  bool isCoroutine() const { return CurCoro.Data != nullptr; }
+
+  mlir::LogicalResult buildCoroutineBody(const clang::CoroutineBodyStmt &S);
+  mlir::LogicalResult buildCoreturnStmt(const clang::CoreturnStmt &S);
+  RValue buildCoawaitExpr(const clang::CoawaitExpr &E,
+                          bool ignoreResult = false);
+  RValue buildCoyieldExpr(const clang::CoyieldExpr &E,
+                          bool ignoreResult = false);
+  RValue buildCoroutineIntrinsic(const clang::CallExpr *E,
+                                 unsigned BuiltinID);
+
+  /// Get the l-value / r-value bound to an OpaqueValueExpr, e.g. the operand
+  /// of a co_await while building the awaiter calls.
+  LValue getOpaqueLValueMapping(const clang::OpaqueValueExpr *E) {
+    auto it = OpaqueLValues.find(E);
+    assert(it != OpaqueLValues.end() && "no mapping for opaque value!");
+    return it->second;
+  }
+  RValue getOpaqueRValueMapping(const clang::OpaqueValueExpr *E) {
+    auto it = OpaqueRValues.find(E);
+    assert(it != OpaqueRValues.end() && "no mapping for opaque value!");
+    return it->second;
+  }
+
   /// Set the address of a local variable.
   void setAddrOfLocalVar(const clang::VarDecl *VD, Address Addr) {
     assert(!LocalDeclMap.count(VD) && "Decl already exists in LocalDeclMap!");
@@ -558,6 +600,17 @@ public:
   RValue buildCallExpr(const clang::CallExpr *E,
                        ReturnValueSlot ReturnValue = ReturnValueSlot());
 
+  /// Emit the code that moves the incoming arguments of \p Fn, as lowered by
+  /// the ABI, into the storage of the parameters in \p Args.
+  mlir::LogicalResult buildFunctionProlog(const CIRGenFunctionInfo &FI,
+                                          mlir::cir::FuncOp Fn,
+                                          const FunctionArgList &Args,
+                                          mlir::Location FnBodyBegin);
+
+  /// Emit the return of the current function, loading the return value in
+  /// the form the ABI expects.
+  mlir::cir::ReturnOp buildFunctionEpilog(mlir::Location Loc);
+
   void buildCallArg(CallArgList &args, const clang::Expr *E,
                     clang::QualType ArgType);
 
@@ -587,6 +640,7 @@ public:
                                       bool useCurrentScope);
 
   mlir::LogicalResult buildForStmt(const clang::ForStmt &S);
+  mlir::LogicalResult buildCXXForRangeStmt(const clang::CXXForRangeStmt &S);
   mlir::LogicalResult buildWhileStmt(const clang::WhileStmt &S);
   mlir::LogicalResult buildDoStmt(const clang::DoStmt &S);
   mlir::LogicalResult buildSwitchStmt(const clang::SwitchStmt &S);
@@ -1029,6 +1083,15 @@ public:
   Address CreateMemTemp(QualType T, CharUnits Align, mlir::Location Loc,
                         const Twine &Name = "tmp", Address *Alloca = nullptr);
 
+  /// Create a temporary memory object for the given aggregate type.
+  AggValueSlot CreateAggTemp(clang::QualType T, mlir::Location Loc,
+                             const Twine &Name = "tmp") {
+    return AggValueSlot::forAddr(
+        CreateMemTemp(T, Loc, Name), T.getQualifiers(),
+        AggValueSlot::IsNotDestructed, AggValueSlot::DoesNotNeedGCBarriers,
+        AggValueSlot::IsNotAliased, AggValueSlot::DoesNotOverlap);
+  }
+
   /// Create a temporary memory object of the given type, with
   /// appropriate alignment without casting it to the default address space.
   Address CreateMemTempWithoutCast(QualType T, mlir::Location Loc,
@@ -16,6 +16,7 @@
 #define LLVM_CLANG_CIR_CIRGENFUNCTIONINFO_H
 
 #include "clang/AST/CanonicalType.h"
+#include "clang/AST/CharUnits.h"
 
 #include "llvm/ADT/FoldingSet.h"
 #include "llvm/Support/TrailingObjects.h"
@@ -101,8 +102,10 @@ private:
     unsigned AllocaFieldIndex;     // isInAlloca()
   };
   Kind TheKind;
-  bool CanBeFlattened : 1; // isDirect()
-  bool SignExt : 1;        // isExtend()
+  bool IndirectByVal : 1;   // isIndirect()
+  bool IndirectRealign : 1; // isIndirect()
+  bool CanBeFlattened : 1;  // isDirect()
+  bool SignExt : 1;         // isExtend()
 
   bool canHavePaddingType() const {
     return isDirect() || isExtend() || isIndirect() || isIndirectAliased() ||
@@ -117,7 +120,7 @@ private:
 public:
   ABIArgInfo(Kind K = Direct)
       : TypeData(nullptr), PaddingType(nullptr), DirectAttr{0, 0}, TheKind(K),
-        CanBeFlattened(false) {}
+        IndirectByVal(false), IndirectRealign(false), CanBeFlattened(false) {}
 
   static ABIArgInfo getDirect(mlir::Type T = nullptr, unsigned Offset = 0,
                               mlir::Type Padding = nullptr,
@@ -164,6 +167,17 @@ public:
 
   static ABIArgInfo getIgnore() { return ABIArgInfo(Ignore); }
 
+  static ABIArgInfo getIndirect(clang::CharUnits Alignment, bool ByVal = true,
+                                bool Realign = false,
+                                mlir::Type Padding = nullptr) {
+    auto AI = ABIArgInfo(Indirect);
+    AI.setIndirectAlign(Alignment);
+    AI.setIndirectByVal(ByVal);
+    AI.setIndirectRealign(Realign);
+    AI.setPaddingType(Padding);
+    return AI;
+  }
+
   Kind getKind() const { return TheKind; }
   bool isDirect() const { return TheKind == Direct; }
   bool isInAlloca() const { return TheKind == InAlloca; }
@@ -188,21 +202,67 @@ public:
     DirectAttr.Offset = Offset;
   }
 
+  unsigned getDirectAlign() const {
+    assert((isDirect() || isExtend()) && "Not a direct or extend kind");
+    return DirectAttr.Align;
+  }
+
   void setDirectAlign(unsigned Align) {
     assert((isDirect() || isExtend()) && "Not a direct or extend kind");
     DirectAttr.Align = Align;
   }
 
+  bool isSignExt() const {
+    assert(isExtend() && "Invalid kind!");
+    return SignExt;
+  }
+
   void setSignExt(bool SExt) {
     assert(isExtend() && "Invalid kind!");
     SignExt = SExt;
   }
 
+  bool getCanBeFlattened() const {
+    assert(isDirect() && "Invalid kind!");
+    return CanBeFlattened;
+  }
+
   void setCanBeFlattened(bool Flatten) {
     assert(isDirect() && "Invalid kind!");
     CanBeFlattened = Flatten;
   }
 
+  // Indirect accessors
+  clang::CharUnits getIndirectAlign() const {
+    assert((isIndirect() || isIndirectAliased()) && "Invalid kind!");
+    return clang::CharUnits::fromQuantity(IndirectAttr.Align);
+  }
+
+  void setIndirectAlign(clang::CharUnits IA) {
+    assert((isIndirect() || isIndirectAliased()) && "Invalid kind!");
+    IndirectAttr.Align = IA.getQuantity();
+  }
+
+  bool getIndirectByVal() const {
+    assert(isIndirect() && "Invalid kind!");
+    return IndirectByVal;
+  }
+
+  void setIndirectByVal(bool IBV) {
+    assert(isIndirect() && "Invalid kind!");
+    IndirectByVal = IBV;
+  }
+
+  bool getIndirectRealign() const {
+    assert((isIndirect() || isIndirectAliased()) && "Invalid kind!");
+    return IndirectRealign;
+  }
+
+  void setIndirectRealign(bool IR) {
+    assert((isIndirect() || isIndirectAliased()) && "Invalid kind!");
+    IndirectRealign = IR;
+  }
+
   mlir::Type getPaddingType() const {
     return (canHavePaddingType() ? PaddingType : nullptr);
   }
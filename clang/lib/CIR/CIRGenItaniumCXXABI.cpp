@@ -215,7 +215,15 @@ CIRGenCXXABI *cir::CreateCIRGenItaniumCXXABI(CIRGenModule &CGM) {
 
 bool CIRGenItaniumCXXABI::classifyReturnType(CIRGenFunctionInfo &FI) const {
   auto *RD = FI.getReturnType()->getAsCXXRecordDecl();
-  assert(!RD && "RecordDecl return types NYI");
+  if (!RD)
+    return false;
+
+  // If C++ prohibits us from making a copy, return by address.
+  if (!RD->canPassInRegisters()) {
+    auto Align = CGM.getASTContext().getTypeAlignInChars(FI.getReturnType());
+    FI.getReturnInfo() = ABIArgInfo::getIndirect(Align, /*ByVal=*/false);
+    return true;
+  }
   return false;
 }
 
@@ -1464,6 +1464,37 @@ mlir::cir::FuncOp CIRGenModule::createCIRFunction(mlir::Location loc,
   return f;
 }
 
+void CIRGenModule::setFunctionAttributes(const FunctionDecl *FD,
+                                         mlir::cir::FuncOp F) {
+  auto *ctx = builder.getContext();
+
+  // Without exceptions, or when the function promises so, calls cannot
+  // unwind.
+  const auto *FPT = FD->getType()->getAs<FunctionProtoType>();
+  bool NoThrow = !getLangOpts().Exceptions || FD->hasAttr<NoThrowAttr>() ||
+                 (FPT && FPT->isNothrow());
+
+  // 'const' and 'pure' functions are not allowed to throw.
+  if (FD->hasAttr<ConstAttr>()) {
+    F.memory_effectsAttr(mlir::cir::FuncMemoryEffectsAttr::get(
+        ctx, mlir::cir::FuncMemoryEffects::none));
+    NoThrow = true;
+  } else if (FD->hasAttr<PureAttr>()) {
+    F.memory_effectsAttr(mlir::cir::FuncMemoryEffectsAttr::get(
+        ctx, mlir::cir::FuncMemoryEffects::read));
+    NoThrow = true;
+  }
+  if (NoThrow)
+    F.nothrowAttr(mlir::UnitAttr::get(ctx));
+
+  if (F.getNumResults() == 1 &&
+      (FD->hasAttr<RestrictAttr>() ||
+       (getCodeGenOpts().AssumeSaneOperatorNew &&
+        FD->isReplaceableGlobalAllocationFunction())))
+    F.setResultAttr(0, mlir::cir::FuncOp::getNoAliasResultAttrName(),
+                    mlir::UnitAttr::get(ctx));
+}
+
 /// If the specified mangled name is not in the module,
 /// create and return a CIR Function with the specified type. If there is
 /// something in the module with the specified name, return it potentially
@@ -1559,8 +1590,14 @@ mlir::cir::FuncOp CIRGenModule::GetOrCreateCIRFunction(
   // sense for MLIR
   // assert(F->getName().getStringRef() == MangledName && "name was uniqued!");
 
-  if (D)
-    ; // TODO: set function attributes from the declaration
+  if (D) {
+    setFunctionAttributes(FD, F);
+    const CIRGenFunctionInfo &FI =
+        isa<CXXConstructorDecl, CXXDestructorDecl>(FD)
+            ? getTypes().arrangeCXXStructorDeclaration(GD)
+            : getTypes().arrangeGlobalDeclaration(GD);
+    constructAttributeList(FI, F);
+  }
 
   // TODO: set function attributes from the missing attributes param
 
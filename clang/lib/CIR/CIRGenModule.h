@@ -382,6 +382,16 @@ private:
   mlir::cir::FuncOp createCIRFunction(mlir::Location loc, StringRef name,
                                       mlir::FunctionType Ty);
 
+  /// Set the effect attributes of \p F that follow from the declaration of
+  /// \p FD (exception specification, const, pure and malloc attributes).
+  void setFunctionAttributes(const clang::FunctionDecl *FD,
+                             mlir::cir::FuncOp F);
+
+  /// Set the attributes of the arguments of \p F the ABI passes in memory:
+  /// the sret argument and the indirect arguments described by \p FI.
+  void constructAttributeList(const CIRGenFunctionInfo &FI,
+                              mlir::cir::FuncOp F);
+
   // An ordered map of canonical GlobalDecls to their mangled names.
   llvm::MapVector<clang::GlobalDecl, llvm::StringRef> MangledDeclNames;
   llvm::StringMap<clang::GlobalDecl, llvm::BumpPtrAllocator> Manglings;
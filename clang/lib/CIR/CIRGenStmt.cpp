@@ -128,6 +128,10 @@ mlir::LogicalResult CIRGenFunction::buildStmt(const Stmt *S,
     if (buildForStmt(cast<ForStmt>(*S)).failed())
       return mlir::failure();
     break;
+  case Stmt::CXXForRangeStmtClass:
+    if (buildCXXForRangeStmt(cast<CXXForRangeStmt>(*S)).failed())
+      return mlir::failure();
+    break;
   case Stmt::WhileStmtClass:
     if (buildWhileStmt(cast<WhileStmt>(*S)).failed())
       return mlir::failure();
@@ -137,13 +141,16 @@ mlir::LogicalResult CIRGenFunction::buildStmt(const Stmt *S,
       return mlir::failure();
     break;
 
+  case Stmt::CoroutineBodyStmtClass:
+    return buildCoroutineBody(cast<CoroutineBodyStmt>(*S));
+  case Stmt::CoreturnStmtClass:
+    return buildCoreturnStmt(cast<CoreturnStmt>(*S));
+
   case Stmt::IndirectGotoStmtClass:
   case Stmt::ReturnStmtClass:
   // When implemented, GCCAsmStmtClass should fall-through to MSAsmStmtClass.
   case Stmt::GCCAsmStmtClass:
   case Stmt::MSAsmStmtClass:
-  case Stmt::CoroutineBodyStmtClass:
-  case Stmt::CoreturnStmtClass:
   case Stmt::CapturedStmtClass:
   case Stmt::ObjCAtTryStmtClass:
   case Stmt::ObjCAtThrowStmtClass:
@@ -151,7 +158,6 @@ mlir::LogicalResult CIRGenFunction::buildStmt(const Stmt *S,
   case Stmt::ObjCForCollectionStmtClass:
   case Stmt::ObjCAutoreleasePoolStmtClass:
   case Stmt::CXXTryStmtClass:
-  case Stmt::CXXForRangeStmtClass:
   case Stmt::SEHTryStmtClass:
   case Stmt::OMPMetaDirectiveClass:
   case Stmt::OMPCanonicalLoopClass:
@@ -442,9 +448,18 @@ mlir::LogicalResult CIRGenFunction::buildReturnStmt(const ReturnStmt &S) {
       builder.create<mlir::cir::StoreOp>(loc, V, *FnRetAlloca);
       break;
     case TEK_Complex:
-    case TEK_Aggregate:
       llvm::errs() << "ReturnStmt EvaluationKind not implemented\n";
       return mlir::failure();
+    case TEK_Aggregate:
+      // The return value slot is a complete object, which nothing else
+      // overlaps.
+      buildAggExpr(RV,
+                   AggValueSlot::forAddr(ReturnValue, Qualifiers(),
+                                         AggValueSlot::IsDestructed,
+                                         AggValueSlot::DoesNotNeedGCBarriers,
+                                         AggValueSlot::IsNotAliased,
+                                         AggValueSlot::DoesNotOverlap));
+      break;
     }
   }
 
@@ -611,6 +626,71 @@ static mlir::LogicalResult buildLoopCondYield(mlir::OpBuilder &builder,
   return mlir::success();
 }
 
+mlir::LogicalResult
+CIRGenFunction::buildCXXForRangeStmt(const CXXForRangeStmt &S) {
+  mlir::cir::LoopOp loopOp;
+
+  // TODO: pass in array of attributes.
+  auto forStmtBuilder = [&]() -> mlir::LogicalResult {
+    auto loopRes = mlir::success();
+    // Evaluate the first pieces before the loop.
+    if (S.getInit())
+      if (buildStmt(S.getInit(), /*useCurrentScope=*/true).failed())
+        return mlir::failure();
+    if (buildStmt(S.getRangeStmt(), /*useCurrentScope=*/true).failed())
+      return mlir::failure();
+    if (buildStmt(S.getBeginStmt(), /*useCurrentScope=*/true).failed())
+      return mlir::failure();
+    if (buildStmt(S.getEndStmt(), /*useCurrentScope=*/true).failed())
+      return mlir::failure();
+
+    loopOp = builder.create<LoopOp>(
+        getLoc(S.getSourceRange()), mlir::cir::LoopOpKind::For,
+        /*condBuilder=*/
+        [&](mlir::OpBuilder &b, mlir::Location loc) {
+          // TODO: branch weigths, likelyhood, profile counter, etc.
+          mlir::Value condVal = evaluateExprAsBool(S.getCond());
+          if (buildLoopCondYield(b, loc, condVal).failed())
+            loopRes = mlir::failure();
+        },
+        /*bodyBuilder=*/
+        [&](mlir::OpBuilder &b, mlir::Location loc) {
+          // The loop variable and the body share the same scope.
+          if (buildStmt(S.getLoopVarStmt(), /*useCurrentScope=*/true)
+                  .failed() ||
+              buildStmt(S.getBody(), /*useCurrentScope=*/true).failed())
+            loopRes = mlir::failure();
+        },
+        /*stepBuilder=*/
+        [&](mlir::OpBuilder &b, mlir::Location loc) {
+          if (buildStmt(S.getInc(), /*useCurrentScope=*/true).failed())
+            loopRes = mlir::failure();
+          builder.create<YieldOp>(loc);
+        });
+    return loopRes;
+  };
+
+  auto res = mlir::success();
+  auto scopeLoc = getLoc(S.getSourceRange());
+  builder.create<mlir::cir::ScopeOp>(
+      scopeLoc, mlir::TypeRange(), /*scopeBuilder=*/
+      [&](mlir::OpBuilder &b, mlir::Location loc) {
+        auto fusedLoc = loc.cast<mlir::FusedLoc>();
+        auto scopeLocBegin = fusedLoc.getLocations()[0];
+        auto scopeLocEnd = fusedLoc.getLocations()[1];
+        LexicalScopeContext lexScope{scopeLocBegin, scopeLocEnd,
+                                     builder.getInsertionBlock()};
+        LexicalScopeGuard lexForScopeGuard{*this, &lexScope};
+        res = forStmtBuilder();
+      });
+
+  if (res.failed())
+    return res;
+
+  terminateBody(builder, loopOp.body(), getLoc(S.getEndLoc()));
+  return mlir::success();
+}
+
 mlir::LogicalResult CIRGenFunction::buildForStmt(const ForStmt &S) {
   mlir::cir::LoopOp loopOp;
 
@@ -16,9 +16,19 @@
 #include "clang/AST/GlobalDecl.h"
 #include "clang/AST/RecordLayout.h"
 
+#include "llvm/ADT/Statistic.h"
+
 using namespace clang;
 using namespace cir;
 
+#define DEBUG_TYPE "cir-types"
+
+STATISTIC(NumTypeCacheHits, "Number of type conversions found in the cache");
+STATISTIC(NumTypeCacheMisses, "Number of type conversions not in the cache");
+STATISTIC(NumTypeCacheInvalidations,
+          "Number of cached type conversions invalidated by a completed "
+          "record");
+
 unsigned CIRGenTypes::ClangCallConvToCIRCallConv(clang::CallingConv CC) {
   assert(CC == CC_C && "No other calling conventions implemented.");
   return cir::CallingConv::C;
@@ -127,9 +137,7 @@ mlir::Type CIRGenTypes::convertRecordDeclType(const clang::RecordDecl *RD) {
 
   // If this struct blocked a FunctionType conversion, then recompute whatever
   // was derived from that.
-  // FIXME: This is hugely overconservative.
-  if (SkippedLayout)
-    TypeCache.clear();
+  invalidateTypeCache(key);
 
   // If we're done converting the outer-most record, then convert any deferred
   // structs as well.
@@ -140,6 +148,51 @@ mlir::Type CIRGenTypes::convertRecordDeclType(const clang::RecordDecl *RD) {
   return entry;
 }
 
+void CIRGenTypes::addTypeCacheDependency(const clang::Type *Record,
+                                         const clang::Type *Ty) {
+  if (TypeCacheDependents[Record].insert(Ty))
+    TypeCacheDependencies[Ty].insert(Record);
+}
+
+void CIRGenTypes::addTypeCacheDependency(const clang::Type *Record) {
+  SkippedLayout = true;
+  for (const clang::Type *Ty : TypesBeingConverted)
+    addTypeCacheDependency(Record, Ty);
+}
+
+void CIRGenTypes::addCachedTypeDependency(const clang::Type *Ty) {
+  // The types built from a cached placeholder-derived type are as stale as
+  // the type itself, e.g. `void (**)(struct S)` once `void (*)(struct S)` was
+  // converted while laying out S.
+  auto I = TypeCacheDependencies.find(Ty);
+  if (I == TypeCacheDependencies.end())
+    return;
+  // Adding dependencies may grow the map.
+  llvm::SmallVector<const clang::Type *, 2> Records(I->second.begin(),
+                                                    I->second.end());
+  for (const clang::Type *Record : Records)
+    for (const clang::Type *Dependent : TypesBeingConverted)
+      addTypeCacheDependency(Record, Dependent);
+}
+
+void CIRGenTypes::invalidateTypeCache(const clang::Type *Record) {
+  auto I = TypeCacheDependents.find(Record);
+  if (I == TypeCacheDependents.end())
+    return;
+
+  // Types still being converted are cached once done, and derive from the
+  // completed record by then.
+  for (const clang::Type *Ty : I->second) {
+    NumTypeCacheInvalidations += TypeCache.erase(Ty);
+    auto J = TypeCacheDependencies.find(Ty);
+    J->second.erase(Record);
+    if (J->second.empty())
+      TypeCacheDependencies.erase(J);
+  }
+  TypeCacheDependents.erase(I);
+  SkippedLayout = !TypeCacheDependents.empty();
+}
+
 mlir::Type CIRGenTypes::convertTypeForMem(clang::QualType qualType,
                                           bool forBitField) {
   assert(!qualType->isConstantMatrixType() && "Matrix types NYI");
@@ -163,7 +216,21 @@ mlir::Type CIRGenTypes::ConvertFunctionTypeInternal(QualType QFT) {
   // First, check whether we can build the full fucntion type. If the function
   // type depends on an incomplete type (e.g. a struct or enum), we cannot lower
   // the function type.
-  assert(isFuncTypeConvertible(FT) && "NYI");
+  if (!isFuncTypeConvertible(FT)) {
+    // Remember which records blocked the conversion, so the types derived
+    // from the placeholder are converted again once they are laid out.
+    auto NoteRecord = [&](QualType T) {
+      if (const auto *RT = T->getAs<RecordType>())
+        addTypeCacheDependency(RT);
+    };
+    NoteRecord(FT->getReturnType());
+    if (const auto *FPT = dyn_cast<FunctionProtoType>(FT))
+      for (QualType ParamTy : FPT->param_types())
+        NoteRecord(ParamTy);
+
+    // Return a placeholder type.
+    return mlir::cir::StructType::get(&getMLIRContext(), {}, "");
+  }
 
   // While we're converting the parameter types for a function, we don't want to
   // recursively convert any pointed-to structs. Converting directly-used
@@ -206,9 +273,24 @@ bool CIRGenTypes::isFuncParamTypeConvertible(clang::QualType Ty) {
   assert(!Ty->getAs<MemberPointerType>() && "NYI");
 
   // If this isn't a tagged type, we can convert it!
-  auto *TT = Ty->getAs<TagType>();
-  assert(!TT && "Only non-TagTypes implemented atm.");
-  return true;
+  const TagType *TT = Ty->getAs<TagType>();
+  if (!TT)
+    return true;
+
+  // Incomplete types cannot be converted.
+  if (TT->isIncompleteType())
+    return false;
+
+  // If this is an enum, then it is always safe to convert.
+  const RecordType *RT = dyn_cast<RecordType>(TT);
+  if (!RT)
+    return true;
+
+  // Otherwise, we have to be careful. If it is a struct that we're in the
+  // process of expanding, then we can't convert the function type. That's ok
+  // though because we must be in a pointer context under the struct, so we can
+  // just convert it to a dummy type.
+  return !RecordsBeingLaidOut.count(RT);
 }
 
 /// Code to verify a given function type is complete, i.e. the return type and
@@ -243,10 +325,16 @@ mlir::Type CIRGenTypes::ConvertType(QualType T) {
   // See if type is already cached.
   TypeCacheTy::iterator TCI = TypeCache.find(Ty);
   // If type is found in map then use it. Otherwise, convert type T.
-  if (TCI != TypeCache.end())
+  if (TCI != TypeCache.end()) {
+    ++NumTypeCacheHits;
+    if (SkippedLayout)
+      addCachedTypeDependency(Ty);
     return TCI->second;
+  }
+  ++NumTypeCacheMisses;
 
   // If we don't have it in the cache, convert it now.
+  TypesBeingConverted.push_back(Ty);
   mlir::Type ResultType = nullptr;
   switch (Ty->getTypeClass()) {
   case Type::Record: // Handled above.
@@ -336,11 +424,20 @@ mlir::Type CIRGenTypes::ConvertType(QualType T) {
       break;
     case BuiltinType::LongDouble:
     case BuiltinType::Float128:
-    case BuiltinType::Ibm128:
-      // FIXME: look at Context.getFloatTypeSemantics(T) and getTypeForFormat
-      // on LLVM codegen.
-      assert(0 && "not implemented");
+    case BuiltinType::Ibm128: {
+      // Mirrors getTypeForFormat on LLVM codegen.
+      const auto &Semantics = Context.getFloatTypeSemantics(T);
+      if (&Semantics == &llvm::APFloat::IEEEdouble())
+        ResultType = Builder.getF64Type();
+      else if (&Semantics == &llvm::APFloat::x87DoubleExtended())
+        ResultType = Builder.getF80Type();
+      else if (&Semantics == &llvm::APFloat::IEEEquad())
+        ResultType = Builder.getF128Type();
+      else
+        // FIXME: PPCDoubleDouble has no builtin MLIR type.
+        assert(0 && "not implemented");
       break;
+    }
 
     case BuiltinType::NullPtr:
       // Model std::nullptr_t as i8*
@@ -350,8 +447,7 @@ mlir::Type CIRGenTypes::ConvertType(QualType T) {
 
     case BuiltinType::UInt128:
     case BuiltinType::Int128:
-      assert(0 && "not implemented");
-      // FIXME: ResultType = Builder.getIntegerType(128);
+      ResultType = Builder.getIntegerType(128);
       break;
 
 #define IMAGE_TYPE(ImgType, Id, SingletonId, Access, Suffix)                   \
@@ -559,6 +655,7 @@ mlir::Type CIRGenTypes::ConvertType(QualType T) {
 
   assert(ResultType && "Didn't convert a type?");
 
+  TypesBeingConverted.pop_back();
   TypeCache[Ty] = ResultType;
   return ResultType;
 }
@@ -644,9 +741,12 @@ void CIRGenTypes::UpdateCompletedType(const TagDecl *TD) {
     return;
 
   // Only complete if we converted it already. If we haven't converted it yet,
-  // we'll just do it lazily.
-  if (recordDeclTypes.count(Context.getTagDeclType(RD).getTypePtr()))
+  // we'll just do it lazily. Function types which needed it are converted
+  // again either way.
+  const auto *Key = Context.getTagDeclType(RD).getTypePtr();
+  if (recordDeclTypes.count(Key))
     convertRecordDeclType(RD);
+  invalidateTypeCache(Key);
 
   // If necessary, provide the full definition of a type only used with a
   // declaration so far.
@@ -21,6 +21,8 @@
 #include "clang/AST/Type.h"
 #include "clang/Basic/ABI.h"
 
+#include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/SetVector.h"
 #include "llvm/ADT/SmallPtrSet.h"
 
 #include "mlir/Dialect/CIR/IR/CIRTypes.h"
@@ -107,6 +109,38 @@ class CIRGenTypes {
   /// conversion, set this to true.
   bool SkippedLayout;
 
+  /// The types ConvertType is converting, innermost last. When the layout of
+  /// a function type is skipped, all of them derive from its placeholder.
+  llvm::SmallVector<const clang::Type *, 8> TypesBeingConverted;
+
+  /// For each record that blocked the conversion of a function type, the
+  /// types cached in TypeCache which were derived from the placeholder.
+  llvm::DenseMap<const clang::Type *,
+                 llvm::SmallSetVector<const clang::Type *, 4>>
+      TypeCacheDependents;
+
+  /// The reverse of TypeCacheDependents: for each cached type derived from a
+  /// placeholder, the records it waits for.
+  llvm::DenseMap<const clang::Type *,
+                 llvm::SmallPtrSet<const clang::Type *, 2>>
+      TypeCacheDependencies;
+
+  /// Note that \p Ty must be converted again once \p Record is laid out.
+  void addTypeCacheDependency(const clang::Type *Record, const clang::Type *Ty);
+
+  /// Note that the conversion of a function type was skipped because of the
+  /// record \p Record, so the types being converted must be converted again
+  /// once \p Record can be laid out.
+  void addTypeCacheDependency(const clang::Type *Record);
+
+  /// Note that the cached type \p Ty is used by the types being converted, so
+  /// they depend on whatever records \p Ty depends on.
+  void addCachedTypeDependency(const clang::Type *Ty);
+
+  /// Drop the cached types derived from a placeholder used in place of a
+  /// function type depending on \p Record.
+  void invalidateTypeCache(const clang::Type *Record);
+
   llvm::SmallVector<const clang::RecordDecl *, 8> DeferredRecords;
 
   /// Heper for ConvertType.
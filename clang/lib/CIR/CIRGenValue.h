@@ -299,13 +299,11 @@ class AggValueSlot {
   AggValueSlot(Address Addr, clang::Qualifiers Quals, bool DestructedFlag,
                bool ObjCGCFlag, bool ZeroedFlag, bool AliasedFlag,
                bool OverlapFlag, bool SanitizerCheckedFlag)
-      : Addr(Addr), Quals(Quals)
+      : Addr(Addr), Quals(Quals), ZeroedFlag(ZeroedFlag),
+        OverlapFlag(OverlapFlag), SanitizerCheckedFlag(SanitizerCheckedFlag)
   // ,DestructedFlag(DestructedFlag)
   // ,ObjCGCFlag(ObjCGCFlag)
-  // ,ZeroedFlag(ZeroedFlag)
   // ,AliasedFlag(AliasedFlag)
-  // ,OverlapFlag(OverlapFlag)
-  // ,SanitizerCheckedFlag(SanitizerCheckedFlag)
   {}
 
 public:
@@ -17,10 +17,33 @@
 #include "mlir/Pass/PassManager.h"
 
 namespace cir {
+void buildCIRToCIRPipeline(mlir::OpPassManager &pm, unsigned optLevel,
+                           unsigned sizeLevel, bool enableCoroElide) {
+  // Cleanups only simplify the structure of the CIR, they are cheap enough
+  // for -O0.
+  pm.addPass(mlir::createMergeCleanupsPass());
+  if (optLevel == 0)
+    return;
+
+  // The loops are raised before inferring attributes, which then don't have
+  // to see through the iterator calls.
+  if (optLevel >= 2)
+    pm.addPass(mlir::createRaiseContainerLoopsPass());
+  pm.addPass(mlir::createFunctionAttrsPass());
+
+  // Eliding a coroutine frame clones the coroutine into an `.elided` copy and
+  // reserves an upper bound of its frame size in the caller's stack: it trades
+  // code size and stack usage for the heap allocation, and is only done on
+  // request.
+  if (enableCoroElide && optLevel >= 2 && sizeLevel == 0)
+    pm.addPass(mlir::createCoroElidePass());
+}
+
 void runCIRToCIRPasses(mlir::ModuleOp theModule, mlir::MLIRContext *mlirCtx,
-                       bool enableVerifier) {
+                       unsigned optLevel, unsigned sizeLevel,
+                       bool enableCoroElide, bool enableVerifier) {
   mlir::PassManager pm(mlirCtx);
-  pm.addPass(mlir::createMergeCleanupsPass());
+  buildCIRToCIRPipeline(pm, optLevel, sizeLevel, enableCoroElide);
   pm.enableVerifier(enableVerifier);
 
   auto result = !mlir::failed(pm.run(theModule));
@@ -28,4 +51,14 @@ void runCIRToCIRPasses(mlir::ModuleOp theModule, mlir::MLIRContext *mlirCtx,
     llvm::report_fatal_error(
         "CIR codegen: MLIR pass manager fails when running CIR passes!");
 }
+
+void runCIRPerfLint(mlir::ModuleOp theModule, mlir::MLIRContext *mlirCtx,
+                    llvm::StringRef reportFile) {
+  mlir::PassManager pm(mlirCtx);
+  pm.addPass(mlir::createPerfLintPass(reportFile));
+
+  // The pass only fails when the report cannot be written, which it has
+  // already diagnosed.
+  (void)pm.run(theModule);
+}
 } // namespace cir
\ No newline at end of file
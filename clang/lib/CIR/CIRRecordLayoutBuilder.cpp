@@ -42,6 +42,7 @@ struct CIRRecordLowering final {
   // Short helper routines.
 
   void lower(bool nonVirtualBaseType);
+  void lowerUnion();
 
   void accumulateFields();
   void accumulateVBases();
@@ -127,7 +128,8 @@ CIRRecordLowering::CIRRecordLowering(CIRGenTypes &cirGenTypes,
 
 void CIRRecordLowering::lower(bool nonVirtualBaseType) {
   if (recordDecl->isUnion()) {
-    llvm_unreachable("NYI");
+    lowerUnion();
+    return;
   }
 
   CharUnits Size = nonVirtualBaseType ? astRecordLayout.getNonVirtualSize()
@@ -160,6 +162,37 @@ void CIRRecordLowering::lower(bool nonVirtualBaseType) {
   // TODO: implement volatile bit fields
 }
 
+void CIRRecordLowering::lowerUnion() {
+  CharUnits layoutSize = astRecordLayout.getSize();
+  mlir::Type storageType = nullptr;
+  CharUnits storageAlign, storageSize;
+  // All union fields live at offset zero. The storage is the most aligned
+  // field, the largest one on a tie, padded to the size of the union.
+  for (const auto *field : recordDecl->fields()) {
+    assert(!field->isBitField() && "bit fields NYI");
+    fields[field->getCanonicalDecl()] = 0;
+    if (field->isZeroSize(astContext))
+      continue;
+    auto fieldType = getStorageType(field);
+    auto typeInfo = astContext.getTypeInfoInChars(field->getType());
+    if (!storageType || typeInfo.Align > storageAlign ||
+        (typeInfo.Align == storageAlign && typeInfo.Width > storageSize)) {
+      storageType = fieldType;
+      storageAlign = typeInfo.Align;
+      storageSize = typeInfo.Width;
+    }
+  }
+
+  // An empty union still takes up its size.
+  if (!storageType) {
+    appendPaddingBytes(layoutSize);
+    return;
+  }
+
+  fieldTypes.push_back(storageType);
+  appendPaddingBytes(layoutSize - storageSize);
+}
+
 void CIRRecordLowering::accumulateVBases() {
   if (astRecordLayout.hasOwnVFPtr())
     llvm_unreachable("NYI");
@@ -28,6 +28,7 @@
 #include "mlir/Dialect/SCF/Transforms/Passes.h"
 #include "mlir/IR/BlockAndValueMapping.h"
 #include "mlir/IR/BuiltinDialect.h"
+#include "mlir/IR/SymbolTable.h"
 #include "mlir/Pass/Pass.h"
 #include "mlir/Pass/PassManager.h"
 #include "mlir/Target/LLVMIR/Dialect/LLVMIR/LLVMToLLVMIRTranslation.h"
@@ -35,6 +36,7 @@
 #include "mlir/Transforms/DialectConversion.h"
 #include "clang/CIR/Passes.h"
 #include "llvm/ADT/Sequence.h"
+#include "llvm/Linker/Linker.h"
 
 using namespace cir;
 using namespace llvm;
@@ -168,13 +170,43 @@ public:
   mlir::LogicalResult
   matchAndRewrite(mlir::cir::FuncOp op,
                   mlir::PatternRewriter &rewriter) const override {
+    // Effect attributes become LLVM function attributes, which survive the
+    // conversion to the LLVM dialect as passthrough attributes.
+    llvm::SmallVector<mlir::Attribute, 2> passthrough;
+    if (op.nothrow())
+      passthrough.push_back(rewriter.getStringAttr("nounwind"));
+    if (auto effects = op.memory_effects())
+      passthrough.push_back(rewriter.getStringAttr(
+          *effects == mlir::cir::FuncMemoryEffects::none ? "readnone"
+                                                         : "readonly"));
+
     auto fn = rewriter.replaceOpWithNewOp<mlir::func::FuncOp>(
         op, op.getName(), op.getFunctionType());
+    if (!passthrough.empty())
+      fn->setAttr("passthrough", rewriter.getArrayAttr(passthrough));
+
+    // The ABI attributes of arguments passed in memory map onto the LLVM
+    // dialect argument attributes, which FuncToLLVM carries over.
+    for (unsigned argNo = 0, e = op.getNumArguments(); argNo != e; ++argNo) {
+      if (op.getArgAttr(argNo, mlir::cir::FuncOp::getSRetArgAttrName()))
+        fn.setArgAttr(argNo, "llvm.sret", rewriter.getUnitAttr());
+      if (op.getArgAttr(argNo, mlir::cir::FuncOp::getByValArgAttrName()))
+        fn.setArgAttr(argNo, "llvm.byval", rewriter.getUnitAttr());
+      if (auto align = op.getArgAttrOfType<mlir::IntegerAttr>(
+              argNo, mlir::cir::FuncOp::getAlignArgAttrName()))
+        fn.setArgAttr(argNo, mlir::LLVM::LLVMDialect::getAlignAttrName(),
+                      align);
+    }
     auto &srcRegion = op.body();
     auto &dstRegion = fn.getBody();
 
     mlir::BlockAndValueMapping mapper;
     srcRegion.cloneInto(&dstRegion, mapper);
+
+    // MLIR symbol declarations cannot be public, this does not change the
+    // linkage of the LLVM function.
+    if (dstRegion.empty())
+      fn.setPrivate();
     return mlir::LogicalResult::success();
   }
 };
@@ -254,15 +286,87 @@ void ConvertCIRToFuncPass::runOnOperation() {
     signalPassFailure();
 }
 
+/// The LLVM dialect cannot carry return attributes to LLVM IR, remember which
+/// functions return unaliased pointers.
+static llvm::SmallVector<std::string, 4>
+getNoAliasResultFns(mlir::ModuleOp theModule) {
+  llvm::SmallVector<std::string, 4> noAliasResultFns;
+  theModule.walk([&](mlir::cir::FuncOp fn) {
+    if (fn.hasNoAliasResult())
+      noAliasResultFns.push_back(fn.getName().str());
+  });
+  return noAliasResultFns;
+}
+
+static void addNoAliasResults(llvm::Module &llvmModule,
+                              ArrayRef<std::string> noAliasResultFns) {
+  for (auto &name : noAliasResultFns)
+    if (auto *fn = llvmModule.getFunction(name))
+      fn->addRetAttr(llvm::Attribute::NoAlias);
+}
+
+/// Whether `ty` is a CIR record, or a pointer or an array of one.
+static bool isOrHoldsRecord(mlir::Type ty) {
+  if (ty.isa<mlir::cir::StructType>())
+    return true;
+  if (auto ptrTy = ty.dyn_cast<mlir::cir::PointerType>())
+    return isOrHoldsRecord(ptrTy.getPointee());
+  if (auto arrTy = ty.dyn_cast<mlir::cir::ArrayType>())
+    return isOrHoldsRecord(arrTy.getEltType());
+  return false;
+}
+
+/// Report the first operation the lowering cannot handle yet, instead of
+/// failing to legalize it or emitting IR that does not follow the ABI:
+/// - coroutines have to be split into their ramp, resume and destroy
+///   functions first, which CIR does not do yet;
+/// - records do not lower, and with them the SysV coercion of record
+///   arguments and results to their {lo, hi} pair, sret and byval.
+static mlir::LogicalResult diagnoseUnsupportedOps(mlir::ModuleOp theModule) {
+  auto result = theModule.walk([](mlir::Operation *op) {
+    if (!isa<mlir::cir::AwaitOp, mlir::cir::CoroAllocFrameOp,
+             mlir::cir::CoroFreeFrameOp, mlir::cir::CoroResumeOp,
+             mlir::cir::CoroDestroyOp, mlir::cir::CoroDoneOp,
+             mlir::cir::CoroPromiseOp>(op))
+      return mlir::WalkResult::advance();
+    op->emitError("lowering of CIR coroutines to LLVM IR is not supported");
+    return mlir::WalkResult::interrupt();
+  });
+  if (result.wasInterrupted())
+    return mlir::failure();
+
+  result = theModule.walk([](mlir::Operation *op) {
+    bool usesRecords;
+    if (auto fn = dyn_cast<mlir::cir::FuncOp>(op))
+      usesRecords = llvm::any_of(fn.getArgumentTypes(), isOrHoldsRecord) ||
+                    llvm::any_of(fn.getResultTypes(), isOrHoldsRecord);
+    else
+      usesRecords = llvm::any_of(op->getOperandTypes(), isOrHoldsRecord) ||
+                    llvm::any_of(op->getResultTypes(), isOrHoldsRecord);
+    if (!usesRecords)
+      return mlir::WalkResult::advance();
+    op->emitError("lowering of CIR records to LLVM IR is not supported");
+    return mlir::WalkResult::interrupt();
+  });
+  return mlir::failure(result.wasInterrupted());
+}
+
+static void buildCIRToLLVMPipeline(mlir::PassManager &pm) {
+  pm.addPass(createConvertCIRToFuncPass());
+  pm.addPass(createConvertCIRToMemRefPass());
+  pm.addPass(createConvertCIRToLLVMPass());
+}
+
 std::unique_ptr<llvm::Module>
 lowerFromCIRToLLVMIR(mlir::ModuleOp theModule,
                      std::unique_ptr<mlir::MLIRContext> mlirCtx,
                      LLVMContext &llvmCtx) {
-  mlir::PassManager pm(mlirCtx.get());
+  if (mlir::failed(diagnoseUnsupportedOps(theModule)))
+    report_fatal_error("Lowering of CIR to LLVM IR failed!");
 
-  pm.addPass(createConvertCIRToFuncPass());
-  pm.addPass(createConvertCIRToMemRefPass());
-  pm.addPass(createConvertCIRToLLVMPass());
+  mlir::PassManager pm(mlirCtx.get());
+  auto noAliasResultFns = getNoAliasResultFns(theModule);
+  buildCIRToLLVMPipeline(pm);
 
   auto result = !mlir::failed(pm.run(theModule));
   if (!result)
@@ -281,6 +385,109 @@ lowerFromCIRToLLVMIR(mlir::ModuleOp theModule,
   if (!llvmModule)
     report_fatal_error("Lowering from LLVMIR dialect to llvm IR failed!");
 
+  addNoAliasResults(*llvmModule, noAliasResultFns);
+  return llvmModule;
+}
+
+/// Declare the symbols of `theModule` that `op` uses at the end of `builder`'s
+/// module, skipping `op` and the ones in `declared`.
+static void
+declareSymbolUses(mlir::OpBuilder &builder, mlir::SymbolTable &symbolTable,
+                  mlir::Operation *op,
+                  llvm::SmallPtrSetImpl<mlir::Operation *> &declared) {
+  auto uses = mlir::SymbolTable::getSymbolUses(op);
+  if (!uses)
+    return;
+  for (auto &use : *uses) {
+    auto *symbol = symbolTable.lookup(use.getSymbolRef().getRootReference());
+    if (!symbol || symbol == op || !declared.insert(symbol).second)
+      continue;
+    builder.insert(symbol->cloneWithoutRegions());
+  }
+}
+
+/// Lower and translate the scratch module `scratch` and link it into
+/// `linker`'s module.
+static void lowerAndLink(mlir::PassManager &pm, mlir::ModuleOp scratch,
+                         llvm::LLVMContext &llvmCtx, llvm::Linker &linker) {
+  if (mlir::failed(pm.run(scratch)))
+    report_fatal_error(
+        "The pass manager failed to lower CIR to LLVMIR dialect!");
+  if (scratch.verify().failed())
+    report_fatal_error("Verification of the final LLVMIR dialect failed!");
+
+  auto scratchLLVMModule = mlir::translateModuleToLLVMIR(scratch, llvmCtx);
+  if (!scratchLLVMModule)
+    report_fatal_error("Lowering from LLVMIR dialect to llvm IR failed!");
+  if (linker.linkInModule(std::move(scratchLLVMModule)))
+    report_fatal_error("Linking lowered CIR failed!");
+}
+
+std::unique_ptr<llvm::Module>
+lowerFromCIRToLLVMIRStreaming(mlir::ModuleOp theModule,
+                              std::unique_ptr<mlir::MLIRContext> mlirCtx,
+                              LLVMContext &llvmCtx) {
+  if (mlir::failed(diagnoseUnsupportedOps(theModule)))
+    report_fatal_error("Streaming lowering of CIR to LLVM IR failed!");
+
+  mlir::PassManager pm(mlirCtx.get());
+  auto noAliasResultFns = getNoAliasResultFns(theModule);
+  buildCIRToLLVMPipeline(pm);
+  mlir::registerLLVMDialectTranslation(*mlirCtx);
+
+  auto llvmModule = std::make_unique<llvm::Module>(
+      theModule.getName().value_or("LLVMDialectModule"), llvmCtx);
+  llvm::Linker linker(*llvmModule);
+  mlir::SymbolTable symbolTable(theModule);
+  mlir::OpBuilder builder(mlirCtx.get());
+
+  auto createScratchModule = [&](mlir::Location loc) {
+    mlir::OwningOpRef<mlir::ModuleOp> scratch =
+        mlir::ModuleOp::create(loc, theModule.getName());
+    scratch->getOperation()->setAttrs(theModule->getAttrDictionary());
+    builder.setInsertionPointToEnd(scratch->getBody());
+    return scratch;
+  };
+
+  // The conversion to the LLVM dialect does not handle globals yet, report
+  // the first one rather than failing somewhere in a scratch module.
+  for (auto global : theModule.getOps<mlir::cir::GlobalOp>()) {
+    global.emitError("streaming lowering of CIR globals is not supported");
+    report_fatal_error("Streaming lowering of CIR to LLVM IR failed!");
+  }
+
+  // Function declarations are lowered once in their own module, so that
+  // none is lost when no definition refers to it. Definitions are moved out
+  // one by one, only declarations stay for the functions referring to them.
+  llvm::SmallVector<mlir::cir::FuncOp> declarations;
+  llvm::SmallVector<mlir::cir::FuncOp> definitions;
+  for (auto fn : theModule.getOps<mlir::cir::FuncOp>()) {
+    if (fn.isDeclaration())
+      declarations.push_back(fn);
+    else
+      definitions.push_back(fn);
+  }
+
+  if (!declarations.empty()) {
+    auto declModule = createScratchModule(theModule.getLoc());
+    for (auto fn : declarations)
+      builder.insert(fn->clone());
+    lowerAndLink(pm, *declModule, llvmCtx, linker);
+  }
+
+  for (auto fn : definitions) {
+    auto fnModule = createScratchModule(fn.getLoc());
+    llvm::SmallPtrSet<mlir::Operation *, 8> declared;
+    declareSymbolUses(builder, symbolTable, fn, declared);
+
+    // Move the body to the copy being lowered, which leaves a declaration
+    // behind for the functions lowered next.
+    mlir::Operation *def = builder.insert(fn->cloneWithoutRegions());
+    def->getRegion(0).takeBody(fn.getBody());
+    lowerAndLink(pm, *fnModule, llvmCtx, linker);
+  }
+
+  addNoAliasResults(*llvmModule, noAliasResultFns);
   return llvmModule;
 }
 
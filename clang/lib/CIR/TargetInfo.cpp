@@ -1,12 +1,18 @@
 #include "TargetInfo.h"
 #include "ABIInfo.h"
 #include "CIRGenCXXABI.h"
+#include "CIRGenFunction.h"
 #include "CIRGenFunctionInfo.h"
 #include "CIRGenTypes.h"
 #include "CallingConv.h"
 
+#include "clang/AST/RecordLayout.h"
 #include "clang/Basic/TargetInfo.h"
 
+#include "mlir/Dialect/CIR/IR/CIRTypes.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/IR/BuiltinTypes.h"
+
 using namespace cir;
 using namespace clang;
 
@@ -78,6 +84,19 @@ namespace {
 /// The AVX ABI leel for X86 targets.
 enum class X86AVXABILevel { None, AVX, AVX512 };
 
+/// \p returns the size in bits of the largest (native) vector for \p AVXLevel.
+static unsigned getNativeVectorSizeForAVXABI(X86AVXABILevel AVXLevel) {
+  switch (AVXLevel) {
+  case X86AVXABILevel::AVX512:
+    return 512;
+  case X86AVXABILevel::AVX:
+    return 256;
+  case X86AVXABILevel::None:
+    return 128;
+  }
+  llvm_unreachable("Unknown AVXLevel");
+}
+
 class X86_64ABIInfo : public ABIInfo {
   enum Class {
     Integer = 0,
@@ -90,17 +109,42 @@ class X86_64ABIInfo : public ABIInfo {
     Memory
   };
 
-  // X86AVXABILevel AVXLevel;
+  /// merge - Implement the X86_64 ABI merging algorithm.
+  ///
+  /// Merge an accumulating classification \arg Accum with a field
+  /// classification \arg Field.
+  ///
+  /// \param Accum - The accumulating classification. This should
+  /// always be either NoClass or the result of a previous merge
+  /// call. In addition, this should never be Memory (the caller
+  /// should just return Memory for the aggregate).
+  static Class merge(Class Accum, Class Field);
+
+  /// postMerge - Implement the X86_64 ABI post merging algorithm.
+  ///
+  /// Post merger cleanup, reduces a malformed Hi and Lo pair to
+  /// final MEMORY or SSE classes when necessary.
+  ///
+  /// \param AggregateSize - The size of the current aggregate in
+  /// the classification process.
+  ///
+  /// \param Lo - The classification for the parts of the type
+  /// residing in the low word of the containing object.
+  ///
+  /// \param Hi - The classification for the parts of the type
+  /// residing in the higher words of the containing object.
+  void postMerge(unsigned AggregateSize, Class &Lo, Class &Hi) const;
+
+  X86AVXABILevel AVXLevel;
   // Some ABIs (e.g. X32 ABI and Native Client OS) use 32 bit pointers on 64-bit
   // hardware.
-  // bool Has64BitPointers;
+  bool Has64BitPointers;
 
 public:
   X86_64ABIInfo(CIRGenTypes &CGT, X86AVXABILevel AVXLevel)
-      : ABIInfo(CGT)
-  // , AVXLevel(AVXLevel)
-  // , Has64BitPointers(CGT.getDataLayout().getPointeSize(0) == 8)
-  {}
+      : ABIInfo(CGT), AVXLevel(AVXLevel),
+        Has64BitPointers(
+            CGT.getContext().getTargetInfo().getPointerWidth(0) == 64) {}
 
   virtual void computeInfo(CIRGenFunctionInfo &FI) const override;
 
@@ -144,12 +188,60 @@ public:
                                     QualType SourceTy,
                                     unsigned SourceOffset) const;
 
+  /// The ABI specifies that a value should be passed in a full vector XMM/YMM
+  /// register. Pick a CIR type that will be passed as a vector register.
+  mlir::Type GetByteVectorType(QualType Ty) const;
+
+  /// Given a high and low type that can ideally be used as elements of a two
+  /// register pair to pass or return, return a first class aggregate to
+  /// represent them.
+  mlir::Type GetX86_64ByValArgumentPair(mlir::Type Lo, mlir::Type Hi) const;
+
   /// getIndirectResult - Give a source type \arg Ty, return a suitable result
   /// such that the argument will be passed in memory.
   ///
   /// \param freeIntRegs - The number of free integer registers remaining
   /// available.
   ABIArgInfo getIndirectResult(QualType Ty, unsigned freeIntRegs) const;
+
+  /// getIndirectReturnResult - Give a source type \arg Ty, return a suitable
+  /// result such that the argument will be returned in memory.
+  ABIArgInfo getIndirectReturnResult(QualType Ty) const;
+
+  /// The 0.98 ABI revision clarified a lot of ambiguities, unfortunately in
+  /// ways that were not always consistent with certain previous compilers. In
+  /// particular, platforms which required strict binary compatibility with
+  /// older versions of GCC may need to exempt themselves.
+  bool honorsRevision0_98() const {
+    return !getContext().getTargetInfo().getTriple().isOSDarwin();
+  }
+
+  /// GCC classifies <1 x long long> as SSE but some platform ABIs choose to
+  /// classify it as INTEGER (for compatibility with older clang compilers).
+  bool classifyIntegerMMXAsSSE() const {
+    // Clang <= 3.8 did not do this.
+    if (getContext().getLangOpts().getClangABICompat() <=
+        LangOptions::ClangABI::Ver3_8)
+      return false;
+
+    const llvm::Triple &Triple = getContext().getTargetInfo().getTriple();
+    if (Triple.isOSDarwin() || Triple.isPS() || Triple.isOSFreeBSD())
+      return false;
+    return true;
+  }
+
+  // GCC always passes 256 and 512 bit <X x __int128> vectors in memory.
+  bool passInt128VectorsInMem() const {
+    // Clang <= 9.0 did not do this.
+    if (getContext().getLangOpts().getClangABICompat() <=
+        LangOptions::ClangABI::Ver9)
+      return false;
+
+    const llvm::Triple &T = getContext().getTargetInfo().getTriple();
+    return T.isOSLinux() || T.isOSNetBSD();
+  }
+
+  bool IsIllegalVectorType(QualType Ty) const;
 };
 
 class X86_64TargetCIRGenInfo : public TargetCIRGenInfo {
@@ -159,49 +251,511 @@ public:
 };
 } // namespace
 
-// TODO(cir): remove the attribute once this gets used.
-LLVM_ATTRIBUTE_UNUSED
+static bool isAggregateTypeForABI(QualType T) {
+  return !CIRGenFunction::hasScalarEvaluationKind(T) ||
+         T->isMemberFunctionPointerType();
+}
+
+static CIRGenCXXABI::RecordArgABI getRecordArgABI(const RecordType *RT,
+                                                  CIRGenCXXABI &CXXABI) {
+  const auto *RD = dyn_cast<CXXRecordDecl>(RT->getDecl());
+  if (!RD) {
+    if (!RT->getDecl()->canPassInRegisters())
+      return CIRGenCXXABI::RecordArgABI::Indirect;
+    return CIRGenCXXABI::RecordArgABI::Default;
+  }
+  return CXXABI.getRecordArgABI(RD);
+}
+
+static CIRGenCXXABI::RecordArgABI getRecordArgABI(QualType T,
+                                                  CIRGenCXXABI &CXXABI) {
+  const RecordType *RT = T->getAs<RecordType>();
+  if (!RT)
+    return CIRGenCXXABI::RecordArgABI::Default;
+  return getRecordArgABI(RT, CXXABI);
+}
+
 static bool classifyReturnType(const CIRGenCXXABI &CXXABI,
                                CIRGenFunctionInfo &FI, const ABIInfo &Info) {
   QualType Ty = FI.getReturnType();
 
-  assert(!Ty->getAs<RecordType>() && "RecordType returns NYI");
+  if (const auto *RT = Ty->getAs<RecordType>())
+    if (!isa<CXXRecordDecl>(RT->getDecl()) &&
+        !RT->getDecl()->canPassInRegisters()) {
+      FI.getReturnInfo() = Info.getNaturalAlignIndirect(Ty);
+      return true;
+    }
 
   return CXXABI.classifyReturnType(FI);
 }
 
 CIRGenCXXABI &ABIInfo::getCXXABI() const { return CGT.getCXXABI(); }
 
+clang::ASTContext &ABIInfo::getContext() const { return CGT.getContext(); }
+
+ABIArgInfo ABIInfo::getNaturalAlignIndirect(QualType Ty, bool ByVal,
+                                            bool Realign,
+                                            mlir::Type Padding) const {
+  return ABIArgInfo::getIndirect(getContext().getTypeAlignInChars(Ty), ByVal,
+                                 Realign, Padding);
+}
+
+ABIInfo::~ABIInfo() {}
+
+bool ABIInfo::isPromotableIntegerTypeForABI(QualType Ty) const {
+  if (Ty->isPromotableIntegerType())
+    return true;
+
+  if (const auto *EIT = Ty->getAs<BitIntType>())
+    if (EIT->getNumBits() < getContext().getTypeSize(getContext().IntTy))
+      return true;
+
+  return false;
+}
+
+void X86_64ABIInfo::postMerge(unsigned AggregateSize, Class &Lo,
+                              Class &Hi) const {
+  // AMD64-ABI 3.2.3p2: Rule 5. Then a post merger cleanup is done:
+  //
+  // (a) If one of the classes is Memory, the whole argument is passed in
+  //     memory.
+  //
+  // (b) If X87UP is not preceded by X87, the whole argument is passed in
+  //     memory.
+  //
+  // (c) If the size of the aggregate exceeds two eightbytes and the first
+  //     eightbyte isn't SSE or any other eightbyte isn't SSEUP, the whole
+  //     argument is passed in memory. NOTE: This is necessary to keep the
+  //     ABI working for processors that don't support the __m256 type.
+  //
+  // (d) If SSEUP is not preceded by SSE or SSEUP, it is converted to SSE.
+  //
+  // Some of these are enforced by the merging logic. Others can arise
+  // only with unions; for example:
+  //   union { _Complex double; unsigned; }
+  //
+  // Note that clauses (b) and (c) were added in 0.98.
+  //
+  if (Hi == Memory)
+    Lo = Memory;
+  if (Hi == X87Up && Lo != X87 && honorsRevision0_98())
+    Lo = Memory;
+  if (AggregateSize > 128 && (Lo != SSE || Hi != SSEUp))
+    Lo = Memory;
+  if (Hi == SSEUp && Lo != SSE)
+    Hi = SSE;
+}
+
+X86_64ABIInfo::Class X86_64ABIInfo::merge(Class Accum, Class Field) {
+  // AMD64-ABI 3.2.3p2: Rule 4. Each field of an object is
+  // classified recursively so that always two fields are
+  // considered. The resulting class is calculated according to
+  // the classes of the fields in the eightbyte:
+  //
+  // (a) If both classes are equal, this is the resulting class.
+  //
+  // (b) If one of the classes is NO_CLASS, the resulting class is
+  // the other class.
+  //
+  // (c) If one of the classes is MEMORY, the result is the MEMORY
+  // class.
+  //
+  // (d) If one of the classes is INTEGER, the result is the
+  // INTEGER.
+  //
+  // (e) If one of the classes is X87, X87UP, COMPLEX_X87 class,
+  // MEMORY is used as class.
+  //
+  // (f) Otherwise class SSE is used.
+
+  // Accum should never be memory (we should have returned) or
+  // ComplexX87 (because this cannot be passed in a structure).
+  assert((Accum != Memory && Accum != ComplexX87) &&
+         "Invalid accumulated classification during merge.");
+  if (Accum == Field || Field == NoClass)
+    return Accum;
+  if (Field == Memory)
+    return Memory;
+  if (Accum == NoClass)
+    return Field;
+  if (Accum == Integer || Field == Integer)
+    return Integer;
+  if (Field == X87 || Field == X87Up || Field == ComplexX87 ||
+      Accum == X87 || Accum == X87Up)
+    return Memory;
+  return SSE;
+}
+
+ABIArgInfo X86_64ABIInfo::getIndirectReturnResult(QualType Ty) const {
+  // If this is a scalar CIR value then assume the backend will return it in
+  // the right place naturally.
+  if (!isAggregateTypeForABI(Ty)) {
+    // Treat an enum type as its underlying type.
+    if (const EnumType *EnumTy = Ty->getAs<EnumType>())
+      Ty = EnumTy->getDecl()->getIntegerType();
+
+    if (Ty->isBitIntType())
+      return getNaturalAlignIndirect(Ty);
+
+    return (isPromotableIntegerTypeForABI(Ty) ? ABIArgInfo::getExtend(Ty)
+                                              : ABIArgInfo::getDirect());
+  }
+
+  return getNaturalAlignIndirect(Ty);
+}
+
+bool X86_64ABIInfo::IsIllegalVectorType(QualType Ty) const {
+  if (const VectorType *VecTy = Ty->getAs<VectorType>()) {
+    uint64_t Size = getContext().getTypeSize(VecTy);
+    unsigned LargestVector = getNativeVectorSizeForAVXABI(AVXLevel);
+    if (Size <= 64 || Size > LargestVector)
+      return true;
+    QualType EltTy = VecTy->getElementType();
+    if (passInt128VectorsInMem() &&
+        (EltTy->isSpecificBuiltinType(BuiltinType::Int128) ||
+         EltTy->isSpecificBuiltinType(BuiltinType::UInt128)))
+      return true;
+  }
+
+  return false;
+}
+
 ABIArgInfo X86_64ABIInfo::getIndirectResult(QualType Ty,
                                             unsigned freeIntRegs) const {
-  assert(false && "NYI");
+  // If this is a scalar CIR value then assume the backend will pass it in the
+  // right place naturally.
+  //
+  // This assumption is optimistic, as there could be free registers available
+  // when we need to pass this argument in memory, and the backend could try to
+  // pass the argument in the free register. This does not seem to happen
+  // currently, but this code would be much safer if we could mark the argument
+  // with 'onstack'. See PR12193.
+  if (!isAggregateTypeForABI(Ty) && !IsIllegalVectorType(Ty) &&
+      !Ty->isBitIntType()) {
+    // Treat an enum type as its underlying type.
+    if (const EnumType *EnumTy = Ty->getAs<EnumType>())
+      Ty = EnumTy->getDecl()->getIntegerType();
+
+    return (isPromotableIntegerTypeForABI(Ty) ? ABIArgInfo::getExtend(Ty)
+                                              : ABIArgInfo::getDirect());
+  }
+
+  auto RAA = getRecordArgABI(Ty, getCXXABI());
+  if (RAA != CIRGenCXXABI::RecordArgABI::Default)
+    return getNaturalAlignIndirect(
+        Ty, RAA == CIRGenCXXABI::RecordArgABI::DirectInMemory);
+
+  // Compute the byval alignment. We specify the alignment of the byval in all
+  // cases so that the mid-level optimizer knows the alignment of the byval.
+  unsigned Align = std::max(getContext().getTypeAlign(Ty) / 8, 8U);
+
+  // Attempt to avoid passing indirect results using byval when possible. This
+  // is important for good codegen.
+  //
+  // We do this by coercing the value into a scalar type which the backend can
+  // handle naturally (i.e., without using byval).
+  //
+  // For simplicity, we currently only do this when we have exhausted all of
+  // the free integer registers. Doing this when there are free integer
+  // registers would require more care, as we would have to ensure that the
+  // coerced value did not claim the unused register.
+  if (freeIntRegs == 0) {
+    uint64_t Size = getContext().getTypeSize(Ty);
+
+    // If this type fits in an eightbyte, coerce it into the matching integral
+    // type, which will end up on the stack (with alignment 8).
+    if (Align == 8 && Size <= 64)
+      return ABIArgInfo::getDirect(
+          mlir::IntegerType::get(&CGT.getMLIRContext(), Size));
+  }
+
+  return ABIArgInfo::getIndirect(CharUnits::fromQuantity(Align));
 }
 
 void X86_64ABIInfo::computeInfo(CIRGenFunctionInfo &FI) const {
-  // Top level CIR has unlimited arguments and return types. Lowering for ABI
-  // specific concerns should happen during a lowering phase. Assume everything
-  // is direct for now.
-  for (CIRGenFunctionInfo::arg_iterator it = FI.arg_begin(), ie = FI.arg_end();
-       it != ie; ++it) {
-    if (testIfIsVoidTy(it->type))
-      it->info = ABIArgInfo::getIgnore();
+  // Keep track of the number of assigned registers.
+  unsigned FreeIntRegs = 6;
+  unsigned FreeSSERegs = 8;
+  unsigned NeededInt = 0, NeededSSE = 0;
+
+  if (!::classifyReturnType(getCXXABI(), FI, *this)) {
+    if (testIfIsVoidTy(FI.getReturnType()))
+      FI.getReturnInfo() = ABIArgInfo::getIgnore();
     else
-      it->info = ABIArgInfo::getDirect(CGT.ConvertType(it->type));
+      FI.getReturnInfo() = classifyReturnType(FI.getReturnType());
+  }
+
+  // If the return value is indirect, then the hidden argument is consuming one
+  // integer register.
+  if (FI.getReturnInfo().isIndirect())
+    --FreeIntRegs;
+
+  // The chain argument effectively gives us another free register.
+  if (FI.isChainCall())
+    ++FreeIntRegs;
+
+  unsigned NumRequiredArgs = FI.getNumRequiredArgs();
+  // AMD64-ABI 3.2.3p3: Once arguments are classified, the registers
+  // get assigned (in left-to-right order) for passing as follows...
+  unsigned ArgNo = 0;
+  for (CIRGenFunctionInfo::arg_iterator it = FI.arg_begin(), ie = FI.arg_end();
+       it != ie; ++it, ++ArgNo) {
+    bool IsNamedArg = ArgNo < NumRequiredArgs;
+
+    it->info = classifyArgumentType(it->type, FreeIntRegs, NeededInt,
+                                    NeededSSE, IsNamedArg);
+
+    // AMD64-ABI 3.2.3p3: If there are no registers available for any
+    // eightbyte of an argument, the whole argument is passed on the
+    // stack. If registers have already been assigned for some
+    // eightbytes of such an argument, the assignments get reverted.
+    if (FreeIntRegs >= NeededInt && FreeSSERegs >= NeededSSE) {
+      FreeIntRegs -= NeededInt;
+      FreeSSERegs -= NeededSSE;
+    } else {
+      it->info = getIndirectResult(it->type, FreeIntRegs);
+    }
   }
-  auto RetTy = FI.getReturnType();
-  if (testIfIsVoidTy(RetTy))
-    FI.getReturnInfo() = ABIArgInfo::getIgnore();
-  else
-    FI.getReturnInfo() = ABIArgInfo::getDirect(CGT.ConvertType(RetTy));
 }
 
 /// Pass transparent unions as if they were the type of the first element. Sema
 /// should ensure that all elements of the union have the same "machine type".
 static QualType useFirstFieldIfTransparentUnion(QualType Ty) {
-  assert(!Ty->getAsUnionType() && "NYI");
+  if (const RecordType *UT = Ty->getAsUnionType()) {
+    const RecordDecl *UD = UT->getDecl();
+    if (UD->hasAttr<TransparentUnionAttr>()) {
+      assert(!UD->field_empty() && "sema created an empty transparent union");
+      return UD->field_begin()->getType();
+    }
+  }
   return Ty;
 }
 
+/// BitsContainNoUserData - Return true if the specified [start,end) bit range
+/// is known to either be off the end of the specified type or being in
+/// alignment padding. The user type specified is known to be at most 128 bits
+/// in size, and have passed through X86_64ABIInfo::classify with a successful
+/// classification that put one of the two halves in the INTEGER class.
+///
+/// It is conservatively correct to return false.
+static bool BitsContainNoUserData(QualType Ty, unsigned StartBit,
+                                  unsigned EndBit, ASTContext &Context) {
+  // If the bytes being queried are off the end of the type, there is no user
+  // data hiding here. This handles analysis of builtins, vectors and other
+  // types that don't contain interesting padding.
+  unsigned TySize = (unsigned)Context.getTypeSize(Ty);
+  if (TySize <= StartBit)
+    return true;
+
+  if (const ConstantArrayType *AT = Context.getAsConstantArrayType(Ty)) {
+    unsigned EltSize = (unsigned)Context.getTypeSize(AT->getElementType());
+    unsigned NumElts = (unsigned)AT->getSize().getZExtValue();
+
+    // Check each element to see if the element overlaps with the queried range.
+    for (unsigned i = 0; i != NumElts; ++i) {
+      // If the element is after the span we care about, then we're done..
+      unsigned EltOffset = i * EltSize;
+      if (EltOffset >= EndBit)
+        break;
+
+      unsigned EltStart = EltOffset < StartBit ? StartBit - EltOffset : 0;
+      if (!BitsContainNoUserData(AT->getElementType(), EltStart,
+                                 EndBit - EltOffset, Context))
+        return false;
+    }
+    // If it overlaps no elements, then it is safe to process as padding.
+    return true;
+  }
+
+  if (const RecordType *RT = Ty->getAs<RecordType>()) {
+    const RecordDecl *RD = RT->getDecl();
+    const ASTRecordLayout &Layout = Context.getASTRecordLayout(RD);
+
+    // If this is a C++ record, check the bases first.
+    if (const CXXRecordDecl *CXXRD = dyn_cast<CXXRecordDecl>(RD)) {
+      for (const auto &I : CXXRD->bases()) {
+        assert(!I.isVirtual() && !I.getType()->isDependentType() &&
+               "Unexpected base class!");
+        const auto *Base =
+            cast<CXXRecordDecl>(I.getType()->castAs<RecordType>()->getDecl());
+
+        // If the base is after the span we care about, ignore it.
+        unsigned BaseOffset = Context.toBits(Layout.getBaseClassOffset(Base));
+        if (BaseOffset >= EndBit)
+          continue;
+
+        unsigned BaseStart = BaseOffset < StartBit ? StartBit - BaseOffset : 0;
+        if (!BitsContainNoUserData(I.getType(), BaseStart, EndBit - BaseOffset,
+                                   Context))
+          return false;
+      }
+    }
+
+    // Verify that no field has data that overlaps the region of interest. Yes
+    // this could be sped up a lot by being smarter about queried fields,
+    // however we're only looking at structs up to 16 bytes, so we don't care
+    // much.
+    unsigned idx = 0;
+    for (RecordDecl::field_iterator i = RD->field_begin(), e = RD->field_end();
+         i != e; ++i, ++idx) {
+      unsigned FieldOffset = (unsigned)Layout.getFieldOffset(idx);
+
+      // If we found a field after the region we care about, then we're done.
+      if (FieldOffset >= EndBit)
+        break;
+
+      unsigned FieldStart = FieldOffset < StartBit ? StartBit - FieldOffset : 0;
+      if (!BitsContainNoUserData(i->getType(), FieldStart,
+                                 EndBit - FieldOffset, Context))
+        return false;
+    }
+
+    // If nothing in this record overlapped the area of interest, then we're
+    // clean.
+    return true;
+  }
+
+  return false;
+}
+
+/// Return the scalar member of \p Ty that starts exactly \p Offset bytes into
+/// it, looking through records and constant arrays, or a null type if there
+/// is none (e.g. the offset points into padding, a bit-field or the middle of
+/// a scalar).
+///
+/// Unlike LLVM IR types, CIR types carry no layout, so the coerced types of
+/// the eightbytes are picked by looking at the source type instead.
+static QualType getScalarTypeAtOffset(QualType Ty, uint64_t Offset,
+                                      ASTContext &Context) {
+  if (const ConstantArrayType *AT = Context.getAsConstantArrayType(Ty)) {
+    uint64_t EltSize =
+        Context.getTypeSizeInChars(AT->getElementType()).getQuantity();
+    if (!EltSize || Offset >= EltSize * AT->getSize().getZExtValue())
+      return QualType();
+    return getScalarTypeAtOffset(AT->getElementType(), Offset % EltSize,
+                                 Context);
+  }
+
+  if (const RecordType *RT = Ty->getAs<RecordType>()) {
+    const RecordDecl *RD = RT->getDecl();
+    const ASTRecordLayout &Layout = Context.getASTRecordLayout(RD);
+
+    if (const CXXRecordDecl *CXXRD = dyn_cast<CXXRecordDecl>(RD)) {
+      for (const auto &I : CXXRD->bases()) {
+        const auto *Base =
+            cast<CXXRecordDecl>(I.getType()->castAs<RecordType>()->getDecl());
+        uint64_t BaseOffset = Layout.getBaseClassOffset(Base).getQuantity();
+        uint64_t BaseSize = Context.getTypeSizeInChars(I.getType()).getQuantity();
+        if (Offset >= BaseOffset && Offset < BaseOffset + BaseSize)
+          if (QualType T = getScalarTypeAtOffset(I.getType(),
+                                                 Offset - BaseOffset, Context);
+              !T.isNull())
+            return T;
+      }
+    }
+
+    unsigned idx = 0;
+    for (RecordDecl::field_iterator i = RD->field_begin(), e = RD->field_end();
+         i != e; ++i, ++idx) {
+      if (i->isBitField())
+        continue;
+      uint64_t FieldOffset = Context.toCharUnitsFromBits(
+                                 Layout.getFieldOffset(idx)).getQuantity();
+      uint64_t FieldSize =
+          Context.getTypeSizeInChars(i->getType()).getQuantity();
+      if (Offset >= FieldOffset && Offset < FieldOffset + FieldSize)
+        if (QualType T = getScalarTypeAtOffset(i->getType(),
+                                               Offset - FieldOffset, Context);
+            !T.isNull())
+          return T;
+    }
+    return QualType();
+  }
+
+  if (Offset == 0 && !Ty->isVectorType() && !Ty->isAnyComplexType())
+    return Ty;
+  return QualType();
+}
+
+/// Return the size in bytes of one of the scalar types produced for an
+/// eightbyte by GetINTEGERTypeAtOffset and GetSSETypeAtOffset. These types
+/// are naturally aligned, so this is also their alignment.
+static unsigned getEightbyteTypeSize(mlir::Type Ty) {
+  if (Ty.isa<mlir::cir::PointerType>())
+    return 8;
+  if (Ty.isa<mlir::cir::BoolType>())
+    return 1;
+  if (auto VecTy = Ty.dyn_cast<mlir::VectorType>())
+    return VecTy.getNumElements() *
+           getEightbyteTypeSize(VecTy.getElementType());
+  assert(Ty.isIntOrFloat() && "Invalid/unknown eightbyte type");
+  return llvm::PowerOf2Ceil(Ty.getIntOrFloatBitWidth()) / 8;
+}
+
+/// GetSSETypeAtOffset - Return a type that will be passed by the backend in the
+/// low 8 bytes of an XMM register, corresponding to the SSE class.
+mlir::Type X86_64ABIInfo::GetSSETypeAtOffset(mlir::Type CIRType,
+                                             unsigned int CIROffset,
+                                             clang::QualType SourceTy,
+                                             unsigned int SourceOffset) const {
+  auto &Ctx = getContext();
+  mlir::Builder Builder(&CGT.getMLIRContext());
+  unsigned SourceSize = (unsigned)Ctx.getTypeSize(SourceTy) / 8 - SourceOffset;
+
+  // Return the floating point type starting at Offset, if any.
+  auto getFPTypeAtOffset = [&](unsigned Offset) -> mlir::Type {
+    QualType T = getScalarTypeAtOffset(SourceTy, Offset, Ctx);
+    if (T.isNull() || !T->isRealFloatingType())
+      return nullptr;
+    if (T->isFloat16Type() || T->isHalfType())
+      return Builder.getF16Type();
+    switch (Ctx.getTypeSize(T)) {
+    case 32:
+      return Builder.getF32Type();
+    case 64:
+      return Builder.getF64Type();
+    default:
+      return nullptr;
+    }
+  };
+
+  mlir::Type T0 = getFPTypeAtOffset(SourceOffset);
+  if (!T0 || T0.isF64())
+    return Builder.getF64Type();
+
+  // Get the adjacent FP type.
+  mlir::Type T1 = nullptr;
+  unsigned T0Size = getEightbyteTypeSize(T0);
+  if (SourceSize > T0Size)
+    T1 = getFPTypeAtOffset(SourceOffset + T0Size);
+  if (!T1) {
+    // Check if SourceTy is a half + float. float type will be at offset 4 due
+    // to its alignment.
+    if (T0.isF16() && SourceSize > 4)
+      T1 = getFPTypeAtOffset(SourceOffset + 4);
+    // If we can't get a second FP type, return a simple half or float.
+    if (!T1)
+      return T0;
+  }
+
+  if (T0.isF32() && T1.isF32())
+    return mlir::VectorType::get({2}, T0);
+
+  if (T0.isF16() && T1.isF16()) {
+    mlir::Type T2 = nullptr;
+    if (SourceSize > 4)
+      T2 = getFPTypeAtOffset(SourceOffset + 4);
+    if (!T2)
+      return mlir::VectorType::get({2}, T0);
+    return mlir::VectorType::get({4}, T0);
+  }
+
+  if (T0.isF16() || T1.isF16())
+    return mlir::VectorType::get({4}, Builder.getF16Type());
+
+  return Builder.getF64Type();
+}
+
 /// GetINTEGERTypeAtOffset - The ABI specifies that a value should be passed in
 /// an 8-byte GPR. This means that we either have a scalar or we are talking
 /// about the high or low part of an up-to-16-byte struct. This routine picks
@@ -220,10 +774,115 @@ mlir::Type X86_64ABIInfo::GetINTEGERTypeAtOffset(mlir::Type CIRType,
                                                  unsigned CIROffset,
                                                  QualType SourceTy,
                                                  unsigned SourceOffset) const {
-  // TODO: entirely stubbed out
-  assert(CIROffset == 0 && "NYI");
-  assert(SourceOffset == 0 && "NYI");
-  return CIRType;
+  auto &Ctx = getContext();
+
+  // A scalar is passed as itself.
+  if (CIROffset == 0 && CIRType && !isAggregateTypeForABI(SourceTy) &&
+      Ctx.getTypeSize(SourceTy) <= 64)
+    return CIRType;
+
+  // If there is a pointer or an integer starting at this eightbyte, see if we
+  // can safely use it.
+  QualType T = getScalarTypeAtOffset(SourceTy, SourceOffset, Ctx);
+  if (!T.isNull() &&
+      (T->hasPointerRepresentation() || T->isIntegralOrEnumerationType())) {
+    unsigned BitWidth = (unsigned)Ctx.getTypeSize(T);
+    mlir::Type Ty = T->hasPointerRepresentation()
+                        ? CGT.ConvertType(T)
+                        : mlir::IntegerType::get(&CGT.getMLIRContext(),
+                                                 BitWidth);
+
+    // Pointers and int64's always fill the 8-byte unit.
+    if (BitWidth == 64)
+      return Ty;
+
+    // If we have a 1/2/4-byte integer, we can use it only if the rest of the
+    // goodness in the source type is just tail padding. This is allowed to
+    // kick in for struct {double,int} on the int, but not on
+    // struct{double,int,int} because we wouldn't return the second int. We
+    // have to do this analysis on the source type because we can't depend on
+    // unions being lowered a specific way etc.
+    if ((BitWidth == 8 || BitWidth == 16 || BitWidth == 32) &&
+        BitsContainNoUserData(SourceTy, SourceOffset * 8 + BitWidth,
+                              SourceOffset * 8 + 64, Ctx))
+      return Ty;
+  }
+
+  // Okay, we don't have any better idea of what to pass, so we pass this in an
+  // integer register that isn't too big to fit the rest of the struct.
+  unsigned TySizeInBytes =
+      (unsigned)Ctx.getTypeSizeInChars(SourceTy).getQuantity();
+
+  assert(TySizeInBytes != SourceOffset && "Empty field?");
+
+  // It is always safe to classify this as an integer type up to i64 that
+  // isn't larger than the structure.
+  return mlir::IntegerType::get(&CGT.getMLIRContext(),
+                                std::min(TySizeInBytes - SourceOffset, 8U) * 8);
+}
+
+mlir::Type X86_64ABIInfo::GetByteVectorType(QualType Ty) const {
+  uint64_t Size = getContext().getTypeSize(Ty);
+  mlir::Builder Builder(&CGT.getMLIRContext());
+
+  if (const VectorType *VT = Ty->getAs<VectorType>()) {
+    QualType EltTy = VT->getElementType();
+    // Don't pass vXi128 vectors in their native type, the backend can't
+    // legalize them.
+    if (passInt128VectorsInMem() &&
+        (EltTy->isSpecificBuiltinType(BuiltinType::Int128) ||
+         EltTy->isSpecificBuiltinType(BuiltinType::UInt128)))
+      return mlir::VectorType::get({int64_t(Size / 64)},
+                                   Builder.getIntegerType(64));
+
+    if (EltTy->isIntegerType() || EltTy->isRealFloatingType())
+      return mlir::VectorType::get({VT->getNumElements()},
+                                   CGT.ConvertType(EltTy));
+  }
+
+  if (Ty->isSpecificBuiltinType(BuiltinType::LongDouble) ||
+      Ty->isSpecificBuiltinType(BuiltinType::Float128))
+    return Builder.getF128Type();
+
+  // We couldn't find the preferred vector type for 'Ty'.
+  assert((Size == 128 || Size == 256 || Size == 512) && "Invalid type found!");
+
+  // Return a vector type based on the size of 'Ty'.
+  return mlir::VectorType::get({int64_t(Size / 64)}, Builder.getF64Type());
+}
+
+mlir::Type X86_64ABIInfo::GetX86_64ByValArgumentPair(mlir::Type Lo,
+                                                     mlir::Type Hi) const {
+  // In order to correctly satisfy the ABI, we need to the high part to start
+  // at offset 8. If the high and low parts we inferred are both 4-byte types
+  // (e.g. i32 and i32) then the resultant struct type ({i32,i32}) won't have
+  // the second element at offset 8. Check for this:
+  unsigned LoSize = getEightbyteTypeSize(Lo);
+  unsigned HiAlign = getEightbyteTypeSize(Hi);
+  unsigned HiStart = llvm::alignTo(LoSize, HiAlign);
+  assert(HiStart != 0 && HiStart <= 8 && "Invalid x86-64 argument pair!");
+
+  // To handle this, we have to increase the size of the low part so that the
+  // second element will start at an 8 byte offset. We can't increase the size
+  // of the second element because it might make us access off the end of the
+  // struct.
+  if (HiStart != 8) {
+    // There are usually two sorts of types the ABI generation code can produce
+    // for the low part of a pair that aren't 8 bytes in size: half, float or
+    // i8/i16/i32. This can also include pointers when they are 32-bit (X32 and
+    // NaCl). Promote these to a larger type.
+    mlir::Builder Builder(&CGT.getMLIRContext());
+    if (Lo.isF16() || Lo.isF32())
+      Lo = Builder.getF64Type();
+    else {
+      assert((Lo.isa<mlir::IntegerType, mlir::cir::PointerType,
+                     mlir::cir::BoolType>()) &&
+             "Invalid/unknown lo type");
+      Lo = Builder.getIntegerType(64);
+    }
+  }
+
+  return mlir::cir::StructType::get(&CGT.getMLIRContext(), {Lo, Hi}, "");
 }
 
 ABIArgInfo X86_64ABIInfo::classifyArgumentType(QualType Ty,
@@ -245,8 +904,31 @@ ABIArgInfo X86_64ABIInfo::classifyArgumentType(QualType Ty,
   neededSSE = 0;
   mlir::Type ResType = nullptr;
   switch (Lo) {
-  default:
-    assert(false && "NYI");
+  case NoClass:
+    if (Hi == NoClass)
+      return ABIArgInfo::getIgnore();
+    // If the low part is just padding, it takes no register, leave ResType
+    // null.
+    assert((Hi == SSE || Hi == Integer || Hi == X87Up) &&
+           "Unknown missing lo part");
+    break;
+
+    // AMD64-ABI 3.2.3p3: Rule 1. If the class is MEMORY, pass the argument
+    // on the stack.
+  case Memory:
+
+    // AMD64-ABI 3.2.3p3: Rule 5. If the class is X87, X87UP or
+    // COMPLEX_X87, it is passed in memory.
+  case X87:
+  case ComplexX87:
+    if (getRecordArgABI(Ty, getCXXABI()) ==
+        CIRGenCXXABI::RecordArgABI::Indirect)
+      ++neededInt;
+    return getIndirectResult(Ty, freeIntRegs);
+
+  case SSEUp:
+  case X87Up:
+    llvm_unreachable("Invalid classification for lo word.");
 
   // AMD64-ABI 3.2.3p3: Rule 2. If the class is INTEGER, the next available
   // register of the sequence %rdi, %rsi, %rdx, %rcx, %r8 and %r9 is used.
@@ -259,8 +941,11 @@ ABIArgInfo X86_64ABIInfo::classifyArgumentType(QualType Ty,
     // If we have a sign or zero extended integer, make sure to return Extend so
     // that the parameter gets the right LLVM IR attributes.
     if (Hi == NoClass && ResType.isa<mlir::IntegerType>()) {
-      assert(!Ty->getAs<EnumType>() && "NYI");
-      if (Ty->isSignedIntegerOrEnumerationType() &&
+      // Treat an enum type as its underlying type.
+      if (const EnumType *EnumTy = Ty->getAs<EnumType>())
+        Ty = EnumTy->getDecl()->getIntegerType();
+
+      if (Ty->isIntegralOrEnumerationType() &&
           isPromotableIntegerTypeForABI(Ty))
         return ABIArgInfo::getExtend(Ty);
     }
@@ -280,26 +965,54 @@ ABIArgInfo X86_64ABIInfo::classifyArgumentType(QualType Ty,
 
   mlir::Type HighPart = nullptr;
   switch (Hi) {
-  default:
-    assert(false && "NYI");
+    // Memory was handled previously, ComplexX87 and X87 should
+    // never occur as hi classes, and X87Up must be preceded by X87,
+    // which is passed in memory.
+  case Memory:
+  case X87:
+  case ComplexX87:
+    llvm_unreachable("Invalid classification for hi word.");
+
   case NoClass:
     break;
-  }
 
-  assert(!HighPart && "NYI");
+  case Integer:
+    ++neededInt;
+    // Pick an 8-byte type based on the preferred type.
+    HighPart = GetINTEGERTypeAtOffset(CGT.ConvertType(Ty), 8, Ty, 8);
 
-  return ABIArgInfo::getDirect(ResType);
-}
+    if (Lo == NoClass) // Pass HighPart at offset 8 in memory.
+      return ABIArgInfo::getDirect(HighPart, 8);
+    break;
 
-ABIInfo::~ABIInfo() {}
+    // X87Up generally doesn't occur here (long double is passed in
+    // memory), except in situations involving unions.
+  case X87Up:
+  case SSE:
+    HighPart = GetSSETypeAtOffset(CGT.ConvertType(Ty), 8, Ty, 8);
 
-bool ABIInfo::isPromotableIntegerTypeForABI(QualType Ty) const {
-  if (Ty->isPromotableIntegerType())
-    return true;
+    if (Lo == NoClass) // Pass HighPart at offset 8 in memory.
+      return ABIArgInfo::getDirect(HighPart, 8);
 
-  assert(!Ty->getAs<BitIntType>() && "NYI");
+    ++neededSSE;
+    break;
 
-  return false;
+    // AMD64-ABI 3.2.3p3: Rule 4. If the class is SSEUP, the
+    // eightbyte is passed in the upper half of the last used SSE
+    // register. This only happens when 128-bit vectors are passed.
+  case SSEUp:
+    assert(Lo == SSE && "Unexpected SSEUp classification");
+    ResType = GetByteVectorType(Ty);
+    break;
+  }
+
+  // If a high part was specified, merge it together with the low part. It is
+  // known to pass in the high eightbyte of the result. We do this by forming a
+  // first class struct aggregate with the high and low part: {low, high}
+  if (HighPart)
+    ResType = GetX86_64ByValArgumentPair(ResType, HighPart);
+
+  return ABIArgInfo::getDirect(ResType);
 }
 
 void X86_64ABIInfo::classify(QualType Ty, uint64_t OffsetBase, Class &Lo,
@@ -321,7 +1034,6 @@ void X86_64ABIInfo::classify(QualType Ty, uint64_t OffsetBase, Class &Lo,
     if (k == BuiltinType::Void) {
       Current = NoClass;
     } else if (k == BuiltinType::Int128 || k == BuiltinType::UInt128) {
-      assert(false && "NYI");
       Lo = Integer;
       Hi = Integer;
     } else if (k >= BuiltinType::Bool && k <= BuiltinType::LongLong) {
@@ -330,34 +1042,344 @@ void X86_64ABIInfo::classify(QualType Ty, uint64_t OffsetBase, Class &Lo,
                k == BuiltinType::Float16) {
       Current = SSE;
     } else if (k == BuiltinType::LongDouble) {
-      assert(false && "NYI");
-    } else
-      assert(false &&
-             "Only void and Integer supported so far for builtin types");
+      const llvm::fltSemantics *LDF =
+          &getContext().getTargetInfo().getLongDoubleFormat();
+      if (LDF == &llvm::APFloat::IEEEquad()) {
+        Lo = SSE;
+        Hi = SSEUp;
+      } else if (LDF == &llvm::APFloat::x87DoubleExtended()) {
+        Lo = X87;
+        Hi = X87Up;
+      } else if (LDF == &llvm::APFloat::IEEEdouble()) {
+        Current = SSE;
+      } else
+        llvm_unreachable("unexpected long double representation!");
+    }
     // FIXME: _Decimal32 and _Decimal64 are SSE.
     // FIXME: _float128 and _Decimal128 are (SSE, SSEUp).
     return;
   }
 
-  assert(!Ty->getAs<EnumType>() && "Enums NYI");
+  if (const EnumType *ET = Ty->getAs<EnumType>()) {
+    // Classify the underlying integer type.
+    classify(ET->getDecl()->getIntegerType(), OffsetBase, Lo, Hi, isNamedArg);
+    return;
+  }
+
   if (Ty->hasPointerRepresentation()) {
     Current = Integer;
     return;
   }
 
-  assert(false && "Nothing else implemented yet");
-}
+  if (Ty->isMemberPointerType()) {
+    if (Ty->isMemberFunctionPointerType()) {
+      if (Has64BitPointers) {
+        // If Has64BitPointers, this is an {i64, i64}, so classify both
+        // Lo and Hi now.
+        Lo = Hi = Integer;
+      } else {
+        // Otherwise, with 32-bit pointers, this is an {i32, i32}. If that
+        // straddles an eightbyte boundary, Hi should be classified as well.
+        uint64_t EB_FuncPtr = (OffsetBase) / 64;
+        uint64_t EB_ThisAdj = (OffsetBase + 64 - 1) / 64;
+        if (EB_FuncPtr != EB_ThisAdj) {
+          Lo = Hi = Integer;
+        } else {
+          Current = Integer;
+        }
+      }
+    } else {
+      Current = Integer;
+    }
+    return;
+  }
 
-/// GetSSETypeAtOffset - Return a type that will be passed by the backend in the
-/// low 8 bytes of an XMM register, corresponding to the SSE class.
-mlir::Type X86_64ABIInfo::GetSSETypeAtOffset(mlir::Type CIRType,
-                                             unsigned int CIROffset,
-                                             clang::QualType SourceTy,
-                                             unsigned int SourceOffset) const {
-  // TODO: entirely stubbed out
-  assert(CIROffset == 0 && "NYI");
-  assert(SourceOffset == 0 && "NYI");
-  return CIRType;
+  if (const VectorType *VT = Ty->getAs<VectorType>()) {
+    uint64_t Size = getContext().getTypeSize(VT);
+    if (Size == 1 || Size == 8 || Size == 16 || Size == 32) {
+      // gcc passes the following as integer:
+      // 4 bytes - <4 x char>, <2 x short>, <1 x int>, <1 x float>
+      // 2 bytes - <2 x char>, <1 x short>
+      // 1 byte  - <1 x char>
+      Current = Integer;
+
+      // If this type crosses an eightbyte boundary, it should be
+      // split.
+      uint64_t EB_Lo = (OffsetBase) / 64;
+      uint64_t EB_Hi = (OffsetBase + Size - 1) / 64;
+      if (EB_Lo != EB_Hi)
+        Hi = Lo;
+    } else if (Size == 64) {
+      QualType ElementType = VT->getElementType();
+
+      // gcc passes <1 x double> in memory. :(
+      if (ElementType->isSpecificBuiltinType(BuiltinType::Double))
+        return;
+
+      // gcc passes <1 x long long> as SSE but clang used to unconditionally
+      // pass them as integer. For platforms where clang is the de facto
+      // platform compiler, we must continue to use integer.
+      if (!classifyIntegerMMXAsSSE() &&
+          (ElementType->isSpecificBuiltinType(BuiltinType::LongLong) ||
+           ElementType->isSpecificBuiltinType(BuiltinType::ULongLong) ||
+           ElementType->isSpecificBuiltinType(BuiltinType::Long) ||
+           ElementType->isSpecificBuiltinType(BuiltinType::ULong)))
+        Current = Integer;
+      else
+        Current = SSE;
+
+      // If this type crosses an eightbyte boundary, it should be
+      // split.
+      if (OffsetBase && OffsetBase != 64)
+        Hi = Lo;
+    } else if (Size == 128 ||
+               (isNamedArg && Size <= getNativeVectorSizeForAVXABI(AVXLevel))) {
+      QualType ElementType = VT->getElementType();
+
+      // gcc passes 256 and 512 bit <X x __int128> vectors in memory. :(
+      if (passInt128VectorsInMem() && Size != 128 &&
+          (ElementType->isSpecificBuiltinType(BuiltinType::Int128) ||
+           ElementType->isSpecificBuiltinType(BuiltinType::UInt128)))
+        return;
+
+      // Arguments of 256-bits are split into four eightbyte chunks. The
+      // least significant one belongs to class SSE and all the others to class
+      // SSEUP. The original Lo and Hi design considers that types can't be
+      // greater than 128-bits, so a 64-bit split in Hi and Lo makes sense.
+      // This design isn't correct for 256-bits, but since there're no cases
+      // where the upper parts would need to be inspected, avoid adding
+      // complexity and just consider Hi to match the 64-256 part.
+      //
+      // Note that per 3.5.7 of AMD64-ABI, 256-bit args are only passed in
+      // registers if they are "named", i.e. not part of the "..." of a
+      // variadic function.
+      //
+      // Similarly, per 3.2.3. of the AVX512 draft, 512-bits ("named") args are
+      // split into eight eightbyte chunks, one SSE and seven SSEUP.
+      Lo = SSE;
+      Hi = SSEUp;
+    }
+    return;
+  }
+
+  if (const ComplexType *CT = Ty->getAs<ComplexType>()) {
+    QualType ET = getContext().getCanonicalType(CT->getElementType());
+
+    uint64_t Size = getContext().getTypeSize(Ty);
+    if (ET->isIntegralOrEnumerationType()) {
+      if (Size <= 64)
+        Current = Integer;
+      else if (Size <= 128)
+        Lo = Hi = Integer;
+    } else if (ET->isFloat16Type() || ET == getContext().FloatTy) {
+      Current = SSE;
+    } else if (ET == getContext().DoubleTy) {
+      Lo = Hi = SSE;
+    } else if (ET == getContext().LongDoubleTy) {
+      const llvm::fltSemantics *LDF =
+          &getContext().getTargetInfo().getLongDoubleFormat();
+      if (LDF == &llvm::APFloat::IEEEquad())
+        Current = Memory;
+      else if (LDF == &llvm::APFloat::x87DoubleExtended())
+        Current = ComplexX87;
+      else if (LDF == &llvm::APFloat::IEEEdouble())
+        Lo = Hi = SSE;
+      else
+        llvm_unreachable("unexpected long double representation!");
+    }
+
+    // If this complex type crosses an eightbyte boundary then it
+    // should be split.
+    uint64_t EB_Real = (OffsetBase) / 64;
+    uint64_t EB_Imag = (OffsetBase + getContext().getTypeSize(ET)) / 64;
+    if (Hi == NoClass && EB_Real != EB_Imag)
+      Hi = Lo;
+
+    return;
+  }
+
+  if (const auto *EITy = Ty->getAs<BitIntType>()) {
+    if (EITy->getNumBits() <= 64)
+      Current = Integer;
+    else if (EITy->getNumBits() <= 128)
+      Lo = Hi = Integer;
+    // Larger values need to get passed in memory.
+    return;
+  }
+
+  if (const ConstantArrayType *AT = getContext().getAsConstantArrayType(Ty)) {
+    // Arrays are treated like structures.
+
+    uint64_t Size = getContext().getTypeSize(Ty);
+
+    // AMD64-ABI 3.2.3p2: Rule 1. If the size of an object is larger
+    // than eight eightbytes, ..., it has class MEMORY.
+    if (Size > 512)
+      return;
+
+    // AMD64-ABI 3.2.3p2: Rule 1. If ..., or it contains unaligned
+    // fields, it has class MEMORY.
+    //
+    // Only need to check alignment of array base.
+    if (OffsetBase % getContext().getTypeAlign(AT->getElementType()))
+      return;
+
+    // Otherwise implement simplified merge. We could be smarter about
+    // this, but it isn't worth it and would be harder to verify.
+    Current = NoClass;
+    uint64_t EltSize = getContext().getTypeSize(AT->getElementType());
+    uint64_t ArraySize = AT->getSize().getZExtValue();
+
+    // The only case a 256-bit wide vector could be used is when the array
+    // contains a single 256-bit element. Since Lo and Hi logic isn't extended
+    // to work for sizes wider than 128, early check and fallback to memory.
+    //
+    if (Size > 128 &&
+        (Size != EltSize || Size > getNativeVectorSizeForAVXABI(AVXLevel)))
+      return;
+
+    for (uint64_t i = 0, Offset = OffsetBase; i < ArraySize;
+         ++i, Offset += EltSize) {
+      Class FieldLo, FieldHi;
+      classify(AT->getElementType(), Offset, FieldLo, FieldHi, isNamedArg);
+      Lo = merge(Lo, FieldLo);
+      Hi = merge(Hi, FieldHi);
+      if (Lo == Memory || Hi == Memory)
+        break;
+    }
+
+    postMerge(Size, Lo, Hi);
+    assert((Hi != SSEUp || Lo == SSE) && "Invalid SSEUp array classification.");
+    return;
+  }
+
+  if (const RecordType *RT = Ty->getAs<RecordType>()) {
+    uint64_t Size = getContext().getTypeSize(Ty);
+
+    // AMD64-ABI 3.2.3p2: Rule 1. If the size of an object is larger
+    // than eight eightbytes, ..., it has class MEMORY.
+    if (Size > 512)
+      return;
+
+    // AMD64-ABI 3.2.3p2: Rule 2. If a C++ object has either a non-trivial
+    // copy constructor or a non-trivial destructor, it is passed by invisible
+    // reference.
+    if (getRecordArgABI(RT, getCXXABI()) != CIRGenCXXABI::RecordArgABI::Default)
+      return;
+
+    const RecordDecl *RD = RT->getDecl();
+
+    // Assume variable sized types are passed in memory.
+    if (RD->hasFlexibleArrayMember())
+      return;
+
+    const ASTRecordLayout &Layout = getContext().getASTRecordLayout(RD);
+
+    // Reset Lo class, this will be recomputed.
+    Current = NoClass;
+
+    // If this is a C++ record, classify the bases first.
+    if (const CXXRecordDecl *CXXRD = dyn_cast<CXXRecordDecl>(RD)) {
+      for (const auto &I : CXXRD->bases()) {
+        assert(!I.isVirtual() && !I.getType()->isDependentType() &&
+               "Unexpected base class!");
+        const auto *Base =
+            cast<CXXRecordDecl>(I.getType()->castAs<RecordType>()->getDecl());
+
+        // Classify this field.
+        //
+        // AMD64-ABI 3.2.3p2: Rule 3. If the size of the aggregate exceeds a
+        // single eightbyte, each is classified separately. Each eightbyte gets
+        // initialized to class NO_CLASS.
+        Class FieldLo, FieldHi;
+        uint64_t Offset =
+            OffsetBase + getContext().toBits(Layout.getBaseClassOffset(Base));
+        classify(I.getType(), Offset, FieldLo, FieldHi, isNamedArg);
+        Lo = merge(Lo, FieldLo);
+        Hi = merge(Hi, FieldHi);
+        if (Lo == Memory || Hi == Memory) {
+          postMerge(Size, Lo, Hi);
+          return;
+        }
+      }
+    }
+
+    // Classify the fields one at a time, merging the results.
+    unsigned idx = 0;
+    bool UseClang11Compat = getContext().getLangOpts().getClangABICompat() <=
+                                LangOptions::ClangABI::Ver11 ||
+                            getContext().getTargetInfo().getTriple().isPS();
+    bool IsUnion = RT->isUnionType() && !UseClang11Compat;
+
+    for (RecordDecl::field_iterator i = RD->field_begin(), e = RD->field_end();
+         i != e; ++i, ++idx) {
+      uint64_t Offset = OffsetBase + Layout.getFieldOffset(idx);
+      bool BitField = i->isBitField();
+
+      // Ignore padding bit-fields.
+      if (BitField && i->isUnnamedBitfield())
+        continue;
+
+      // AMD64-ABI 3.2.3p2: Rule 1. If the size of an object is larger than
+      // eight eightbytes, or it contains unaligned fields, it has class MEMORY.
+      //
+      // The only case a 256-bit or a 512-bit wide vector could be used is when
+      // the struct contains a single 256-bit or 512-bit element. Early check
+      // and fallback to memory.
+      //
+      // FIXME: Extended the Lo and Hi logic properly to work for size wider
+      // than 128.
+      if (Size > 128 &&
+          ((!IsUnion && Size != getContext().getTypeSize(i->getType())) ||
+           Size > getNativeVectorSizeForAVXABI(AVXLevel))) {
+        Lo = Memory;
+        postMerge(Size, Lo, Hi);
+        return;
+      }
+      // Note, skip this test for bit-fields, see below.
+      if (!BitField && Offset % getContext().getTypeAlign(i->getType())) {
+        Lo = Memory;
+        postMerge(Size, Lo, Hi);
+        return;
+      }
+
+      // Classify this field.
+      //
+      // AMD64-ABI 3.2.3p2: Rule 3. If the size of the aggregate
+      // exceeds a single eightbyte, each is classified
+      // separately. Each eightbyte gets initialized to class
+      // NO_CLASS.
+      Class FieldLo, FieldHi;
+
+      // Bit-fields require special handling, they do not force the
+      // structure to be passed in memory even if unaligned, and
+      // therefore they can straddle an eightbyte.
+      if (BitField) {
+        assert(!i->isUnnamedBitfield());
+        uint64_t Offset = OffsetBase + Layout.getFieldOffset(idx);
+        uint64_t Size = i->getBitWidthValue(getContext());
+
+        uint64_t EB_Lo = Offset / 64;
+        uint64_t EB_Hi = (Offset + Size - 1) / 64;
+
+        if (EB_Lo) {
+          assert(EB_Hi == EB_Lo && "Invalid classification, type > 16 bytes.");
+          FieldLo = NoClass;
+          FieldHi = Integer;
+        } else {
+          FieldLo = Integer;
+          FieldHi = EB_Hi ? Integer : NoClass;
+        }
+      } else
+        classify(i->getType(), Offset, FieldLo, FieldHi, isNamedArg);
+      Lo = merge(Lo, FieldLo);
+      Hi = merge(Hi, FieldHi);
+      if (Lo == Memory || Hi == Memory)
+        break;
+    }
+
+    postMerge(Size, Lo, Hi);
+  }
 }
 
 ABIArgInfo X86_64ABIInfo::classifyReturnType(QualType RetTy) const {
@@ -370,14 +1392,26 @@ ABIArgInfo X86_64ABIInfo::classifyReturnType(QualType RetTy) const {
   assert((Hi != Memory || Lo == Memory) && "Invalid memory classification.");
   assert((Hi != SSEUp || Lo == SSE) && "Invalid SSEUp classification.");
 
+  mlir::Builder Builder(&CGT.getMLIRContext());
   mlir::Type ResType = nullptr;
-  assert(Lo == NoClass || Lo == Integer ||
-         Lo == SSE && "Only NoClass and Integer supported so far");
-
   switch (Lo) {
   case NoClass:
-    assert(Hi == NoClass && "Only NoClass supported so far for Hi");
-    return ABIArgInfo::getIgnore();
+    if (Hi == NoClass)
+      return ABIArgInfo::getIgnore();
+    // If the low part is just padding, it takes no register, leave ResType
+    // null.
+    assert((Hi == SSE || Hi == Integer || Hi == X87Up) &&
+           "Unknown missing lo part");
+    break;
+
+  case SSEUp:
+  case X87Up:
+    llvm_unreachable("Invalid classification for lo word.");
+
+    // AMD64-ABI 3.2.3p4: Rule 2. Types of class memory are returned via
+    // hidden argument.
+  case Memory:
+    return getIndirectReturnResult(RetTy);
 
   // AMD64-ABI 3.2.3p4: Rule 3. If the class is INTEGER, the next available
   // register of the sequence %rax, %rdx is used.
@@ -405,14 +1439,76 @@ ABIArgInfo X86_64ABIInfo::classifyReturnType(QualType RetTy) const {
     ResType = GetSSETypeAtOffset(CGT.ConvertType(RetTy), 0, RetTy, 0);
     break;
 
-  default:
-    llvm_unreachable("NYI");
+    // AMD64-ABI 3.2.3p4: Rule 6. If the class is X87, the value is
+    // returned on the X87 stack in %st0 as 80-bit x87 number.
+  case X87:
+    ResType = Builder.getF80Type();
+    break;
+
+    // AMD64-ABI 3.2.3p4: Rule 8. If the class is COMPLEX_X87, the real
+    // part of the value is returned in %st0 and the imaginary part in
+    // %st1.
+  case ComplexX87:
+    assert(Hi == ComplexX87 && "Unexpected ComplexX87 classification.");
+    ResType = mlir::cir::StructType::get(
+        &CGT.getMLIRContext(), {Builder.getF80Type(), Builder.getF80Type()},
+        "");
+    break;
   }
 
   mlir::Type HighPart = nullptr;
+  switch (Hi) {
+    // Memory was handled previously and X87 should
+    // never occur as a hi class.
+  case Memory:
+  case X87:
+    llvm_unreachable("Invalid classification for hi word.");
+
+  case ComplexX87: // Previously handled.
+  case NoClass:
+    break;
+
+  case Integer:
+    HighPart = GetINTEGERTypeAtOffset(CGT.ConvertType(RetTy), 8, RetTy, 8);
+    if (Lo == NoClass) // Return HighPart at offset 8 in memory.
+      return ABIArgInfo::getDirect(HighPart, 8);
+    break;
+  case SSE:
+    HighPart = GetSSETypeAtOffset(CGT.ConvertType(RetTy), 8, RetTy, 8);
+    if (Lo == NoClass) // Return HighPart at offset 8 in memory.
+      return ABIArgInfo::getDirect(HighPart, 8);
+    break;
+
+    // AMD64-ABI 3.2.3p4: Rule 5. If the class is SSEUP, the eightbyte
+    // is passed in the next available eightbyte chunk if the last used
+    // vector register.
+    //
+    // SSEUP should always be preceded by SSE, just widen.
+  case SSEUp:
+    assert(Lo == SSE && "Unexpected SSEUp classification.");
+    ResType = GetByteVectorType(RetTy);
+    break;
+
+    // AMD64-ABI 3.2.3p4: Rule 7. If the class is X87UP, the value is
+    // returned together with the previous X87 value in %st0.
+  case X87Up:
+    // If X87Up is preceded by X87, we don't need to do
+    // anything. However, in some cases with unions it may not be
+    // preceded by X87. In such situations we follow gcc and pass the
+    // extra bits in an SSE reg.
+    if (Lo != X87) {
+      HighPart = GetSSETypeAtOffset(CGT.ConvertType(RetTy), 8, RetTy, 8);
+      if (Lo == NoClass) // Return HighPart at offset 8 in memory.
+        return ABIArgInfo::getDirect(HighPart, 8);
+    }
+    break;
+  }
 
+  // If a high part was specified, merge it together with the low part. It is
+  // known to pass in the high eightbyte of the result. We do this by forming a
+  // first class struct aggregate with the high and low part: {low, high}
   if (HighPart)
-    assert(false && "NYI");
+    ResType = GetX86_64ByValArgumentPair(ResType, HighPart);
 
   return ABIArgInfo::getDirect(ResType);
 }
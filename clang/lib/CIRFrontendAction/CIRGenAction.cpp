@@ -11,6 +11,7 @@
 #include "mlir/Dialect/Func/IR/FuncOps.h"
 #include "mlir/Dialect/MemRef/IR/MemRef.h"
 #include "mlir/IR/BuiltinOps.h"
+#include "mlir/IR/Diagnostics.h"
 #include "mlir/IR/MLIRContext.h"
 #include "mlir/Parser/Parser.h"
 #include "mlir/IR/OperationSupport.h"
@@ -58,6 +59,43 @@
 using namespace cir;
 using namespace clang;
 
+/// Map a CIR location back to the source location it was built from.
+static SourceLocation getSourceLocation(mlir::Location loc,
+                                        SourceManager &sourceManager) {
+  if (auto fusedLoc = loc.dyn_cast<mlir::FusedLoc>()) {
+    for (auto l : fusedLoc.getLocations()) {
+      auto sourceLoc = getSourceLocation(l, sourceManager);
+      if (sourceLoc.isValid())
+        return sourceLoc;
+    }
+    return SourceLocation();
+  }
+
+  auto fileLoc = loc.dyn_cast<mlir::FileLineColLoc>();
+  if (!fileLoc)
+    return SourceLocation();
+  auto file = sourceManager.getFileManager().getFile(
+      fileLoc.getFilename().getValue());
+  if (!file)
+    return SourceLocation();
+  return sourceManager.translateFileLineCol(*file, fileLoc.getLine(),
+                                            fileLoc.getColumn());
+}
+
+static DiagnosticsEngine::Level getDiagLevel(mlir::DiagnosticSeverity s) {
+  switch (s) {
+  case mlir::DiagnosticSeverity::Note:
+    return DiagnosticsEngine::Note;
+  case mlir::DiagnosticSeverity::Warning:
+    return DiagnosticsEngine::Warning;
+  case mlir::DiagnosticSeverity::Error:
+    return DiagnosticsEngine::Error;
+  case mlir::DiagnosticSeverity::Remark:
+    return DiagnosticsEngine::Remark;
+  }
+  llvm_unreachable("unknown diagnostic severity");
+}
+
 namespace cir {
 class CIRGenConsumer : public clang::ASTConsumer {
 
@@ -124,10 +162,64 @@ public:
     llvm_unreachable("NYI");
   }
 
+  /// Run the CIR based performance lints requested by -cir-perf-lint, and
+  /// report them as clang diagnostics.
+  void runPerfLint(mlir::ModuleOp mlirMod, mlir::MLIRContext &mlirCtx,
+                   SourceManager &sourceManager) {
+    auto report = [&](mlir::Diagnostic &diag) {
+      unsigned diagID = diagnosticsEngine.getCustomDiagID(
+          getDiagLevel(diag.getSeverity()), "%0");
+      diagnosticsEngine.Report(
+          getSourceLocation(diag.getLocation(), sourceManager), diagID)
+          << diag.str();
+    };
+    auto handler = [&](mlir::Diagnostic &diag) {
+      report(diag);
+      for (auto &note : diag.getNotes())
+        report(note);
+      return mlir::success();
+    };
+    mlir::ScopedDiagnosticHandler scopedHandler(&mlirCtx, handler);
+
+    // Findings go next to the optimization records, so that the tools
+    // aggregating those over a codebase pick them up too.
+    std::string reportFile;
+    StringRef optRecordFile = codeGenOptions.OptRecordFile;
+    if (!optRecordFile.empty() && (codeGenOptions.OptRecordFormat.empty() ||
+                                   codeGenOptions.OptRecordFormat == "yaml")) {
+      optRecordFile.consume_back(".opt.yaml");
+      reportFile = (optRecordFile + ".cir.opt.yaml").str();
+    }
+    runCIRPerfLint(mlirMod, &mlirCtx, reportFile);
+  }
+
+  /// Lower the CIR module to LLVM IR and hand it to the LLVM backend, which
+  /// runs the LLVM pipeline for the optimization level before emitting the
+  /// output.
+  void emitBackendOutput(ASTContext &C, mlir::ModuleOp mlirMod,
+                         std::unique_ptr<mlir::MLIRContext> mlirCtx,
+                         BackendAction backendAction) {
+    llvm::LLVMContext llvmCtx;
+    auto llvmModule =
+        feOptions.CIRStreamingLowering
+            ? lowerFromCIRToLLVMIRStreaming(mlirMod, std::move(mlirCtx),
+                                            llvmCtx)
+            : lowerFromCIRToLLVMIR(mlirMod, std::move(mlirCtx), llvmCtx);
+
+    llvmModule->setTargetTriple(targetOptions.Triple);
+
+    EmitBackendOutput(diagnosticsEngine, headerSearchOptions, codeGenOptions,
+                      targetOptions, langOptions,
+                      C.getTargetInfo().getDataLayoutString(),
+                      llvmModule.get(), backendAction,
+                      std::move(outputStream));
+  }
+
   void HandleTranslationUnit(ASTContext &C) override {
     // Note that this method is called after `HandleTopLevelDecl` has already
     // ran all over the top level decls. Here clang mostly wraps defered and
-    // global codegen, followed by running CIR passes.
+    // global codegen, followed by running CIR passes for every output, so
+    // that they affect the generated code as well.
 
     gen->HandleTranslationUnit(C);
     if (!feOptions.DisableCIRVerifier)
@@ -140,44 +232,36 @@ public:
     auto mlirMod = gen->getModule();
     auto mlirCtx = gen->takeContext();
 
+    if (feOptions.CIRPerfLint)
+      runPerfLint(mlirMod, *mlirCtx, C.getSourceManager());
+
+    if (mlirMod && action != CIRGenAction::OutputType::None &&
+        !feOptions.DisableCIRPasses)
+      runCIRToCIRPasses(mlirMod, mlirCtx.get(),
+                        codeGenOptions.OptimizationLevel,
+                        codeGenOptions.OptimizeSize, feOptions.CIRCoroElide,
+                        !feOptions.DisableCIRVerifier);
+
     switch (action) {
     case CIRGenAction::OutputType::EmitCIR:
       if (outputStream && mlirMod) {
-        if (!feOptions.DisableCIRPasses) {
-          runCIRToCIRPasses(mlirMod, mlirCtx.get(),
-                            !feOptions.DisableCIRVerifier);
-        }
         mlir::OpPrintingFlags flags;
         // FIXME: we cannot roundtrip prettyForm=true right now.
         flags.enableDebugInfo(/*prettyForm=*/false);
         mlirMod->print(*outputStream, flags);
       }
       break;
-    case CIRGenAction::OutputType::EmitLLVM: {
-      llvm::LLVMContext llvmCtx;
-      auto llvmModule =
-          lowerFromCIRToLLVMIR(mlirMod, std::move(mlirCtx), llvmCtx);
-      if (outputStream)
-        llvmModule->print(*outputStream, nullptr);
+    case CIRGenAction::OutputType::EmitLLVM:
+      emitBackendOutput(C, mlirMod, std::move(mlirCtx),
+                        BackendAction::Backend_EmitLL);
       break;
-    }
-    case CIRGenAction::OutputType::EmitObj: {
-      // TODO: Don't duplicate this from above
-      llvm::LLVMContext llvmCtx;
-      auto llvmModule =
-          lowerFromCIRToLLVMIR(mlirMod, std::move(mlirCtx), llvmCtx);
-
-      llvmModule->setTargetTriple(targetOptions.Triple);
-
-      EmitBackendOutput(diagnosticsEngine, headerSearchOptions, codeGenOptions,
-                        targetOptions, langOptions,
-                        C.getTargetInfo().getDataLayoutString(),
-                        llvmModule.get(), BackendAction::Backend_EmitObj,
-                        std::move(outputStream));
+    case CIRGenAction::OutputType::EmitObj:
+      emitBackendOutput(C, mlirMod, std::move(mlirCtx),
+                        BackendAction::Backend_EmitObj);
       break;
-    }
     case CIRGenAction::OutputType::EmitAssembly:
-      assert(false && "Not yet implemented");
+      emitBackendOutput(C, mlirMod, std::move(mlirCtx),
+                        BackendAction::Backend_EmitAssembly);
       break;
     case CIRGenAction::OutputType::None:
       break;
@@ -4610,6 +4610,15 @@ void Clang::ConstructJob(Compilation &C, const JobAction &JA,
   if (Args.hasArg(options::OPT_disable_cir_passes))
     CmdArgs.push_back("-disable-cir-passes");
 
+  if (Args.hasArg(options::OPT_cir_streaming_lowering))
+    CmdArgs.push_back("-cir-streaming-lowering");
+
+  if (Args.hasArg(options::OPT_cir_coro_elide))
+    CmdArgs.push_back("-cir-coro-elide");
+
+  if (Args.hasArg(options::OPT_cir_perf_lint))
+    CmdArgs.push_back("-cir-perf-lint");
+
   if (IsOpenMPDevice) {
     // We have to pass the triple of the host if compiling for an OpenMP device.
     std::string NormalizedTriple =
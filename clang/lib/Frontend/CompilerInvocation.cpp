@@ -2823,6 +2823,12 @@ static bool ParseFrontendArgs(FrontendOptions &Opts, ArgList &Args,
   if (Args.hasArg(OPT_disable_cir_verifier))
     Opts.DisableCIRVerifier = true;
 
+  if (Args.hasArg(OPT_cir_streaming_lowering))
+    Opts.CIRStreamingLowering = true;
+
+  if (Args.hasArg(OPT_cir_coro_elide))
+    Opts.CIRCoroElide = true;
+
   if (Args.hasArg(OPT_aux_target_cpu))
     Opts.AuxTargetCPU = std::string(Args.getLastArgValue(OPT_aux_target_cpu));
   if (Args.hasArg(OPT_aux_target_feature))
@@ -0,0 +1,7 @@
+// RUN: not %clang_cc1 -std=c++20 -triple x86_64-unknown-linux-gnu -fenable-clangir -emit-llvm %S/coro-task.cpp -o /dev/null 2>&1 | FileCheck %s
+// RUN: not %clang_cc1 -std=c++20 -triple x86_64-unknown-linux-gnu -fenable-clangir -emit-llvm -cir-streaming-lowering %S/coro-task.cpp -o /dev/null 2>&1 | FileCheck %s
+
+// Coroutines are not split in CIR yet, lowering them to LLVM IR says so
+// instead of failing to legalize their operations.
+
+// CHECK: error: lowering of CIR coroutines to LLVM IR is not supported
@@ -0,0 +1,97 @@
+// RUN: %clang_cc1 -std=c++20 -triple x86_64-unknown-linux-gnu -fenable-clangir -emit-cir %s -o %t.cir
+// RUN: FileCheck --input-file=%t.cir %s --check-prefix=CORO
+// RUN: FileCheck --input-file=%t.cir %s --check-prefix=HANDLE
+
+// A minimal task type. The coroutine keeps its structure in CIR: the frame is
+// allocated and freed by its own operations and every suspend point is a
+// cir.await. The std::coroutine_handle builtins are operations as well.
+
+namespace std {
+template <typename Ret, typename... Args> struct coroutine_traits {
+  using promise_type = typename Ret::promise_type;
+};
+
+template <typename Promise> struct coroutine_handle {
+  void *ptr;
+  coroutine_handle(void *p) noexcept : ptr(p) {}
+  static coroutine_handle from_address(void *addr) noexcept { return {addr}; }
+  static coroutine_handle from_promise(Promise &promise) noexcept {
+    return {__builtin_coro_promise(&promise, alignof(Promise), true)};
+  }
+  bool done() const noexcept { return __builtin_coro_done(ptr); }
+  void resume() const { __builtin_coro_resume(ptr); }
+  void destroy() const { __builtin_coro_destroy(ptr); }
+};
+} // namespace std
+
+struct suspend_always {
+  int unused;
+  suspend_always() noexcept {}
+  bool await_ready() noexcept { return false; }
+  template <typename P> void await_suspend(std::coroutine_handle<P>) noexcept {}
+  void await_resume() noexcept {}
+};
+
+struct read_value {
+  int value;
+  read_value(int v) noexcept : value(v) {}
+  bool await_ready() noexcept { return false; }
+  template <typename P> void await_suspend(std::coroutine_handle<P>) noexcept {}
+  int await_resume() noexcept { return value; }
+};
+
+struct task {
+  struct promise_type {
+    int value;
+    task get_return_object() noexcept {
+      return {std::coroutine_handle<promise_type>::from_promise(*this)};
+    }
+    suspend_always initial_suspend() noexcept { return {}; }
+    suspend_always final_suspend() noexcept { return {}; }
+    suspend_always yield_value(int v) noexcept {
+      value = v;
+      return {};
+    }
+    void return_value(int v) noexcept { value = v; }
+  };
+
+  void *frame;
+  task(std::coroutine_handle<promise_type> h) noexcept : frame(h.ptr) {}
+};
+
+task gen(int n) {
+  int v = co_await read_value{n};
+  co_yield v;
+  co_return v + 1;
+}
+
+// CORO-LABEL: cir.func @_Z3geni(
+// CORO-SAME: coroutine
+// CORO: cir.alloca {{.*}}["__promise"{{.*}}coro_promise
+// CORO: cir.coro.alloc_frame : !cir.ptr<i8> alloc {
+// CORO: cir.call @_Znwm(
+// CORO: cir.yield
+// CORO: cir.call @_ZN4task12promise_type17get_return_objectEv(
+// CORO: cir.await(init, ready : {
+// CORO: cir.await(user, ready : {
+// CORO: cir.call @_ZN10read_value12await_resumeEv(
+// CORO: cir.call @_ZN4task12promise_type11yield_valueEi(
+// CORO: cir.await(yield, ready : {
+// CORO: cir.call @_ZN4task12promise_type12return_valueEi(
+// CORO: cir.await(final, ready : {
+// CORO: cir.coro.free_frame %{{.+}} : !cir.ptr<i8> dealloc {
+// CORO: cir.call @_ZdlPv
+
+void drive(void *frame) {
+  auto h = std::coroutine_handle<task::promise_type>::from_address(frame);
+  if (!h.done())
+    h.resume();
+  h.destroy();
+}
+
+// HANDLE-DAG: cir.coro.promise from_promise %{{.+}} : !cir.ptr<i8>, !cir.ptr<i8> {alignment = 4 : i64}
+// HANDLE-DAG: cir.coro.done %{{.+}} : !cir.ptr<i8>, !cir.bool
+// HANDLE-DAG: cir.coro.resume %{{.+}} : !cir.ptr<i8>
+// HANDLE-DAG: cir.coro.destroy %{{.+}} : !cir.ptr<i8>
+// HANDLE-DAG: cir.call @_ZNKSt16coroutine_handleIN4task12promise_typeEE6resumeEv(
+// HANDLE-DAG: cir.call @_ZNKSt16coroutine_handleIN4task12promise_typeEE7destroyEv(
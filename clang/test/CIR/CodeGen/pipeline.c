@@ -0,0 +1,14 @@
+// RUN: %clang_cc1 -triple x86_64-unknown-linux-gnu -fenable-clangir -emit-cir -O0 %s -o - | FileCheck %s --check-prefix=O0
+// RUN: %clang_cc1 -triple x86_64-unknown-linux-gnu -fenable-clangir -emit-cir -O2 %s -o - | FileCheck %s --check-prefix=O2
+// RUN: %clang_cc1 -triple x86_64-unknown-linux-gnu -fenable-clangir -emit-cir -O2 -disable-cir-passes %s -o - | FileCheck %s --check-prefix=O0
+
+// Function attributes are only inferred from -O1 on.
+
+int identity(int x) { return x; }
+
+// O0: cir.func @identity(
+// O0-NOT: memory_effects
+// O0-NOT: nothrow
+// O0: cir.return
+
+// O2: cir.func @identity({{.*}}) -> i32 attributes {memory_effects = 1 : i32, nothrow}
@@ -0,0 +1,10 @@
+// RUN: not %clang_cc1 -triple x86_64-unknown-linux-gnu -fenable-clangir -emit-llvm -cir-streaming-lowering %s -o /dev/null 2>&1 | FileCheck %s
+
+// Globals cannot be lowered to LLVM IR yet, streaming lowering says so
+// before lowering any function.
+
+int counter = 1;
+
+int get(void) { return counter; }
+
+// CHECK: error: streaming lowering of CIR globals is not supported
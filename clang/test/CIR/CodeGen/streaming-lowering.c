@@ -0,0 +1,25 @@
+// RUN: %clang_cc1 -triple x86_64-unknown-linux-gnu -fenable-clangir -emit-llvm %s -o %t.ll
+// RUN: %clang_cc1 -triple x86_64-unknown-linux-gnu -fenable-clangir -emit-llvm -cir-streaming-lowering %s -o %t.streaming.ll
+// RUN: FileCheck %s --input-file=%t.ll
+// RUN: FileCheck %s --input-file=%t.streaming.ll
+// RUN: FileCheck %s --check-prefix=DECL --input-file=%t.ll
+// RUN: FileCheck %s --check-prefix=DECL --input-file=%t.streaming.ll
+
+// Lowering one function at a time gives the same functions as lowering the
+// whole module, only declarations may come in another order.
+
+int ext(int);
+
+int callee(int x) { return x; }
+
+int caller(int x) { return callee(ext(x)); }
+
+// CHECK-LABEL: define {{.*}}i32 @callee(i32
+// CHECK: ret i32
+
+// CHECK-LABEL: define {{.*}}i32 @caller(i32
+// CHECK: call i32 @ext(i32
+// CHECK: call i32 @callee(i32
+// CHECK: ret i32
+
+// DECL: declare {{.*}}i32 @ext(i32
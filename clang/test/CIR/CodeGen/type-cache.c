@@ -0,0 +1,43 @@
+// RUN: %clang_cc1 -triple x86_64-unknown-linux-gnu -fenable-clangir -emit-cir %s -o - | FileCheck %s
+// RUN: %clang_cc1 -triple x86_64-unknown-linux-gnu -fenable-clangir -emit-cir -print-stats %s -o /dev/null 2>&1 | FileCheck %s --check-prefix=STATS
+// REQUIRES: asserts
+
+// A function type using a record which cannot be laid out yet is converted
+// to a placeholder. Once the record is laid out, only the cached types
+// derived from the placeholder are converted again.
+
+// The function type is converted while `struct Node` is being laid out.
+struct Node {
+  void (*visit)(struct Node);
+  int value;
+};
+
+// CHECK-LABEL: cir.func @walk(
+// CHECK-SAME: %arg0: !cir.ptr<({{.*}}) -> ()>
+void walk(void (*visit)(struct Node), struct Node *node) {}
+
+// The function types are converted before `struct Late` is complete.
+struct Late;
+
+void early(void (*fp)(struct Late)) {}
+void early_indirect(void (**fpp)(struct Late)) {}
+
+// Types unrelated to `struct Late`, which stay in the cache.
+void unrelated(int *a, long *b, short *c, char *d, float *e, double *f,
+               unsigned *g, int **h, long **i, short **j) {}
+
+struct Late {
+  int x;
+};
+
+// CHECK-LABEL: cir.func @late(
+// CHECK-SAME: %arg0: !cir.ptr<({{.*}}) -> ()>
+void late(void (*fp)(struct Late)) {}
+
+// CHECK-LABEL: cir.func @late_indirect(
+// CHECK-SAME: %arg0: !cir.ptr<!cir.ptr<({{.*}}) -> ()>>
+void late_indirect(void (**fpp)(struct Late)) {}
+
+// Only a handful of types derive from the placeholders, unlike the pointer
+// types of @unrelated.
+// STATS: {{^ *[1-9] cir-types - Number of cached type conversions invalidated}}
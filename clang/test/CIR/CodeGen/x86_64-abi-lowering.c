@@ -0,0 +1,31 @@
+// RUN: %clang_cc1 -triple x86_64-unknown-linux-gnu -fenable-clangir -emit-llvm %s -o - | FileCheck %s
+// RUN: not %clang_cc1 -triple x86_64-unknown-linux-gnu -fenable-clangir -emit-llvm -DPAIR %s -o /dev/null 2>&1 | FileCheck %s --check-prefix=RECORD
+// RUN: not %clang_cc1 -triple x86_64-unknown-linux-gnu -fenable-clangir -emit-llvm -DBYVAL %s -o /dev/null 2>&1 | FileCheck %s --check-prefix=RECORD
+
+// An x87 long double survives the lowering to LLVM. Records do not lower
+// yet, see x86_64-abi.cpp for their CIR: rather than emitting IR that does
+// not follow the ABI, the lowering stops at the first one.
+
+long double pass_ld(long double x) { return x; }
+
+// CHECK-LABEL: define {{.*}}x86_fp80 @pass_ld(x86_fp80
+// CHECK: ret x86_fp80
+
+#ifdef PAIR
+// Coerced to an SSE and INTEGER {lo, hi} pair.
+struct DI {
+  double d;
+  int i;
+};
+void take_di(struct DI s) {}
+#endif
+
+#ifdef BYVAL
+// Passed byval.
+struct Big {
+  long a, b, c;
+};
+void take_big(struct Big s) {}
+#endif
+
+// RECORD: error: lowering of CIR records to LLVM IR is not supported
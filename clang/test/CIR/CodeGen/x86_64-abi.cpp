@@ -0,0 +1,121 @@
+// RUN: %clang_cc1 -std=c++17 -triple x86_64-unknown-linux-gnu -fenable-clangir -emit-cir %s -o - | FileCheck %s
+
+// Arguments and results are passed as the SysV x86-64 ABI classifies them.
+// Records are returned with a copy, which C++ emits for trivially copyable
+// records.
+
+// CHECK-DAG: !cir.struct<"struct.DI", f64, i32>
+// CHECK-DAG: !cir.struct<"struct.II", i32, i32>
+// CHECK-DAG: !cir.struct<"struct.Big", i64, i64, i64>
+// CHECK-DAG: !cir.struct<"union.U", i32>
+
+// An SSE and an INTEGER eightbyte form an unnamed {lo, hi} pair.
+struct DI {
+  double d;
+  int i;
+};
+extern "C" DI pass_di(DI s) { return s; }
+
+// CHECK-LABEL: cir.func @pass_di(
+// CHECK-SAME: %arg0: !cir.struct<"", f64, i32>
+// CHECK-SAME: -> !cir.struct<"", f64, i32>
+
+// A single INTEGER eightbyte is coerced to an integer covering it.
+struct II {
+  int a;
+  int b;
+};
+extern "C" II pass_ii(II s) { return s; }
+
+// CHECK-LABEL: cir.func @pass_ii(
+// CHECK-SAME: %arg0: i64
+// CHECK-SAME: -> i64
+
+// Records larger than 16 bytes are returned through an sret pointer and
+// passed byval.
+struct Big {
+  long a, b, c;
+};
+extern "C" Big pass_big(Big s) { return s; }
+
+// CHECK-LABEL: cir.func @pass_big(
+// CHECK-SAME: %arg0: !cir.ptr<{{.*}}> {cir.align = 8 : i64, cir.sret}
+// CHECK-SAME: %arg1: !cir.ptr<{{.*}}> {cir.align = 8 : i64, cir.byval}) {
+
+// __int128 takes two INTEGER eightbytes.
+extern "C" __int128 pass_i128(__int128 x) { return x; }
+
+// CHECK-LABEL: cir.func @pass_i128(
+// CHECK-SAME: %arg0: !cir.struct<"", i64, i64>
+// CHECK-SAME: -> !cir.struct<"", i64, i64>
+// CHECK: cir.alloca i128
+
+// An x87 long double is passed in memory by the backend, and returned in
+// %st0.
+extern "C" long double pass_ld(long double x) { return x; }
+
+// CHECK-LABEL: cir.func @pass_ld(
+// CHECK-SAME: %arg0: f80
+// CHECK-SAME: -> f80
+
+// A union of an integer and a float is classified INTEGER.
+union U {
+  int i;
+  float f;
+};
+extern "C" U pass_u(U u) { return u; }
+
+// CHECK-LABEL: cir.func @pass_u(
+// CHECK-SAME: %arg0: i32
+// CHECK-SAME: -> i32
+
+// An INTEGER and an SSE eightbyte form the pair in the other order.
+struct ID {
+  int i;
+  double d;
+};
+extern "C" ID pass_id(ID s) { return s; }
+
+// CHECK-LABEL: cir.func @pass_id(
+// CHECK-SAME: %arg0: !cir.struct<"", i32, f64>
+// CHECK-SAME: -> !cir.struct<"", i32, f64>
+
+// At a call site, coerced arguments are loaded as their coerced type from the
+// temporary holding the argument, and coerced results are stored to a
+// temporary of their own before being copied to their destination.
+extern "C" DI call_di(DI s) { return pass_di(s); }
+
+// CHECK-LABEL: cir.func @call_di(
+// CHECK: %[[DI_ARG:.+]] = cir.load %{{.+}} : cir.ptr <!cir.struct<"", f64, i32>>, !cir.struct<"", f64, i32>
+// CHECK: %[[DI_RES:.+]] = cir.call @pass_di(%[[DI_ARG]]) : (!cir.struct<"", f64, i32>) -> !cir.struct<"", f64, i32>
+// CHECK: cir.store %[[DI_RES]], %{{.+}} : !cir.struct<"", f64, i32>, cir.ptr <!cir.struct<"", f64, i32>>
+
+extern "C" ID call_id(ID s) { return pass_id(s); }
+
+// CHECK-LABEL: cir.func @call_id(
+// CHECK: %[[ID_ARG:.+]] = cir.load %{{.+}} : cir.ptr <!cir.struct<"", i32, f64>>, !cir.struct<"", i32, f64>
+// CHECK: %[[ID_RES:.+]] = cir.call @pass_id(%[[ID_ARG]]) : (!cir.struct<"", i32, f64>) -> !cir.struct<"", i32, f64>
+// CHECK: cir.store %[[ID_RES]], %{{.+}} : !cir.struct<"", i32, f64>, cir.ptr <!cir.struct<"", i32, f64>>
+
+extern "C" II call_ii(II s) { return pass_ii(s); }
+
+// CHECK-LABEL: cir.func @call_ii(
+// CHECK: %[[II_ARG:.+]] = cir.load %{{.+}} : cir.ptr <i64>, i64
+// CHECK: %[[II_RES:.+]] = cir.call @pass_ii(%[[II_ARG]]) : (i64) -> i64
+// CHECK: cir.store %[[II_RES]], %{{.+}} : i64, cir.ptr <i64>
+
+// A result returned through an sret pointer is written straight to the
+// destination, here the sret argument of the caller, or to a temporary when
+// it is discarded. Byval arguments pass a copy of the argument.
+extern "C" Big call_big(Big s) { return pass_big(s); }
+
+// CHECK-LABEL: cir.func @call_big(
+// CHECK: %[[BIG_COPY:.+]] = cir.alloca !cir.struct<"struct.Big", i64, i64, i64>, cir.ptr <!cir.struct<"struct.Big", i64, i64, i64>>, ["agg.tmp"
+// CHECK: cir.call @pass_big(%arg0, %[[BIG_COPY]])
+
+extern "C" void drop_big(Big s) { pass_big(s); }
+
+// CHECK-LABEL: cir.func @drop_big(
+// CHECK: %[[BIG_RES:.+]] = cir.alloca !cir.struct<"struct.Big", i64, i64, i64>, cir.ptr <!cir.struct<"struct.Big", i64, i64, i64>>, ["agg-temp"
+// CHECK: %[[BIG_ARG:.+]] = cir.alloca !cir.struct<"struct.Big", i64, i64, i64>, cir.ptr <!cir.struct<"struct.Big", i64, i64, i64>>, ["agg.tmp"
+// CHECK: cir.call @pass_big(%[[BIG_RES]], %[[BIG_ARG]])
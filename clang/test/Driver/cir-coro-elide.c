@@ -0,0 +1,8 @@
+// RUN: %clang -### -target x86_64-unknown-linux -c -fenable-clangir -O2 %s 2>&1 | FileCheck -check-prefix=NO-ELIDE %s
+// RUN: %clang -### -target x86_64-unknown-linux -c -fenable-clangir -O2 -cir-coro-elide %s 2>&1 | FileCheck -check-prefix=ELIDE %s
+
+// Coroutine frames are only elided in CIR on request.
+// ELIDE: "-cc1"
+// ELIDE-SAME: "-cir-coro-elide"
+
+// NO-ELIDE-NOT: -cir-coro-elide
@@ -0,0 +1,9 @@
+// RUN: %clang -### -target x86_64-unknown-linux -c %s 2>&1 | FileCheck -check-prefix=NO-LINT %s
+// RUN: %clang -### -target x86_64-unknown-linux -c -fenable-clangir -cir-perf-lint %s 2>&1 | FileCheck -check-prefix=LINT %s
+
+// The CIR performance lints do not turn on the Sema CIR based warnings.
+// LINT: "-cc1"
+// LINT-SAME: "-cir-perf-lint"
+// LINT-NOT: -fcir-warnings
+
+// NO-LINT-NOT: -cir-perf-lint
@@ -0,0 +1,14 @@
+// UNSUPPORTED: system-windows
+
+// Formatting in place keeps the permissions of the file, whatever the umask.
+// RUN: rm -rf %t.dir
+// RUN: mkdir %t.dir
+// RUN: echo "int   f ( ) ;" > %t.dir/file.cpp
+// RUN: chmod 0664 %t.dir/file.cpp
+// RUN: umask 0077
+// RUN: clang-format -style=LLVM -i %t.dir/file.cpp
+// RUN: ls -l %t.dir/file.cpp | cut -f 1 -d ' ' | FileCheck %s
+// RUN: FileCheck --check-prefix=CODE %s < %t.dir/file.cpp
+
+// CHECK: -rw-rw-r--
+// CODE: int f();
@@ -0,0 +1,18 @@
+// RUN: rm -rf %t.dir
+// RUN: mkdir %t.dir
+// RUN: echo "int   first ( ) ;" > %t.dir/first.cpp
+// RUN: echo "int   second ( ) ;" > %t.dir/second.cpp
+// RUN: echo "int   third ( ) ;" > %t.dir/third.cpp
+
+// The output of every file comes in the order of the files.
+// RUN: clang-format -style=LLVM -j 3 %t.dir/first.cpp %t.dir/second.cpp %t.dir/third.cpp | FileCheck %s
+// RUN: clang-format -style=LLVM -j 0 %t.dir/first.cpp %t.dir/second.cpp %t.dir/third.cpp | FileCheck %s
+
+// In place, without leaving temporary files behind.
+// RUN: clang-format -style=LLVM -j 3 -i %t.dir/first.cpp %t.dir/second.cpp %t.dir/third.cpp
+// RUN: cat %t.dir/first.cpp %t.dir/second.cpp %t.dir/third.cpp | FileCheck %s
+// RUN: ls %t.dir | count 3
+
+// CHECK: int first();
+// CHECK-NEXT: int second();
+// CHECK-NEXT: int third();
@@ -24,7 +24,11 @@
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/InitLLVM.h"
 #include "llvm/Support/Process.h"
+#include "llvm/Support/Signals.h"
+#include "llvm/Support/ThreadPool.h"
 #include <fstream>
+#include <map>
+#include <mutex>
 
 using namespace llvm;
 using clang::tooling::Replacements;
@@ -133,6 +137,14 @@ static cl::opt<bool>
     Verbose("verbose", cl::desc("If set, shows the list of processed files"),
             cl::cat(ClangFormatCategory));
 
+static cl::opt<unsigned>
+    NumThreads("j",
+               cl::desc("Number of files to format in parallel\n"
+                        "(0 = number of hardware threads).\n"
+                        "The output of every file is still written\n"
+                        "in the order of the files."),
+               cl::init(1), cl::cat(ClangFormatCategory));
+
 // Use --dry-run to match other LLVM tools when you mean do it but don't
 // actually do it
 static cl::opt<bool>
@@ -223,8 +235,8 @@ static bool parseLineRange(StringRef Input, unsigned &FromLine,
          LineRange.second.getAsInteger(0, ToLine);
 }
 
-static bool fillRanges(MemoryBuffer *Code,
-                       std::vector<tooling::Range> &Ranges) {
+static bool fillRanges(MemoryBuffer *Code, std::vector<tooling::Range> &Ranges,
+                       raw_ostream &ErrOS) {
   IntrusiveRefCntPtr<llvm::vfs::InMemoryFileSystem> InMemoryFileSystem(
       new llvm::vfs::InMemoryFileSystem);
   FileManager Files(FileSystemOptions(), InMemoryFileSystem);
@@ -236,22 +248,22 @@ static bool fillRanges(MemoryBuffer *Code,
                                  InMemoryFileSystem.get());
   if (!LineRanges.empty()) {
     if (!Offsets.empty() || !Lengths.empty()) {
-      errs() << "error: cannot use -lines with -offset/-length\n";
+      ErrOS << "error: cannot use -lines with -offset/-length\n";
       return true;
     }
 
     for (unsigned i = 0, e = LineRanges.size(); i < e; ++i) {
       unsigned FromLine, ToLine;
       if (parseLineRange(LineRanges[i], FromLine, ToLine)) {
-        errs() << "error: invalid <start line>:<end line> pair\n";
+        ErrOS << "error: invalid <start line>:<end line> pair\n";
         return true;
       }
       if (FromLine < 1) {
-        errs() << "error: start line should be at least 1\n";
+        ErrOS << "error: start line should be at least 1\n";
         return true;
       }
       if (FromLine > ToLine) {
-        errs() << "error: start line should not exceed end line\n";
+        ErrOS << "error: start line should not exceed end line\n";
         return true;
       }
       SourceLocation Start = Sources.translateLineCol(ID, FromLine, 1);
@@ -265,26 +277,28 @@ static bool fillRanges(MemoryBuffer *Code,
     return false;
   }
 
-  if (Offsets.empty())
-    Offsets.push_back(0);
-  if (Offsets.size() != Lengths.size() &&
-      !(Offsets.size() == 1 && Lengths.empty())) {
-    errs() << "error: number of -offset and -length arguments must match.\n";
+  // Files may be formatted in parallel, leave the options alone.
+  std::vector<unsigned> FileOffsets(Offsets.begin(), Offsets.end());
+  if (FileOffsets.empty())
+    FileOffsets.push_back(0);
+  if (FileOffsets.size() != Lengths.size() &&
+      !(FileOffsets.size() == 1 && Lengths.empty())) {
+    ErrOS << "error: number of -offset and -length arguments must match.\n";
     return true;
   }
-  for (unsigned i = 0, e = Offsets.size(); i != e; ++i) {
-    if (Offsets[i] >= Code->getBufferSize()) {
-      errs() << "error: offset " << Offsets[i] << " is outside the file\n";
+  for (unsigned i = 0, e = FileOffsets.size(); i != e; ++i) {
+    if (FileOffsets[i] >= Code->getBufferSize()) {
+      ErrOS << "error: offset " << FileOffsets[i] << " is outside the file\n";
       return true;
     }
     SourceLocation Start =
-        Sources.getLocForStartOfFile(ID).getLocWithOffset(Offsets[i]);
+        Sources.getLocForStartOfFile(ID).getLocWithOffset(FileOffsets[i]);
     SourceLocation End;
     if (i < Lengths.size()) {
-      if (Offsets[i] + Lengths[i] > Code->getBufferSize()) {
-        errs() << "error: invalid length " << Lengths[i]
-               << ", offset + length (" << Offsets[i] + Lengths[i]
-               << ") is outside the file.\n";
+      if (FileOffsets[i] + Lengths[i] > Code->getBufferSize()) {
+        ErrOS << "error: invalid length " << Lengths[i]
+              << ", offset + length (" << FileOffsets[i] + Lengths[i]
+              << ") is outside the file.\n";
         return true;
       }
       End = Start.getLocWithOffset(Lengths[i]);
@@ -298,47 +312,49 @@ static bool fillRanges(MemoryBuffer *Code,
   return false;
 }
 
-static void outputReplacementXML(StringRef Text) {
+static void outputReplacementXML(StringRef Text, raw_ostream &OS) {
   // FIXME: When we sort includes, we need to make sure the stream is correct
   // utf-8.
   size_t From = 0;
   size_t Index;
   while ((Index = Text.find_first_of("\n\r<&", From)) != StringRef::npos) {
-    outs() << Text.substr(From, Index - From);
+    OS << Text.substr(From, Index - From);
     switch (Text[Index]) {
     case '\n':
-      outs() << "&#10;";
+      OS << "&#10;";
       break;
     case '\r':
-      outs() << "&#13;";
+      OS << "&#13;";
       break;
     case '<':
-      outs() << "&lt;";
+      OS << "&lt;";
       break;
     case '&':
-      outs() << "&amp;";
+      OS << "&amp;";
       break;
     default:
       llvm_unreachable("Unexpected character encountered!");
     }
     From = Index + 1;
   }
-  outs() << Text.substr(From);
+  OS << Text.substr(From);
 }
 
-static void outputReplacementsXML(const Replacements &Replaces) {
+static void outputReplacementsXML(const Replacements &Replaces,
+                                  raw_ostream &OS) {
   for (const auto &R : Replaces) {
-    outs() << "<replacement "
+    OS << "<replacement "
            << "offset='" << R.getOffset() << "' "
            << "length='" << R.getLength() << "'>";
-    outputReplacementXML(R.getReplacementText());
-    outs() << "</replacement>\n";
+    outputReplacementXML(R.getReplacementText(), OS);
+    OS << "</replacement>\n";
   }
 }
 
 static bool
 emitReplacementWarnings(const Replacements &Replaces, StringRef AssumedFileName,
-                        const std::unique_ptr<llvm::MemoryBuffer> &Code) {
+                        const std::unique_ptr<llvm::MemoryBuffer> &Code,
+                        raw_ostream &ErrOS) {
   if (Replaces.empty())
     return false;
 
@@ -356,7 +372,7 @@ emitReplacementWarnings(const Replacements &Replaces, StringRef AssumedFileName,
                            : SourceMgr::DiagKind::DK_Warning,
           "code should be clang-formatted [-Wclang-format-violations]");
 
-      Diag.print(nullptr, llvm::errs(), (ShowColors && !NoShowColors));
+      Diag.print(nullptr, ErrOS, (ShowColors && !NoShowColors));
       if (ErrorLimit && ++Errors >= ErrorLimit)
         break;
     }
@@ -368,20 +384,20 @@ static void outputXML(const Replacements &Replaces,
                       const Replacements &FormatChanges,
                       const FormattingAttemptStatus &Status,
                       const cl::opt<unsigned> &Cursor,
-                      unsigned CursorPosition) {
-  outs() << "<?xml version='1.0'?>\n<replacements "
-            "xml:space='preserve' incomplete_format='"
-         << (Status.FormatComplete ? "false" : "true") << "'";
+                      unsigned CursorPosition, raw_ostream &OS) {
+  OS << "<?xml version='1.0'?>\n<replacements "
+        "xml:space='preserve' incomplete_format='"
+     << (Status.FormatComplete ? "false" : "true") << "'";
   if (!Status.FormatComplete)
-    outs() << " line='" << Status.Line << "'";
-  outs() << ">\n";
+    OS << " line='" << Status.Line << "'";
+  OS << ">\n";
   if (Cursor.getNumOccurrences() != 0) {
-    outs() << "<cursor>" << FormatChanges.getShiftedCodePosition(CursorPosition)
-           << "</cursor>\n";
+    OS << "<cursor>" << FormatChanges.getShiftedCodePosition(CursorPosition)
+       << "</cursor>\n";
   }
 
-  outputReplacementsXML(Replaces);
-  outs() << "</replacements>\n";
+  outputReplacementsXML(Replaces, OS);
+  OS << "</replacements>\n";
 }
 
 class ClangFormatDiagConsumer : public DiagnosticConsumer {
@@ -392,14 +408,139 @@ class ClangFormatDiagConsumer : public DiagnosticConsumer {
 
     SmallVector<char, 16> vec;
     Info.FormatDiagnostic(vec);
-    errs() << "clang-format error:" << vec << "\n";
+    ErrOS << "clang-format error:" << vec << "\n";
   }
+
+  raw_ostream &ErrOS;
+
+public:
+  ClangFormatDiagConsumer(raw_ostream &ErrOS) : ErrOS(ErrOS) {}
+};
+
+namespace {
+// Styles by directory and language. getStyle() looks for the .clang-format
+// files up the directory tree and parses them again for every file, which
+// dominates the time to format small files: all the files of a directory get
+// the same style.
+class StyleCache {
+public:
+  llvm::Expected<FormatStyle> get(StringRef FileName, StringRef Code);
+
+private:
+  struct Entry {
+    llvm::Optional<FormatStyle> Style;
+    std::string Error;
+  };
+
+  std::mutex Mutex;
+  std::map<std::pair<std::string, FormatStyle::LanguageKind>, Entry> Entries;
 };
+} // namespace
+
+llvm::Expected<FormatStyle> StyleCache::get(StringRef FileName,
+                                            StringRef Code) {
+  auto computeStyle = [&] {
+    return getStyle(Style, FileName, FallbackStyle, Code, nullptr,
+                    WNoErrorList.isSet(WNoError::Unknown));
+  };
+  SmallString<128> Dir(FileName);
+  if (llvm::sys::fs::make_absolute(Dir))
+    return computeStyle();
+  llvm::sys::path::remove_filename(Dir);
+  auto Key = std::make_pair(std::string(Dir), guessLanguage(FileName, Code));
+
+  {
+    std::lock_guard<std::mutex> Lock(Mutex);
+    auto It = Entries.find(Key);
+    if (It != Entries.end()) {
+      if (It->second.Style)
+        return *It->second.Style;
+      return llvm::createStringError(llvm::inconvertibleErrorCode(),
+                                     It->second.Error);
+    }
+  }
+
+  // Files of the same directory formatted at the same time may all compute
+  // the style, the first one to finish fills the cache.
+  llvm::Expected<FormatStyle> Result = computeStyle();
+  Entry NewEntry;
+  if (Result) {
+    NewEntry.Style = *Result;
+  } else {
+    NewEntry.Error = llvm::toString(Result.takeError());
+    Result = llvm::createStringError(llvm::inconvertibleErrorCode(),
+                                     NewEntry.Error);
+  }
+  std::lock_guard<std::mutex> Lock(Mutex);
+  Entries.emplace(std::move(Key), std::move(NewEntry));
+  return Result;
+}
+
+static StyleCache &getStyleCache() {
+  static StyleCache Cache;
+  return Cache;
+}
+
+// Replaces the contents of FileName with Code. They are written to a
+// temporary file next to it, with the same permissions, which is then renamed
+// over it: nothing ever sees the file half written, even when the run is
+// interrupted. Returns true on error.
+static bool writeFileInPlace(StringRef FileName, StringRef Code,
+                             raw_ostream &ErrOS) {
+  llvm::sys::fs::file_status Status;
+  if (std::error_code EC = llvm::sys::fs::status(FileName, Status)) {
+    ErrOS << "error: cannot stat '" << FileName << "': " << EC.message()
+          << "\n";
+    return true;
+  }
+
+  SmallString<128> TempName;
+  int FD;
+  if (std::error_code EC = llvm::sys::fs::createUniqueFile(
+          FileName + "-%%%%%%%%", FD, TempName, llvm::sys::fs::OF_None,
+          Status.permissions())) {
+    ErrOS << "error: cannot create a temporary file for '" << FileName
+          << "': " << EC.message() << "\n";
+    return true;
+  }
+  llvm::sys::RemoveFileOnSignal(TempName);
+
+  auto Fail = [&](StringRef What, std::error_code EC) {
+    ErrOS << "error: cannot " << What << " '" << TempName
+          << "': " << EC.message() << "\n";
+    llvm::sys::fs::remove(TempName);
+    llvm::sys::DontRemoveFileOnSignal(TempName);
+    return true;
+  };
+
+  // The permissions given to createUniqueFile are masked by the umask.
+  if (std::error_code EC =
+          llvm::sys::fs::setPermissions(FD, Status.permissions())) {
+    llvm::sys::Process::SafelyCloseFileDescriptor(FD);
+    return Fail("set the permissions of", EC);
+  }
+
+  {
+    llvm::raw_fd_ostream OS(FD, /*shouldClose=*/true);
+    OS << Code;
+    OS.close();
+    if (OS.has_error()) {
+      std::error_code EC = OS.error();
+      OS.clear_error();
+      return Fail("write", EC);
+    }
+  }
+  if (std::error_code EC = llvm::sys::fs::rename(TempName, FileName))
+    return Fail("rename", EC);
+  llvm::sys::DontRemoveFileOnSignal(TempName);
+  return false;
+}
 
 // Returns true on error.
-static bool format(StringRef FileName) {
+static bool format(StringRef FileName, raw_ostream &OS,
+                   raw_ostream &ErrOS) {
   if (!OutputXML && Inplace && FileName == "-") {
-    errs() << "error: cannot use -i when reading from stdin.\n";
+    ErrOS << "error: cannot use -i when reading from stdin.\n";
     return false;
   }
   // On Windows, overwriting a file with an open file mapping doesn't work,
@@ -408,7 +549,7 @@ static bool format(StringRef FileName) {
       !OutputXML && Inplace ? MemoryBuffer::getFileAsStream(FileName)
                             : MemoryBuffer::getFileOrSTDIN(FileName);
   if (std::error_code EC = CodeOrErr.getError()) {
-    errs() << EC.message() << "\n";
+    ErrOS << EC.message() << "\n";
     return true;
   }
   std::unique_ptr<llvm::MemoryBuffer> Code = std::move(CodeOrErr.get());
@@ -420,28 +561,27 @@ static bool format(StringRef FileName) {
   const char *InvalidBOM = SrcMgr::ContentCache::getInvalidBOM(BufStr);
 
   if (InvalidBOM) {
-    errs() << "error: encoding with unsupported byte order mark \""
-           << InvalidBOM << "\" detected";
+    ErrOS << "error: encoding with unsupported byte order mark \""
+          << InvalidBOM << "\" detected";
     if (FileName != "-")
-      errs() << " in file '" << FileName << "'";
-    errs() << ".\n";
+      ErrOS << " in file '" << FileName << "'";
+    ErrOS << ".\n";
     return true;
   }
 
   std::vector<tooling::Range> Ranges;
-  if (fillRanges(Code.get(), Ranges))
+  if (fillRanges(Code.get(), Ranges, ErrOS))
     return true;
   StringRef AssumedFileName = (FileName == "-") ? AssumeFileName : FileName;
   if (AssumedFileName.empty()) {
-    llvm::errs() << "error: empty filenames are not allowed\n";
+    ErrOS << "error: empty filenames are not allowed\n";
     return true;
   }
 
   llvm::Expected<FormatStyle> FormatStyle =
-      getStyle(Style, AssumedFileName, FallbackStyle, Code->getBuffer(),
-               nullptr, WNoErrorList.isSet(WNoError::Unknown));
+      getStyleCache().get(AssumedFileName, Code->getBuffer());
   if (!FormatStyle) {
-    llvm::errs() << llvm::toString(FormatStyle.takeError()) << "\n";
+    ErrOS << llvm::toString(FormatStyle.takeError()) << "\n";
     return true;
   }
 
@@ -482,12 +622,12 @@ static bool format(StringRef FileName) {
     auto Err = Replaces.add(tooling::Replacement(
         tooling::Replacement(AssumedFileName, 0, 0, "x = ")));
     if (Err)
-      llvm::errs() << "Bad Json variable insertion\n";
+      ErrOS << "Bad Json variable insertion\n";
   }
 
   auto ChangedCode = tooling::applyAllReplacements(Code->getBuffer(), Replaces);
   if (!ChangedCode) {
-    llvm::errs() << llvm::toString(ChangedCode.takeError()) << "\n";
+    ErrOS << llvm::toString(ChangedCode.takeError()) << "\n";
     return true;
   }
   // Get new affected ranges after sorting `#includes`.
@@ -498,16 +638,25 @@ static bool format(StringRef FileName) {
   Replaces = Replaces.merge(FormatChanges);
   if (OutputXML || DryRun) {
     if (DryRun)
-      return emitReplacementWarnings(Replaces, AssumedFileName, Code);
+      return emitReplacementWarnings(Replaces, AssumedFileName, Code, ErrOS);
     else
-      outputXML(Replaces, FormatChanges, Status, Cursor, CursorPosition);
+      outputXML(Replaces, FormatChanges, Status, Cursor, CursorPosition, OS);
+  } else if (Inplace) {
+    auto NewCode = tooling::applyAllReplacements(Code->getBuffer(), Replaces);
+    if (!NewCode) {
+      ErrOS << llvm::toString(NewCode.takeError()) << "\n";
+      return true;
+    }
+    if (*NewCode != Code->getBuffer() &&
+        writeFileInPlace(FileName, *NewCode, ErrOS))
+      return true;
   } else {
     IntrusiveRefCntPtr<llvm::vfs::InMemoryFileSystem> InMemoryFileSystem(
         new llvm::vfs::InMemoryFileSystem);
     FileManager Files(FileSystemOptions(), InMemoryFileSystem);
 
     IntrusiveRefCntPtr<DiagnosticOptions> DiagOpts(new DiagnosticOptions());
-    ClangFormatDiagConsumer IgnoreDiagnostics;
+    ClangFormatDiagConsumer IgnoreDiagnostics(ErrOS);
     DiagnosticsEngine Diagnostics(
         IntrusiveRefCntPtr<DiagnosticIDs>(new DiagnosticIDs), &*DiagOpts,
         &IgnoreDiagnostics, false);
@@ -516,21 +665,16 @@ static bool format(StringRef FileName) {
                                    InMemoryFileSystem.get());
     Rewriter Rewrite(Sources, LangOptions());
     tooling::applyAllReplacements(Replaces, Rewrite);
-    if (Inplace) {
-      if (Rewrite.overwriteChangedFiles())
-        return true;
-    } else {
-      if (Cursor.getNumOccurrences() != 0) {
-        outs() << "{ \"Cursor\": "
-               << FormatChanges.getShiftedCodePosition(CursorPosition)
-               << ", \"IncompleteFormat\": "
-               << (Status.FormatComplete ? "false" : "true");
-        if (!Status.FormatComplete)
-          outs() << ", \"Line\": " << Status.Line;
-        outs() << " }\n";
-      }
-      Rewrite.getEditBuffer(ID).write(outs());
+    if (Cursor.getNumOccurrences() != 0) {
+      OS << "{ \"Cursor\": "
+         << FormatChanges.getShiftedCodePosition(CursorPosition)
+         << ", \"IncompleteFormat\": "
+         << (Status.FormatComplete ? "false" : "true");
+      if (!Status.FormatComplete)
+        OS << ", \"Line\": " << Status.Line;
+      OS << " }\n";
     }
+    Rewrite.getEditBuffer(ID).write(OS);
   }
   return false;
 }
@@ -574,6 +718,51 @@ static int dumpConfig() {
   return 0;
 }
 
+// Formats FileNames on -j threads. The output and the diagnostics of every
+// file are buffered, and written as soon as all the files before it are
+// done, so they come in the same order as when formatting serially.
+static bool formatFilesInParallel() {
+  struct FileResult {
+    std::string Out;
+    std::string Err;
+    bool Error = false;
+    bool Done = false;
+  };
+  std::vector<FileResult> Results(FileNames.size());
+  std::mutex Mutex;
+  size_t NextToWrite = 0;
+  bool Error = false;
+
+  llvm::ThreadPool Pool(llvm::hardware_concurrency(NumThreads));
+  for (size_t I = 0, E = FileNames.size(); I != E; ++I) {
+    Pool.async([&, I, E] {
+      FileResult &Result = Results[I];
+      {
+        raw_string_ostream OS(Result.Out);
+        raw_string_ostream ErrOS(Result.Err);
+        if (Verbose) {
+          ErrOS << "Formatting [" << I + 1 << "/" << E << "] " << FileNames[I]
+                << "\n";
+        }
+        Result.Error = clang::format::format(FileNames[I], OS, ErrOS);
+      }
+
+      std::lock_guard<std::mutex> Lock(Mutex);
+      Result.Done = true;
+      for (; NextToWrite != E && Results[NextToWrite].Done; ++NextToWrite) {
+        FileResult &Next = Results[NextToWrite];
+        errs() << Next.Err;
+        outs() << Next.Out;
+        Error |= Next.Error;
+        std::string().swap(Next.Out);
+        std::string().swap(Next.Err);
+      }
+    });
+  }
+  Pool.wait();
+  return Error;
+}
+
 int main(int argc, const char **argv) {
   llvm::InitLLVM X(argc, argv);
 
@@ -611,7 +800,7 @@ int main(int argc, const char **argv) {
 
   bool Error = false;
   if (FileNames.empty()) {
-    Error = clang::format::format("-");
+    Error = clang::format::format("-", outs(), errs());
     return Error ? 1 : 0;
   }
   if (FileNames.size() != 1 &&
@@ -621,13 +810,16 @@ int main(int argc, const char **argv) {
     return 1;
   }
 
+  if (NumThreads != 1 && FileNames.size() > 1)
+    return formatFilesInParallel() ? 1 : 0;
+
   unsigned FileNo = 1;
   for (const auto &FileName : FileNames) {
     if (Verbose) {
       errs() << "Formatting [" << FileNo++ << "/" << FileNames.size() << "] "
              << FileName << "\n";
     }
-    Error |= clang::format::format(FileName);
+    Error |= clang::format::format(FileName, outs(), errs());
   }
   return Error ? 1 : 0;
 }
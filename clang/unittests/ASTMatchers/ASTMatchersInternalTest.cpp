@@ -216,6 +216,67 @@ TEST(MatchFinder, CheckProfiling) {
   EXPECT_EQ("MyID", Records.begin()->getKey());
 }
 
+TEST(MatchFinder, CheckProfilingMemoization) {
+  MatchFinder::MatchFinderOptions Options;
+  llvm::StringMap<llvm::TimeRecord> Records;
+  llvm::StringMap<MatchFinder::MatchFinderOptions::Profiling::MemoizationStats>
+      MemoizationRecords;
+  Options.CheckProfiling.emplace(Records, &MemoizationRecords);
+  MatchFinder Finder(std::move(Options));
+
+  struct NamedCallback : public MatchFinder::MatchCallback {
+    void run(const MatchFinder::MatchResult &Result) override {}
+    StringRef getID() const override { return "MyID"; }
+  } Callback;
+  Finder.addMatcher(varDecl(hasAncestor(functionDecl())), &Callback);
+  std::unique_ptr<FrontendActionFactory> Factory(
+      newFrontendActionFactory(&Finder));
+  // Matching 'b' finds the result of the compound statement, memoized when
+  // matching 'a'.
+  ASSERT_TRUE(
+      tooling::runToolOnCode(Factory->create(), "void f() { int a; int b; }"));
+
+  ASSERT_EQ(1u, MemoizationRecords.size());
+  EXPECT_EQ("MyID", MemoizationRecords.begin()->getKey());
+  const auto &Stats = MemoizationRecords.begin()->getValue();
+  EXPECT_EQ(1u, Stats.Hits);
+  EXPECT_GT(Stats.Misses, 0u);
+  EXPECT_EQ(0u, Stats.Evictions);
+}
+
+TEST(MatchFinder, CheckProfilingMemoizationEviction) {
+  MatchFinder::MatchFinderOptions Options;
+  llvm::StringMap<llvm::TimeRecord> Records;
+  llvm::StringMap<MatchFinder::MatchFinderOptions::Profiling::MemoizationStats>
+      MemoizationRecords;
+  Options.CheckProfiling.emplace(Records, &MemoizationRecords);
+  MatchFinder Finder(std::move(Options));
+
+  struct NamedCallback : public MatchFinder::MatchCallback {
+    void run(const MatchFinder::MatchResult &Result) override {}
+    StringRef getID() const override { return "MyID"; }
+  } Callback;
+  Finder.addMatcher(varDecl(hasAncestor(functionDecl())), &Callback);
+  std::unique_ptr<FrontendActionFactory> Factory(
+      newFrontendActionFactory(&Finder));
+  // Each variable memoizes the results of itself and of its declaration
+  // statement, more than the 10000 entries the cache holds, and looks up the
+  // result of the compound statement, memoized by the first variable.
+  const unsigned NumVars = 6000;
+  std::string Code = "void f() {";
+  for (unsigned I = 0; I < NumVars; ++I)
+    Code += " int v" + std::to_string(I) + ";";
+  Code += " }";
+  ASSERT_TRUE(tooling::runToolOnCode(Factory->create(), Code));
+
+  ASSERT_EQ(1u, MemoizationRecords.size());
+  const auto &Stats = MemoizationRecords.begin()->getValue();
+  EXPECT_GT(Stats.Evictions, 0u);
+  // The result of the compound statement is never evicted.
+  EXPECT_EQ(NumVars - 1, Stats.Hits);
+  EXPECT_EQ(2 * NumVars + 1, Stats.Misses);
+}
+
 class VerifyStartOfTranslationUnit : public MatchFinder::MatchCallback {
 public:
   VerifyStartOfTranslationUnit() : Called(false) {}
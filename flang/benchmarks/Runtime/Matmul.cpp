@@ -0,0 +1,91 @@
+//===-- flang/benchmarks/Runtime/Matmul.cpp ---------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Benchmarks of MATMUL on contiguous square matrices and vectors.  The rate
+// reported is in multiply-add operations per second.  Set FORT_MATMUL_BLAS=0
+// to measure the built-in kernels when a BLAS is linked.
+//
+// Note: make sure to build the benchmark in Release mode.
+//
+//===----------------------------------------------------------------------===//
+
+#include "benchmark/benchmark.h"
+#include "flang/Runtime/cpp-type.h"
+#include "flang/Runtime/descriptor.h"
+#include "flang/Runtime/main.h"
+#include "flang/Runtime/matmul.h"
+#include "flang/Runtime/type-code.h"
+
+using namespace Fortran::runtime;
+using Fortran::common::TypeCategory;
+
+template <TypeCategory CAT, int KIND>
+static OwningPtr<Descriptor> MakeOperand(int rank, SubscriptValue extent) {
+  auto result{Descriptor::Create(TypeCode{CAT, KIND},
+      CAT == TypeCategory::Complex ? 2 * KIND : KIND, nullptr, rank, nullptr,
+      CFI_attribute_allocatable)};
+  for (int j{0}; j < rank; ++j) {
+    result->GetDimension(j).SetBounds(1, extent);
+  }
+  result->Allocate();
+  using T = CppTypeFor<CAT, KIND>;
+  T *p{result->OffsetElement<T>()};
+  for (std::size_t j{0}; j < result->Elements(); ++j) {
+    p[j] = T(static_cast<int>(j % 17) - 8) / T(8);
+  }
+  return result;
+}
+
+// Benchmarks a MATMUL of operands of the given ranks and extent state.range(0)
+template <TypeCategory CAT, int KIND, int XRANK, int YRANK>
+static void BM_Matmul(benchmark::State &state) {
+  SubscriptValue extent{state.range(0)};
+  auto x{MakeOperand<CAT, KIND>(XRANK, extent)};
+  auto y{MakeOperand<CAT, KIND>(YRANK, extent)};
+  auto result{MakeOperand<CAT, KIND>(XRANK + YRANK - 2, extent)};
+  for (auto _ : state) {
+    RTNAME(MatmulDirect)(*result, *x, *y, __FILE__, __LINE__);
+    benchmark::DoNotOptimize(result->raw().base_addr);
+    benchmark::ClobberMemory();
+  }
+  SubscriptValue work{extent * extent * (XRANK + YRANK == 4 ? extent : 1)};
+  state.SetItemsProcessed(state.iterations() * work);
+}
+
+static void MatrixSizes(benchmark::internal::Benchmark *b) {
+  for (int extent : {8, 16, 32, 64, 100, 128, 256, 500, 1000}) {
+    b->Arg(extent);
+  }
+}
+
+static void VectorSizes(benchmark::internal::Benchmark *b) {
+  for (int extent : {16, 64, 256, 1000, 4000}) {
+    b->Arg(extent);
+  }
+}
+
+#define MATMUL_BENCHMARKS(CAT, KIND) \
+  BENCHMARK_TEMPLATE(BM_Matmul, TypeCategory::CAT, KIND, 2, 2) \
+      ->Apply(MatrixSizes); \
+  BENCHMARK_TEMPLATE(BM_Matmul, TypeCategory::CAT, KIND, 2, 1) \
+      ->Apply(VectorSizes); \
+  BENCHMARK_TEMPLATE(BM_Matmul, TypeCategory::CAT, KIND, 1, 2) \
+      ->Apply(VectorSizes);
+
+MATMUL_BENCHMARKS(Real, 4)
+MATMUL_BENCHMARKS(Real, 8)
+MATMUL_BENCHMARKS(Complex, 4)
+MATMUL_BENCHMARKS(Complex, 8)
+
+int main(int argc, char **argv) {
+  // Reads the runtime's environment variables, as a Fortran main program does
+  RTNAME(ProgramStart)(argc, const_cast<const char **>(argv), nullptr);
+  benchmark::Initialize(&argc, argv);
+  benchmark::RunSpecifiedBenchmarks();
+  return 0;
+}
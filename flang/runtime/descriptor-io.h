@@ -23,6 +23,8 @@
 #include "flang/Common/uint128.h"
 #include "flang/Runtime/cpp-type.h"
 #include "flang/Runtime/descriptor.h"
+#include <algorithm>
+#include <limits>
 
 namespace Fortran::runtime::io::descr {
 template <typename A>
@@ -36,6 +38,35 @@ inline A &ExtractElement(IoStatementState &io, const Descriptor &descriptor,
   return *p;
 }
 
+// Output of the elements of an intrinsic numeric array.  A data edit
+// descriptor with a repeat count (e.g., 10F12.4), as well as list-directed
+// editing, serves as many elements as it can, so that the FORMAT is
+// interpreted once per group of elements rather than once per element.
+// The EDIT function edits the element at "subscripts".
+template <typename EDIT>
+inline bool RepeatedDataEditOutput(IoStatementState &io,
+    const Descriptor &descriptor, SubscriptValue subscripts[],
+    std::size_t numElements, EDIT edit) {
+  for (std::size_t j{0}; j < numElements;) {
+    int maxRepeat{static_cast<int>(std::min<std::size_t>(
+        numElements - j, std::numeric_limits<int>::max()))};
+    auto dataEdit{io.GetNextDataEdit(maxRepeat)};
+    if (!dataEdit) {
+      return false;
+    }
+    for (int k{0}; k < std::max(dataEdit->repeat, 1); ++k, ++j) {
+      if (!edit(*dataEdit)) {
+        return false;
+      }
+      if (!descriptor.IncrementSubscripts(subscripts) && j + 1 < numElements) {
+        io.GetIoErrorHandler().Crash(
+            "RepeatedDataEditOutput: subscripts out of bounds");
+      }
+    }
+  }
+  return true;
+}
+
 // Per-category descriptor-based I/O templates
 
 // TODO (perhaps as a nontrivial but small starter project): implement
@@ -49,15 +80,18 @@ inline bool FormattedIntegerIO(
   SubscriptValue subscripts[maxRank];
   descriptor.GetLowerBounds(subscripts);
   using IntType = CppTypeFor<TypeCategory::Integer, KIND>;
+  if constexpr (DIR == Direction::Output) {
+    return RepeatedDataEditOutput(io, descriptor, subscripts, numElements,
+        [&](const DataEdit &edit) {
+          return EditIntegerOutput<KIND>(io, edit,
+              ExtractElement<IntType>(io, descriptor, subscripts));
+        });
+  }
   bool anyInput{false};
   for (std::size_t j{0}; j < numElements; ++j) {
     if (auto edit{io.GetNextDataEdit()}) {
       IntType &x{ExtractElement<IntType>(io, descriptor, subscripts)};
-      if constexpr (DIR == Direction::Output) {
-        if (!EditIntegerOutput<KIND>(io, *edit, x)) {
-          return false;
-        }
-      } else if (edit->descriptor != DataEdit::ListDirectedNullValue) {
+      if (edit->descriptor != DataEdit::ListDirectedNullValue) {
         if (EditIntegerInput(io, *edit, reinterpret_cast<void *>(&x), KIND)) {
           anyInput = true;
         } else {
@@ -82,15 +116,19 @@ inline bool FormattedRealIO(
   SubscriptValue subscripts[maxRank];
   descriptor.GetLowerBounds(subscripts);
   using RawType = typename RealOutputEditing<KIND>::BinaryFloatingPoint;
+  if constexpr (DIR == Direction::Output) {
+    return RepeatedDataEditOutput(io, descriptor, subscripts, numElements,
+        [&](const DataEdit &edit) {
+          return RealOutputEditing<KIND>{
+              io, ExtractElement<RawType>(io, descriptor, subscripts)}
+              .Edit(edit);
+        });
+  }
   bool anyInput{false};
   for (std::size_t j{0}; j < numElements; ++j) {
     if (auto edit{io.GetNextDataEdit()}) {
       RawType &x{ExtractElement<RawType>(io, descriptor, subscripts)};
-      if constexpr (DIR == Direction::Output) {
-        if (!RealOutputEditing<KIND>{io, x}.Edit(*edit)) {
-          return false;
-        }
-      } else if (edit->descriptor != DataEdit::ListDirectedNullValue) {
+      if (edit->descriptor != DataEdit::ListDirectedNullValue) {
         if (EditRealInput<KIND>(io, *edit, reinterpret_cast<void *>(&x))) {
           anyInput = true;
         } else {
@@ -7,11 +7,14 @@
 //===----------------------------------------------------------------------===//
 
 #include "float.h"
+#include "parallel.h"
 #include "terminator.h"
 #include "tools.h"
 #include "flang/Runtime/cpp-type.h"
 #include "flang/Runtime/descriptor.h"
+#include "flang/Runtime/memory.h"
 #include "flang/Runtime/reduction.h"
+#include <algorithm>
 #include <cfloat>
 #include <cinttypes>
 
@@ -49,6 +52,62 @@ private:
   Result sum_{};
 };
 
+// Dot product of contiguous numeric vectors.  Each block of elements (see
+// parallel.h) is accumulated in independent lanes, which can be vectorized,
+// and the blocks can be computed on multiple threads.
+template <TypeCategory RCAT, int RKIND, typename XT, typename YT>
+static inline AccumulationType<RCAT, RKIND> ContiguousDotProduct(const XT *xp,
+    const YT *yp, std::size_t n, Terminator &terminator) {
+  using AccumType = AccumulationType<RCAT, RKIND>;
+  auto dotBlock{[=](std::size_t first, std::size_t count) {
+    constexpr std::size_t lanes{8};
+    AccumType sum[lanes]{};
+    const XT *x{xp + first};
+    const YT *y{yp + first};
+    std::size_t j{0};
+    for (; j + lanes <= count; j += lanes) {
+      for (std::size_t k{0}; k < lanes; ++k) {
+        if constexpr (RCAT == TypeCategory::Complex) {
+          sum[k] += std::conj(static_cast<AccumType>(x[j + k])) *
+              static_cast<AccumType>(y[j + k]);
+        } else {
+          sum[k] += static_cast<AccumType>(x[j + k]) *
+              static_cast<AccumType>(y[j + k]);
+        }
+      }
+    }
+    AccumType result{};
+    for (std::size_t k{0}; k < lanes; ++k) {
+      result += sum[k];
+    }
+    for (; j < count; ++j) {
+      if constexpr (RCAT == TypeCategory::Complex) {
+        result += std::conj(static_cast<AccumType>(x[j])) *
+            static_cast<AccumType>(y[j]);
+      } else {
+        result += static_cast<AccumType>(x[j]) * static_cast<AccumType>(y[j]);
+      }
+    }
+    return result;
+  }};
+  if (n <= reductionBlockElements) {
+    return dotBlock(0, n);
+  }
+  std::size_t blocks{(n + reductionBlockElements - 1) / reductionBlockElements};
+  AccumType *partial{static_cast<AccumType *>(
+      AllocateMemoryOrCrash(terminator, blocks * sizeof(AccumType)))};
+  auto dotBlockAt{[&](std::size_t j) {
+    std::size_t first{j * reductionBlockElements};
+    partial[j] = dotBlock(first, std::min(reductionBlockElements, n - first));
+  }};
+  ParallelFor(blocks, dotBlockAt);
+  CombineInFixedOrder(partial, blocks,
+      [](AccumType &left, const AccumType &right) { left += right; });
+  AccumType result{partial[0]};
+  FreeMemory(partial);
+  return result;
+}
+
 template <TypeCategory RCAT, int RKIND, typename XT, typename YT>
 static inline CppTypeFor<RCAT, RKIND> DoDotProduct(
     const Descriptor &x, const Descriptor &y, Terminator &terminator) {
@@ -76,22 +135,8 @@ static inline CppTypeFor<RCAT, RKIND> DoDotProduct(
           // TODO: call BLAS-1 ZDOTC
         }
       }
-      XT *xp{x.OffsetElement<XT>(0)};
-      YT *yp{y.OffsetElement<YT>(0)};
-      using AccumType = AccumulationType<RCAT, RKIND>;
-      AccumType accum{};
-      if constexpr (RCAT == TypeCategory::Complex) {
-        for (SubscriptValue j{0}; j < n; ++j) {
-          accum += std::conj(static_cast<AccumType>(*xp++)) *
-              static_cast<AccumType>(*yp++);
-        }
-      } else {
-        for (SubscriptValue j{0}; j < n; ++j) {
-          accum +=
-              static_cast<AccumType>(*xp++) * static_cast<AccumType>(*yp++);
-        }
-      }
-      return static_cast<Result>(accum);
+      return static_cast<Result>(ContiguousDotProduct<RCAT, RKIND>(
+          x.OffsetElement<XT>(0), y.OffsetElement<YT>(0), n, terminator));
     }
   }
   // Non-contiguous, heterogeneous, & LOGICAL cases
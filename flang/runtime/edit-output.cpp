@@ -236,9 +236,19 @@ bool RealOutputEditingBase::EmitSuffix(const DataEdit &edit) {
   }
 }
 
+// The shortest decimal representation of a value does not depend on the
+// number of significant digits requested, so long as it does not reach
+// that limit.  List-directed, F0, and E0 editing request it more than
+// once with different limits, and these later requests reuse the first
+// conversion.
 template <int binaryPrecision>
 decimal::ConversionToDecimalResult RealOutputEditing<binaryPrecision>::Convert(
     int significantDigits, enum decimal::FortranRounding rounding, int flags) {
+  bool isMinimized{(flags & decimal::Minimize) != 0};
+  if (isMinimized && minimized_.str && flags == minimizedFlags_ &&
+      rounding == minimizedRounding_ && significantDigits > minimizedDigits_) {
+    return minimized_;
+  }
   auto converted{decimal::ConvertToDecimal<binaryPrecision>(buffer_,
       sizeof buffer_, static_cast<enum decimal::DecimalConversionFlags>(flags),
       significantDigits, rounding, x_)};
@@ -247,6 +257,17 @@ decimal::ConversionToDecimalResult RealOutputEditing<binaryPrecision>::Convert(
         "RealOutputEditing::Convert : buffer size %zd was insufficient",
         sizeof buffer_);
   }
+  minimized_.str = nullptr; // buffer_ was overwritten
+  if (isMinimized) {
+    int signLength{*converted.str == '-' || *converted.str == '+' ? 1 : 0};
+    int digits{static_cast<int>(converted.length) - signLength};
+    if (digits < significantDigits) { // not truncated
+      minimized_ = converted;
+      minimizedDigits_ = digits;
+      minimizedFlags_ = flags;
+      minimizedRounding_ = rounding;
+    }
+  }
   return converted;
 }
 
@@ -526,16 +547,37 @@ DataEdit RealOutputEditing<binaryPrecision>::EditForGOutput(DataEdit edit) {
 template <int binaryPrecision>
 bool RealOutputEditing<binaryPrecision>::EditListDirectedOutput(
     const DataEdit &edit) {
-  decimal::ConversionToDecimalResult converted{Convert(1, edit.modes.round)};
-  if (IsInfOrNaN(converted)) {
-    return EditEorDOutput(edit);
-  }
-  int expo{converted.decimalExponent};
   // The decimal precision of 16-bit floating-point types is very low,
   // so use a reasonable cap of 6 to allow more values to be emitted
   // with Fw.d editing.
   static constexpr int maxExpo{
       std::max(6, BinaryFloatingPoint::decimalPrecision)};
+  // The choice between the F and E forms depends on the decimal exponent
+  // of the value rounded to one digit.  Both forms emit the shortest
+  // decimal representation, so convert to that once (see Convert()) and
+  // take the exponent from it; the two exponents can differ only when
+  // one of the roundings carries into the next power of ten, and that
+  // matters only when it crosses one of the bounds.
+  int flags{decimal::Minimize};
+  if (edit.modes.editingFlags & signPlus) {
+    flags |= decimal::AlwaysSign;
+  }
+  decimal::ConversionToDecimalResult converted{
+      Convert(sizeof buffer_ - 2, edit.modes.round, flags)};
+  if (IsInfOrNaN(converted)) {
+    return EditEorDOutput(edit);
+  }
+  int expo{converted.decimalExponent};
+  if (!IsZero()) {
+    int signLength{*converted.str == '-' || *converted.str == '+' ? 1 : 0};
+    char leading{converted.str[signLength]};
+    bool isPowerOfTen{leading == '1' &&
+        converted.length == static_cast<std::size_t>(signLength) + 1};
+    if ((leading == '9' && (expo == -1 || expo == maxExpo)) ||
+        (isPowerOfTen && (expo == 0 || expo == maxExpo + 1))) {
+      expo = Convert(1, edit.modes.round).decimalExponent;
+    }
+  }
   if (expo < 0 || expo > maxExpo) {
     DataEdit copy{edit};
     copy.modes.scale = 1; // 1P
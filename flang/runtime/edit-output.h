@@ -90,6 +90,13 @@ private:
   BinaryFloatingPoint x_;
   char buffer_[BinaryFloatingPoint::maxDecimalConversionDigits +
       EXTRA_DECIMAL_CONVERSION_SPACE];
+  // The result of the latest conversion to the shortest decimal
+  // representation (decimal::Minimize), which is still in buffer_,
+  // and what is needed to reuse it.
+  decimal::ConversionToDecimalResult minimized_{};
+  int minimizedDigits_{0};
+  int minimizedFlags_{0};
+  enum decimal::FortranRounding minimizedRounding_{decimal::RoundNearest};
 };
 
 bool ListDirectedLogicalOutput(
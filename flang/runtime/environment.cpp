@@ -89,6 +89,29 @@ void ExecutionEnvironment::Configure(
     }
   }
 
+  if (auto *x{std::getenv("FORT_MATMUL_BLAS")}) {
+    char *end;
+    auto n{std::strtol(x, &end, 10)};
+    if (n >= 0 && n <= 1 && *end == '\0') {
+      matmulUseBLAS = n != 0;
+    } else {
+      std::fprintf(stderr,
+          "Fortran runtime: FORT_MATMUL_BLAS=%s is invalid; ignored\n", x);
+    }
+  }
+
+  if (auto *x{std::getenv("FORT_REDUCTION_THREADS")}) {
+    char *end;
+    auto n{std::strtol(x, &end, 10)};
+    if (n > 0 && n <= 256 && *end == '\0') {
+      reductionThreads = n;
+    } else {
+      std::fprintf(stderr,
+          "Fortran runtime: FORT_REDUCTION_THREADS=%s is invalid; ignored\n",
+          x);
+    }
+  }
+
   // TODO: Set RP/ROUND='PROCESSOR_DEFINED' from environment
 }
 
@@ -45,6 +45,8 @@ struct ExecutionEnvironment {
   Convert conversion{Convert::Unknown}; // FORT_CONVERT
   bool noStopMessage{false}; // NO_STOP_MESSAGE=1 inhibits "Fortran STOP"
   bool defaultUTF8{false}; // DEFAULT_UTF8
+  bool matmulUseBLAS{true}; // FORT_MATMUL_BLAS=0 ignores a linked BLAS
+  int reductionThreads{1}; // FORT_REDUCTION_THREADS
 };
 
 extern ExecutionEnvironment executionEnvironment;
@@ -339,6 +339,34 @@ public:
   template <typename A> bool AccumulateAt(const SubscriptValue at[]) {
     return Accumulate(*array_.Element<A>(at));
   }
+  // Independent lanes, which can be vectorized
+  template <typename A> void AccumulateContiguous(const A *p, std::size_t n) {
+    constexpr std::size_t lanes{8};
+    Type extremum[lanes];
+    for (std::size_t k{0}; k < lanes; ++k) {
+      extremum[k] = extremum_;
+    }
+    std::size_t j{0};
+    for (; j + lanes <= n; j += lanes) {
+      for (std::size_t k{0}; k < lanes; ++k) {
+        Type x{p[j + k]};
+        if constexpr (IS_MAXVAL) {
+          extremum[k] = x > extremum[k] ? x : extremum[k];
+        } else {
+          extremum[k] = x < extremum[k] ? x : extremum[k];
+        }
+      }
+    }
+    for (std::size_t k{0}; k < lanes; ++k) {
+      Accumulate(extremum[k]);
+    }
+    for (; j < n; ++j) {
+      Accumulate(p[j]);
+    }
+  }
+  void Combine(const NumericExtremumAccumulator &that) {
+    Accumulate(that.extremum_);
+  }
 
 private:
   const Descriptor &array_;
@@ -92,6 +92,7 @@ public:
     for (int j{0}; j < rank_; ++j) {
       location_[j] = 0;
     }
+    found_ = false;
   }
   template <typename A> void GetResult(A *p, int zeroBasedDim = -1) {
     if (zeroBasedDim >= 0) {
@@ -108,11 +109,20 @@ public:
       for (int j{0}; j < rank_; ++j) {
         location_[j] = at[j];
       }
+      found_ = true;
       return back_;
     } else {
       return true;
     }
   }
+  void Combine(const LocationAccumulator &that) {
+    if (that.found_ && (back_ || !found_)) {
+      for (int j{0}; j < rank_; ++j) {
+        location_[j] = that.location_[j];
+      }
+      found_ = true;
+    }
+  }
 
 private:
   const Descriptor &array_;
@@ -120,6 +130,7 @@ private:
   const bool back_{false};
   const int rank_{array_.rank()};
   SubscriptValue location_[maxRank];
+  bool found_{false};
   const EQUALITY equality_{};
 };
 
@@ -595,12 +595,18 @@ std::optional<char32_t> IoStatementState::GetCurrentChar(
 }
 
 bool IoStatementState::EmitRepeated(char ch, std::size_t n) {
+  // Emit in chunks rather than one character at a time; blank padding
+  // and zero fill are frequent in formatted output.
+  char buffer[64];
+  std::memset(buffer, ch, std::min(n, sizeof buffer));
   return common::visit(
-      [=](auto &x) {
-        for (std::size_t j{0}; j < n; ++j) {
-          if (!x.get().Emit(&ch, 1)) {
+      [&](auto &x) {
+        while (n > 0) {
+          std::size_t chunk{std::min(n, sizeof buffer)};
+          if (!x.get().Emit(buffer, chunk)) {
             return false;
           }
+          n -= chunk;
         }
         return true;
       },
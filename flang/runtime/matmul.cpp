@@ -17,15 +17,53 @@
 // of logical kinds (16).  A single template undergoes many instantiations
 // to cover all of the valid possibilities.
 //
-// Places where BLAS routines could be called are marked as TODO items.
+// Contiguous REAL and COMPLEX operands of kinds 4 and 8 and of the same type
+// are multiplied by cache-blocked and vectorizable kernels, or by the BLAS
+// when the program is linked with one.
 
 #include "flang/Runtime/matmul.h"
+#include "environment.h"
 #include "terminator.h"
 #include "tools.h"
 #include "flang/Runtime/c-or-cpp.h"
 #include "flang/Runtime/cpp-type.h"
 #include "flang/Runtime/descriptor.h"
+#include <algorithm>
+#include <climits>
 #include <cstring>
+#include <utility>
+
+// When a BLAS library is linked into the program, its xGEMM and xGEMV
+// routines are used for large products.  They are weak references, which
+// are null when no BLAS is present; this requires ELF weak undefined symbols,
+// so elsewhere the built-in kernels are always used.  Only the LP64 interface
+// (32-bit integer arguments) is supported.
+#if defined(__ELF__) && (defined(__GNUC__) || defined(__clang__))
+#define FLANG_MATMUL_BLAS_HOOK 1
+#define BLAS_GEMM(NAME, T) \
+  void NAME(const char *transA, const char *transB, const int *m, \
+      const int *n, const int *k, const T *alpha, const T *a, const int *lda, \
+      const T *b, const int *ldb, const T *beta, T *c, const int *ldc) \
+      __attribute__((weak));
+#define BLAS_GEMV(NAME, T) \
+  void NAME(const char *trans, const int *m, const int *n, const T *alpha, \
+      const T *a, const int *lda, const T *x, const int *incx, const T *beta, \
+      T *y, const int *incy) __attribute__((weak));
+extern "C" {
+BLAS_GEMM(sgemm_, float)
+BLAS_GEMM(dgemm_, double)
+BLAS_GEMM(cgemm_, std::complex<float>)
+BLAS_GEMM(zgemm_, std::complex<double>)
+BLAS_GEMV(sgemv_, float)
+BLAS_GEMV(dgemv_, double)
+BLAS_GEMV(cgemv_, std::complex<float>)
+BLAS_GEMV(zgemv_, std::complex<double>)
+} // extern "C"
+#undef BLAS_GEMM
+#undef BLAS_GEMV
+#else
+#define FLANG_MATMUL_BLAS_HOOK 0
+#endif
 
 namespace Fortran::runtime {
 
@@ -149,6 +187,350 @@ inline void VectorTimesMatrix(CppTypeFor<RCAT, RKIND> *RESTRICT product,
   }
 }
 
+// The types for which there are blocked kernels and BLAS routines
+template <typename T>
+constexpr bool hasBlockedKernels{std::is_same_v<T, float> ||
+    std::is_same_v<T, double> || std::is_same_v<T, std::complex<float>> ||
+    std::is_same_v<T, std::complex<double>>};
+
+// Products with fewer multiplications than this are computed by the simple
+// loops above, for which packing operands or calling the BLAS would cost
+// more than it saves.
+static constexpr SubscriptValue blockedMinimumWork{16 * 16 * 16};
+
+template <typename T> inline void MultiplyAdd(T &acc, T x, T y) {
+  acc += x * y;
+}
+// The usual formula, without the recovery of infinite results from NaN
+// parts that would keep the loops from being vectorized
+template <typename R>
+inline void MultiplyAdd(
+    std::complex<R> &acc, std::complex<R> x, std::complex<R> y) {
+  acc = std::complex<R>{
+      acc.real() + (x.real() * y.real() - x.imag() * y.imag()),
+      acc.imag() + (x.real() * y.imag() + x.imag() * y.real())};
+}
+
+// The blocked matrix*matrix kernel is written with the vector extensions of
+// GCC and Clang, as compilers do not reliably keep a tile of the product in
+// SIMD registers otherwise.  Other compilers use MatrixTimesMatrix().
+#if defined(__GNUC__) || defined(__clang__)
+#define FLANG_MATMUL_SIMD 1
+#if defined(__AVX__)
+static constexpr std::size_t simdBytes{32};
+#else
+static constexpr std::size_t simdBytes{16};
+#endif
+
+template <typename T> struct RealPart {
+  using type = T;
+};
+template <typename R> struct RealPart<std::complex<R>> {
+  using type = R;
+};
+
+// Contiguous REAL or COMPLEX matrix*matrix multiplication with operands of
+// the result type, following Goto & van de Geijn.  The product is computed in
+// MR x NR tiles, each kept in SIMD registers by the micro-kernel while a slice
+// of KC terms is added into it.  A MC x KC block of X is first packed into a
+// buffer, so that the micro-kernel reads it contiguously and it stays in the
+// L2 cache while all of the columns of Y pass over it.  The real and
+// imaginary parts of complex elements are packed apart, so that they fill
+// vectors of their own.  Every element of the product still accumulates its
+// terms in order of increasing K, so the results are those of
+// MatrixTimesMatrix().
+template <typename T> class BlockedMatrixTimesMatrix {
+public:
+  using Real = typename RealPart<T>::type;
+  typedef Real Vector __attribute__((vector_size(simdBytes)));
+  // For loads of vectors from arrays of Real
+  typedef Real UnalignedVector __attribute__((
+      vector_size(simdBytes), aligned(alignof(Real)), __may_alias__));
+  static constexpr bool isComplex{!std::is_same_v<T, Real>};
+  static constexpr SubscriptValue lanes{simdBytes / sizeof(Real)};
+  // Each column of a tile is held in two vectors: two of real elements, or
+  // one of real parts and one of imaginary parts.
+  static constexpr SubscriptValue mr{isComplex ? lanes : 2 * lanes};
+  static constexpr SubscriptValue nr{4};
+  static constexpr SubscriptValue kc{256};
+  // 128 KiB of packed X; a multiple of MR
+  static constexpr SubscriptValue mc{128 * 1024 / (kc * sizeof(T))};
+  static constexpr std::size_t bufferBytes{mc * kc * sizeof(T)};
+
+  static void Multiply(T *RESTRICT product, SubscriptValue rows,
+      SubscriptValue cols, const T *RESTRICT x, const T *RESTRICT y,
+      SubscriptValue n, Real *RESTRICT buffer) {
+    if (n == 0) {
+      std::fill_n(product, rows * cols, T{});
+      return;
+    }
+    for (SubscriptValue k0{0}; k0 < n; k0 += kc) {
+      SubscriptValue kb{std::min(kc, n - k0)};
+      for (SubscriptValue i0{0}; i0 < rows; i0 += mc) {
+        SubscriptValue mb{std::min(mc, rows - i0)};
+        Pack(buffer, &x[i0 + k0 * rows], rows, mb, kb);
+        for (SubscriptValue j0{0}; j0 < cols; j0 += nr) {
+          SubscriptValue nb{std::min(nr, cols - j0)};
+          for (SubscriptValue i{0}; i < mb; i += mr) {
+            MicroKernel(&product[i0 + i + j0 * rows], rows,
+                std::min(mr, mb - i), nb, &buffer[i / mr * kb * 2 * lanes],
+                &y[k0 + j0 * n], n, kb, k0 == 0);
+          }
+        }
+      }
+    }
+  }
+
+private:
+  // The two vectors of a column of a tile
+  using Column = Vector[2];
+
+  // Packs a rows x KB block of X (with leading dimension ld) into panels of MR
+  // rows, which hold for every K the two vectors of a column of a tile.  The
+  // last panel is padded with zeroes.
+  static void Pack(Real *RESTRICT buffer, const T *RESTRICT x,
+      SubscriptValue ld, SubscriptValue rows, SubscriptValue kb) {
+    for (SubscriptValue i0{0}; i0 < rows; i0 += mr) {
+      SubscriptValue tileRows{std::min(mr, rows - i0)};
+      for (SubscriptValue k{0}; k < kb; ++k) {
+        const T *RESTRICT xp{&x[i0 + k * ld]};
+        for (SubscriptValue i{0}; i < mr; ++i) {
+          T xv{i < tileRows ? xp[i] : T{}};
+          if constexpr (isComplex) {
+            buffer[i] = xv.real();
+            buffer[mr + i] = xv.imag();
+          } else {
+            buffer[i] = xv;
+          }
+        }
+        buffer += 2 * lanes;
+      }
+    }
+  }
+
+  static void Load(Column &column, const Real *RESTRICT from) {
+    column[0] = reinterpret_cast<const UnalignedVector *>(from)[0];
+    column[1] = reinterpret_cast<const UnalignedVector *>(from)[1];
+  }
+
+  // Loads the first count elements of a column of the product; the others
+  // are zero.
+  static void Load(
+      Column &column, const T *RESTRICT from, SubscriptValue count) {
+    Real parts[2 * lanes]{};
+    for (SubscriptValue i{0}; i < count; ++i) {
+      if constexpr (isComplex) {
+        parts[i] = from[i].real();
+        parts[lanes + i] = from[i].imag();
+      } else {
+        parts[i] = from[i];
+      }
+    }
+    Load(column, parts);
+  }
+
+  static void Store(
+      T *RESTRICT to, const Column &column, SubscriptValue count) {
+    for (SubscriptValue i{0}; i < count; ++i) {
+      if constexpr (isComplex) {
+        to[i] = T{column[0][i], column[1][i]};
+      } else {
+        to[i] = i < lanes ? column[0][i] : column[1][i - lanes];
+      }
+    }
+  }
+
+  static void MultiplyAdd(Column &acc, const Column &x, T yv) {
+    if constexpr (isComplex) {
+      Real yr{yv.real()}, yi{yv.imag()};
+      acc[0] += x[0] * yr - x[1] * yi;
+      acc[1] += x[0] * yi + x[1] * yr;
+    } else {
+      acc[0] += x[0] * yv;
+      acc[1] += x[1] * yv;
+    }
+  }
+
+  // Adds a packed MR x KB panel of X times a KB x NR block of Y into a tile of
+  // the product, or stores it there for the first slice.  Only the leading
+  // tileRows x tileCols elements of the tile exist.  The loop over the
+  // columns is unrolled by a fold expression, so that the tile is not
+  // indexed by variables and stays in registers.
+  template <SubscriptValue... J>
+  static void MicroKernel(T *RESTRICT product, SubscriptValue ld,
+      SubscriptValue tileRows, SubscriptValue tileCols,
+      const Real *RESTRICT packed, const T *RESTRICT y, SubscriptValue yLd,
+      SubscriptValue kb, bool isFirstSlice,
+      std::integer_sequence<SubscriptValue, J...>) {
+    Column acc[nr];
+    // Missing columns repeat the first one; their sums are discarded.
+    const T *RESTRICT yCol[nr]{&y[J < tileCols ? J * yLd : 0]...};
+    (Load(acc[J], &product[J * ld],
+         isFirstSlice || J >= tileCols ? 0 : tileRows),
+        ...);
+    for (SubscriptValue k{0}; k < kb; ++k) {
+      Column xv;
+      Load(xv, packed);
+      (MultiplyAdd(acc[J], xv, yCol[J][k]), ...);
+      packed += 2 * lanes;
+    }
+    for (SubscriptValue j{0}; j < tileCols; ++j) {
+      Store(&product[j * ld], acc[j], tileRows);
+    }
+  }
+  static void MicroKernel(T *RESTRICT product, SubscriptValue ld,
+      SubscriptValue tileRows, SubscriptValue tileCols,
+      const Real *RESTRICT packed, const T *RESTRICT y, SubscriptValue yLd,
+      SubscriptValue kb, bool isFirstSlice) {
+    MicroKernel(product, ld, tileRows, tileCols, packed, y, yLd, kb,
+        isFirstSlice, std::make_integer_sequence<SubscriptValue, nr>{});
+  }
+};
+#else
+#define FLANG_MATMUL_SIMD 0
+#endif
+
+// Contiguous REAL or COMPLEX matrix*vector multiplication with operands of
+// the result type.  Four columns of X are added into each element of the
+// product at once, in their order, so that the product is loaded and stored
+// a quarter as often as by MatrixTimesVector().  The rows are processed in
+// blocks whose part of the product stays in the L1 cache.
+template <typename T>
+static void BlockedMatrixTimesVector(T *RESTRICT product, SubscriptValue rows,
+    SubscriptValue n, const T *RESTRICT x, const T *RESTRICT y) {
+  constexpr SubscriptValue rowBlock{16 * 1024 / sizeof(T)};
+  for (SubscriptValue i0{0}; i0 < rows; i0 += rowBlock) {
+    SubscriptValue rb{std::min(rowBlock, rows - i0)};
+    T *RESTRICT p{&product[i0]};
+    std::fill_n(p, rb, T{});
+    SubscriptValue k{0};
+    for (; k + 4 <= n; k += 4) {
+      const T *RESTRICT x0{&x[i0 + k * rows]};
+      const T *RESTRICT x1{x0 + rows};
+      const T *RESTRICT x2{x1 + rows};
+      const T *RESTRICT x3{x2 + rows};
+      T y0{y[k]}, y1{y[k + 1]}, y2{y[k + 2]}, y3{y[k + 3]};
+      for (SubscriptValue i{0}; i < rb; ++i) {
+        T acc{p[i]};
+        MultiplyAdd(acc, x0[i], y0);
+        MultiplyAdd(acc, x1[i], y1);
+        MultiplyAdd(acc, x2[i], y2);
+        MultiplyAdd(acc, x3[i], y3);
+        p[i] = acc;
+      }
+    }
+    for (; k < n; ++k) {
+      const T *RESTRICT xk{&x[i0 + k * rows]};
+      T yk{y[k]};
+      for (SubscriptValue i{0}; i < rb; ++i) {
+        MultiplyAdd(p[i], xk[i], yk);
+      }
+    }
+  }
+}
+
+// Computes COLS elements of a contiguous vector*matrix product, which are the
+// dot products of X with contiguous columns of Y.  Each element of X is loaded
+// once for all of the columns.  Each dot product is accumulated in several
+// partial sums so that it can be vectorized; unlike VectorTimesMatrix(), its
+// terms are therefore not added in their order.
+template <int COLS, typename T>
+inline void DotProducts(T *RESTRICT product, SubscriptValue n,
+    const T *RESTRICT x, const T *RESTRICT y) {
+  constexpr int lanes{64 / sizeof(T)};
+  T sum[COLS][lanes]{};
+  SubscriptValue k{0};
+  for (; k + lanes <= n; k += lanes) {
+    for (int j{0}; j < COLS; ++j) {
+      for (int l{0}; l < lanes; ++l) {
+        MultiplyAdd(sum[j][l], x[k + l], y[k + l + j * n]);
+      }
+    }
+  }
+  for (int j{0}; j < COLS; ++j) {
+    T total{};
+    for (int l{0}; l < lanes; ++l) {
+      total += sum[j][l];
+    }
+    for (SubscriptValue kk{k}; kk < n; ++kk) {
+      MultiplyAdd(total, x[kk], y[kk + j * n]);
+    }
+    product[j] = total;
+  }
+}
+
+template <typename T>
+static void BlockedVectorTimesMatrix(T *RESTRICT product, SubscriptValue n,
+    SubscriptValue cols, const T *RESTRICT x, const T *RESTRICT y) {
+  SubscriptValue j{0};
+  for (; j + 4 <= cols; j += 4) {
+    DotProducts<4>(&product[j], n, x, &y[j * n]);
+  }
+  for (; j < cols; ++j) {
+    DotProducts<1>(&product[j], n, x, &y[j * n]);
+  }
+}
+
+#if FLANG_MATMUL_BLAS_HOOK
+template <typename T> struct BLAS;
+template <> struct BLAS<float> {
+  static auto Gemm() { return &sgemm_; }
+  static auto Gemv() { return &sgemv_; }
+};
+template <> struct BLAS<double> {
+  static auto Gemm() { return &dgemm_; }
+  static auto Gemv() { return &dgemv_; }
+};
+template <> struct BLAS<std::complex<float>> {
+  static auto Gemm() { return &cgemm_; }
+  static auto Gemv() { return &cgemv_; }
+};
+template <> struct BLAS<std::complex<double>> {
+  static auto Gemm() { return &zgemm_; }
+  static auto Gemv() { return &zgemv_; }
+};
+
+static bool FitsInInt(SubscriptValue x) { return x <= INT_MAX; }
+#endif
+
+// Each of these returns false when no BLAS is linked or when the product
+// cannot be passed to it, and the built-in kernel must be used.
+template <typename T>
+static bool CallBLASMatrixTimesMatrix(T *product, SubscriptValue rows,
+    SubscriptValue cols, const T *x, const T *y, SubscriptValue n) {
+#if FLANG_MATMUL_BLAS_HOOK
+  if (auto *gemm{BLAS<T>::Gemm()}; gemm &&
+      executionEnvironment.matmulUseBLAS && FitsInInt(rows) &&
+      FitsInInt(cols) && FitsInInt(n)) {
+    int m{static_cast<int>(rows)}, nc{static_cast<int>(cols)},
+        k{static_cast<int>(n)};
+    int ldx{std::max(m, 1)}, ldy{std::max(k, 1)};
+    T one{1}, zero{0};
+    gemm("N", "N", &m, &nc, &k, &one, x, &ldx, y, &ldy, &zero, product, &ldx);
+    return true;
+  }
+#endif
+  return false;
+}
+
+// Computes X*Y or, with isTransposed, Y*X where X is a (rows,n) matrix.
+template <typename T>
+static bool CallBLASMatrixTimesVector(T *product, SubscriptValue rows,
+    SubscriptValue n, const T *x, const T *y, bool isTransposed) {
+#if FLANG_MATMUL_BLAS_HOOK
+  if (auto *gemv{BLAS<T>::Gemv()}; gemv &&
+      executionEnvironment.matmulUseBLAS && FitsInInt(rows) && FitsInInt(n)) {
+    int m{static_cast<int>(rows)}, nc{static_cast<int>(n)};
+    int ldx{std::max(m, 1)}, inc{1};
+    T one{1}, zero{0};
+    gemv(isTransposed ? "T" : "N", &m, &nc, &one, x, &ldx, y, &inc, &zero,
+        product, &inc);
+    return true;
+  }
+#endif
+  return false;
+}
+
 // Implements an instance of MATMUL for given argument types.
 template <bool IS_ALLOCATING, TypeCategory RCAT, int RKIND, typename XT,
     typename YT>
@@ -176,8 +558,10 @@ static inline void DoMatmul(
     }
   } else {
     RUNTIME_CHECK(terminator, resRank == result.rank());
-    RUNTIME_CHECK(
-        terminator, result.ElementBytes() == static_cast<std::size_t>(RKIND));
+    RUNTIME_CHECK(terminator,
+        result.ElementBytes() ==
+            static_cast<std::size_t>(
+                RCAT == TypeCategory::Complex ? 2 * RKIND : RKIND));
     RUNTIME_CHECK(terminator, result.GetDimension(0).Extent() == extent[0]);
     RUNTIME_CHECK(terminator,
         resRank == 1 || result.GetDimension(1).Extent() == extent[1]);
@@ -196,15 +580,22 @@ static inline void DoMatmul(
         (IS_ALLOCATING || result.IsContiguous())) {
       // Contiguous numeric matrices
       if (resRank == 2) { // M*M -> M
-        if (std::is_same_v<XT, YT>) {
-          if constexpr (std::is_same_v<XT, float>) {
-            // TODO: call BLAS-3 SGEMM
-          } else if constexpr (std::is_same_v<XT, double>) {
-            // TODO: call BLAS-3 DGEMM
-          } else if constexpr (std::is_same_v<XT, std::complex<float>>) {
-            // TODO: call BLAS-3 CGEMM
-          } else if constexpr (std::is_same_v<XT, std::complex<double>>) {
-            // TODO: call BLAS-3 ZGEMM
+        if constexpr (std::is_same_v<XT, YT> && hasBlockedKernels<XT>) {
+          XT *product{result.template OffsetElement<XT>()};
+          const XT *xp{x.OffsetElement<XT>()}, *yp{y.OffsetElement<XT>()};
+          if (extent[0] * extent[1] * n >= blockedMinimumWork) {
+            if (CallBLASMatrixTimesMatrix(
+                    product, extent[0], extent[1], xp, yp, n)) {
+              return;
+            }
+#if FLANG_MATMUL_SIMD
+            using Kernel = BlockedMatrixTimesMatrix<XT>;
+            auto *buffer{static_cast<typename Kernel::Real *>(
+                AllocateMemoryOrCrash(terminator, Kernel::bufferBytes))};
+            Kernel::Multiply(product, extent[0], extent[1], xp, yp, n, buffer);
+            FreeMemory(buffer);
+            return;
+#endif
           }
         }
         MatrixTimesMatrix<RCAT, RKIND, XT, YT>(
@@ -212,32 +603,30 @@ static inline void DoMatmul(
             x.OffsetElement<XT>(), y.OffsetElement<YT>(), n);
         return;
       } else if (xRank == 2) { // M*V -> V
-        if (std::is_same_v<XT, YT>) {
-          if constexpr (std::is_same_v<XT, float>) {
-            // TODO: call BLAS-2 SGEMV(x,y)
-          } else if constexpr (std::is_same_v<XT, double>) {
-            // TODO: call BLAS-2 DGEMV(x,y)
-          } else if constexpr (std::is_same_v<XT, std::complex<float>>) {
-            // TODO: call BLAS-2 CGEMV(x,y)
-          } else if constexpr (std::is_same_v<XT, std::complex<double>>) {
-            // TODO: call BLAS-2 ZGEMV(x,y)
+        if constexpr (std::is_same_v<XT, YT> && hasBlockedKernels<XT>) {
+          XT *product{result.template OffsetElement<XT>()};
+          const XT *xp{x.OffsetElement<XT>()}, *yp{y.OffsetElement<XT>()};
+          if (extent[0] * n < blockedMinimumWork ||
+              !CallBLASMatrixTimesVector(product, extent[0], n, xp, yp,
+                  /*isTransposed=*/false)) {
+            BlockedMatrixTimesVector(product, extent[0], n, xp, yp);
           }
+          return;
         }
         MatrixTimesVector<RCAT, RKIND, XT, YT>(
             result.template OffsetElement<WriteResult>(), extent[0], n,
             x.OffsetElement<XT>(), y.OffsetElement<YT>());
         return;
       } else { // V*M -> V
-        if (std::is_same_v<XT, YT>) {
-          if constexpr (std::is_same_v<XT, float>) {
-            // TODO: call BLAS-2 SGEMV(y,x)
-          } else if constexpr (std::is_same_v<XT, double>) {
-            // TODO: call BLAS-2 DGEMV(y,x)
-          } else if constexpr (std::is_same_v<XT, std::complex<float>>) {
-            // TODO: call BLAS-2 CGEMV(y,x)
-          } else if constexpr (std::is_same_v<XT, std::complex<double>>) {
-            // TODO: call BLAS-2 ZGEMV(y,x)
+        if constexpr (std::is_same_v<XT, YT> && hasBlockedKernels<XT>) {
+          XT *product{result.template OffsetElement<XT>()};
+          const XT *xp{x.OffsetElement<XT>()}, *yp{y.OffsetElement<XT>()};
+          if (n * extent[0] < blockedMinimumWork ||
+              !CallBLASMatrixTimesVector(product, n, extent[0], yp, xp,
+                  /*isTransposed=*/true)) {
+            BlockedVectorTimesMatrix(product, n, extent[0], xp, yp);
           }
+          return;
         }
         VectorTimesMatrix<RCAT, RKIND, XT, YT>(
             result.template OffsetElement<WriteResult>(), n, extent[0],
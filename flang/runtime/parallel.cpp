@@ -0,0 +1,83 @@
+//===-- runtime/parallel.cpp ----------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "parallel.h"
+#include <algorithm>
+#include <atomic>
+
+#ifndef _WIN32
+#include <pthread.h>
+// Programs that do not otherwise use threads need not link with the
+// threads library (it is part of the C library in recent glibc releases);
+// references to it are weak, and when it is absent all tasks run on the
+// calling thread.
+#if defined(__ELF__) && (defined(__GNUC__) || defined(__clang__))
+#pragma weak pthread_create
+#pragma weak pthread_join
+#endif
+#endif
+
+namespace Fortran::runtime {
+
+namespace {
+class TaskQueue {
+public:
+  TaskQueue(std::size_t tasks, void (*task)(std::size_t, void *), void *context)
+      : tasks_{tasks}, task_{task}, context_{context} {}
+
+  // Runs tasks until none remain; tasks are claimed in increasing order
+  void Run() {
+    for (std::size_t j{next_++}; j < tasks_; j = next_++) {
+      task_(j, context_);
+    }
+  }
+
+#ifndef _WIN32
+  static void *RunThread(void *queue) {
+    static_cast<TaskQueue *>(queue)->Run();
+    return nullptr;
+  }
+#endif
+
+private:
+  const std::size_t tasks_;
+  void (*const task_)(std::size_t, void *);
+  void *const context_;
+  std::atomic<std::size_t> next_{0};
+};
+} // namespace
+
+// Thread limit, in case of a wild FORT_REDUCTION_THREADS=
+static constexpr int maxThreads{256};
+
+void RunTasks(
+    std::size_t tasks, void (*task)(std::size_t, void *), void *context) {
+  TaskQueue queue{tasks, task, context};
+#ifndef _WIN32
+  if (&pthread_create && &pthread_join) {
+    std::size_t threads{std::min<std::size_t>(tasks,
+        std::min(executionEnvironment.reductionThreads, maxThreads))};
+    pthread_t thread[maxThreads];
+    std::size_t started{0};
+    for (; started + 1 < threads; ++started) {
+      if (pthread_create(
+              &thread[started], nullptr, &TaskQueue::RunThread, &queue) != 0) {
+        break; // continue with the threads that were created
+      }
+    }
+    queue.Run();
+    for (std::size_t j{0}; j < started; ++j) {
+      pthread_join(thread[j], nullptr);
+    }
+    return;
+  }
+#endif
+  queue.Run();
+}
+
+} // namespace Fortran::runtime
@@ -0,0 +1,65 @@
+//===-- runtime/parallel.h --------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+// Support for running independent tasks of a runtime operation, like the
+// blocks of a large reduction, on multiple threads.  The number of threads
+// is set by FORT_REDUCTION_THREADS and defaults to one, so the runtime
+// creates no threads unless asked to.  Results must not depend on the
+// number of threads; see CombineInFixedOrder() below.
+
+#ifndef FORTRAN_RUNTIME_PARALLEL_H_
+#define FORTRAN_RUNTIME_PARALLEL_H_
+
+#include "environment.h"
+#include <cstddef>
+
+namespace Fortran::runtime {
+
+// Calls task(j, context) once for each j in [0, tasks), on as many as
+// executionEnvironment.reductionThreads threads, the calling thread
+// included, and returns when all calls have completed.  Falls back to
+// running all of the tasks on the calling thread when threads are not
+// available.
+void RunTasks(
+    std::size_t tasks, void (*task)(std::size_t, void *), void *context);
+
+template <typename TASK> void ParallelFor(std::size_t tasks, TASK &task) {
+  if (tasks > 1 && executionEnvironment.reductionThreads > 1) {
+    RunTasks(
+        tasks,
+        [](std::size_t j, void *context) {
+          (*static_cast<TASK *>(context))(j);
+        },
+        &task);
+  } else {
+    for (std::size_t j{0}; j < tasks; ++j) {
+      task(j);
+    }
+  }
+}
+
+// Combines the partial results of n consecutive blocks of a reduction as a
+// balanced binary tree whose shape depends only on n, leaving the result
+// in partial[0].  combine(left, right) folds the partial result of a block
+// into that of the adjacent preceding block.
+template <typename A, typename COMBINE>
+void CombineInFixedOrder(A partial[], std::size_t n, COMBINE combine) {
+  for (std::size_t width{1}; width < n; width *= 2) {
+    for (std::size_t j{0}; j + width < n; j += 2 * width) {
+      combine(partial[j], partial[j + width]);
+    }
+  }
+}
+
+// The number of elements in each block of a large reduction.  It is fixed,
+// so that the order of the operations does not depend on the number of
+// threads.
+constexpr std::size_t reductionBlockElements{std::size_t{1} << 16};
+
+} // namespace Fortran::runtime
+#endif // FORTRAN_RUNTIME_PARALLEL_H_
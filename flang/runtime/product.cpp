@@ -28,6 +28,11 @@ public:
     product_ *= *array_.Element<A>(at);
     return product_ != 0;
   }
+  void Combine(const NonComplexProductAccumulator &that) {
+    if (product_ != 0) { // as if cut short at the zero
+      product_ *= that.product_;
+    }
+  }
 
 private:
   const Descriptor &array_;
@@ -47,6 +52,9 @@ public:
     product_ *= *array_.Element<A>(at);
     return true;
   }
+  void Combine(const ComplexProductAccumulator &that) {
+    product_ *= that.product_;
+  }
 
 private:
   const Descriptor &array_;
@@ -21,10 +21,15 @@
 #ifndef FORTRAN_RUNTIME_REDUCTION_TEMPLATES_H_
 #define FORTRAN_RUNTIME_REDUCTION_TEMPLATES_H_
 
+#include "parallel.h"
 #include "terminator.h"
 #include "tools.h"
 #include "flang/Runtime/cpp-type.h"
 #include "flang/Runtime/descriptor.h"
+#include "flang/Runtime/memory.h"
+#include <algorithm>
+#include <new>
+#include <type_traits>
 
 namespace Fortran::runtime {
 
@@ -35,6 +40,80 @@ namespace Fortran::runtime {
 // AccumulateAt() member function that applies supplied subscripts to the
 // array and does something with a scalar element, and a GetResult()
 // member function that copies a final result into its destination.
+//
+// Accumulators for total reductions may also support
+//  * AccumulateContiguous(), which does the same for a run of contiguous
+//    elements with a loop that can be vectorized, and
+//  * Combine(), which folds the result of another accumulator for the
+//    elements that follow this one's into this one, so that the blocks of
+//    a large array can be reduced independently, possibly on multiple
+//    threads; see DoBlockedTotalReduction() below.
+
+template <typename ACCUMULATOR, typename = void>
+struct CanCombine : std::false_type {};
+template <typename ACCUMULATOR>
+struct CanCombine<ACCUMULATOR,
+    std::void_t<decltype(std::declval<ACCUMULATOR &>().Combine(
+        std::declval<const ACCUMULATOR &>()))>> : std::true_type {};
+
+template <typename TYPE, typename ACCUMULATOR, typename = void>
+struct CanAccumulateContiguous : std::false_type {};
+template <typename TYPE, typename ACCUMULATOR>
+struct CanAccumulateContiguous<TYPE, ACCUMULATOR,
+    std::void_t<decltype(std::declval<ACCUMULATOR &>()
+                             .template AccumulateContiguous<TYPE>(
+                                 std::declval<const TYPE *>(),
+                                 std::size_t{0}))>> : std::true_type {};
+
+// Accumulates the elements of x with zero-based element numbers in
+// [first, first + count) in array element order.
+template <typename TYPE, typename ACCUMULATOR>
+inline void AccumulateElements(const Descriptor &x, std::size_t first,
+    std::size_t count, ACCUMULATOR &accumulator) {
+  if constexpr (CanAccumulateContiguous<TYPE, ACCUMULATOR>::value) {
+    if (x.IsContiguous()) {
+      accumulator.template AccumulateContiguous<TYPE>(
+          x.OffsetElement<const TYPE>(first * x.ElementBytes()), count);
+      return;
+    }
+  }
+  SubscriptValue xAt[maxRank];
+  x.SubscriptsForZeroBasedElementNumber(xAt, first);
+  for (; count--; x.IncrementSubscripts(xAt)) {
+    if (!accumulator.template AccumulateAt<TYPE>(xAt)) {
+      break; // cut short, result is known
+    }
+  }
+}
+
+// Total reduction of an array with more than one block of elements (see
+// parallel.h).  Each block is reduced with its own copy of the initial
+// accumulator, and the partial results are combined in a fixed order, so
+// that the result is the same for any number of threads.
+template <typename TYPE, typename ACCUMULATOR>
+inline void DoBlockedTotalReduction(const Descriptor &x, std::size_t elements,
+    ACCUMULATOR &accumulator, Terminator &terminator) {
+  std::size_t blocks{
+      (elements + reductionBlockElements - 1) / reductionBlockElements};
+  ACCUMULATOR *partial{static_cast<ACCUMULATOR *>(
+      AllocateMemoryOrCrash(terminator, blocks * sizeof(ACCUMULATOR)))};
+  for (std::size_t j{0}; j < blocks; ++j) {
+    new (&partial[j]) ACCUMULATOR{accumulator};
+  }
+  auto reduceBlock{[&](std::size_t j) {
+    std::size_t first{j * reductionBlockElements};
+    AccumulateElements<TYPE>(x, first,
+        std::min(reductionBlockElements, elements - first), partial[j]);
+  }};
+  ParallelFor(blocks, reduceBlock);
+  CombineInFixedOrder(partial, blocks,
+      [](ACCUMULATOR &left, const ACCUMULATOR &right) { left.Combine(right); });
+  accumulator.Combine(partial[0]);
+  for (std::size_t j{0}; j < blocks; ++j) {
+    partial[j].~ACCUMULATOR();
+  }
+  FreeMemory(partial);
+}
 
 // Total reduction of the array argument to a scalar (or to a vector in the
 // cases of FINDLOC, MAXLOC, & MINLOC).  These are the cases without DIM= or
@@ -67,11 +146,16 @@ inline void DoTotalReduction(const Descriptor &x, int dim,
     }
   }
   // No MASK=, or scalar MASK=.TRUE.
-  for (auto elements{x.Elements()}; elements--; x.IncrementSubscripts(xAt)) {
-    if (!accumulator.template AccumulateAt<TYPE>(xAt)) {
-      break; // cut short, result is known
+  std::size_t elements{x.Elements()};
+  if constexpr (CanCombine<ACCUMULATOR>::value) {
+    if (elements > reductionBlockElements) {
+      DoBlockedTotalReduction<TYPE>(x, elements, accumulator, terminator);
+      return;
     }
   }
+  if (elements > 0) {
+    AccumulateElements<TYPE>(x, 0, elements, accumulator);
+  }
 }
 
 template <TypeCategory CAT, int KIND, typename ACCUMULATOR>
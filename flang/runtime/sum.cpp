@@ -32,6 +32,14 @@ public:
     sum_ += *array_.Element<A>(at);
     return true;
   }
+  template <typename A> void AccumulateContiguous(const A *p, std::size_t n) {
+    INTERMEDIATE sum{sum_};
+    for (std::size_t j{0}; j < n; ++j) {
+      sum += p[j];
+    }
+    sum_ = sum;
+  }
+  void Combine(const IntegerSumAccumulator &that) { sum_ += that.sum_; }
 
 private:
   const Descriptor &array_;
@@ -48,7 +56,7 @@ public:
   }
   template <typename A> bool Accumulate(A x) {
     // Kahan summation
-    auto next{x + correction_};
+    auto next{x - correction_};
     auto oldSum{sum_};
     sum_ += next;
     correction_ = (sum_ - oldSum) - next; // algebraically zero
@@ -57,6 +65,36 @@ public:
   template <typename A> bool AccumulateAt(const SubscriptValue at[]) {
     return Accumulate(*array_.Element<A>(at));
   }
+  // Kahan summation of every stride'th element in independent lanes, which
+  // can be vectorized
+  template <typename A>
+  void AccumulateStrided(const A *p, std::size_t n, std::size_t stride) {
+    constexpr std::size_t lanes{8};
+    INTERMEDIATE sum[lanes]{}, correction[lanes]{};
+    std::size_t j{0};
+    for (; j + lanes <= n; j += lanes) {
+      for (std::size_t k{0}; k < lanes; ++k) {
+        auto next{p[(j + k) * stride] - correction[k]};
+        auto oldSum{sum[k]};
+        sum[k] += next;
+        correction[k] = (sum[k] - oldSum) - next;
+      }
+    }
+    for (std::size_t k{0}; k < lanes; ++k) {
+      Accumulate(sum[k]);
+      Accumulate(-correction[k]);
+    }
+    for (; j < n; ++j) {
+      Accumulate(p[j * stride]);
+    }
+  }
+  template <typename A> void AccumulateContiguous(const A *p, std::size_t n) {
+    AccumulateStrided(p, n, 1);
+  }
+  void Combine(const RealSumAccumulator &that) {
+    Accumulate(that.sum_);
+    Accumulate(-that.correction_);
+  }
 
 private:
   const Descriptor &array_;
@@ -83,6 +121,16 @@ public:
   template <typename A> bool AccumulateAt(const SubscriptValue at[]) {
     return Accumulate(*array_.Element<A>(at));
   }
+  template <typename A> void AccumulateContiguous(const A *p, std::size_t n) {
+    // std::complex<> is laid out as an array of two parts
+    const auto *parts{reinterpret_cast<const typename A::value_type *>(p)};
+    reals_.AccumulateStrided(parts, n, 2);
+    imaginaries_.AccumulateStrided(parts + 1, n, 2);
+  }
+  void Combine(const ComplexSumAccumulator &that) {
+    reals_.Combine(that.reals_);
+    imaginaries_.Combine(that.imaginaries_);
+  }
 
 private:
   const Descriptor &array_;
@@ -13,6 +13,7 @@
 #include "flang/Runtime/cpp-type.h"
 #include "flang/Runtime/descriptor.h"
 #include "flang/Runtime/type-code.h"
+#include <tuple>
 
 using namespace Fortran::runtime;
 using Fortran::common::TypeCategory;
@@ -96,3 +97,93 @@ TEST(Matmul, Basic) {
   EXPECT_TRUE(
       static_cast<bool>(*result.ZeroBasedIndexedElement<std::uint16_t>(3)));
 }
+
+// Checks the blocked kernels against a naive computation.  The operands have
+// small integral values, so that the results are exact whatever the order in
+// which the terms are added.
+template <TypeCategory CAT, int KIND>
+static void CheckContiguousMatmul(int rows, int n, int cols) {
+  using T = CppTypeFor<CAT, KIND>;
+  auto value{[](int i, int j, int m) {
+    if constexpr (CAT == TypeCategory::Complex) {
+      return T((i + 2 * j) % m - m / 2, (3 * i + j) % m - m / 2);
+    } else {
+      return T((i + 2 * j) % m - m / 2);
+    }
+  }};
+  std::vector<T> xData, yData, vData, wData;
+  for (int k{0}; k < n; ++k) {
+    for (int i{0}; i < rows; ++i) {
+      xData.push_back(value(i, k, 7));
+    }
+  }
+  for (int j{0}; j < cols; ++j) {
+    for (int k{0}; k < n; ++k) {
+      yData.push_back(value(k, j, 5));
+    }
+  }
+  for (int k{0}; k < n; ++k) {
+    vData.push_back(value(k, 1, 3));
+  }
+  for (int i{0}; i < rows; ++i) {
+    wData.push_back(value(i, 2, 3));
+  }
+  auto x{MakeArray<CAT, KIND>(std::vector<int>{rows, n}, xData)};
+  auto y{MakeArray<CAT, KIND>(std::vector<int>{n, cols}, yData)};
+  auto v{MakeArray<CAT, KIND>(std::vector<int>{n}, vData)};
+  auto w{MakeArray<CAT, KIND>(std::vector<int>{rows}, wData)};
+  StaticDescriptor<2, true> statDesc;
+  Descriptor &result{statDesc.descriptor()};
+
+  RTNAME(Matmul)(result, *x, *y, __FILE__, __LINE__);
+  ASSERT_EQ(result.rank(), 2);
+  ASSERT_EQ(result.type(), (TypeCode{CAT, KIND}));
+  for (int j{0}; j < cols; ++j) {
+    for (int i{0}; i < rows; ++i) {
+      T expect{};
+      for (int k{0}; k < n; ++k) {
+        expect += xData[i + k * rows] * yData[k + j * n];
+      }
+      ASSERT_EQ(*result.ZeroBasedIndexedElement<T>(i + j * rows), expect)
+          << "M*M " << rows << 'x' << n << 'x' << cols << " at " << i << ','
+          << j;
+    }
+  }
+  result.Destroy();
+
+  RTNAME(Matmul)(result, *x, *v, __FILE__, __LINE__);
+  ASSERT_EQ(result.rank(), 1);
+  for (int i{0}; i < rows; ++i) {
+    T expect{};
+    for (int k{0}; k < n; ++k) {
+      expect += xData[i + k * rows] * vData[k];
+    }
+    ASSERT_EQ(*result.ZeroBasedIndexedElement<T>(i), expect)
+        << "M*V " << rows << 'x' << n << " at " << i;
+  }
+  result.Destroy();
+
+  RTNAME(Matmul)(result, *w, *x, __FILE__, __LINE__);
+  ASSERT_EQ(result.rank(), 1);
+  for (int k{0}; k < n; ++k) {
+    T expect{};
+    for (int i{0}; i < rows; ++i) {
+      expect += wData[i] * xData[i + k * rows];
+    }
+    ASSERT_EQ(*result.ZeroBasedIndexedElement<T>(k), expect)
+        << "V*M " << rows << 'x' << n << " at " << k;
+  }
+  result.Destroy();
+}
+
+TEST(Matmul, Blocked) {
+  // Sizes around the tile and block sizes of the kernels, including an inner
+  // dimension that is split in several slices
+  for (auto [rows, n, cols] : std::vector<std::tuple<int, int, int>>{
+           {16, 16, 16}, {17, 33, 5}, {130, 300, 9}, {3, 600, 41}}) {
+    CheckContiguousMatmul<TypeCategory::Real, 4>(rows, n, cols);
+    CheckContiguousMatmul<TypeCategory::Real, 8>(rows, n, cols);
+    CheckContiguousMatmul<TypeCategory::Complex, 4>(rows, n, cols);
+    CheckContiguousMatmul<TypeCategory::Complex, 8>(rows, n, cols);
+  }
+}
@@ -251,6 +251,50 @@ TEST(IOApiTests, DescriptorOutputTest) {
       << std::string{buffer, sizeof buffer} << "'";
 }
 
+// Numeric arrays are edited with repeated data edit descriptors
+TEST(IOApiTests, NumericArrayOutputTest) {
+  char buffer[64];
+  StaticDescriptor<1> staticDescriptor;
+  Descriptor &desc{staticDescriptor.descriptor()};
+
+  // Values near the bounds of the choice between F and E list-directed
+  // editing, where rounding to one digit reaches the next power of ten
+  double reals[]{0.095, 0.0999, 0.1, 1.5, 9.5e14, 1.0e16, -0.0, 3.25};
+  static const SubscriptValue realExtent[]{8};
+  desc.Establish(TypeCode{TypeCategory::Real, 8}, sizeof(double), reals, 1,
+      realExtent);
+  auto cookie{IONAME(BeginInternalListOutput)(buffer, sizeof buffer)};
+  IONAME(OutputDescriptor)(cookie, desc);
+  ASSERT_EQ(IONAME(EndIoStatement)(cookie), 0);
+  EXPECT_TRUE(CompareFormattedStrings(
+      " .095 .0999 .1 1.5 9.5E+14 1.E+16 -0. 3.25",
+      std::string{buffer, sizeof buffer}))
+      << "list-directed: got '" << std::string{buffer, sizeof buffer} << "'";
+
+  const char *format{"(3F7.3,1X,2E10.3,3F6.1)"};
+  cookie = IONAME(BeginInternalFormattedOutput)(
+      buffer, sizeof buffer, format, std::strlen(format));
+  IONAME(OutputDescriptor)(cookie, desc);
+  ASSERT_EQ(IONAME(EndIoStatement)(cookie), 0);
+  EXPECT_TRUE(CompareFormattedStrings(
+      "  0.095  0.100  0.100  0.150E+01 0.950E+15******  -0.0   3.2",
+      std::string{buffer, sizeof buffer}))
+      << format << ": got '" << std::string{buffer, sizeof buffer} << "'";
+
+  std::int32_t integers[]{1, -22, 333, -4444, 55555};
+  static const SubscriptValue integerExtent[]{5};
+  desc.Establish(TypeCode{TypeCategory::Integer, 4}, sizeof(std::int32_t),
+      integers, 1, integerExtent);
+  format = "(2I4,1X,I0,2I7)";
+  cookie = IONAME(BeginInternalFormattedOutput)(
+      buffer, sizeof buffer, format, std::strlen(format));
+  IONAME(OutputDescriptor)(cookie, desc);
+  ASSERT_EQ(IONAME(EndIoStatement)(cookie), 0);
+  EXPECT_TRUE(CompareFormattedStrings(
+      "   1 -22 333  -4444  55555", std::string{buffer, sizeof buffer}))
+      << format << ": got '" << std::string{buffer, sizeof buffer} << "'";
+}
+
 //------------------------------------------------------------------------------
 /// Tests for output formatting real values
 //------------------------------------------------------------------------------
@@ -9,6 +9,7 @@
 #include "flang/Runtime/reduction.h"
 #include "gtest/gtest.h"
 #include "tools.h"
+#include "../../runtime/environment.h"
 #include "flang/Runtime/allocatable.h"
 #include "flang/Runtime/cpp-type.h"
 #include "flang/Runtime/descriptor.h"
@@ -616,3 +617,55 @@ TEST(Reductions, DotProduct) {
   EXPECT_FALSE(RTNAME(DotProductLogical)(
       *logicalVector2, *logicalVector1, __FILE__, __LINE__));
 }
+
+TEST(Reductions, LargeArrays) {
+  // Large enough to be reduced in several blocks, with a partial last block
+  constexpr int n{3 * 65536 + 17};
+  std::vector<std::int32_t> ints(n);
+  std::vector<double> reals(n), ones(n, 1.0);
+  for (int j{0}; j < n; ++j) {
+    ints[j] = j % 7 - 3;
+  }
+  ints[n / 3] = ints[n - 2] = 1000;
+  std::int32_t expected{0};
+  for (int j{0}; j < n; ++j) {
+    reals[j] = ints[j];
+    expected += ints[j];
+  }
+  ones[5] = 2.0;
+  ones[n - 1] = -3.0;
+  auto intArray{MakeArray<TypeCategory::Integer, 4>(
+      std::vector<int>{n}, std::vector<std::int32_t>{ints})};
+  auto realArray{MakeArray<TypeCategory::Real, 8>(
+      std::vector<int>{n}, std::vector<double>{reals})};
+  auto onesArray{MakeArray<TypeCategory::Real, 8>(
+      std::vector<int>{n}, std::vector<double>{ones})};
+  StaticDescriptor<1, true> statDesc[2];
+  Descriptor &res{statDesc[0].descriptor()};
+  Descriptor &target{statDesc[1].descriptor()};
+  double value{1000.0};
+  target.Establish(TypeCategory::Real, 8, static_cast<void *>(&value), 0,
+      nullptr, CFI_attribute_pointer);
+  int savedThreads{executionEnvironment.reductionThreads};
+  // Results must not depend on the number of threads
+  for (int threads : {1, 3}) {
+    executionEnvironment.reductionThreads = threads;
+    EXPECT_EQ(RTNAME(SumInteger4)(*intArray, __FILE__, __LINE__), expected);
+    EXPECT_EQ(RTNAME(SumReal8)(*realArray, __FILE__, __LINE__), expected);
+    EXPECT_EQ(RTNAME(MaxvalInteger4)(*intArray, __FILE__, __LINE__), 1000);
+    EXPECT_EQ(RTNAME(MinvalReal8)(*realArray, __FILE__, __LINE__), -3.0);
+    EXPECT_EQ(RTNAME(ProductReal8)(*onesArray, __FILE__, __LINE__), -6.0);
+    EXPECT_EQ(
+        RTNAME(DotProductReal8)(*realArray, *onesArray, __FILE__, __LINE__),
+        expected + reals[5] - 4.0 * reals[n - 1]);
+    RTNAME(Findloc)
+    (res, *realArray, target, 8, __FILE__, __LINE__, nullptr, /*BACK=*/false);
+    EXPECT_EQ(*res.ZeroBasedIndexedElement<SubscriptValue>(0), n / 3 + 1);
+    res.Destroy();
+    RTNAME(Findloc)
+    (res, *realArray, target, 8, __FILE__, __LINE__, nullptr, /*BACK=*/true);
+    EXPECT_EQ(*res.ZeroBasedIndexedElement<SubscriptValue>(0), n - 1);
+    res.Destroy();
+  }
+  executionEnvironment.reductionThreads = savedThreads;
+}
@@ -0,0 +1,101 @@
+#include "src/__support/alloc/allocator.h"
+#include "benchmark/benchmark.h"
+#include <cstdint>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+// Allocator interface under test.
+struct LlvmLibcAllocator {
+  static void *allocate(size_t Size) {
+    return __llvm_libc::alloc::allocate(Size);
+  }
+  static void deallocate(void *Ptr) { __llvm_libc::alloc::deallocate(Ptr); }
+};
+
+struct HostAllocator {
+  static void *allocate(size_t Size) { return ::malloc(Size); }
+  static void deallocate(void *Ptr) { ::free(Ptr); }
+};
+
+// Allocates and immediately frees blocks of a fixed size. This measures the
+// thread cache fast path.
+template <typename Allocator>
+static void BM_AllocateFree(benchmark::State &State) {
+  const size_t Size = State.range(0);
+  for (auto _ : State) {
+    void *Ptr = Allocator::allocate(Size);
+    benchmark::DoNotOptimize(Ptr);
+    Allocator::deallocate(Ptr);
+  }
+  State.SetItemsProcessed(State.iterations());
+}
+
+// Keeps a working set of blocks with sizes drawn from a distribution skewed
+// towards small sizes and replaces random blocks. This exercises the central
+// free lists and the page heap.
+template <typename Allocator>
+static void BM_RandomWorkingSet(benchmark::State &State) {
+  const size_t WorkingSet = State.range(0);
+  const size_t MaxSize = State.range(1);
+  std::mt19937 Generator(State.thread_index());
+  std::vector<void *> Blocks(WorkingSet, nullptr);
+  auto RandomSize = [&]() {
+    // Picks a power of two bucket uniformly, then a size inside of it.
+    const unsigned Buckets = 64 - __builtin_clzll(MaxSize);
+    const size_t Bucket = size_t(1) << (Generator() % Buckets);
+    return Bucket + Generator() % Bucket;
+  };
+  for (auto &Block : Blocks)
+    Block = Allocator::allocate(RandomSize());
+  for (auto _ : State) {
+    void *&Block = Blocks[Generator() % WorkingSet];
+    Allocator::deallocate(Block);
+    Block = Allocator::allocate(RandomSize());
+    benchmark::DoNotOptimize(Block);
+  }
+  for (void *Block : Blocks)
+    Allocator::deallocate(Block);
+  State.SetItemsProcessed(State.iterations());
+}
+
+// Allocates blocks on one thread and frees them on another through a shared
+// buffer, so objects constantly migrate between thread caches.
+template <typename Allocator>
+static void BM_ProducerConsumer(benchmark::State &State) {
+  constexpr size_t Slots = 4096;
+  static void *Shared[Slots];
+  const size_t Size = State.range(0);
+  std::mt19937 Generator(State.thread_index());
+  for (auto _ : State) {
+    void *Ptr = Allocator::allocate(Size);
+    void *Old = __atomic_exchange_n(&Shared[Generator() % Slots], Ptr,
+                                    __ATOMIC_ACQ_REL);
+    if (Old != nullptr)
+      Allocator::deallocate(Old);
+  }
+  State.SetItemsProcessed(State.iterations());
+  if (State.thread_index() == 0) {
+    for (void *&Ptr : Shared) {
+      Allocator::deallocate(Ptr);
+      Ptr = nullptr;
+    }
+  }
+}
+
+#define BENCHMARK_ALLOCATOR(ALLOCATOR)                                         \
+  BENCHMARK_TEMPLATE(BM_AllocateFree, ALLOCATOR)                               \
+      ->RangeMultiplier(4)                                                     \
+      ->Range(8, 1 << 20);                                                     \
+  BENCHMARK_TEMPLATE(BM_RandomWorkingSet, ALLOCATOR)                           \
+      ->Args({1024, 1024})                                                     \
+      ->Args({16384, 4096})                                                    \
+      ->Args({4096, 1 << 20})                                                  \
+      ->ThreadRange(1, 16);                                                    \
+  BENCHMARK_TEMPLATE(BM_ProducerConsumer, ALLOCATOR)                           \
+      ->Arg(64)                                                                \
+      ->Arg(1024)                                                              \
+      ->ThreadRange(2, 16)
+
+BENCHMARK_ALLOCATOR(LlvmLibcAllocator);
+BENCHMARK_ALLOCATOR(HostAllocator);
@@ -0,0 +1,94 @@
+#include "benchmark/benchmark.h"
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <vector>
+
+namespace __llvm_libc {
+
+extern void qsort(void *array, size_t array_size, size_t elem_size,
+                  int (*compare)(const void *, const void *));
+
+} // namespace __llvm_libc
+
+// An element of `Size` bytes whose ordering is given by its leading key.
+template <size_t Size> struct Element {
+  static_assert(Size >= sizeof(uint32_t), "Element too small");
+  uint32_t Key;
+  char Payload[Size - sizeof(uint32_t)];
+};
+template <> struct Element<sizeof(uint32_t)> { uint32_t Key; };
+
+template <size_t Size> static int compareElements(const void *L, const void *R) {
+  const uint32_t LK = static_cast<const Element<Size> *>(L)->Key;
+  const uint32_t RK = static_cast<const Element<Size> *>(R)->Key;
+  return (LK > RK) - (LK < RK);
+}
+
+enum class Order { Random, Sorted, Reversed, FewUnique };
+
+template <size_t Size>
+static std::vector<Element<Size>> makeInput(size_t Count, Order O) {
+  std::mt19937 Generator(Count);
+  std::vector<Element<Size>> Result(Count);
+  for (size_t I = 0; I < Count; ++I) {
+    auto &E = Result[I];
+    std::memset(&E, 0, sizeof(E));
+    switch (O) {
+    case Order::Random:
+      E.Key = Generator();
+      break;
+    case Order::Sorted:
+      E.Key = I;
+      break;
+    case Order::Reversed:
+      E.Key = Count - I;
+      break;
+    case Order::FewUnique:
+      E.Key = Generator() % 16;
+      break;
+    }
+  }
+  return Result;
+}
+
+using QsortFunction = void (*)(void *, size_t, size_t,
+                               int (*)(const void *, const void *));
+
+template <size_t Size, QsortFunction Qsort>
+static void BM_Qsort(benchmark::State &State) {
+  const size_t Count = State.range(0);
+  const auto Input = makeInput<Size>(Count, static_cast<Order>(State.range(1)));
+  std::vector<Element<Size>> Buffer(Count);
+  for (auto _ : State) {
+    State.PauseTiming();
+    Buffer = Input;
+    State.ResumeTiming();
+    Qsort(Buffer.data(), Count, Size, compareElements<Size>);
+    benchmark::ClobberMemory();
+  }
+  State.SetItemsProcessed(State.iterations() * Count);
+  State.SetBytesProcessed(State.iterations() * Count * Size);
+}
+
+static void QsortArguments(benchmark::internal::Benchmark *B) {
+  for (int64_t O : {static_cast<int64_t>(Order::Random),
+                    static_cast<int64_t>(Order::Sorted),
+                    static_cast<int64_t>(Order::Reversed),
+                    static_cast<int64_t>(Order::FewUnique)})
+    for (int64_t Count : {16, 256, 4096, 65536, 1 << 20})
+      B->Args({Count, O});
+  B->ArgNames({"count", "order"});
+}
+
+#define BENCHMARK_QSORT(SIZE)                                                  \
+  BENCHMARK_TEMPLATE(BM_Qsort, SIZE, __llvm_libc::qsort)                       \
+      ->Apply(QsortArguments);                                                 \
+  BENCHMARK_TEMPLATE(BM_Qsort, SIZE, ::qsort)->Apply(QsortArguments)
+
+BENCHMARK_QSORT(4);
+BENCHMARK_QSORT(8);
+BENCHMARK_QSORT(16);
+BENCHMARK_QSORT(24);
+BENCHMARK_QSORT(64);
@@ -24,22 +24,16 @@
 namespace __llvm_libc {
 namespace fputil {
 
+// The builtins lower to a single fmadd instruction. Unlike inline assembly,
+// they can be vectorized when used in loops.
 template <typename T>
 cpp::enable_if_t<cpp::is_same_v<T, float>, T> fma(T x, T y, T z) {
-  float result;
-  __asm__ __volatile__("fmadd %s0, %s1, %s2, %s3\n\t"
-                       : "=w"(result)
-                       : "w"(x), "w"(y), "w"(z));
-  return result;
+  return __builtin_fmaf(x, y, z);
 }
 
 template <typename T>
 cpp::enable_if_t<cpp::is_same_v<T, double>, T> fma(T x, T y, T z) {
-  double result;
-  __asm__ __volatile__("fmadd %d0, %d1, %d2, %d3\n\t"
-                       : "=w"(result)
-                       : "w"(x), "w"(y), "w"(z));
-  return result;
+  return __builtin_fma(x, y, z);
 }
 
 } // namespace fputil
@@ -20,32 +20,21 @@
 #endif
 
 #include "src/__support/CPP/type_traits.h"
-#include <immintrin.h>
 
 namespace __llvm_libc {
 namespace fputil {
 
+// The builtins lower to the same instructions as the corresponding intrinsics,
+// but unlike them they can be vectorized when used in loops.
 template <typename T>
 static inline cpp::enable_if_t<cpp::is_same_v<T, float>, T> fma(T x, T y, T z) {
-  float result;
-  __m128 xmm = _mm_load_ss(&x);           // NOLINT
-  __m128 ymm = _mm_load_ss(&y);           // NOLINT
-  __m128 zmm = _mm_load_ss(&z);           // NOLINT
-  __m128 r = _mm_fmadd_ss(xmm, ymm, zmm); // NOLINT
-  _mm_store_ss(&result, r);               // NOLINT
-  return result;
+  return __builtin_fmaf(x, y, z);
 }
 
 template <typename T>
 static inline cpp::enable_if_t<cpp::is_same_v<T, double>, T> fma(T x, T y,
                                                                  T z) {
-  double result;
-  __m128d xmm = _mm_load_sd(&x);           // NOLINT
-  __m128d ymm = _mm_load_sd(&y);           // NOLINT
-  __m128d zmm = _mm_load_sd(&z);           // NOLINT
-  __m128d r = _mm_fmadd_sd(xmm, ymm, zmm); // NOLINT
-  _mm_store_sd(&result, r);                // NOLINT
-  return result;
+  return __builtin_fma(x, y, z);
 }
 
 } // namespace fputil
@@ -19,23 +19,17 @@
 #error "SSE4.2 instruction set is not supported"
 #endif
 
-#include <immintrin.h>
-
 namespace __llvm_libc {
 namespace fputil {
 
-static inline float nearest_integer(float x) {
-  __m128 xmm = _mm_set_ss(x); // NOLINT
-  __m128 ymm =
-      _mm_round_ss(xmm, xmm, _MM_ROUND_NEAREST | _MM_FROUND_NO_EXC); // NOLINT
-  return ymm[0];
-}
+// Round to nearest, ties to even, regardless of the rounding mode. With SSE4.1
+// the builtins lower to a single round instruction, the same one emitted for
+// _mm_round_ss/_mm_round_sd with _MM_FROUND_TO_NEAREST_INT. Unlike the scalar
+// intrinsics, they can be vectorized when used in loops.
+static inline float nearest_integer(float x) { return __builtin_roundevenf(x); }
 
 static inline double nearest_integer(double x) {
-  __m128d xmm = _mm_set_sd(x); // NOLINT
-  __m128d ymm =
-      _mm_round_sd(xmm, xmm, _MM_ROUND_NEAREST | _MM_FROUND_NO_EXC); // NOLINT
-  return ymm[0];
+  return __builtin_roundeven(x);
 }
 
 } // namespace fputil
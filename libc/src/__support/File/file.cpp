@@ -9,6 +9,7 @@
 #include "file.h"
 
 #include "src/__support/CPP/ArrayRef.h"
+#include "src/string/memory_utils/memcpy_implementations.h"
 
 #include <errno.h>
 #include <stdio.h>
@@ -37,6 +38,21 @@ size_t File::write_unlocked(const void *data, size_t len) {
 }
 
 size_t File::write_unlocked_nbf(const void *data, size_t len) {
+  if (pos > 0 && platform_writev != nullptr) {
+    // Write out the buffer and |data| with a single platform write.
+    const size_t write_size = pos;
+    size_t bytes_written = platform_writev(this, buf, write_size, data, len);
+    pos = 0; // Buffer is now empty so reset pos to the beginning.
+    if (bytes_written < write_size) {
+      err = true;
+      return 0; // No bytes from data were written, so return 0.
+    }
+    const size_t written = bytes_written - write_size;
+    if (written < len)
+      err = true;
+    return written;
+  }
+
   if (pos > 0) { // If the buffer is not empty
     // Flush the buffer
     const size_t write_size = pos;
@@ -60,7 +76,10 @@ size_t File::write_unlocked_fbf(const void *data, size_t len) {
   const size_t bufspace = bufsize - pos;
 
   // If data is too large to be buffered at all, then just write it unbuffered.
-  if (len > bufspace + bufsize)
+  // When the platform can write the buffer and |data| in one go, do so as soon
+  // as |data| fills a whole buffer, which avoids copying it into the buffer.
+  if (len > bufspace + bufsize ||
+      (platform_writev != nullptr && len >= bufsize))
     return write_unlocked_nbf(data, len);
 
   // we split |data| (conceptually) using the split point. Then we handle the
@@ -82,9 +101,8 @@ size_t File::write_unlocked_fbf(const void *data, size_t len) {
   cpp::MutableArrayRef<uint8_t> bufref(buf, bufsize);
 
   // Copy the first piece into the buffer.
-  // TODO: Replace the for loop below with a call to internal memcpy.
-  for (size_t i = 0; i < primary.size(); ++i)
-    bufref[pos + i] = primary[i];
+  inline_memcpy(reinterpret_cast<char *>(bufref.data() + pos),
+                reinterpret_cast<const char *>(primary.data()), primary.size());
   pos += primary.size();
 
   // If there is no remainder, we can return early, since the first piece has
@@ -108,9 +126,9 @@ size_t File::write_unlocked_fbf(const void *data, size_t len) {
   // know that if the second piece has data in it then the buffer has been
   // flushed, meaning that pos is always 0.
   if (remainder.size() < bufsize) {
-    // TODO: Replace the for loop below with a call to internal memcpy.
-    for (size_t i = 0; i < remainder.size(); ++i)
-      bufref[i] = remainder[i];
+    inline_memcpy(reinterpret_cast<char *>(bufref.data()),
+                  reinterpret_cast<const char *>(remainder.data()),
+                  remainder.size());
     pos = remainder.size();
   } else {
     size_t bytes_written =
@@ -190,17 +208,16 @@ size_t File::read_unlocked(void *data, size_t len) {
   // available_data is never a wrapped around value.
   size_t available_data = read_limit - pos;
   if (len <= available_data) {
-    // TODO: Replace the for loop below with a call to internal memcpy.
-    for (size_t i = 0; i < len; ++i)
-      dataref[i] = bufref[i + pos];
+    inline_memcpy(reinterpret_cast<char *>(dataref.data()),
+                  reinterpret_cast<const char *>(bufref.data() + pos), len);
     pos += len;
     return len;
   }
 
   // Copy all of the available data.
-  // TODO: Replace the for loop with a call to internal memcpy.
-  for (size_t i = 0; i < available_data; ++i)
-    dataref[i] = bufref[i + pos];
+  inline_memcpy(reinterpret_cast<char *>(dataref.data()),
+                reinterpret_cast<const char *>(bufref.data() + pos),
+                available_data);
   read_limit = pos = 0; // Reset the pointers.
 
   size_t to_fetch = len - available_data;
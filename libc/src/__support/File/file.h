@@ -10,6 +10,7 @@
 #define LLVM_LIBC_SRC_SUPPORT_OSUTIL_FILE_H
 
 #include "src/__support/threads/mutex.h"
+#include "src/__support/threads/single_threaded.h"
 
 #include <stddef.h>
 #include <stdint.h>
@@ -27,6 +28,10 @@ public:
   using UnlockFunc = void(File *);
 
   using WriteFunc = size_t(File *, const void *, size_t);
+  // Writes two pieces of data back to back with a single platform operation.
+  // Returns the total number of bytes written.
+  using WritevFunc = size_t(File *, const void *, size_t, const void *,
+                            size_t);
   using ReadFunc = size_t(File *, void *, size_t);
   using SeekFunc = int(File *, long, int);
   using CloseFunc = int(File *);
@@ -68,6 +73,9 @@ private:
   SeekFunc *platform_seek;
   CloseFunc *platform_close;
   FlushFunc *platform_flush;
+  // Optional. When available, it is used to write out the buffered data
+  // together with the data being written instead of issuing two writes.
+  WritevFunc *platform_writev;
 
   Mutex mutex;
 
@@ -97,14 +105,23 @@ private:
   bool eof;
   bool err;
 
-  // This is a convenience RAII class to lock and unlock file objects.
+  // This is a convenience RAII class to lock and unlock file objects. The
+  // lock is skipped while the process is single threaded as nothing can
+  // contend for it, and no thread can be created while it is held.
   class FileLock {
     File *file;
+    bool locked;
 
   public:
-    explicit FileLock(File *f) : file(f) { file->lock(); }
+    explicit FileLock(File *f) : file(f), locked(!is_single_threaded()) {
+      if (locked)
+        file->lock();
+    }
 
-    ~FileLock() { file->unlock(); }
+    ~FileLock() {
+      if (locked)
+        file->unlock();
+    }
 
     FileLock(const FileLock &) = delete;
     FileLock(FileLock &&) = delete;
@@ -128,25 +145,27 @@ public:
   // potentially lead to static initialization order fiasco.
   constexpr File(WriteFunc *wf, ReadFunc *rf, SeekFunc *sf, CloseFunc *cf,
                  FlushFunc *ff, void *buffer, size_t buffer_size,
-                 int buffer_mode, bool owned, ModeFlags modeflags)
+                 int buffer_mode, bool owned, ModeFlags modeflags,
+                 WritevFunc *wvf = nullptr)
       : platform_write(wf), platform_read(rf), platform_seek(sf),
-        platform_close(cf), platform_flush(ff), mutex(false, false, false),
-        buf(buffer), bufsize(buffer_size), bufmode(buffer_mode), own_buf(owned),
-        mode(modeflags), pos(0), prev_op(FileOp::NONE), read_limit(0),
-        eof(false), err(false) {}
+        platform_close(cf), platform_flush(ff), platform_writev(wvf),
+        mutex(false, false, false), buf(buffer), bufsize(buffer_size),
+        bufmode(buffer_mode), own_buf(owned), mode(modeflags), pos(0),
+        prev_op(FileOp::NONE), read_limit(0), eof(false), err(false) {}
 
   // This function helps initialize the various fields of the File data
   // structure after a allocating memory for it via a call to malloc.
   static void init(File *f, WriteFunc *wf, ReadFunc *rf, SeekFunc *sf,
                    CloseFunc *cf, FlushFunc *ff, void *buffer,
                    size_t buffer_size, int buffer_mode, bool owned,
-                   ModeFlags modeflags) {
+                   ModeFlags modeflags, WritevFunc *wvf = nullptr) {
     Mutex::init(&f->mutex, false, false, false);
     f->platform_write = wf;
     f->platform_read = rf;
     f->platform_seek = sf;
     f->platform_close = cf;
     f->platform_flush = ff;
+    f->platform_writev = wvf;
     f->buf = reinterpret_cast<uint8_t *>(buffer);
     f->bufsize = buffer_size;
     f->bufmode = buffer_mode;
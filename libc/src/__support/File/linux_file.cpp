@@ -21,6 +21,7 @@ namespace __llvm_libc {
 namespace {
 
 size_t write_func(File *, const void *, size_t);
+size_t writev_func(File *, const void *, size_t, const void *, size_t);
 size_t read_func(File *, void *, size_t);
 int seek_func(File *, long, int);
 int close_func(File *);
@@ -35,14 +36,16 @@ public:
   constexpr LinuxFile(int file_descriptor, void *buffer, size_t buffer_size,
                       int buffer_mode, bool owned, File::ModeFlags modeflags)
       : File(&write_func, &read_func, &seek_func, &close_func, flush_func,
-             buffer, buffer_size, buffer_mode, owned, modeflags),
+             buffer, buffer_size, buffer_mode, owned, modeflags,
+             &writev_func),
         fd(file_descriptor) {}
 
   static void init(LinuxFile *f, int file_descriptor, void *buffer,
                    size_t buffer_size, int buffer_mode, bool owned,
                    File::ModeFlags modeflags) {
     File::init(f, &write_func, &read_func, &seek_func, &close_func, &flush_func,
-               buffer, buffer_size, buffer_mode, owned, modeflags);
+               buffer, buffer_size, buffer_mode, owned, modeflags,
+               &writev_func);
     f->fd = file_descriptor;
   }
 
@@ -61,6 +64,23 @@ size_t write_func(File *f, const void *data, size_t size) {
   return ret;
 }
 
+size_t writev_func(File *f, const void *data1, size_t size1, const void *data2,
+                   size_t size2) {
+  // Same layout as struct iovec, which the libc headers do not provide yet.
+  struct IOVec {
+    const void *base;
+    size_t len;
+  };
+  auto *lf = reinterpret_cast<LinuxFile *>(f);
+  IOVec iov[2] = {{data1, size1}, {data2, size2}};
+  long ret = __llvm_libc::syscall(SYS_writev, lf->get_fd(), iov, 2);
+  if (ret < 0) {
+    errno = -ret;
+    return 0;
+  }
+  return ret;
+}
+
 size_t read_func(File *f, void *buf, size_t size) {
   auto *lf = reinterpret_cast<LinuxFile *>(f);
   long ret = __llvm_libc::syscall(SYS_read, lf->get_fd(), buf, size);
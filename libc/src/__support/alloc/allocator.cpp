@@ -0,0 +1,339 @@
+//===-- Implementation of the LLVM libc allocator -------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/__support/alloc/allocator.h"
+#include "src/__support/alloc/page_heap.h"
+#include "src/__support/alloc/size_classes.h"
+#include "src/__support/common.h"
+#include "src/__support/CPP/atomic.h"
+#include "src/__support/threads/mutex.h"
+#include "src/__support/threads/thread.h"
+#include "src/string/memory_utils/memcpy_implementations.h"
+#include "src/string/memory_utils/memset_implementations.h"
+
+#include <stdint.h>
+
+namespace __llvm_libc {
+namespace alloc {
+
+// Free objects are linked through their first word.
+static inline void *next_object(void *object) {
+  return *reinterpret_cast<void **>(object);
+}
+
+static inline void set_next_object(void *object, void *next) {
+  *reinterpret_cast<void **>(object) = next;
+}
+
+// The central free list of a size class. It carves spans obtained from the
+// page heap into objects and hands them out in batches.
+class CentralFreeList {
+  // Number of full batches the transfer cache can hold.
+  static constexpr size_t TRANSFER_SLOTS = 64;
+
+  Mutex mutex;
+  // Spans of this size class which have free objects.
+  SpanList nonempty_spans;
+  // Transfer cache: linked lists of exactly class_to_batch() objects.
+  void *batches[TRANSFER_SLOTS];
+  size_t num_batches;
+
+  bool populate(unsigned size_class) {
+    Span *span = page_heap.allocate_span(class_to_pages(size_class));
+    if (span == nullptr)
+      return false;
+    span->size_class = uint16_t(size_class);
+
+    const size_t object_size = class_to_size(size_class);
+    const size_t num_objects = span->bytes() / object_size;
+    // Link the objects in address order so that consecutive allocations are
+    // adjacent in memory.
+    void *head = nullptr;
+    for (size_t i = num_objects; i > 0; --i) {
+      void *object =
+          reinterpret_cast<void *>(span->start + (i - 1) * object_size);
+      set_next_object(object, head);
+      head = object;
+    }
+    span->free_objects = head;
+    nonempty_spans.push_front(span);
+    return true;
+  }
+
+  void release_object(void *object) {
+    Span *span = span_of(object);
+    if (span->free_objects == nullptr)
+      nonempty_spans.push_front(span);
+    set_next_object(object, span->free_objects);
+    span->free_objects = object;
+    if (--span->allocated == 0) {
+      SpanList::remove(span);
+      page_heap.free_span(span);
+    }
+  }
+
+public:
+  constexpr CentralFreeList()
+      : mutex(false, false, false), nonempty_spans(), batches(),
+        num_batches(0) {}
+
+  // Removes up to |count| objects and returns them as a linked list in
+  // |head|. Returns the number of objects removed, which is only less than
+  // |count| if memory is exhausted.
+  size_t remove_range(unsigned size_class, void **head, size_t count) {
+    MutexLock lock(&mutex);
+    if (count == class_to_batch(size_class) && num_batches > 0) {
+      *head = batches[--num_batches];
+      return count;
+    }
+
+    void *list = nullptr;
+    size_t removed = 0;
+    while (removed < count) {
+      if (nonempty_spans.empty() && !populate(size_class))
+        break;
+      Span *span = nonempty_spans.first();
+      while (removed < count && span->free_objects != nullptr) {
+        void *object = span->free_objects;
+        span->free_objects = next_object(object);
+        set_next_object(object, list);
+        list = object;
+        ++span->allocated;
+        ++removed;
+      }
+      if (span->free_objects == nullptr)
+        SpanList::remove(span);
+    }
+    *head = list;
+    return removed;
+  }
+
+  // Inserts the linked list of |count| objects starting at |head|.
+  void insert_range(unsigned size_class, void *head, size_t count) {
+    MutexLock lock(&mutex);
+    if (count == class_to_batch(size_class) && num_batches < TRANSFER_SLOTS) {
+      batches[num_batches++] = head;
+      return;
+    }
+    while (head != nullptr) {
+      void *next = next_object(head);
+      release_object(head);
+      head = next;
+    }
+  }
+};
+
+static CentralFreeList central_lists[NUM_SIZE_CLASSES];
+
+// A per-thread cache of free objects of every size class. The length a free
+// list may reach before objects are returned to the central free list starts
+// at one batch and grows every time the list runs empty, so that threads
+// which allocate a lot of objects of a class fetch them in larger amounts.
+// The cache of a thread is flushed when the thread exits, see
+// register_exit_flush below.
+static void flush_on_thread_exit();
+
+// Registers the thread exit callback which flushes the thread cache. This is
+// done lazily from the refill path, which every thread goes through before
+// it caches its first object, so programs which never allocate do not pay
+// for the callback.
+static inline void register_exit_flush() {
+  static cpp::Atomic<bool> registered(false);
+  if (likely(registered.load(cpp::MemoryOrder::RELAXED)))
+    return;
+  bool expected = false;
+  if (registered.compare_exchange_strong(expected, true))
+    register_thread_exit_callback(&flush_on_thread_exit);
+}
+
+class ThreadCache {
+  static constexpr size_t MAX_CACHED_BYTES = 2 * 1024 * 1024;
+  static constexpr size_t MAX_LENGTH_IN_BATCHES = 8;
+
+  struct FreeList {
+    void *head;
+    uint32_t length;
+    uint32_t max_length;
+  };
+
+  FreeList lists[NUM_SIZE_CLASSES];
+  size_t cached_bytes;
+
+  // Pops |count| objects from |list| and returns them to the central list.
+  void release(unsigned size_class, FreeList &list, size_t count) {
+    void *head = list.head;
+    void *tail = head;
+    for (size_t i = 1; i < count; ++i)
+      tail = next_object(tail);
+    list.head = next_object(tail);
+    set_next_object(tail, nullptr);
+    list.length -= uint32_t(count);
+    cached_bytes -= count * class_to_size(size_class);
+    central_lists[size_class].insert_range(size_class, head, count);
+  }
+
+  void *refill(unsigned size_class) {
+    register_exit_flush();
+    const size_t batch = class_to_batch(size_class);
+    void *head;
+    const size_t count =
+        central_lists[size_class].remove_range(size_class, &head, batch);
+    if (count == 0)
+      return nullptr;
+
+    FreeList &list = lists[size_class];
+    list.head = next_object(head);
+    list.length = uint32_t(count - 1);
+    cached_bytes += (count - 1) * class_to_size(size_class);
+    if (list.max_length < batch * MAX_LENGTH_IN_BATCHES)
+      list.max_length += uint32_t(batch);
+    return head;
+  }
+
+  // Gives half of every free list back when the cache grows too large.
+  void scavenge() {
+    for (unsigned size_class = 1; size_class < NUM_SIZE_CLASSES;
+         ++size_class) {
+      FreeList &list = lists[size_class];
+      if (list.length > 0)
+        release(size_class, list, (list.length + 1) / 2);
+    }
+  }
+
+public:
+  void *allocate(unsigned size_class) {
+    FreeList &list = lists[size_class];
+    void *object = list.head;
+    if (unlikely(object == nullptr))
+      return refill(size_class);
+    list.head = next_object(object);
+    --list.length;
+    cached_bytes -= class_to_size(size_class);
+    return object;
+  }
+
+  void deallocate(void *object, unsigned size_class) {
+    FreeList &list = lists[size_class];
+    set_next_object(object, list.head);
+    list.head = object;
+    ++list.length;
+    cached_bytes += class_to_size(size_class);
+
+    const size_t batch = class_to_batch(size_class);
+    const size_t max_length = list.max_length > batch ? list.max_length : batch;
+    if (unlikely(list.length > max_length))
+      release(size_class, list, batch);
+    if (unlikely(cached_bytes > MAX_CACHED_BYTES))
+      scavenge();
+  }
+
+  void flush() {
+    for (unsigned size_class = 1; size_class < NUM_SIZE_CLASSES;
+         ++size_class) {
+      FreeList &list = lists[size_class];
+      if (list.length > 0)
+        release(size_class, list, list.length);
+    }
+  }
+};
+
+// Zero initialized, so it needs no dynamic initialization on thread creation.
+static thread_local ThreadCache thread_cache;
+
+static void flush_on_thread_exit() { thread_cache.flush(); }
+
+static void *allocate_pages(size_t size, size_t alignment) {
+  if (size <= MAX_PAGE_RUN_SIZE && alignment <= PAGE_BYTES) {
+    Span *span = page_heap.allocate_span((size + PAGE_BYTES - 1) >> PAGE_SHIFT);
+    return span == nullptr ? nullptr : reinterpret_cast<void *>(span->start);
+  }
+  return map_allocation(size, alignment);
+}
+
+void *allocate(size_t size) {
+  if (likely(size <= MAX_SMALL_SIZE))
+    return thread_cache.allocate(size_to_class(size));
+  return allocate_pages(size, MIN_ALIGNMENT);
+}
+
+void *allocate_aligned(size_t alignment, size_t size) {
+  if (alignment <= MIN_ALIGNMENT)
+    return allocate(size);
+  if (size <= MAX_SMALL_SIZE && alignment <= PAGE_BYTES) {
+    // Objects sit at multiples of their size from the page aligned start of
+    // their span, so any class whose size is a multiple of the alignment
+    // yields suitably aligned objects.
+    const size_t min_size = size < alignment ? alignment : size;
+    for (unsigned size_class = size_to_class(min_size);
+         size_class < NUM_SIZE_CLASSES; ++size_class) {
+      if (class_to_size(size_class) % alignment == 0)
+        return thread_cache.allocate(size_class);
+    }
+  }
+  return allocate_pages(size, alignment);
+}
+
+void deallocate(void *ptr) {
+  if (ptr == nullptr)
+    return;
+  ChunkHeader *chunk = chunk_of(ptr);
+  if (unlikely(chunk->kind == ChunkKind::MAPPED))
+    return unmap_allocation(chunk);
+  Span *span = span_of(ptr);
+  if (unlikely(span->size_class == 0))
+    return page_heap.free_span(span);
+  thread_cache.deallocate(ptr, span->size_class);
+}
+
+size_t usable_size(const void *ptr) {
+  ChunkHeader *chunk = chunk_of(ptr);
+  if (chunk->kind == ChunkKind::MAPPED)
+    return chunk->usable_bytes;
+  Span *span = span_of(ptr);
+  if (span->size_class == 0)
+    return span->bytes();
+  return class_to_size(span->size_class);
+}
+
+void *reallocate(void *ptr, size_t size) {
+  if (ptr == nullptr)
+    return allocate(size);
+  // Keep the block if it is large enough and not more than twice as large as
+  // needed.
+  const size_t old_size = usable_size(ptr);
+  if (size <= old_size && size >= old_size / 2)
+    return ptr;
+  void *new_ptr = allocate(size);
+  if (new_ptr == nullptr)
+    return nullptr;
+  inline_memcpy(reinterpret_cast<char *>(new_ptr),
+                reinterpret_cast<const char *>(ptr),
+                size < old_size ? size : old_size);
+  deallocate(ptr);
+  return new_ptr;
+}
+
+void *allocate_zeroed(size_t size) {
+  // Directly mapped memory is fresh from the OS and already zeroed.
+  if (size > MAX_PAGE_RUN_SIZE)
+    return map_allocation(size, MIN_ALIGNMENT);
+  void *ptr = allocate(size);
+  if (ptr != nullptr)
+    inline_memset(reinterpret_cast<char *>(ptr), 0, size);
+  return ptr;
+}
+
+void flush_thread_cache() { thread_cache.flush(); }
+
+void release_free_memory() {
+  flush_thread_cache();
+  page_heap.release_all();
+}
+
+} // namespace alloc
+} // namespace __llvm_libc
@@ -0,0 +1,65 @@
+//===-- Interface of the LLVM libc allocator --------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_LIBC_SRC_SUPPORT_ALLOC_ALLOCATOR_H
+#define LLVM_LIBC_SRC_SUPPORT_ALLOC_ALLOCATOR_H
+
+#include <stddef.h>
+
+namespace __llvm_libc {
+namespace alloc {
+
+// The allocator is organized in three tiers:
+//
+// 1. Each thread owns a cache holding free objects of every size class. Most
+//    allocations and deallocations are served from it without any locking.
+// 2. Each size class has a central free list, protected by its own mutex. It
+//    moves objects to and from thread caches in batches. Full batches are
+//    parked in a transfer cache so they can move between threads without
+//    being taken apart.
+// 3. The page heap hands out spans of pages carved from huge page sized
+//    chunks, coalesces them when they are freed and returns unused pages to
+//    the OS.
+//
+// Allocations too large for a size class are served as page runs by the page
+// heap, or mapped directly from the OS when they are larger still.
+
+// Returns a block of at least |size| bytes aligned to MIN_ALIGNMENT, or
+// nullptr if memory is exhausted.
+void *allocate(size_t size);
+
+// Returns a block of at least |size| bytes aligned to |alignment|, which must
+// be a power of two, or nullptr if memory is exhausted.
+void *allocate_aligned(size_t alignment, size_t size);
+
+// Like allocate, but the returned block is zero filled.
+void *allocate_zeroed(size_t size);
+
+// Frees a block returned by one of the allocation functions. |ptr| may be
+// nullptr.
+void deallocate(void *ptr);
+
+// Resizes the block at |ptr| to |size| bytes, moving it if needed. Follows
+// the semantics of realloc except that a |size| of zero returns a minimal
+// block.
+void *reallocate(void *ptr, size_t size);
+
+// Returns the number of usable bytes of the block at |ptr|.
+size_t usable_size(const void *ptr);
+
+// Returns the free objects cached by the calling thread to the central free
+// lists.
+void flush_thread_cache();
+
+// Returns all free pages of the page heap to the OS.
+void release_free_memory();
+
+} // namespace alloc
+} // namespace __llvm_libc
+
+#endif // LLVM_LIBC_SRC_SUPPORT_ALLOC_ALLOCATOR_H
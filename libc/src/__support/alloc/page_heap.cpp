@@ -0,0 +1,313 @@
+//===-- Implementation of the page heap of the LLVM libc allocator --------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/__support/alloc/page_heap.h"
+#include "src/__support/OSUtil/syscall.h" // For internal syscall function.
+
+#include <sys/mman.h>    // For PROT_* and MAP_* flags.
+#include <sys/syscall.h> // For syscall numbers.
+
+namespace __llvm_libc {
+namespace alloc {
+
+PageHeap page_heap;
+
+static void *os_map(size_t size) {
+  long ret_val = __llvm_libc::syscall(SYS_mmap, nullptr, size,
+                                      PROT_READ | PROT_WRITE,
+                                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  // Negative values in the last page are error codes, see mmap.cpp.
+  if (ret_val < 0 && ret_val > -long(PAGE_BYTES))
+    return nullptr;
+  return reinterpret_cast<void *>(ret_val);
+}
+
+static void os_unmap(uintptr_t addr, size_t size) {
+  if (size != 0)
+    __llvm_libc::syscall(SYS_munmap, addr, size);
+}
+
+// Maps |size| bytes and returns the address A inside the mapping for which
+// A + |leading_bytes| is |alignment| aligned. Only [A, A + |mapped_size|) is
+// kept, the excess at both ends is unmapped.
+static uintptr_t os_map_aligned(size_t size, size_t alignment,
+                                size_t leading_bytes, size_t mapped_size) {
+  void *mem = os_map(size);
+  if (mem == nullptr)
+    return 0;
+  const uintptr_t base = uintptr_t(mem);
+  const uintptr_t aligned =
+      ((base + leading_bytes + alignment - 1) & ~(alignment - 1)) -
+      leading_bytes;
+  os_unmap(base, aligned - base);
+  os_unmap(aligned + mapped_size, base + size - (aligned + mapped_size));
+  return aligned;
+}
+
+// Span descriptors live outside of the chunks they describe. They are carved
+// out of regions obtained from the OS and recycled through a free list. Only
+// accessed with the page heap mutex held.
+class SpanArena {
+  static constexpr size_t REGION_BYTES = 64 * 1024;
+
+  Span *free_spans = nullptr;
+  uintptr_t cursor = 0;
+  uintptr_t limit = 0;
+
+public:
+  Span *allocate() {
+    if (free_spans != nullptr) {
+      Span *span = free_spans;
+      free_spans = span->next;
+      return span;
+    }
+    if (cursor + sizeof(Span) > limit) {
+      void *region = os_map(REGION_BYTES);
+      if (region == nullptr)
+        return nullptr;
+      cursor = uintptr_t(region);
+      limit = cursor + REGION_BYTES;
+    }
+    Span *span = reinterpret_cast<Span *>(cursor);
+    cursor += sizeof(Span);
+    return span;
+  }
+
+  void deallocate(Span *span) {
+    span->next = free_spans;
+    free_spans = span;
+  }
+};
+
+static SpanArena span_arena;
+
+static void set_page_map(Span *span) {
+  ChunkHeader *chunk = chunk_of(reinterpret_cast<void *>(span->start + 1));
+  const size_t first = (span->start - uintptr_t(chunk)) >> PAGE_SHIFT;
+  for (size_t i = 0; i < span->num_pages; ++i)
+    chunk->page_map[first + i] = span;
+}
+
+// Returns the free neighbouring span starting at page |page| of the chunk
+// containing |span|, or nullptr if there is none.
+static Span *free_neighbour(Span *span, uintptr_t page) {
+  ChunkHeader *chunk = chunk_of(reinterpret_cast<void *>(span->start + 1));
+  const uintptr_t chunk_start = uintptr_t(chunk);
+  if (page < chunk_start + HEADER_PAGES * PAGE_BYTES ||
+      page >= chunk_start + CHUNK_BYTES)
+    return nullptr;
+  Span *neighbour = chunk->page_map[(page - chunk_start) >> PAGE_SHIFT];
+  if (neighbour == nullptr || neighbour->in_use)
+    return nullptr;
+  return neighbour;
+}
+
+void PageHeap::insert_free_span(Span *span) {
+  span->in_use = false;
+  span->size_class = 0;
+  free_list_for(span->num_pages).push_front(span);
+  if (!span->released)
+    unreleased_free_bytes += span->bytes();
+}
+
+void PageHeap::remove_free_span(Span *span) {
+  SpanList::remove(span);
+  if (!span->released)
+    unreleased_free_bytes -= span->bytes();
+}
+
+Span *PageHeap::find_free_span(size_t num_pages) {
+  for (size_t n = num_pages; n < NUM_EXACT_LISTS; ++n) {
+    if (!free_lists[n].empty())
+      return free_lists[n].first();
+  }
+  // Best fit among the large spans, preferring lower addresses to keep
+  // allocations packed in as few chunks as possible.
+  Span *best = nullptr;
+  SpanList &large = free_lists[0];
+  for (Span *span = large.first(); span != large.end(); span = span->next) {
+    if (span->num_pages < num_pages)
+      continue;
+    if (best == nullptr || span->num_pages < best->num_pages ||
+        (span->num_pages == best->num_pages && span->start < best->start))
+      best = span;
+  }
+  return best;
+}
+
+bool PageHeap::grow() {
+  const uintptr_t chunk_start =
+      os_map_aligned(2 * CHUNK_BYTES, CHUNK_BYTES, 0, CHUNK_BYTES);
+  if (chunk_start == 0)
+    return false;
+  // Ask for transparent huge pages. Failure is not fatal, the chunk is then
+  // simply backed by small pages.
+  __llvm_libc::syscall(SYS_madvise, chunk_start, CHUNK_BYTES, MADV_HUGEPAGE);
+
+  Span *span = span_arena.allocate();
+  if (span == nullptr) {
+    os_unmap(chunk_start, CHUNK_BYTES);
+    return false;
+  }
+  mapped_bytes += CHUNK_BYTES;
+
+  // Fresh anonymous memory is zeroed, so the page map starts out empty.
+  ChunkHeader *chunk = reinterpret_cast<ChunkHeader *>(chunk_start);
+  chunk->kind = ChunkKind::PAGES;
+  *span = Span{nullptr,
+               nullptr,
+               chunk_start + HEADER_PAGES * PAGE_BYTES,
+               USABLE_PAGES_PER_CHUNK,
+               nullptr,
+               0,
+               0,
+               false,
+               true};
+  set_page_map(span);
+  insert_free_span(span);
+  return true;
+}
+
+Span *PageHeap::allocate_span(size_t num_pages) {
+  MutexLock lock(&mutex);
+  Span *span = find_free_span(num_pages);
+  if (span == nullptr) {
+    if (!grow())
+      return nullptr;
+    span = find_free_span(num_pages);
+  }
+  remove_free_span(span);
+
+  if (span->num_pages > num_pages) {
+    // Split off the tail and keep it in the page heap.
+    Span *rest = span_arena.allocate();
+    if (rest != nullptr) {
+      *rest = Span{nullptr,
+                   nullptr,
+                   span->start + (num_pages << PAGE_SHIFT),
+                   span->num_pages - num_pages,
+                   nullptr,
+                   0,
+                   0,
+                   false,
+                   span->released};
+      span->num_pages = num_pages;
+      set_page_map(rest);
+      insert_free_span(rest);
+    }
+  }
+
+  span->in_use = true;
+  span->released = false;
+  span->free_objects = nullptr;
+  span->allocated = 0;
+  span->size_class = 0;
+  set_page_map(span);
+  return span;
+}
+
+void PageHeap::free_span(Span *span) {
+  MutexLock lock(&mutex);
+  span->in_use = false;
+  span->released = false;
+
+  // Coalesce with the free neighbours on both sides whose pages are still
+  // backed. A span is released as a whole, so merging in released pages
+  // would count them as unreleased again.
+  Span *prev = free_neighbour(span, span->start - PAGE_BYTES);
+  if (prev != nullptr && !prev->released) {
+    remove_free_span(prev);
+    span->start = prev->start;
+    span->num_pages += prev->num_pages;
+    span_arena.deallocate(prev);
+  }
+  Span *next = free_neighbour(span, span->start + span->bytes());
+  if (next != nullptr && !next->released) {
+    remove_free_span(next);
+    span->num_pages += next->num_pages;
+    span_arena.deallocate(next);
+  }
+  set_page_map(span);
+  insert_free_span(span);
+
+  if (unreleased_free_bytes > RELEASE_THRESHOLD) {
+    release_free_pages(/*whole_chunks_only=*/true);
+    if (unreleased_free_bytes > RELEASE_THRESHOLD / 2)
+      release_free_pages(/*whole_chunks_only=*/false);
+  }
+}
+
+void PageHeap::release_span(Span *span) {
+  // MADV_DONTNEED drops the pages immediately. The next access faults in
+  // zeroed pages, so released spans can be reused without further work.
+  __llvm_libc::syscall(SYS_madvise, span->start, span->bytes(),
+                       MADV_DONTNEED);
+  unreleased_free_bytes -= span->bytes();
+  span->released = true;
+}
+
+void PageHeap::release_free_pages(bool whole_chunks_only) {
+  for (SpanList &list : free_lists) {
+    for (Span *span = list.first(); span != list.end(); span = span->next) {
+      if (span->released)
+        continue;
+      if (whole_chunks_only && span->num_pages != USABLE_PAGES_PER_CHUNK)
+        continue;
+      release_span(span);
+    }
+  }
+}
+
+void PageHeap::release_all() {
+  MutexLock lock(&mutex);
+  release_free_pages(/*whole_chunks_only=*/false);
+}
+
+size_t PageHeap::get_mapped_bytes() {
+  MutexLock lock(&mutex);
+  return mapped_bytes;
+}
+
+void *map_allocation(size_t size, size_t alignment) {
+  // The header occupies the chunk aligned start of the region and the
+  // allocation starts |offset| bytes after it, so that chunk_of finds the
+  // header from the allocation address.
+  const size_t usable_bytes = (size + PAGE_BYTES - 1) & ~(PAGE_BYTES - 1);
+  if (usable_bytes < size)
+    return nullptr;
+  if (alignment < PAGE_BYTES)
+    alignment = PAGE_BYTES;
+  const size_t offset = alignment < CHUNK_BYTES ? alignment : CHUNK_BYTES;
+  const size_t region_alignment =
+      alignment < CHUNK_BYTES ? CHUNK_BYTES : alignment;
+  const size_t mapping_bytes = offset + usable_bytes;
+  const size_t reserve_bytes = mapping_bytes + region_alignment;
+  if (mapping_bytes < usable_bytes || reserve_bytes < mapping_bytes)
+    return nullptr;
+
+  // When the alignment exceeds the chunk size, the allocation rather than the
+  // header has to be aligned.
+  const size_t leading_bytes = alignment < CHUNK_BYTES ? 0 : offset;
+  const uintptr_t start = os_map_aligned(reserve_bytes, region_alignment,
+                                         leading_bytes, mapping_bytes);
+  if (start == 0)
+    return nullptr;
+
+  ChunkHeader *chunk = reinterpret_cast<ChunkHeader *>(start);
+  chunk->kind = ChunkKind::MAPPED;
+  chunk->mapping_bytes = mapping_bytes;
+  chunk->usable_bytes = usable_bytes;
+  return reinterpret_cast<void *>(start + offset);
+}
+
+void unmap_allocation(ChunkHeader *chunk) {
+  os_unmap(uintptr_t(chunk), chunk->mapping_bytes);
+}
+
+} // namespace alloc
+} // namespace __llvm_libc
@@ -0,0 +1,166 @@
+//===-- Page heap of the LLVM libc allocator --------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_LIBC_SRC_SUPPORT_ALLOC_PAGE_HEAP_H
+#define LLVM_LIBC_SRC_SUPPORT_ALLOC_PAGE_HEAP_H
+
+#include "src/__support/alloc/size_classes.h"
+#include "src/__support/threads/mutex.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace __llvm_libc {
+namespace alloc {
+
+// A span is a run of contiguous pages inside a chunk. A span is either free
+// and owned by the page heap, or in use. In use spans either hold objects of a
+// single size class or serve one page level allocation (size class 0).
+struct Span {
+  Span *next;
+  Span *prev;
+  uintptr_t start;  // Address of the first page.
+  size_t num_pages; // Number of pages in the span.
+
+  void *free_objects; // Singly linked list of free objects of a size class.
+  uint32_t allocated; // Number of objects handed out from this span.
+  uint16_t size_class;
+  bool in_use;
+  bool released; // True if the pages of this free span were given back to
+                 // the OS.
+
+  size_t bytes() const { return num_pages << PAGE_SHIFT; }
+};
+
+// An intrusive circular doubly linked list of spans.
+class SpanList {
+  Span head;
+
+public:
+  constexpr SpanList()
+      : head{&head, &head, 0, 0, nullptr, 0, 0, false, false} {}
+
+  bool empty() const { return head.next == &head; }
+  Span *first() { return head.next; }
+  Span *end() { return &head; }
+
+  void push_front(Span *span) {
+    span->next = head.next;
+    span->prev = &head;
+    head.next->prev = span;
+    head.next = span;
+  }
+
+  static void remove(Span *span) {
+    span->prev->next = span->next;
+    span->next->prev = span->prev;
+    span->next = span->prev = nullptr;
+  }
+};
+
+// Kinds of memory regions whose header sits at the start of a chunk.
+enum class ChunkKind : uint32_t {
+  // A chunk carved into spans by the page heap.
+  PAGES = 0x5041474b,
+  // A single allocation mapped directly from the OS.
+  MAPPED = 0x4d415050,
+};
+
+// The header found at the start of every chunk aligned region. For PAGES
+// chunks, |page_map| maps every page in the chunk to the span containing it.
+struct ChunkHeader {
+  ChunkKind kind;
+  size_t mapping_bytes; // Size of a MAPPED region, header included.
+  size_t usable_bytes;  // Usable size of a MAPPED allocation.
+  Span *page_map[PAGES_PER_CHUNK];
+};
+
+// The pages at the start of a PAGES chunk which hold its header.
+constexpr size_t HEADER_PAGES =
+    (sizeof(ChunkHeader) + PAGE_BYTES - 1) / PAGE_BYTES;
+constexpr size_t USABLE_PAGES_PER_CHUNK = PAGES_PER_CHUNK - HEADER_PAGES;
+
+static_assert(MAX_PAGE_RUN_SIZE <= USABLE_PAGES_PER_CHUNK * PAGE_BYTES,
+              "Page runs must fit in a chunk");
+
+// Returns the header of the chunk aligned region containing |ptr|, which must
+// have been returned by the allocator. Allocations never start at the very
+// beginning of a chunk, so the byte before |ptr| is always inside the region.
+inline ChunkHeader *chunk_of(const void *ptr) {
+  return reinterpret_cast<ChunkHeader *>((uintptr_t(ptr) - 1) &
+                                         ~(CHUNK_BYTES - 1));
+}
+
+// Returns the span containing |ptr|, which must be inside a PAGES chunk.
+inline Span *span_of(const void *ptr) {
+  ChunkHeader *chunk = chunk_of(ptr);
+  return chunk->page_map[(uintptr_t(ptr) - uintptr_t(chunk)) >> PAGE_SHIFT];
+}
+
+// The central page heap. It obtains huge page sized chunks from the OS,
+// hands out spans of pages and coalesces them again when they are freed.
+// Free pages in excess of a threshold are returned to the OS with madvise,
+// preferring chunks which are entirely free so that huge pages backing
+// partially used chunks are kept intact.
+class PageHeap {
+  // Free spans of N pages are kept in free_lists[N] for N < NUM_EXACT_LISTS,
+  // larger ones in free_lists[0].
+  static constexpr size_t NUM_EXACT_LISTS = 128;
+
+  // Free pages are released to the OS when more than this many bytes of
+  // unreleased free pages accumulate.
+  static constexpr size_t RELEASE_THRESHOLD = 32 * 1024 * 1024;
+
+  Mutex mutex;
+  SpanList free_lists[NUM_EXACT_LISTS];
+  size_t unreleased_free_bytes;
+  size_t mapped_bytes;
+
+  SpanList &free_list_for(size_t num_pages) {
+    return free_lists[num_pages < NUM_EXACT_LISTS ? num_pages : 0];
+  }
+
+  Span *find_free_span(size_t num_pages);
+  bool grow();
+  void insert_free_span(Span *span);
+  void remove_free_span(Span *span);
+  void release_span(Span *span);
+  void release_free_pages(bool whole_chunks_only);
+
+public:
+  constexpr PageHeap()
+      : mutex(false, false, false), free_lists(), unreleased_free_bytes(0),
+        mapped_bytes(0) {}
+
+  // Returns an in use span of |num_pages| pages, or nullptr if the OS is out
+  // of memory. |num_pages| should not exceed USABLE_PAGES_PER_CHUNK.
+  Span *allocate_span(size_t num_pages);
+
+  // Returns |span| to the page heap.
+  void free_span(Span *span);
+
+  // Returns all free pages to the OS.
+  void release_all();
+
+  // Total number of bytes obtained from the OS for chunks.
+  size_t get_mapped_bytes();
+};
+
+// Maps a region for a single allocation of |size| bytes aligned to
+// |alignment| directly from the OS. Returns nullptr on failure.
+void *map_allocation(size_t size, size_t alignment);
+
+// Unmaps an allocation made by map_allocation.
+void unmap_allocation(ChunkHeader *chunk);
+
+extern PageHeap page_heap;
+
+} // namespace alloc
+} // namespace __llvm_libc
+
+#endif // LLVM_LIBC_SRC_SUPPORT_ALLOC_PAGE_HEAP_H
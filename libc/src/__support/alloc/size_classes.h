@@ -0,0 +1,102 @@
+//===-- Size classes of the LLVM libc allocator -----------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_LIBC_SRC_SUPPORT_ALLOC_SIZE_CLASSES_H
+#define LLVM_LIBC_SRC_SUPPORT_ALLOC_SIZE_CLASSES_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace __llvm_libc {
+namespace alloc {
+
+// The allocator manages memory in pages which are carved out of naturally
+// aligned chunks the size of a huge page.
+constexpr size_t PAGE_SHIFT = 12;
+constexpr size_t PAGE_BYTES = size_t(1) << PAGE_SHIFT;
+constexpr size_t CHUNK_SHIFT = 21;
+constexpr size_t CHUNK_BYTES = size_t(1) << CHUNK_SHIFT;
+constexpr size_t PAGES_PER_CHUNK = CHUNK_BYTES / PAGE_BYTES;
+
+// Every allocation is at least aligned to MIN_ALIGNMENT, which matches the
+// alignment of max_align_t on the supported targets.
+constexpr size_t MIN_ALIGNMENT = 16;
+
+// Requests up to MAX_SMALL_SIZE bytes are rounded up to a size class and
+// served from per-thread caches. Requests up to MAX_PAGE_RUN_SIZE bytes are
+// served as page runs from the page heap. Anything larger is mapped directly.
+constexpr size_t MAX_SMALL_SIZE = 256 * 1024;
+constexpr size_t MAX_PAGE_RUN_SIZE = 1024 * 1024;
+
+// Size classes are 16 bytes apart up to 128 bytes. After that, every power of
+// two interval is split into four classes, which bounds internal
+// fragmentation to 25%. Class 0 is reserved to denote page level allocations.
+constexpr unsigned NUM_LINEAR_CLASSES = 8;
+constexpr size_t MAX_LINEAR_SIZE = NUM_LINEAR_CLASSES * MIN_ALIGNMENT;
+constexpr unsigned LINEAR_SIZE_SHIFT = 7; // log2(MAX_LINEAR_SIZE)
+constexpr unsigned CLASSES_PER_DOUBLING = 4;
+constexpr unsigned NUM_SIZE_CLASSES = 53;
+
+constexpr unsigned log2_floor(size_t value) {
+  return unsigned(sizeof(size_t) * 8 - 1 - __builtin_clzl(value));
+}
+
+// Returns the size class serving allocations of |size| bytes. |size| should
+// not exceed MAX_SMALL_SIZE.
+constexpr unsigned size_to_class(size_t size) {
+  if (size <= MAX_LINEAR_SIZE)
+    return size == 0 ? 1 : unsigned((size + MIN_ALIGNMENT - 1) / MIN_ALIGNMENT);
+  const unsigned exponent = log2_floor(size - 1);
+  const size_t base = size_t(1) << exponent;
+  const size_t step = base / CLASSES_PER_DOUBLING;
+  return NUM_LINEAR_CLASSES + 1 +
+         (exponent - LINEAR_SIZE_SHIFT) * CLASSES_PER_DOUBLING +
+         unsigned((size - 1 - base) / step);
+}
+
+// Returns the size of the objects in |size_class|.
+constexpr size_t class_to_size(unsigned size_class) {
+  if (size_class <= NUM_LINEAR_CLASSES)
+    return size_class * MIN_ALIGNMENT;
+  const unsigned index = size_class - NUM_LINEAR_CLASSES - 1;
+  const size_t base = size_t(1)
+                      << (LINEAR_SIZE_SHIFT + index / CLASSES_PER_DOUBLING);
+  return base + (index % CLASSES_PER_DOUBLING + 1) *
+                    (base / CLASSES_PER_DOUBLING);
+}
+
+// Returns the number of pages of the spans carved into objects of
+// |size_class|. Spans hold at least eight objects unless that would make them
+// larger than 64 KiB.
+constexpr size_t class_to_pages(unsigned size_class) {
+  constexpr size_t MAX_SPAN_BYTES = 64 * 1024;
+  const size_t object_size = class_to_size(size_class);
+  size_t span_bytes = object_size * 8;
+  if (span_bytes > MAX_SPAN_BYTES)
+    span_bytes = object_size > MAX_SPAN_BYTES ? object_size : MAX_SPAN_BYTES;
+  return (span_bytes + PAGE_BYTES - 1) / PAGE_BYTES;
+}
+
+// Returns the number of objects moved at once between a thread cache and the
+// central free lists.
+constexpr size_t class_to_batch(unsigned size_class) {
+  constexpr size_t BATCH_BYTES = 64 * 1024;
+  constexpr size_t MAX_BATCH = 32;
+  const size_t batch = BATCH_BYTES / class_to_size(size_class);
+  return batch < 1 ? 1 : (batch > MAX_BATCH ? MAX_BATCH : batch);
+}
+
+static_assert(size_to_class(MAX_SMALL_SIZE) == NUM_SIZE_CLASSES - 1,
+              "The largest size class must serve MAX_SMALL_SIZE");
+static_assert(class_to_size(NUM_SIZE_CLASSES - 1) == MAX_SMALL_SIZE,
+              "Inconsistent size class mapping");
+
+} // namespace alloc
+} // namespace __llvm_libc
+
+#endif // LLVM_LIBC_SRC_SUPPORT_ALLOC_SIZE_CLASSES_H
@@ -12,6 +12,7 @@
 #include "src/__support/CPP/error.h"
 #include "src/__support/OSUtil/syscall.h"           // For syscall functions.
 #include "src/__support/threads/linux/futex_word.h" // For FutexWordType
+#include "src/__support/threads/single_threaded.h"
 
 #ifdef LLVM_LIBC_ARCH_AARCH64
 #include <arm_acle.h>
@@ -124,6 +125,10 @@ static void start_thread() {
     retval = long(attrib->retval.stdc_retval);
   }
 
+  // Run the exit callbacks before the thread resources, which include the
+  // TLS, can be cleaned up.
+  call_thread_exit_callbacks();
+
   uint32_t joinable_state = uint32_t(DetachState::JOINABLE);
   if (!attrib->detach_state.compare_exchange_strong(
           joinable_state, uint32_t(DetachState::EXITING))) {
@@ -191,6 +196,10 @@ int Thread::run(ThreadStyle style, ThreadRunner runner, void *arg, void *stack,
   clear_tid->val = CLEAR_TID_VALUE;
   attrib->platform_data = clear_tid;
 
+  // Locks elided while the process was single threaded have to be taken from
+  // now on. This has to happen before the new thread can run.
+  mark_multi_threaded();
+
   // The clone syscall takes arguments in an architecture specific order.
   // Also, we want the result of the syscall to be in a register as the child
   // thread gets a completely different stack after it is created. The stack
@@ -0,0 +1,15 @@
+//===--- Definition of the single threaded process flag ---------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "single_threaded.h"
+
+namespace __llvm_libc {
+
+cpp::Atomic<bool> process_single_threaded(true);
+
+} // namespace __llvm_libc
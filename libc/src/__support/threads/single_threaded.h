@@ -0,0 +1,33 @@
+//===--- Tracking of whether the process is single threaded -----*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_LIBC_SRC_SUPPORT_THREADS_SINGLE_THREADED_H
+#define LLVM_LIBC_SRC_SUPPORT_THREADS_SINGLE_THREADED_H
+
+#include "src/__support/CPP/atomic.h"
+
+namespace __llvm_libc {
+
+// True until the process creates its first thread through the Thread class,
+// after which it stays false. As long as it is true, no other thread can
+// contend for internal locks, so callers can skip taking locks which are
+// never held across the creation of a thread.
+extern cpp::Atomic<bool> process_single_threaded;
+
+inline bool is_single_threaded() {
+  return process_single_threaded.load(cpp::MemoryOrder::RELAXED);
+}
+
+// Called by the thread implementation before it creates a new thread.
+inline void mark_multi_threaded() {
+  process_single_threaded.store(false, cpp::MemoryOrder::RELEASE);
+}
+
+} // namespace __llvm_libc
+
+#endif // LLVM_LIBC_SRC_SUPPORT_THREADS_SINGLE_THREADED_H
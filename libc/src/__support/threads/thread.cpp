@@ -12,4 +12,30 @@ namespace __llvm_libc {
 
 thread_local Thread self;
 
+static constexpr size_t MAX_THREAD_EXIT_CALLBACKS = 8;
+
+// The callbacks are stored as integers as cpp::Atomic only holds arithmetic
+// types. A zero slot has been reserved but not written yet.
+static cpp::Atomic<uintptr_t> exit_callbacks[MAX_THREAD_EXIT_CALLBACKS];
+static cpp::Atomic<size_t> exit_callback_count;
+
+bool register_thread_exit_callback(ThreadExitCallback *callback) {
+  size_t index = exit_callback_count.fetch_add(1);
+  if (index >= MAX_THREAD_EXIT_CALLBACKS)
+    return false;
+  exit_callbacks[index].store(reinterpret_cast<uintptr_t>(callback));
+  return true;
+}
+
+void call_thread_exit_callbacks() {
+  size_t count = exit_callback_count.load();
+  if (count > MAX_THREAD_EXIT_CALLBACKS)
+    count = MAX_THREAD_EXIT_CALLBACKS;
+  for (size_t i = 0; i < count; ++i) {
+    uintptr_t callback = exit_callbacks[i].load();
+    if (callback != 0)
+      reinterpret_cast<ThreadExitCallback *>(callback)();
+  }
+}
+
 } // namespace __llvm_libc
@@ -169,6 +169,18 @@ struct Thread {
 
 extern thread_local Thread self;
 
+using ThreadExitCallback = void();
+
+// Registers |callback| to be called on every thread created with the Thread
+// class right before it exits, after the thread function has returned.
+// Callbacks cannot be unregistered. Returns false if the callback table is
+// full.
+bool register_thread_exit_callback(ThreadExitCallback *callback);
+
+// Calls the registered thread exit callbacks on the calling thread. Platform
+// implementations of the Thread class call this from the exiting thread.
+void call_thread_exit_callbacks();
+
 } // namespace __llvm_libc
 
 #endif // LLVM_LIBC_SRC_SUPPORT_THREADS_THREAD_H
@@ -0,0 +1,267 @@
+//===-- Main paths of single precision math functions -----------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_LIBC_SRC_MATH_GENERIC_FAST_PATHS_H
+#define LLVM_LIBC_SRC_MATH_GENERIC_FAST_PATHS_H
+
+#include "common_constants.h"
+#include "src/__support/FPUtil/BasicOperations.h"
+#include "src/__support/FPUtil/FPBits.h"
+#include "src/__support/FPUtil/PolyEval.h"
+#include "src/__support/FPUtil/except_value_utils.h"
+#include "src/__support/FPUtil/multiply_add.h"
+#include "src/__support/FPUtil/nearest_integer.h"
+
+#include <stdint.h>
+
+#if defined(LIBC_TARGET_HAS_FMA)
+#include "range_reduction_fma.h"
+#else
+#include "range_reduction.h"
+#endif
+
+// The main paths of expf, logf, sinf and cosf, which handle all inputs except
+// special values, exceptional values and inputs needing a different range
+// reduction. They are free of branches so that loops calling them can be
+// vectorized. The scalar functions and their vector variants share them, which
+// guarantees that both produce the same results.
+
+namespace __llvm_libc {
+
+#if defined(LIBC_TARGET_HAS_FMA)
+using fma::FAST_PASS_BOUND;
+using fma::large_range_reduction;
+using fma::N_EXCEPTS;
+using fma::SinfExcepts;
+using fma::small_range_reduction;
+#else
+using generic::FAST_PASS_BOUND;
+using generic::large_range_reduction;
+using generic::N_EXCEPTS;
+using generic::SinfExcepts;
+using generic::small_range_reduction;
+#endif
+
+// Returns true if expf(x) is computed by expf_main_path, that is if
+// -89 < x < 89, |x| > 2^-25 and x is not an exceptional value.
+static inline bool expf_in_main_range(uint32_t x_u) {
+  uint32_t x_abs = x_u & 0x7fff'ffffU;
+  return x_abs < 0x42b2'0000U && x_abs > 0x3280'0000U && x_u != 0xc236'bd8cU;
+}
+
+// Computes exp(x) for -104 < x < 89.
+static inline float expf_main_path(float x) {
+  // For -104 < x < 89, to compute exp(x), we perform the following range
+  // reduction: find hi, mid, lo such that:
+  //   x = hi + mid + lo, in which
+  //     hi is an integer,
+  //     mid * 2^7 is an integer
+  //     -2^(-8) <= lo < 2^-8.
+  // In particular,
+  //   hi + mid = round(x * 2^7) * 2^(-7).
+  // Then,
+  //   exp(x) = exp(hi + mid + lo) = exp(hi) * exp(mid) * exp(lo).
+  // We store exp(hi) and exp(mid) in the lookup tables EXP_M1 and EXP_M2
+  // respectively.  exp(lo) is computed using a degree-4 minimax polynomial
+  // generated by Sollya.
+
+  // x_hi = (hi + mid) * 2^7 = round(x * 2^7).
+  float kf = fputil::nearest_integer(x * 0x1.0p7f);
+  // Subtract (hi + mid) from x to get lo.
+  double xd = static_cast<double>(fputil::multiply_add(kf, -0x1.0p-7f, x));
+  int x_hi = static_cast<int>(kf);
+  x_hi += 104 << 7;
+  // hi = x_hi >> 7
+  double exp_hi = EXP_M1[x_hi >> 7];
+  // mid * 2^7 = x_hi & 0x0000'007fU;
+  double exp_mid = EXP_M2[x_hi & 0x7f];
+  // Degree-4 minimax polynomial generated by Sollya with the following
+  // commands:
+  //   > display = hexadecimal;
+  //   > Q = fpminimax(expm1(x)/x, 3, [|D...|], [-2^-8, 2^-8]);
+  //   > Q;
+  double exp_lo =
+      fputil::polyeval(xd, 0x1p0, 0x1.ffffffffff777p-1, 0x1.000000000071cp-1,
+                       0x1.555566668e5e7p-3, 0x1.55555555ef243p-5);
+  return static_cast<float>(exp_hi * exp_mid * exp_lo);
+}
+
+// Inputs for which logf needs a correction depending on the rounding mode.
+static constexpr int LOGF_EXCEPTS = 8;
+static constexpr uint32_t LOGF_EXCEPT_INPUTS[LOGF_EXCEPTS] = {
+    0x41178febU, 0x4c5d65a5U, 0x65d890d3U, 0x6f31a8ecU,
+    0x3f800001U, 0x500ffb03U, 0x7a17f30aU, 0x5cd69e88U};
+
+// Returns true if logf(x) is computed by logf_main_path without any
+// adjustment, that is if x is a positive normal number which is not an
+// exceptional value.
+static inline bool logf_in_main_range(uint32_t x_u) {
+  using FPBits = typename fputil::FPBits<float>;
+  bool except = false;
+  for (int i = 0; i < LOGF_EXCEPTS; ++i)
+    except |= x_u == LOGF_EXCEPT_INPUTS[i];
+  return x_u >= FPBits::MIN_NORMAL && x_u <= FPBits::MAX_NORMAL && !except;
+}
+
+// Computes log(2^m * x) for a positive normal number x.
+static inline float logf_main_path(fputil::FPBits<float> xbits, int m) {
+  constexpr double LOG_2 = 0x1.62e42fefa39efp-1;
+  using FPBits = typename fputil::FPBits<float>;
+
+  m += xbits.get_exponent();
+  // Set bits to 1.m
+  xbits.set_unbiased_exponent(0x7F);
+  int f_index = xbits.get_mantissa() >> 16;
+
+  FPBits f = xbits;
+  f.bits &= ~0x0000'FFFF;
+
+  double d = static_cast<float>(xbits) - static_cast<float>(f);
+  d *= ONE_OVER_F[f_index];
+
+  double extra_factor =
+      fputil::multiply_add(static_cast<double>(m), LOG_2, LOG_F[f_index]);
+
+  double r = __llvm_libc::fputil::polyeval(
+      d, extra_factor, 0x1.fffffffffffacp-1, -0x1.fffffffef9cb2p-2,
+      0x1.5555513bc679ap-2, -0x1.fff4805ea441p-3, 0x1.930180dbde91ap-3);
+
+  return static_cast<float>(r);
+}
+
+// Returns true if sinf(x) is computed by sinf_main_path, that is if
+// pi/16 < |x| < FAST_PASS_BOUND and x is not an exceptional value.
+static inline bool sinf_in_main_range(uint32_t x_abs) {
+  bool except = false;
+  for (int i = 0; i < N_EXCEPTS; ++i)
+    except |= x_abs == SinfExcepts.inputs[i];
+  return x_abs > 0x3e49'0fdbU && x_abs < FAST_PASS_BOUND && !except;
+}
+
+// Computes sin(x) from k and y such that x = (k + y) * pi/16 and |y| <= 0.5.
+static inline float sinf_eval(int64_t k, double y) {
+  // After range reduction, k = round(x * 16 / pi) and y = (x * 16 / pi) - k.
+  // So k is an integer and -0.5 <= y <= 0.5.
+  // Then sin(x) = sin((k + y)*pi/16)
+  //             = sin(y*pi/16) * cos(k*pi/16) + cos(y*pi/16) * sin(k*pi/16)
+
+  double ysq = y * y;
+
+  // Degree-6 minimax even polynomial for sin(y*pi/16)/y generated by Sollya
+  // with:
+  // > Q = fpminimax(sin(y*pi/16)/y, [|0, 2, 4, 6|], [|D...|], [0, 0.5]);
+  double sin_y =
+      fputil::polyeval(ysq, 0x1.921fb54442d17p-3, -0x1.4abbce6256adp-10,
+                       0x1.466bc5a5ac6b3p-19, -0x1.32bdcb4207562p-29);
+  // Degree-8 minimax even polynomial for cos(y*pi/16) generated by Sollya with:
+  // > P = fpminimax(cos(x*pi/16), [|0, 2, 4, 6, 8|], [|1, D...|], [0, 0.5]);
+  // Note that cosm1_y = cos(y*pi/16) - 1.
+  double cosm1_y =
+      ysq * fputil::polyeval(ysq, -0x1.3bd3cc9be45dcp-6, 0x1.03c1f081b08ap-14,
+                             -0x1.55d3c6fb0fb6ep-24, 0x1.e1d3d60f58873p-35);
+
+  double sin_k = SIN_K_PI_OVER_16[k & 31];
+  // cos(k * pi/16) = sin(k * pi/16 + pi/2) = sin((k + 8) * pi/16).
+  // cos_k = y * cos(k * pi/16)
+  double cos_k = y * SIN_K_PI_OVER_16[(k + 8) & 31];
+
+  // Combine the results with the sine of sum formula:
+  //   sin(x) = sin((k + y)*pi/16)
+  //          = sin(y*pi/16) * cos(k*pi/16) + cos(y*pi/16) * sin(k*pi/16)
+  //          = sin_y * cos_k + (1 + cosm1_y) * sin_k
+  //          = sin_y * cos_k + (cosm1_y * sin_k + sin_k)
+  return fputil::multiply_add(sin_y, cos_k,
+                              fputil::multiply_add(cosm1_y, sin_k, sin_k));
+}
+
+// Computes sin(x) for |x| < FAST_PASS_BOUND.
+static inline float sinf_main_path(float x) {
+  double y;
+  int64_t k = small_range_reduction(static_cast<double>(x), y);
+  return sinf_eval(k, y);
+}
+
+// Exceptional cases for cosf.
+static constexpr int COSF_EXCEPTS = 6;
+
+static constexpr fputil::ExceptionalValues<float, COSF_EXCEPTS> CosfExcepts{
+    /* inputs */ {
+        0x55325019, // x = 0x1.64a032p43
+        0x5922aa80, // x = 0x1.4555p51
+        0x5aa4542c, // x = 0x1.48a858p54
+        0x5f18b878, // x = 0x1.3170fp63
+        0x6115cb11, // x = 0x1.2b9622p67
+        0x7beef5ef, // x = 0x1.ddebdep120
+    },
+    /* outputs (RZ, RU offset, RD offset, RN offset) */
+    {
+        {0x3f4ea5d2, 1, 0, 0}, // x = 0x1.64a032p43, cos(x) = 0x1.9d4ba4p-1 (RZ)
+        {0x3f08aebe, 1, 0, 1}, // x = 0x1.4555p51, cos(x) = 0x1.115d7cp-1 (RZ)
+        {0x3efa40a4, 1, 0, 0}, // x = 0x1.48a858p54, cos(x) = 0x1.f48148p-2 (RZ)
+        {0x3f7f14bb, 1, 0, 0}, // x = 0x1.3170fp63, cos(x) = 0x1.fe2976p-1 (RZ)
+        {0x3f78142e, 1, 0, 1}, // x = 0x1.2b9622p67, cos(x) = 0x1.f0285cp-1 (RZ)
+        {0x3f08a21c, 1, 0,
+         0}, // x = 0x1.ddebdep120, cos(x) = 0x1.114438p-1 (RZ)
+    }};
+
+// Returns true if cosf(x) is computed by cosf_main_path, that is if
+// 2^-12 <= |x| < FAST_PASS_BOUND and x is not an exceptional value.
+static inline bool cosf_in_main_range(uint32_t x_abs) {
+  bool except = false;
+  for (int i = 0; i < COSF_EXCEPTS; ++i)
+    except |= x_abs == CosfExcepts.inputs[i];
+  return x_abs >= 0x3980'0000U && x_abs < FAST_PASS_BOUND && !except;
+}
+
+// Computes cos(x) from k and y such that |x| = (k + y) * pi/16 and
+// |y| <= 0.5.
+static inline float cosf_eval(int64_t k, double y) {
+  // After range reduction, k = round(x * 16 / pi) and y = (x * 16 / pi) - k.
+  // So k is an integer and -0.5 <= y <= 0.5.
+  // Then cos(x) = cos((k + y)*pi/16)
+  //             = cos(y*pi/16) * cos(k*pi/16) - sin(y*pi/16) * sin(k*pi/16)
+
+  double ysq = y * y;
+
+  // Degree-6 minimax even polynomial for sin(y*pi/16)/y generated by Sollya
+  // with:
+  // > Q = fpminimax(sin(y*pi/16)/y, [|0, 2, 4, 6|], [|D...|], [0, 0.5]);
+  double sin_y =
+      y * fputil::polyeval(ysq, 0x1.921fb54442d17p-3, -0x1.4abbce6256adp-10,
+                           0x1.466bc5a5ac6b3p-19, -0x1.32bdcb4207562p-29);
+  // Degree-8 minimax even polynomial for cos(y*pi/16) generated by Sollya with:
+  // > P = fpminimax(cos(x*pi/16), [|0, 2, 4, 6, 8|], [|1, D...|], [0, 0.5]);
+  // Note that cosm1_y = cos(y*pi/16) - 1.
+  double cosm1_y =
+      ysq * fputil::polyeval(ysq, -0x1.3bd3cc9be45dcp-6, 0x1.03c1f081b08ap-14,
+                             -0x1.55d3c6fb0fb6ep-24, 0x1.e1d3d60f58873p-35);
+
+  double sin_k = -SIN_K_PI_OVER_16[k & 31];
+  // cos(k * pi/16) = sin(k * pi/16 + pi/2) = sin((k + 8) * pi/16).
+  // cos_k = y * cos(k * pi/16)
+  double cos_k = SIN_K_PI_OVER_16[(k + 8) & 31];
+
+  // Combine the results with the sine of sum formula:
+  //   cos(x) = cos((k + y)*pi/16)
+  //          = cos(y*pi/16) * cos(k*pi/16) - sin(y*pi/16) * sin(k*pi/16)
+  //          = cosm1_y * cos_k + sin_y * sin_k
+  //          = (cosm1_y * cos_k + cos_k) + sin_y * sin_k
+  return fputil::multiply_add(sin_y, sin_k,
+                              fputil::multiply_add(cosm1_y, cos_k, cos_k));
+}
+
+// Computes cos(x) for |x| < FAST_PASS_BOUND.
+static inline float cosf_main_path(float x) {
+  double y;
+  int64_t k = small_range_reduction(static_cast<double>(fputil::abs(x)), y);
+  return cosf_eval(k, y);
+}
+
+} // namespace __llvm_libc
+
+#endif // LLVM_LIBC_SRC_MATH_GENERIC_FAST_PATHS_H
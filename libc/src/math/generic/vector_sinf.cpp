@@ -0,0 +1,39 @@
+//===-- Vector variants of sinf -------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/math/vector_sinf.h"
+#include "vector_utils.h"
+#include "src/__support/common.h"
+
+namespace __llvm_libc {
+
+#if defined(LLVM_LIBC_VECTOR_MATH_SSE)
+LLVM_LIBC_FUNCTION(Float32x4, _ZGVbN4v_sinf, (Float32x4 x)) {
+  return vector::eval<vector::SinfKernel>(x);
+}
+#endif
+
+#if defined(LLVM_LIBC_VECTOR_MATH_AVX2)
+LLVM_LIBC_FUNCTION(Float32x8, _ZGVdN8v_sinf, (Float32x8 x)) {
+  return vector::eval<vector::SinfKernel>(x);
+}
+#endif
+
+#if defined(LLVM_LIBC_VECTOR_MATH_AVX512)
+LLVM_LIBC_FUNCTION(Float32x16, _ZGVeN16v_sinf, (Float32x16 x)) {
+  return vector::eval<vector::SinfKernel>(x);
+}
+#endif
+
+#if defined(LLVM_LIBC_VECTOR_MATH_NEON)
+LLVM_LIBC_FUNCTION(Float32x4, _ZGVnN4v_sinf, (Float32x4 x)) {
+  return vector::eval<vector::SinfKernel>(x);
+}
+#endif
+
+} // namespace __llvm_libc
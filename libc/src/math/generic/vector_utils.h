@@ -0,0 +1,111 @@
+//===-- Utilities for the vector variants of math functions -----*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_LIBC_SRC_MATH_GENERIC_VECTOR_UTILS_H
+#define LLVM_LIBC_SRC_MATH_GENERIC_VECTOR_UTILS_H
+
+#include "fast_paths.h"
+#include "src/__support/FPUtil/FPBits.h"
+#include "src/__support/common.h"
+#include "src/math/cosf.h"
+#include "src/math/expf.h"
+#include "src/math/logf.h"
+#include "src/math/sinf.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace __llvm_libc {
+namespace vector {
+
+// A kernel describes how a function is evaluated on a vector:
+//   - in_main_range(x) tells whether main_path computes f(x).
+//   - main_path(x) is the branch free main path of f shared with the scalar
+//     function.
+//   - scalar(x) is the scalar function, used for all other inputs.
+
+struct ExpfKernel {
+  static bool in_main_range(float x) {
+    return expf_in_main_range(fputil::FPBits<float>(x).uintval());
+  }
+  static float main_path(float x) { return expf_main_path(x); }
+  static float scalar(float x) { return __llvm_libc::expf(x); }
+};
+
+struct LogfKernel {
+  static bool in_main_range(float x) {
+    return logf_in_main_range(fputil::FPBits<float>(x).uintval());
+  }
+  static float main_path(float x) {
+    return logf_main_path(fputil::FPBits<float>(x), 0);
+  }
+  static float scalar(float x) { return __llvm_libc::logf(x); }
+};
+
+struct SinfKernel {
+  static bool in_main_range(float x) {
+    return sinf_in_main_range(fputil::FPBits<float>(x).uintval() &
+                              0x7fff'ffffU);
+  }
+  static float main_path(float x) { return sinf_main_path(x); }
+  static float scalar(float x) { return __llvm_libc::sinf(x); }
+};
+
+struct CosfKernel {
+  static bool in_main_range(float x) {
+    return cosf_in_main_range(fputil::FPBits<float>(x).uintval() &
+                              0x7fff'ffffU);
+  }
+  static float main_path(float x) { return cosf_main_path(x); }
+  static float scalar(float x) { return __llvm_libc::cosf(x); }
+};
+
+// Evaluates the function described by Kernel on every lane of x. All lanes go
+// through the main path, so that the loop below can be vectorized. Lanes
+// outside of the main range are given an input the main path handles and are
+// recomputed with the scalar function afterwards. This keeps the results and
+// errno identical to calling the scalar function on each lane. Only the
+// inexact exception may be raised where the scalar function would not.
+template <typename Kernel, typename Vector> static inline Vector eval(Vector x) {
+  constexpr size_t LANES = sizeof(Vector) / sizeof(float);
+  // Any input in the main range of all kernels.
+  constexpr float SAFE_INPUT = 1.0f;
+
+  // Compilers vectorize loops over arrays more reliably than loops over the
+  // lanes of a vector.
+  float in[LANES];
+  __builtin_memcpy(in, &x, sizeof(x));
+
+  float safe_in[LANES];
+  bool all_in_main_range = true;
+  for (size_t i = 0; i < LANES; ++i) {
+    bool in_main_range = Kernel::in_main_range(in[i]);
+    all_in_main_range &= in_main_range;
+    safe_in[i] = in_main_range ? in[i] : SAFE_INPUT;
+  }
+
+  float out[LANES];
+  for (size_t i = 0; i < LANES; ++i)
+    out[i] = Kernel::main_path(safe_in[i]);
+
+  if (unlikely(!all_in_main_range)) {
+    for (size_t i = 0; i < LANES; ++i) {
+      if (!Kernel::in_main_range(in[i]))
+        out[i] = Kernel::scalar(in[i]);
+    }
+  }
+
+  Vector y;
+  __builtin_memcpy(&y, out, sizeof(y));
+  return y;
+}
+
+} // namespace vector
+} // namespace __llvm_libc
+
+#endif // LLVM_LIBC_SRC_MATH_GENERIC_VECTOR_UTILS_H
@@ -0,0 +1,31 @@
+//===-- Implementation header for the vector variants of expf ---*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_LIBC_SRC_MATH_VECTOR_EXPF_H
+#define LLVM_LIBC_SRC_MATH_VECTOR_EXPF_H
+
+#include "src/math/vector_types.h"
+
+namespace __llvm_libc {
+
+#if defined(LLVM_LIBC_VECTOR_MATH_SSE)
+Float32x4 _ZGVbN4v_expf(Float32x4 x);
+#endif
+#if defined(LLVM_LIBC_VECTOR_MATH_AVX2)
+Float32x8 _ZGVdN8v_expf(Float32x8 x);
+#endif
+#if defined(LLVM_LIBC_VECTOR_MATH_AVX512)
+Float32x16 _ZGVeN16v_expf(Float32x16 x);
+#endif
+#if defined(LLVM_LIBC_VECTOR_MATH_NEON)
+LLVM_LIBC_VECTOR_PCS Float32x4 _ZGVnN4v_expf(Float32x4 x);
+#endif
+
+} // namespace __llvm_libc
+
+#endif // LLVM_LIBC_SRC_MATH_VECTOR_EXPF_H
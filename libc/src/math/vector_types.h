@@ -0,0 +1,44 @@
+//===-- Vector types of the vector math functions ---------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_LIBC_SRC_MATH_VECTOR_TYPES_H
+#define LLVM_LIBC_SRC_MATH_VECTOR_TYPES_H
+
+#include "src/__support/architectures.h"
+
+// The vector variants of the math functions follow the vector function ABI of
+// their target, so that the loop vectorizer can call them in place of the
+// scalar functions. Their names encode the instruction set, the number of
+// lanes and the parameters, e.g. _ZGVdN8v_expf is the AVX2 variant of expf
+// taking a vector of 8 floats.
+
+namespace __llvm_libc {
+
+using Float32x4 = float __attribute__((vector_size(16)));
+using Float32x8 = float __attribute__((vector_size(32)));
+using Float32x16 = float __attribute__((vector_size(64)));
+
+} // namespace __llvm_libc
+
+#if defined(LLVM_LIBC_ARCH_X86_64)
+// SSE variants are always available. AVX2 and AVX-512 variants are only
+// available when the library is built for a target supporting them.
+#define LLVM_LIBC_VECTOR_MATH_SSE
+#if defined(__AVX2__)
+#define LLVM_LIBC_VECTOR_MATH_AVX2
+#endif
+#if defined(__AVX512F__)
+#define LLVM_LIBC_VECTOR_MATH_AVX512
+#endif
+#elif defined(LLVM_LIBC_ARCH_AARCH64)
+// Advanced SIMD variants use the vector procedure call standard.
+#define LLVM_LIBC_VECTOR_MATH_NEON
+#define LLVM_LIBC_VECTOR_PCS __attribute__((aarch64_vector_pcs))
+#endif
+
+#endif // LLVM_LIBC_SRC_MATH_VECTOR_TYPES_H
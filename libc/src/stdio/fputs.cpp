@@ -0,0 +1,25 @@
+//===-- Implementation of fputs -------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/stdio/fputs.h"
+#include "src/__support/File/file.h"
+#include "src/string/string_utils.h"
+
+#include <stdio.h>
+
+namespace __llvm_libc {
+
+LLVM_LIBC_FUNCTION(int, fputs,
+                   (const char *__restrict str, ::FILE *__restrict stream)) {
+  size_t len = internal::string_length(str);
+  size_t written =
+      reinterpret_cast<__llvm_libc::File *>(stream)->write(str, len);
+  return written == len ? 0 : EOF;
+}
+
+} // namespace __llvm_libc
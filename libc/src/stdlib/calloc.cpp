@@ -0,0 +1,29 @@
+//===-- Implementation of calloc ------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/stdlib/calloc.h"
+#include "src/__support/alloc/allocator.h"
+#include "src/__support/common.h"
+
+#include <errno.h>
+
+namespace __llvm_libc {
+
+LLVM_LIBC_FUNCTION(void *, calloc, (size_t num, size_t size)) {
+  size_t bytes;
+  if (__builtin_mul_overflow(num, size, &bytes)) {
+    errno = ENOMEM;
+    return nullptr;
+  }
+  void *ptr = alloc::allocate_zeroed(bytes);
+  if (ptr == nullptr)
+    errno = ENOMEM;
+  return ptr;
+}
+
+} // namespace __llvm_libc
@@ -8,6 +8,7 @@
 
 #include "src/stdlib/qsort.h"
 #include "src/__support/common.h"
+#include "src/string/memory_utils/elements.h"
 
 #include <stdint.h>
 
@@ -15,7 +16,27 @@ namespace __llvm_libc {
 
 namespace internal {
 
-// A simple quicksort implementation using the Hoare partition scheme.
+// An introsort implementation:
+// - Ranges smaller than INSERTION_SORT_THRESHOLD elements are sorted with an
+//   insertion sort.
+// - Larger ranges are split with a Hoare partition around a median-of-three
+//   pivot, or a ninther (median of three medians) for large ranges.
+// - The smaller side of a partition is sorted recursively and the larger side
+//   iteratively, so the recursion depth is bounded by log2(n).
+// - Once the partitioning depth exceeds 2 * log2(n), the range is heapsorted
+//   to avoid the quadratic worst case of quicksort.
+
+constexpr size_t INSERTION_SORT_THRESHOLD = 16;
+constexpr size_t NINTHER_THRESHOLD = 128;
+
+// Swaps two non-overlapping blocks of Element::SIZE bytes.
+template <typename Element> static inline void swap_block(char *a, char *b) {
+  Storage<Element> temp;
+  char *temp_ptr = reinterpret_cast<char *>(&temp);
+  copy<Element>(temp_ptr, a);
+  copy<Element>(a, b);
+  copy<Element>(b, temp_ptr);
+}
 
 class Array {
   typedef int (*comparator)(const void *, const void *);
@@ -25,6 +46,30 @@ class Array {
   size_t elem_size;
   comparator compare;
 
+  // Swaps elements of arbitrary size in 16 byte blocks, then handles the tail.
+  static void swap_generic(char *a, char *b, size_t size) {
+    using namespace __llvm_libc::builtin;
+    for (; size >= _16::SIZE; size -= _16::SIZE) {
+      swap_block<_16>(a, b);
+      a += _16::SIZE;
+      b += _16::SIZE;
+    }
+    if (size >= _8::SIZE) {
+      swap_block<_8>(a, b);
+      a += _8::SIZE;
+      b += _8::SIZE;
+      size -= _8::SIZE;
+    }
+    if (size >= _4::SIZE) {
+      swap_block<_4>(a, b);
+      a += _4::SIZE;
+      b += _4::SIZE;
+      size -= _4::SIZE;
+    }
+    for (size_t i = 0; i < size; ++i)
+      swap_block<_1>(a + i, b + i);
+  }
+
 public:
   Array(uint8_t *a, size_t s, size_t e, comparator c)
       : array(a), array_size(s), elem_size(e), compare(c) {}
@@ -32,12 +77,23 @@ public:
   uint8_t *get(size_t i) const { return array + i * elem_size; }
 
   void swap(size_t i, size_t j) const {
-    uint8_t *elem_i = get(i);
-    uint8_t *elem_j = get(j);
-    for (size_t b = 0; b < elem_size; ++b) {
-      uint8_t temp = elem_i[b];
-      elem_i[b] = elem_j[b];
-      elem_j[b] = temp;
+    if (i == j)
+      return;
+    char *elem_i = reinterpret_cast<char *>(get(i));
+    char *elem_j = reinterpret_cast<char *>(get(j));
+    // Element sizes of 4, 8 and 16 bytes cover the common cases of int, long,
+    // double, pointers and pairs thereof. Swapping them with fixed-size
+    // operations avoids a byte-wise loop.
+    using namespace __llvm_libc::builtin;
+    switch (elem_size) {
+    case 4:
+      return swap_block<_4>(elem_i, elem_j);
+    case 8:
+      return swap_block<_8>(elem_i, elem_j);
+    case 16:
+      return swap_block<_16>(elem_i, elem_j);
+    default:
+      return swap_generic(elem_i, elem_j, elem_size);
     }
   }
 
@@ -49,6 +105,10 @@ public:
     return compare(get(i), other);
   }
 
+  bool elem_less(size_t i, size_t j) const {
+    return elem_compare(i, get(j)) < 0;
+  }
+
   size_t size() const { return array_size; }
 
   // Make an Array starting at index |i| and size |s|.
@@ -57,9 +117,70 @@ public:
   }
 };
 
+static void insertion_sort(const Array &array) {
+  const size_t array_size = array.size();
+  for (size_t i = 1; i < array_size; ++i)
+    for (size_t j = i; j > 0 && array.elem_less(j, j - 1); --j)
+      array.swap(j, j - 1);
+}
+
+static void sift_down(const Array &array, size_t root, size_t heap_size) {
+  while (true) {
+    size_t largest = root;
+    const size_t left = 2 * root + 1;
+    const size_t right = left + 1;
+    if (left < heap_size && array.elem_less(largest, left))
+      largest = left;
+    if (right < heap_size && array.elem_less(largest, right))
+      largest = right;
+    if (largest == root)
+      return;
+    array.swap(root, largest);
+    root = largest;
+  }
+}
+
+static void heap_sort(const Array &array) {
+  const size_t array_size = array.size();
+  for (size_t i = array_size / 2; i > 0; --i)
+    sift_down(array, i - 1, array_size);
+  for (size_t end = array_size - 1; end > 0; --end) {
+    array.swap(0, end);
+    sift_down(array, 0, end);
+  }
+}
+
+// Returns the index of the median of the elements at indices |a|, |b| and |c|.
+static size_t median_of_three(const Array &array, size_t a, size_t b,
+                              size_t c) {
+  if (array.elem_less(a, b)) {
+    if (array.elem_less(b, c))
+      return b;
+    return array.elem_less(a, c) ? c : a;
+  }
+  if (array.elem_less(a, c))
+    return a;
+  return array.elem_less(b, c) ? c : b;
+}
+
+static size_t choose_pivot(const Array &array) {
+  const size_t array_size = array.size();
+  const size_t mid = array_size / 2;
+  const size_t last = array_size - 1;
+  if (array_size < NINTHER_THRESHOLD)
+    return median_of_three(array, 0, mid, last);
+  const size_t step = array_size / 8;
+  return median_of_three(
+      array, median_of_three(array, 0, step, 2 * step),
+      median_of_three(array, mid - step, mid, mid + step),
+      median_of_three(array, last - 2 * step, last - step, last));
+}
+
 static size_t partition(const Array &array) {
   const size_t array_size = array.size();
   size_t pivot_index = array_size / 2;
+  // The partition loop below expects the pivot in the middle of the array.
+  array.swap(choose_pivot(array), pivot_index);
   uint8_t *pivot = array.get(pivot_index);
   size_t i = 0;
   size_t j = array_size - 1;
@@ -97,17 +218,32 @@ static size_t partition(const Array &array) {
   }
 }
 
-static void quicksort(const Array &array) {
-  const size_t array_size = array.size();
-  if (array_size <= 1)
-    return;
-  size_t split_index = partition(array);
-  if (array_size <= 2) {
-    // The partition operation sorts the two element array.
-    return;
+static void introsort(Array array, size_t depth_limit) {
+  while (array.size() > INSERTION_SORT_THRESHOLD) {
+    if (depth_limit == 0)
+      return heap_sort(array);
+    --depth_limit;
+
+    const size_t split_index = partition(array);
+    const size_t right_size = array.size() - split_index;
+    // Recurse into the smaller side and loop on the larger one to keep the
+    // stack depth logarithmic.
+    if (split_index < right_size) {
+      introsort(array.make_array(0, split_index), depth_limit);
+      array = array.make_array(split_index, right_size);
+    } else {
+      introsort(array.make_array(split_index, right_size), depth_limit);
+      array = array.make_array(0, split_index);
+    }
   }
-  quicksort(array.make_array(0, split_index));
-  quicksort(array.make_array(split_index, array.size() - split_index));
+  insertion_sort(array);
+}
+
+static void quicksort(const Array &array) {
+  size_t depth_limit = 0;
+  for (size_t n = array.size(); n > 1; n >>= 1)
+    depth_limit += 2;
+  introsort(array, depth_limit);
 }
 
 } // namespace internal
@@ -0,0 +1,25 @@
+//===-- Implementation of realloc -----------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/stdlib/realloc.h"
+#include "src/__support/alloc/allocator.h"
+#include "src/__support/common.h"
+
+#include <errno.h>
+
+namespace __llvm_libc {
+
+LLVM_LIBC_FUNCTION(void *, realloc, (void *ptr, size_t size)) {
+  // The original block is left untouched if the allocation fails.
+  void *new_ptr = alloc::reallocate(ptr, size);
+  if (new_ptr == nullptr)
+    errno = ENOMEM;
+  return new_ptr;
+}
+
+} // namespace __llvm_libc
@@ -0,0 +1,57 @@
+//===-- Test thread exit callbacks ----------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/__support/CPP/atomic.h"
+#include "src/__support/threads/thread.h"
+#include "utils/IntegrationTest/test.h"
+
+static __llvm_libc::cpp::Atomic<int> exit_count(0);
+static thread_local int tlval = 0;
+static __llvm_libc::cpp::Atomic<int> tlval_at_exit(0);
+
+// The callback runs on the exiting thread, so it sees the thread's TLS.
+void count_exit() {
+  tlval_at_exit = tlval;
+  exit_count.fetch_add(1);
+}
+
+int func(void *arg) {
+  tlval = *reinterpret_cast<int *>(arg);
+  return 0;
+}
+
+void joinable_thread_test() {
+  int value = 123;
+  int retval;
+  __llvm_libc::Thread th;
+  th.run(func, &value, nullptr, 0);
+  th.join(&retval);
+  ASSERT_EQ(exit_count.load(), 1);
+  ASSERT_EQ(tlval_at_exit.load(), 123);
+}
+
+void detached_thread_test() {
+  int value = 456;
+  __llvm_libc::Thread th;
+  th.run(func, &value, nullptr, 0, /*detached=*/true);
+  // A detached thread cleans itself up, so we cannot wait on it. Spin until
+  // the callback has run instead.
+  while (exit_count.load() != 2)
+    ;
+  ASSERT_EQ(exit_count.load(), 2);
+  ASSERT_EQ(tlval_at_exit.load(), 456);
+}
+
+TEST_MAIN() {
+  ASSERT_TRUE(__llvm_libc::register_thread_exit_callback(&count_exit));
+  joinable_thread_test();
+  detached_thread_test();
+  // The callbacks are not called for the main thread.
+  ASSERT_EQ(exit_count.load(), 2);
+  return 0;
+}
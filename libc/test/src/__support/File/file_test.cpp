@@ -23,9 +23,12 @@ class StringFile : public __llvm_libc::File {
   char str[SIZE] = {0};
   size_t eof_marker;
   bool write_append;
+  size_t write_calls;
 
   static size_t str_read(__llvm_libc::File *f, void *data, size_t len);
   static size_t str_write(__llvm_libc::File *f, const void *data, size_t len);
+  static size_t str_writev(__llvm_libc::File *f, const void *data1,
+                           size_t len1, const void *data2, size_t len2);
   static int str_seek(__llvm_libc::File *f, long offset, int whence);
   static int str_close(__llvm_libc::File *f) { return 0; }
   static int str_flush(__llvm_libc::File *f) { return 0; }
@@ -36,16 +39,17 @@ public:
       : __llvm_libc::File(&str_write, &str_read, &str_seek, &str_close,
                           &str_flush, buffer, buflen, bufmode, owned,
                           modeflags),
-        pos(0), eof_marker(0), write_append(false) {
+        pos(0), eof_marker(0), write_append(false), write_calls(0) {
     if (modeflags & static_cast<ModeFlags>(__llvm_libc::File::OpenMode::APPEND))
       write_append = true;
   }
 
   void init(char *buffer, size_t buflen, int bufmode, bool owned,
-            ModeFlags modeflags) {
+            ModeFlags modeflags, bool vectored = false) {
     File::init(this, &str_write, &str_read, &str_seek, &str_close, &str_flush,
-               buffer, buflen, bufmode, owned, modeflags);
-    pos = eof_marker = 0;
+               buffer, buflen, bufmode, owned, modeflags,
+               vectored ? &str_writev : nullptr);
+    pos = eof_marker = write_calls = 0;
     if (modeflags & static_cast<ModeFlags>(__llvm_libc::File::OpenMode::APPEND))
       write_append = true;
     else
@@ -54,6 +58,7 @@ public:
 
   void reset() { pos = 0; }
   size_t get_pos() const { return pos; }
+  size_t get_write_calls() const { return write_calls; }
   char *get_str() { return str; }
 
   // Use this method to prefill the file.
@@ -81,6 +86,7 @@ size_t StringFile::str_read(__llvm_libc::File *f, void *data, size_t len) {
 size_t StringFile::str_write(__llvm_libc::File *f, const void *data,
                              size_t len) {
   StringFile *sf = static_cast<StringFile *>(f);
+  ++sf->write_calls;
   if (sf->write_append)
     sf->pos = sf->eof_marker;
   if (sf->pos >= SIZE)
@@ -94,6 +100,16 @@ size_t StringFile::str_write(__llvm_libc::File *f, const void *data,
   return i;
 }
 
+size_t StringFile::str_writev(__llvm_libc::File *f, const void *data1,
+                              size_t len1, const void *data2, size_t len2) {
+  size_t written = str_write(f, data1, len1);
+  if (written < len1)
+    return written;
+  // Both pieces are written by a single platform operation.
+  --static_cast<StringFile *>(f)->write_calls;
+  return written + str_write(f, data2, len2);
+}
+
 int StringFile::str_seek(__llvm_libc::File *f, long offset, int whence) {
   StringFile *sf = static_cast<StringFile *>(f);
   if (whence == SEEK_SET)
@@ -106,9 +122,11 @@ int StringFile::str_seek(__llvm_libc::File *f, long offset, int whence) {
 }
 
 StringFile *new_string_file(char *buffer, size_t buflen, int bufmode,
-                            bool owned, const char *mode) {
+                            bool owned, const char *mode,
+                            bool vectored = false) {
   StringFile *f = reinterpret_cast<StringFile *>(malloc(sizeof(StringFile)));
-  f->init(buffer, buflen, bufmode, owned, __llvm_libc::File::mode_flags(mode));
+  f->init(buffer, buflen, bufmode, owned, __llvm_libc::File::mode_flags(mode),
+          vectored);
   return f;
 }
 
@@ -148,6 +166,35 @@ TEST(LlvmLibcFileTest, WriteOnly) {
   ASSERT_EQ(f->close(), 0);
 }
 
+TEST(LlvmLibcFileTest, WriteVectored) {
+  const char data[] = "hello, file";
+  constexpr size_t FILE_BUFFER_SIZE = sizeof(data);
+  char file_buffer[FILE_BUFFER_SIZE];
+  StringFile *f = new_string_file(file_buffer, FILE_BUFFER_SIZE, _IOFBF, false,
+                                  "w", /*vectored=*/true);
+
+  // Small writes are buffered.
+  ASSERT_EQ(size_t(5), f->write(data, 5));
+  EXPECT_EQ(f->get_pos(), size_t(0));
+
+  // A write which fills a whole buffer goes out together with the buffered
+  // data in a single platform write, without going through the buffer.
+  ASSERT_EQ(sizeof(data), f->write(data, sizeof(data)));
+  EXPECT_EQ(f->get_pos(), sizeof(data) + 5);
+  EXPECT_EQ(f->get_write_calls(), size_t(1));
+  MemoryView src1("hellohello, file", sizeof(data) + 5),
+      dst1(f->get_str(), sizeof(data) + 5);
+  EXPECT_MEM_EQ(src1, dst1);
+
+  // With an empty buffer, the data is written directly.
+  ASSERT_EQ(sizeof(data), f->write(data, sizeof(data)));
+  EXPECT_EQ(f->get_write_calls(), size_t(2));
+  ASSERT_EQ(f->flush(), 0);
+  EXPECT_EQ(f->get_write_calls(), size_t(2));
+
+  ASSERT_EQ(f->close(), 0);
+}
+
 TEST(LlvmLibcFileTest, WriteLineBuffered) {
   const char data[] = "hello\n file";
   constexpr size_t FILE_BUFFER_SIZE = sizeof(data) * 3 / 2;
@@ -0,0 +1,104 @@
+//===-- Unittests for the allocator ---------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/__support/alloc/allocator.h"
+#include "src/__support/alloc/size_classes.h"
+#include "utils/UnitTest/Test.h"
+
+#include <stdint.h>
+
+using namespace __llvm_libc::alloc;
+
+static void fill(void *ptr, size_t size, unsigned char value) {
+  unsigned char *bytes = reinterpret_cast<unsigned char *>(ptr);
+  for (size_t i = 0; i < size; ++i)
+    bytes[i] = value;
+}
+
+static bool check(const void *ptr, size_t size, unsigned char value) {
+  const unsigned char *bytes = reinterpret_cast<const unsigned char *>(ptr);
+  for (size_t i = 0; i < size; ++i) {
+    if (bytes[i] != value)
+      return false;
+  }
+  return true;
+}
+
+TEST(LlvmLibcAllocatorTest, AllocateAllSizes) {
+  // Covers size classes, page runs and directly mapped allocations.
+  const size_t sizes[] = {0,     1,      16,     17,     128,    129,
+                          4096,  5000,   65536,  MAX_SMALL_SIZE,
+                          MAX_SMALL_SIZE + 1,    MAX_PAGE_RUN_SIZE,
+                          MAX_PAGE_RUN_SIZE + 1, 8 * 1024 * 1024};
+  for (size_t size : sizes) {
+    void *ptr = allocate(size);
+    ASSERT_NE(ptr, static_cast<void *>(nullptr));
+    ASSERT_EQ(uintptr_t(ptr) % MIN_ALIGNMENT, uintptr_t(0));
+    ASSERT_GE(usable_size(ptr), size);
+    fill(ptr, size, 0xAB);
+    ASSERT_TRUE(check(ptr, size, 0xAB));
+    deallocate(ptr);
+  }
+}
+
+TEST(LlvmLibcAllocatorTest, ObjectsDoNotOverlap) {
+  constexpr size_t COUNT = 1000;
+  void *ptrs[COUNT];
+  for (size_t i = 0; i < COUNT; ++i) {
+    ptrs[i] = allocate(48);
+    ASSERT_NE(ptrs[i], static_cast<void *>(nullptr));
+    fill(ptrs[i], 48, static_cast<unsigned char>(i));
+  }
+  for (size_t i = 0; i < COUNT; ++i) {
+    ASSERT_TRUE(check(ptrs[i], 48, static_cast<unsigned char>(i)));
+    deallocate(ptrs[i]);
+  }
+  flush_thread_cache();
+}
+
+TEST(LlvmLibcAllocatorTest, AlignedAllocations) {
+  const size_t sizes[] = {1, 100, 3 * PAGE_BYTES};
+  for (size_t alignment = 1; alignment <= 8 * CHUNK_BYTES; alignment *= 2) {
+    for (size_t size : sizes) {
+      void *ptr = allocate_aligned(alignment, size);
+      ASSERT_NE(ptr, static_cast<void *>(nullptr));
+      ASSERT_EQ(uintptr_t(ptr) % alignment, uintptr_t(0));
+      ASSERT_GE(usable_size(ptr), size);
+      fill(ptr, size, 0xCD);
+      deallocate(ptr);
+    }
+  }
+}
+
+TEST(LlvmLibcAllocatorTest, Reallocate) {
+  void *ptr = reallocate(nullptr, 10);
+  ASSERT_NE(ptr, static_cast<void *>(nullptr));
+  fill(ptr, 10, 0x12);
+  for (size_t size = 20; size < 4 * MAX_PAGE_RUN_SIZE; size *= 3) {
+    ptr = reallocate(ptr, size);
+    ASSERT_NE(ptr, static_cast<void *>(nullptr));
+    ASSERT_TRUE(check(ptr, 10, 0x12));
+  }
+  ptr = reallocate(ptr, 5);
+  ASSERT_TRUE(check(ptr, 5, 0x12));
+  deallocate(ptr);
+}
+
+TEST(LlvmLibcAllocatorTest, Zeroed) {
+  const size_t sizes[] = {24, 70000, 3 * MAX_PAGE_RUN_SIZE};
+  for (size_t size : sizes) {
+    void *ptr = allocate(size);
+    fill(ptr, size, 0xFF);
+    deallocate(ptr);
+    ptr = allocate_zeroed(size);
+    ASSERT_NE(ptr, static_cast<void *>(nullptr));
+    ASSERT_TRUE(check(ptr, size, 0));
+    deallocate(ptr);
+  }
+  release_free_memory();
+}
@@ -0,0 +1,39 @@
+//===-- Unittests for the allocator size classes --------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "src/__support/alloc/size_classes.h"
+#include "utils/UnitTest/Test.h"
+
+using namespace __llvm_libc::alloc;
+
+TEST(LlvmLibcAllocSizeClassesTest, SizesFitTheirClass) {
+  for (size_t size = 0; size <= MAX_SMALL_SIZE; ++size) {
+    const unsigned size_class = size_to_class(size);
+    ASSERT_GT(size_class, 0u);
+    ASSERT_LT(size_class, NUM_SIZE_CLASSES);
+    ASSERT_GE(class_to_size(size_class), size);
+    // The class must be the smallest one fitting the size.
+    if (size_class > 1)
+      ASSERT_LT(class_to_size(size_class - 1), size);
+  }
+}
+
+TEST(LlvmLibcAllocSizeClassesTest, ClassesAreAligned) {
+  for (unsigned size_class = 1; size_class < NUM_SIZE_CLASSES; ++size_class) {
+    ASSERT_EQ(class_to_size(size_class) % MIN_ALIGNMENT, size_t(0));
+    ASSERT_EQ(size_to_class(class_to_size(size_class)), size_class);
+  }
+}
+
+TEST(LlvmLibcAllocSizeClassesTest, SpansHoldObjects) {
+  for (unsigned size_class = 1; size_class < NUM_SIZE_CLASSES; ++size_class) {
+    const size_t span_bytes = class_to_pages(size_class) * PAGE_BYTES;
+    ASSERT_GE(span_bytes, class_to_size(size_class));
+    ASSERT_GE(class_to_batch(size_class), size_t(1));
+  }
+}
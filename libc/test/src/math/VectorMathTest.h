@@ -0,0 +1,100 @@
+//===-- Utility class to test the vector variants of math functions -------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef LLVM_LIBC_TEST_SRC_MATH_VECTORMATHTEST_H
+#define LLVM_LIBC_TEST_SRC_MATH_VECTORMATHTEST_H
+
+#include "src/__support/FPUtil/FPBits.h"
+#include "src/math/vector_types.h"
+#include "utils/UnitTest/Test.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+// The vector variants must return, bit for bit, what the scalar function
+// returns for each lane.
+class VectorMathTestTemplate : public __llvm_libc::testing::Test {
+public:
+  using ScalarFunc = float (*)(float);
+  using FPBits = __llvm_libc::fputil::FPBits<float>;
+
+  // Checks every input. When |count| is not a multiple of the vector width,
+  // the last vector is padded by wrapping around to the start of |inputs|.
+  template <typename Vector, typename VectorFunc>
+  void check(VectorFunc vector_func, ScalarFunc scalar_func,
+             const float *inputs, size_t count) {
+    constexpr size_t LANES = sizeof(Vector) / sizeof(float);
+    for (size_t i = 0; i < count; i += LANES) {
+      Vector x;
+      for (size_t j = 0; j < LANES; ++j)
+        x[j] = inputs[(i + j) % count];
+      Vector y = vector_func(x);
+      for (size_t j = 0; j < LANES; ++j)
+        ASSERT_EQ(FPBits(scalar_func(x[j])).uintval(), FPBits(y[j]).uintval());
+    }
+  }
+
+  // Special values, alone and mixed with values in the main range in the
+  // same vector.
+  template <typename Vector, typename VectorFunc>
+  void test_special_numbers(VectorFunc vector_func, ScalarFunc scalar_func) {
+    const float inputs[] = {0.0f,
+                            -0.0f,
+                            float(FPBits::inf()),
+                            float(FPBits::neg_inf()),
+                            float(FPBits::build_nan(1)),
+                            1.0f,
+                            0x1.0p-30f,
+                            -0x1.0p-140f,
+                            0x1.fffffep127f,
+                            -2.5f,
+                            100.0f,
+                            -100.0f,
+                            0x1.0p30f,
+                            -0x1.0p100f,
+                            // Exceptional values of expf and logf.
+                            -0x1.6d7b18p+5f,
+                            0x1.2f1fd6p+3f,
+                            0x1.000002p+0f,
+                            0.5f,
+                            -0.75f,
+                            1.5f,
+                            3.0f,
+                            -3.0f,
+                            0.25f,
+                            -1.0f};
+    check<Vector>(vector_func, scalar_func, inputs,
+                  sizeof(inputs) / sizeof(inputs[0]));
+  }
+
+  template <typename Vector, typename VectorFunc>
+  void test_in_float_range(VectorFunc vector_func, ScalarFunc scalar_func) {
+    constexpr size_t BLOCK = 1024;
+    constexpr uint32_t COUNT = 1000000;
+    constexpr uint32_t STEP = UINT32_MAX / COUNT;
+    float inputs[BLOCK];
+    uint32_t v = 0;
+    for (uint32_t i = 0; i < COUNT; i += BLOCK) {
+      for (size_t j = 0; j < BLOCK; ++j, v += STEP)
+        inputs[j] = float(FPBits(v));
+      check<Vector>(vector_func, scalar_func, inputs, BLOCK);
+    }
+  }
+};
+
+#define LIST_VECTOR_MATH_TESTS(Suite, Vector, vector_func, scalar_func)         \
+  TEST_F(Suite, SpecialNumbers##vector_func) {                                 \
+    test_special_numbers<Vector>(&__llvm_libc::vector_func,                    \
+                                 &__llvm_libc::scalar_func);                   \
+  }                                                                            \
+  TEST_F(Suite, InFloatRange##vector_func) {                                   \
+    test_in_float_range<Vector>(&__llvm_libc::vector_func,                     \
+                                &__llvm_libc::scalar_func);                    \
+  }
+
+#endif // LLVM_LIBC_TEST_SRC_MATH_VECTORMATHTEST_H
@@ -0,0 +1,35 @@
+//===-- Unittests for the vector variants of sinf -------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "VectorMathTest.h"
+
+#include "src/math/sinf.h"
+#include "src/math/vector_sinf.h"
+#include "utils/UnitTest/Test.h"
+
+using LlvmLibcVectorSinfTest = VectorMathTestTemplate;
+
+#if defined(LLVM_LIBC_VECTOR_MATH_SSE)
+LIST_VECTOR_MATH_TESTS(LlvmLibcVectorSinfTest, __llvm_libc::Float32x4,
+                       _ZGVbN4v_sinf, sinf)
+#endif
+
+#if defined(LLVM_LIBC_VECTOR_MATH_AVX2)
+LIST_VECTOR_MATH_TESTS(LlvmLibcVectorSinfTest, __llvm_libc::Float32x8,
+                       _ZGVdN8v_sinf, sinf)
+#endif
+
+#if defined(LLVM_LIBC_VECTOR_MATH_AVX512)
+LIST_VECTOR_MATH_TESTS(LlvmLibcVectorSinfTest, __llvm_libc::Float32x16,
+                       _ZGVeN16v_sinf, sinf)
+#endif
+
+#if defined(LLVM_LIBC_VECTOR_MATH_NEON)
+LIST_VECTOR_MATH_TESTS(LlvmLibcVectorSinfTest, __llvm_libc::Float32x4,
+                       _ZGVnN4v_sinf, sinf)
+#endif
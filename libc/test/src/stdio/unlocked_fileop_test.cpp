@@ -10,8 +10,11 @@
 #include "src/stdio/fclose.h"
 #include "src/stdio/feof_unlocked.h"
 #include "src/stdio/ferror_unlocked.h"
+#include "src/stdio/fflush_unlocked.h"
 #include "src/stdio/flockfile.h"
 #include "src/stdio/fopen.h"
+#include "src/stdio/fputs.h"
+#include "src/stdio/fputs_unlocked.h"
 #include "src/stdio/fread_unlocked.h"
 #include "src/stdio/funlockfile.h"
 #include "src/stdio/fwrite_unlocked.h"
@@ -74,3 +77,31 @@ TEST(LlvmLibcFILETest, UnlockedReadAndWrite) {
 
   ASSERT_EQ(__llvm_libc::fclose(f), 0);
 }
+
+TEST(LlvmLibcFILETest, UnlockedPutsAndFlush) {
+  constexpr char fNAME[] = "testdata/unlocked_puts_and_flush.test";
+  ::FILE *f = __llvm_libc::fopen(fNAME, "w");
+  ASSERT_FALSE(f == nullptr);
+  __llvm_libc::flockfile(f);
+  ASSERT_GE(__llvm_libc::fputs_unlocked("12345", f), 0);
+  ASSERT_GE(__llvm_libc::fputs_unlocked("67890", f), 0);
+  ASSERT_EQ(__llvm_libc::fflush_unlocked(f), 0);
+  __llvm_libc::funlockfile(f);
+  ASSERT_GE(__llvm_libc::fputs("abcde", f), 0);
+  ASSERT_EQ(0, __llvm_libc::fclose(f));
+
+  f = __llvm_libc::fopen(fNAME, "r");
+  ASSERT_FALSE(f == nullptr);
+  constexpr size_t READ_SIZE = 15;
+  char data[READ_SIZE + 1];
+  data[READ_SIZE] = '\0';
+  ASSERT_EQ(__llvm_libc::fread_unlocked(data, 1, READ_SIZE, f), READ_SIZE);
+  ASSERT_STREQ(data, "1234567890abcde");
+
+  // Writing to a file opened for reading fails.
+  ASSERT_EQ(__llvm_libc::fputs_unlocked("12345", f), EOF);
+  ASSERT_NE(__llvm_libc::ferror_unlocked(f), 0);
+  errno = 0;
+
+  ASSERT_EQ(__llvm_libc::fclose(f), 0);
+}
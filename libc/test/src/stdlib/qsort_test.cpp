@@ -263,3 +263,59 @@ TEST(LlvmLibcQSortTest, SingleElementArray) {
 
   ASSERT_LE(array[0], ELEM);
 }
+
+TEST(LlvmLibcQSortTest, LargeReverseSortedArray) {
+  constexpr size_t ARRAY_SIZE = 1000;
+  int array[ARRAY_SIZE];
+  for (size_t i = 0; i < ARRAY_SIZE; ++i)
+    array[i] = static_cast<int>(ARRAY_SIZE - i);
+
+  __llvm_libc::qsort(array, ARRAY_SIZE, sizeof(int), int_compare);
+
+  for (size_t i = 0; i < ARRAY_SIZE; ++i)
+    ASSERT_EQ(array[i], static_cast<int>(i + 1));
+}
+
+TEST(LlvmLibcQSortTest, LargeOrganPipeArray) {
+  // Organ pipe inputs defeat naive middle-element pivot selection.
+  constexpr size_t ARRAY_SIZE = 1000;
+  int array[ARRAY_SIZE];
+  for (size_t i = 0; i < ARRAY_SIZE / 2; ++i) {
+    array[i] = static_cast<int>(i);
+    array[ARRAY_SIZE - 1 - i] = static_cast<int>(i);
+  }
+
+  __llvm_libc::qsort(array, ARRAY_SIZE, sizeof(int), int_compare);
+
+  for (size_t i = 0; i < ARRAY_SIZE; ++i)
+    ASSERT_EQ(array[i], static_cast<int>(i / 2));
+}
+
+struct PaddedElement {
+  int key;
+  char payload[7];
+};
+
+static int padded_compare(const void *l, const void *r) {
+  return int_compare(&reinterpret_cast<const PaddedElement *>(l)->key,
+                     &reinterpret_cast<const PaddedElement *>(r)->key);
+}
+
+TEST(LlvmLibcQSortTest, OddSizedElements) {
+  // Elements whose size is not 4, 8 or 16 bytes take the generic swap path.
+  constexpr size_t ARRAY_SIZE = 200;
+  PaddedElement array[ARRAY_SIZE];
+  for (size_t i = 0; i < ARRAY_SIZE; ++i) {
+    array[i].key = static_cast<int>((i * 37) % ARRAY_SIZE);
+    for (size_t j = 0; j < sizeof(array[i].payload); ++j)
+      array[i].payload[j] = static_cast<char>(array[i].key + j);
+  }
+
+  __llvm_libc::qsort(array, ARRAY_SIZE, sizeof(PaddedElement), padded_compare);
+
+  for (size_t i = 0; i < ARRAY_SIZE; ++i) {
+    ASSERT_EQ(array[i].key, static_cast<int>(i));
+    for (size_t j = 0; j < sizeof(array[i].payload); ++j)
+      ASSERT_EQ(array[i].payload[j], static_cast<char>(i + j));
+  }
+}
@@ -47,6 +47,10 @@ struct VectorizerParams {
   /// \When performing memory disambiguation checks at runtime do not
   /// make more than this number of comparisons.
   static unsigned RuntimeMemoryCheckThreshold;
+
+  /// Analyze and vectorize read-only loops with exits whose count cannot be
+  /// computed.
+  static bool EarlyExitVectorization;
 };
 
 /// Checks memory dependences among accesses to the same underlying
@@ -18,6 +18,8 @@
 #include "llvm/CodeGen/LiveRegUnits.h"
 #include "llvm/CodeGen/MachineFunction.h"
 #include "llvm/CodeGen/MachineRegisterInfo.h"
+#include "llvm/CodeGen/StableHashing.h"
+#include "llvm/Support/Error.h"
 #include <initializer_list>
 
 namespace llvm {
@@ -230,15 +232,22 @@ public:
   /// Target-defined identifier for constructing a frame for this function.
   unsigned FrameConstructionID = 0;
 
+  /// Set if the function is shared with the other modules outlining the same
+  /// sequence, and only one copy of it is kept by the linker.
+  bool IsShared = false;
+
   /// Return the number of candidates for this \p OutlinedFunction.
   unsigned getOccurrenceCount() const { return Candidates.size(); }
 
   /// Return the number of bytes it would take to outline this
-  /// function.
+  /// function. The body of a shared function is paid for by the whole
+  /// program rather than by this module.
   unsigned getOutliningCost() const {
     unsigned CallOverhead = 0;
     for (const Candidate &C : Candidates)
       CallOverhead += C.getCallOverhead();
+    if (IsShared)
+      return CallOverhead;
     return CallOverhead + SequenceSize + FrameOverhead;
   }
 
@@ -270,6 +279,52 @@ public:
 
   OutlinedFunction() = default;
 };
+
+/// A sequence of instructions found in a module, identified by the stable
+/// hashes of its instructions so that it can be matched in other modules.
+///
+/// With ThinLTO, every backend records its sequences in a first round of
+/// codegen. The thin link merges the records and keeps the sequences worth
+/// sharing across modules, which a second round of codegen outlines to
+/// linkonce_odr functions the linker deduplicates.
+struct GlobalSequence {
+  /// The stable hashes of the instructions in the sequence.
+  std::vector<stable_hash> InstrHashes;
+
+  /// Number of occurrences of the sequence in all modules.
+  unsigned Occurrences = 0;
+
+  /// Number of modules the sequence was found in.
+  unsigned NumModules = 0;
+
+  /// Target-defined size of the sequence, and overheads of calling and of
+  /// constructing an outlined function, as computed for \p OutlinedFunction.
+  unsigned SequenceSize = 0;
+  unsigned CallOverhead = 0;
+  unsigned FrameOverhead = 0;
+
+  /// Return the number of bytes saved by outlining every occurrence to a
+  /// single function.
+  unsigned getBenefit() const {
+    unsigned NotOutlinedCost = Occurrences * SequenceSize;
+    unsigned OutlinedCost =
+        Occurrences * CallOverhead + SequenceSize + FrameOverhead;
+    return (NotOutlinedCost < OutlinedCost) ? 0
+                                            : NotOutlinedCost - OutlinedCost;
+  }
+};
+
+/// Parse the sequences written by writeGlobalSequences from \p Buffer.
+Error readGlobalSequences(StringRef Buffer,
+                          std::vector<GlobalSequence> &Sequences);
+
+/// Write \p Sequences to \p OS, one per line.
+void writeGlobalSequences(raw_ostream &OS, ArrayRef<GlobalSequence> Sequences);
+
+/// Merge the sequences recorded by several modules, and return the ones found
+/// in more than one module that are worth outlining to a shared function.
+std::vector<GlobalSequence>
+selectGlobalSequences(ArrayRef<GlobalSequence> Recorded);
 } // namespace outliner
 } // namespace llvm
 
@@ -1908,7 +1908,9 @@ public:
   }
 
   /// Returns a \p outliner::OutlinedFunction struct containing target-specific
-  /// information for a set of outlining candidates.
+  /// information for a set of outlining candidates. The set may hold a single
+  /// candidate, for a sequence shared with other modules; the outliner drops
+  /// the other sets left with fewer than two candidates.
   virtual outliner::OutlinedFunction getOutliningCandidateInfo(
       std::vector<outliner::Candidate> &RepeatedSequenceLocs) const {
     llvm_unreachable(
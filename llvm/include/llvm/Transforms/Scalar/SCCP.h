@@ -27,9 +27,11 @@
 
 namespace llvm {
 class AssumptionCache;
+class BlockFrequencyInfo;
 class DataLayout;
 class Function;
 class Module;
+class ProfileSummaryInfo;
 class TargetLibraryInfo;
 class TargetTransformInfo;
 struct AnalysisResultsForFn;
@@ -49,7 +51,9 @@ bool runFunctionSpecialization(
     std::function<TargetLibraryInfo &(Function &)> GetTLI,
     std::function<TargetTransformInfo &(Function &)> GetTTI,
     std::function<AssumptionCache &(Function &)> GetAC,
-    function_ref<AnalysisResultsForFn(Function &)> GetAnalysis);
+    function_ref<AnalysisResultsForFn(Function &)> GetAnalysis,
+    ProfileSummaryInfo *PSI = nullptr,
+    std::function<BlockFrequencyInfo &(Function &)> GetBFI = nullptr);
 } // end namespace llvm
 
 #endif // LLVM_TRANSFORMS_SCALAR_SCCP_H
@@ -300,6 +300,21 @@ public:
   /// Returns the widest induction type.
   Type *getWidestInductionType() { return WidestIndTy; }
 
+  /// Returns true if the loop can leave through exits whose trip count SCEV
+  /// cannot compute, e.g. when a search loop finds what it is looking for.
+  bool hasUncountableEarlyExit() const {
+    return !UncountableExitingBlocks.empty();
+  }
+
+  /// Returns the exiting blocks of the exits that SCEV cannot count.
+  const SmallVectorImpl<BasicBlock *> &getUncountableExitingBlocks() const {
+    return UncountableExitingBlocks;
+  }
+
+  /// Returns the backedge-taken count of the loop if it only left through
+  /// its countable exits. This bounds the iterations the vector loop runs.
+  const SCEV *getCountableBackedgeTakenCount() const;
+
   /// Returns True if given store is a final invariant store of one of the
   /// reductions found in the loop.
   bool isInvariantStoreOfReduction(StoreInst *SI);
@@ -439,6 +454,12 @@ private:
   /// transformation.
   bool canVectorizeWithIfConvert();
 
+  /// Return true if the exits of the loop that SCEV cannot count can be
+  /// checked by the vector loop, and record them. The vector loop evaluates
+  /// every lane of an iteration before checking the exits, so the loop must
+  /// be free of side effects and only read dereferenceable memory.
+  bool canVectorizeUncountableExits();
+
   /// Return true if we can vectorize this outer loop. The method performs
   /// specific checks for outer loop vectorization.
   bool canVectorizeOuterLoop();
@@ -534,6 +555,9 @@ private:
   /// Holds the widest induction type encountered.
   Type *WidestIndTy = nullptr;
 
+  /// Holds the exiting blocks whose exit count cannot be computed.
+  SmallVector<BasicBlock *, 4> UncountableExitingBlocks;
+
   /// Allowed outside users. This holds the variables that can be accessed from
   /// outside the loop.
   SmallPtrSet<Value *, 4> AllowedExit;
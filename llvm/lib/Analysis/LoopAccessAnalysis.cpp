@@ -92,6 +92,15 @@ static cl::opt<unsigned, true> RuntimeMemoryCheckThreshold(
     cl::location(VectorizerParams::RuntimeMemoryCheckThreshold), cl::init(8));
 unsigned VectorizerParams::RuntimeMemoryCheckThreshold;
 
+static cl::opt<bool, true> EnableEarlyExitVectorization(
+    "enable-early-exit-vectorization", cl::Hidden,
+    cl::desc("Enable vectorization of read-only loops with exits whose trip "
+             "count cannot be computed. Their loads must be dereferenceable "
+             "up to a constant maximum trip count, as in searches through "
+             "arrays of known size."),
+    cl::location(VectorizerParams::EarlyExitVectorization), cl::init(false));
+bool VectorizerParams::EarlyExitVectorization;
+
 /// The maximum iterations used to merge memory checks
 static cl::opt<unsigned> MemoryCheckMergeThreshold(
     "memory-check-merge-threshold", cl::Hidden,
@@ -2091,8 +2100,14 @@ bool LoopAccessInfo::canAnalyzeLoop() {
     return false;
   }
 
-  // ScalarEvolution needs to be able to find the exit count.
+  // ScalarEvolution needs to be able to find the exit count. With early exit
+  // vectorization, loops with exits that depend on the data they read are
+  // only analyzed if they do not write memory, see analyzeLoop, in which case
+  // bounding the accesses by the countable exits is enough.
   const SCEV *ExitCount = PSE->getBackedgeTakenCount();
+  if (isa<SCEVCouldNotCompute>(ExitCount) &&
+      VectorizerParams::EarlyExitVectorization)
+    ExitCount = PSE->getSE()->getSymbolicMaxBackedgeTakenCount(TheLoop);
   if (isa<SCEVCouldNotCompute>(ExitCount)) {
     recordAnalysis("CantComputeNumberOfIterations")
         << "could not determine number of loop iterations";
@@ -2124,8 +2139,12 @@ void LoopAccessInfo::analyzeLoop(AAResults *AA, LoopInfo *LI,
 
   const bool IsAnnotatedParallel = TheLoop->isAnnotatedParallel();
 
+  // Set when the loop also has exits that SCEV cannot count.
+  const bool HasUncountableExit =
+      isa<SCEVCouldNotCompute>(PSE->getBackedgeTakenCount());
+
   const bool EnableMemAccessVersioningOfLoop =
-      EnableMemAccessVersioning &&
+      EnableMemAccessVersioning && !HasUncountableExit &&
       !TheLoop->getHeader()->getParent()->hasOptSize();
 
   // Traverse blocks in fixed RPOT order, regardless of their storage in the
@@ -2221,6 +2240,17 @@ void LoopAccessInfo::analyzeLoop(AAResults *AA, LoopInfo *LI,
     return;
   }
 
+  // The accesses of a loop leaving at a data-dependent exit cannot be
+  // bounded, so there is nothing to check them against.
+  if (HasUncountableExit && !Stores.empty()) {
+    recordAnalysis("CantComputeNumberOfIterations")
+        << "could not determine number of loop iterations";
+    LLVM_DEBUG(dbgs() << "LAA: Found a store in a loop with an uncountable "
+                         "exit.\n");
+    CanVecMem = false;
+    return;
+  }
+
   // Now we have two lists that hold the loads and the stores.
   // Next, we find the pointers that they use.
 
@@ -55,13 +55,18 @@
 ///
 //===----------------------------------------------------------------------===//
 #include "llvm/CodeGen/MachineOutliner.h"
+#include "llvm/ADT/BitVector.h"
 #include "llvm/ADT/DenseMap.h"
+#include "llvm/ADT/MapVector.h"
 #include "llvm/ADT/SmallSet.h"
 #include "llvm/ADT/Statistic.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/ADT/Triple.h"
 #include "llvm/ADT/Twine.h"
 #include "llvm/Analysis/OptimizationRemarkEmitter.h"
 #include "llvm/CodeGen/LivePhysRegs.h"
 #include "llvm/CodeGen/MachineModuleInfo.h"
+#include "llvm/CodeGen/MachineStableHash.h"
 #include "llvm/CodeGen/MachineOptimizationRemarkEmitter.h"
 #include "llvm/CodeGen/Passes.h"
 #include "llvm/CodeGen/TargetInstrInfo.h"
@@ -72,9 +77,15 @@
 #include "llvm/InitializePasses.h"
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MD5.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/Path.h"
 #include "llvm/Support/SuffixTree.h"
 #include "llvm/Support/raw_ostream.h"
 #include <functional>
+#include <limits>
+#include <set>
 #include <tuple>
 #include <vector>
 
@@ -87,6 +98,8 @@ using namespace outliner;
 // Statistics for outlined functions.
 STATISTIC(NumOutlined, "Number of candidates outlined");
 STATISTIC(FunctionsCreated, "Number of functions created");
+STATISTIC(SharedFunctionsCreated,
+          "Number of functions created to be shared across modules");
 
 // Statistics for instruction mapping.
 STATISTIC(NumLegalInUnsignedVec, "Number of legal instrs in unsigned vector");
@@ -113,6 +126,55 @@ static cl::opt<unsigned> OutlinerReruns(
     cl::desc(
         "Number of times to rerun the outliner after the initial outline"));
 
+/// First round of whole-program outlining with ThinLTO: the sequences found in
+/// each module are written to a file of their own in a directory, which the
+/// thin link merges (see `llvm-lto2 merge-outliner-summaries`).
+static cl::opt<std::string> OutlinerSummaryOut(
+    "machine-outliner-summary-out", cl::Hidden, cl::value_desc("directory"),
+    cl::desc("Write the sequences found in the module to a file in the "
+             "given directory, to select sequences to outline across "
+             "modules"));
+
+/// Sequences found once in a module are recorded up to this length: unlike
+/// repeated ones, every window of instructions is one.
+static cl::opt<unsigned> OutlinerSummaryMaxLength(
+    "machine-outliner-summary-max-length", cl::init(8), cl::Hidden,
+    cl::desc("Maximum number of instructions in the sequences found once in "
+             "a module that are written with -machine-outliner-summary-out"));
+
+/// Second round: the sequences selected by the thin link are outlined to
+/// linkonce_odr functions named after their contents, which the linker
+/// deduplicates.
+static cl::opt<std::string> OutlinerGlobalSequences(
+    "machine-outliner-global-sequences", cl::Hidden,
+    cl::value_desc("filename"),
+    cl::desc("Outline the sequences read from the given file to functions "
+             "shared across modules"));
+
+/// Return a hash of \p MI that is the same in every module, or 0 if there is
+/// none. CFI instructions index into the frame instructions of their
+/// function, and constant pool and jump table operands into tables of their
+/// module, so their operands mean something else in every function. Globals
+/// local to a module are different objects in every module with the same
+/// name.
+static stable_hash getStableOutliningHash(const MachineInstr &MI) {
+  if (MI.isCFIInstruction())
+    return 0;
+  for (const MachineOperand &MO : MI.operands())
+    if (MO.isCPI() || MO.isJTI() || MO.isFI() ||
+        (MO.isGlobal() && MO.getGlobal()->hasLocalLinkage()))
+      return 0;
+  return stableHashValue(MI);
+}
+
+/// Return the hash identifying the sequence of instructions with the stable
+/// hashes \p InstrHashes, or 0 if one of them has none.
+static stable_hash getSequenceHash(ArrayRef<stable_hash> InstrHashes) {
+  if (is_contained(InstrHashes, 0))
+    return 0;
+  return stable_hash_combine_range(InstrHashes.begin(), InstrHashes.end());
+}
+
 namespace {
 
 /// Maps \p MachineInstrs to unsigned integers and stores the mappings.
@@ -142,6 +204,11 @@ struct InstructionMapper {
   /// at index i in \p UnsignedVec for each index i.
   std::vector<MachineBasicBlock::iterator> InstrList;
 
+  /// The stable hash of the instruction at index i in \p UnsignedVec for each
+  /// index i, or 0 if it cannot be outlined or has no stable hash. Only
+  /// computed when sequences are matched across modules.
+  std::vector<stable_hash> StableHashes;
+
   // Set if we added an illegal number in the previous step.
   // Since each illegal number is unique, we only need one of them between
   // each range of legal numbers. This lets us make sure we don't add more
@@ -327,6 +394,14 @@ struct InstructionMapper {
     }
   }
 
+  /// Fill \p StableHashes once every basic block has been mapped.
+  void computeStableHashes() {
+    StableHashes.assign(UnsignedVec.size(), 0);
+    for (unsigned I = 0, E = UnsignedVec.size(); I != E; ++I)
+      if (UnsignedVec[I] < LegalInstrNumber)
+        StableHashes[I] = getStableOutliningHash(*InstrList[I]);
+  }
+
   InstructionMapper() {
     // Make sure that the implementation of DenseMapInfo<unsigned> hasn't
     // changed.
@@ -363,6 +438,15 @@ struct MachineOutliner : public ModulePass {
   /// Set when the pass is constructed in TargetPassConfig.
   bool RunOnAllFunctions = true;
 
+  /// The sequences found in the module, recorded for the thin link when
+  /// -machine-outliner-summary-out is given.
+  std::vector<GlobalSequence> RecordedSequences;
+
+  /// The sequences to outline to functions shared across modules, keyed by
+  /// their sequence hash, and the set of their lengths.
+  DenseMap<stable_hash, GlobalSequence> GlobalSequences;
+  std::set<unsigned> GlobalSequenceLengths;
+
   StringRef getPassName() const override { return "Machine Outliner"; }
 
   void getAnalysisUsage(AnalysisUsage &AU) const override {
@@ -401,6 +485,35 @@ struct MachineOutliner : public ModulePass {
   void findCandidates(InstructionMapper &Mapper,
                       std::vector<OutlinedFunction> &FunctionList);
 
+  /// Find the occurrences of the sequences selected across modules, which are
+  /// worth outlining to a shared function even when they only appear once in
+  /// this module.
+  ///
+  /// \param Mapper Contains outlining mapping information.
+  /// \param[out] FunctionList Filled with a shared \p OutlinedFunction for
+  /// each sequence found.
+  void findGlobalCandidates(InstructionMapper &Mapper,
+                            std::vector<OutlinedFunction> &FunctionList);
+
+  /// Record the sequences found once in the module, which the thin link
+  /// selects if other modules have them as well. The sequences repeated in
+  /// the module are recorded by findCandidates.
+  ///
+  /// \param Mapper Contains outlining mapping information.
+  void recordUniqueSequences(InstructionMapper &Mapper);
+
+  /// Record the sequence with the stable hashes \p InstrHashes for the thin
+  /// link, with the sizes computed for its occurrences in \p OF.
+  void recordSequence(ArrayRef<stable_hash> InstrHashes,
+                      const OutlinedFunction &OF);
+
+  /// Read the sequences selected across modules from \p Filename.
+  void loadGlobalSequences(StringRef Filename);
+
+  /// Write the sequences recorded for \p M to a file of its own in
+  /// \p Directory.
+  void writeRecordedSequences(const Module &M, StringRef Directory);
+
   /// Replace the sequences of instructions represented by \p OutlinedFunctions
   /// with calls to functions.
   ///
@@ -583,6 +696,17 @@ void MachineOutliner::findCandidates(
     if (CandidatesForRepeatedSeq.size() < 2)
       continue;
 
+    // Sequences selected across modules are outlined to a shared function by
+    // findGlobalCandidates.
+    ArrayRef<stable_hash> InstrHashes;
+    if (!Mapper.StableHashes.empty()) {
+      InstrHashes = makeArrayRef(Mapper.StableHashes)
+                        .slice(CandidatesForRepeatedSeq[0].getStartIdx(),
+                               StringLen);
+      if (GlobalSequences.count(getSequenceHash(InstrHashes)))
+        continue;
+    }
+
     // Arbitrarily choose a TII from the first candidate.
     // FIXME: Should getOutliningCandidateInfo move to TargetMachine?
     const TargetInstrInfo *TII =
@@ -596,6 +720,12 @@ void MachineOutliner::findCandidates(
     if (OF.Candidates.size() < 2)
       continue;
 
+    // Record the sequence for the thin link, even if it is not worth
+    // outlining in this module alone.
+    if (!OutlinerSummaryOut.empty() && OutlineRepeatedNum == 0 &&
+        getSequenceHash(InstrHashes))
+      recordSequence(InstrHashes, OF);
+
     // Is it better to outline this candidate than not?
     if (OF.getBenefit() < 1) {
       emitNotOutliningCheaperRemark(StringLen, CandidatesForRepeatedSeq, OF);
@@ -606,6 +736,111 @@ void MachineOutliner::findCandidates(
   }
 }
 
+void MachineOutliner::recordUniqueSequences(InstructionMapper &Mapper) {
+  ArrayRef<stable_hash> Hashes = Mapper.StableHashes;
+
+  // Every window of instructions with stable hashes is a sequence, which the
+  // thin link may find in other modules. Note where each one starts, unless
+  // it is repeated.
+  const unsigned Repeated = std::numeric_limits<unsigned>::max();
+  for (unsigned Len = 2; Len <= OutlinerSummaryMaxLength; ++Len) {
+    MapVector<stable_hash, unsigned> StartIndices;
+    for (unsigned StartIdx = 0; StartIdx + Len <= Hashes.size(); ++StartIdx) {
+      stable_hash SeqHash = getSequenceHash(Hashes.slice(StartIdx, Len));
+      if (!SeqHash)
+        continue;
+      auto Inserted = StartIndices.insert({SeqHash, StartIdx});
+      if (!Inserted.second)
+        Inserted.first->second = Repeated;
+    }
+
+    for (auto &Entry : StartIndices) {
+      unsigned StartIdx = Entry.second;
+      if (StartIdx == Repeated)
+        continue;
+
+      unsigned EndIdx = StartIdx + Len - 1;
+      MachineBasicBlock::iterator StartIt = Mapper.InstrList[StartIdx];
+      MachineBasicBlock::iterator EndIt = Mapper.InstrList[EndIdx];
+      MachineBasicBlock *MBB = StartIt->getParent();
+      std::vector<Candidate> Candidates;
+      Candidates.emplace_back(StartIdx, Len, StartIt, EndIt, MBB, 0,
+                              Mapper.MBBFlagsMap[MBB]);
+      const TargetInstrInfo *TII =
+          Candidates[0].getMF()->getSubtarget().getInstrInfo();
+      OutlinedFunction OF = TII->getOutliningCandidateInfo(Candidates);
+      if (OF.Candidates.empty())
+        continue;
+
+      // Outlining saves the size of the sequence minus a call at each
+      // occurrence, so a sequence no larger than the call never pays off.
+      if (OF.SequenceSize <= OF.Candidates[0].getCallOverhead())
+        continue;
+
+      recordSequence(Hashes.slice(StartIdx, Len), OF);
+    }
+  }
+}
+
+void MachineOutliner::recordSequence(ArrayRef<stable_hash> InstrHashes,
+                                     const OutlinedFunction &OF) {
+  GlobalSequence Seq;
+  Seq.InstrHashes.assign(InstrHashes.begin(), InstrHashes.end());
+  Seq.Occurrences = OF.getOccurrenceCount();
+  Seq.NumModules = 1;
+  Seq.SequenceSize = OF.SequenceSize;
+  Seq.FrameOverhead = OF.FrameOverhead;
+  for (const Candidate &C : OF.Candidates)
+    Seq.CallOverhead = std::max(Seq.CallOverhead, C.getCallOverhead());
+  RecordedSequences.push_back(std::move(Seq));
+}
+
+void MachineOutliner::findGlobalCandidates(
+    InstructionMapper &Mapper, std::vector<OutlinedFunction> &FunctionList) {
+  ArrayRef<stable_hash> Hashes = Mapper.StableHashes;
+
+  // Match the longest sequences first. Occurrences of the selected sequences
+  // never overlap each other, but may overlap the candidates found in the
+  // suffix tree, in which case the most beneficial function wins in outline.
+  BitVector Taken(Hashes.size());
+  for (unsigned Len : llvm::reverse(GlobalSequenceLengths)) {
+    MapVector<stable_hash, std::vector<Candidate>> CandidatesForSeq;
+    for (unsigned StartIdx = 0; StartIdx + Len <= Hashes.size(); ++StartIdx) {
+      stable_hash SeqHash = getSequenceHash(Hashes.slice(StartIdx, Len));
+      if (!SeqHash || !GlobalSequences.count(SeqHash) ||
+          Taken.find_first_in(StartIdx, StartIdx + Len) != -1)
+        continue;
+
+      unsigned EndIdx = StartIdx + Len - 1;
+      MachineBasicBlock::iterator StartIt = Mapper.InstrList[StartIdx];
+      MachineBasicBlock::iterator EndIt = Mapper.InstrList[EndIdx];
+      MachineBasicBlock *MBB = StartIt->getParent();
+      CandidatesForSeq[SeqHash].emplace_back(StartIdx, Len, StartIt, EndIt, MBB,
+                                             0, Mapper.MBBFlagsMap[MBB]);
+      Taken.set(StartIdx, StartIdx + Len);
+      StartIdx = EndIdx;
+    }
+
+    for (auto &Entry : CandidatesForSeq) {
+      std::vector<Candidate> &Candidates = Entry.second;
+      for (Candidate &C : Candidates)
+        C.FunctionIdx = FunctionList.size();
+      const TargetInstrInfo *TII =
+          Candidates[0].getMF()->getSubtarget().getInstrInfo();
+      OutlinedFunction OF = TII->getOutliningCandidateInfo(Candidates);
+      if (OF.Candidates.empty())
+        continue;
+
+      OF.IsShared = true;
+      for (Candidate &C : OF.Candidates)
+        C.Benefit = OF.getBenefit();
+      if (OF.getBenefit() < 1)
+        continue;
+      FunctionList.push_back(OF);
+    }
+  }
+}
+
 MachineFunction *MachineOutliner::createOutlinedFunction(
     Module &M, OutlinedFunction &OF, InstructionMapper &Mapper, unsigned Name) {
 
@@ -710,6 +945,42 @@ MachineFunction *MachineOutliner::createOutlinedFunction(
 
   TII.buildOutlinedFrame(MBB, MF, OF);
 
+  // Name a shared function after its contents, so that the copies created in
+  // every module are the same linkonce_odr function, which the linker keeps
+  // one of. If its contents have no stable hash, keep it local instead.
+  //
+  // The linker keeps any one of the functions with the same name, so the name
+  // must not be shared by different bodies: the stable hashes only select the
+  // sequences, and the name is the MD5 of the printed body and attributes.
+  if (OF.IsShared) {
+    bool IsStable = true;
+    MD5 Hasher;
+    for (const MachineInstr &MI : MBB) {
+      if (!getStableOutliningHash(MI)) {
+        IsStable = false;
+        break;
+      }
+      std::string Str;
+      raw_string_ostream OS(Str);
+      MI.print(OS, /*IsStandalone=*/true, /*SkipOpers=*/false,
+               /*SkipDebugLoc=*/true, /*AddNewLine=*/true, &TII);
+      Hasher.update(OS.str());
+    }
+    Hasher.update(F->getAttributes().getFnAttrs().getAsString());
+    std::string SharedName =
+        ("OUTLINED_FUNCTION_SHARED_" + Hasher.final().digest()).str();
+    if (IsStable && !M.getNamedValue(SharedName)) {
+      F->setName(SharedName);
+      F->setLinkage(GlobalValue::LinkOnceODRLinkage);
+      F->setVisibility(GlobalValue::HiddenVisibility);
+      if (Triple(M.getTargetTriple()).supportsCOMDAT())
+        F->setComdat(M.getOrInsertComdat(SharedName));
+      SharedFunctionsCreated++;
+    } else {
+      LLVM_DEBUG(dbgs() << "Cannot share " << F->getName() << "\n");
+    }
+  }
+
   // If there's a DISubprogram associated with this outlined function, then
   // emit debug info for the outlined function.
   if (DISubprogram *SP = getSubprogramOrNull(OF)) {
@@ -1007,8 +1278,15 @@ bool MachineOutliner::runOnModule(Module &M) {
   // Number to append to the current outlined function.
   unsigned OutlinedFunctionNum = 0;
 
+  if (!OutlinerGlobalSequences.empty() && GlobalSequences.empty())
+    loadGlobalSequences(OutlinerGlobalSequences);
+
   OutlineRepeatedNum = 0;
-  if (!doOutline(M, OutlinedFunctionNum))
+  RecordedSequences.clear();
+  bool OutlinedSomething = doOutline(M, OutlinedFunctionNum);
+  if (!OutlinerSummaryOut.empty())
+    writeRecordedSequences(M, OutlinerSummaryOut);
+  if (!OutlinedSomething)
     return false;
 
   for (unsigned I = 0; I < OutlinerReruns; ++I) {
@@ -1050,10 +1328,16 @@ bool MachineOutliner::doOutline(Module &M, unsigned &OutlinedFunctionNum) {
 
   // Prepare instruction mappings for the suffix tree.
   populateMapper(Mapper, M, MMI);
+  if (!OutlinerSummaryOut.empty() || !GlobalSequences.empty())
+    Mapper.computeStableHashes();
   std::vector<OutlinedFunction> FunctionList;
 
   // Find all of the outlining candidates.
   findCandidates(Mapper, FunctionList);
+  if (!OutlinerSummaryOut.empty() && OutlineRepeatedNum == 0)
+    recordUniqueSequences(Mapper);
+  if (!GlobalSequences.empty())
+    findGlobalCandidates(Mapper, FunctionList);
 
   // If we've requested size remarks, then collect the MI counts of every
   // function before outlining, and the MI counts after outlining.
@@ -1087,3 +1371,140 @@ bool MachineOutliner::doOutline(Module &M, unsigned &OutlinedFunctionNum) {
 
   return OutlinedSomething;
 }
+
+void MachineOutliner::loadGlobalSequences(StringRef Filename) {
+  auto BufferOrErr = MemoryBuffer::getFile(Filename);
+  if (!BufferOrErr)
+    report_fatal_error("cannot read outliner sequences from '" + Filename +
+                       "': " + BufferOrErr.getError().message());
+  std::vector<GlobalSequence> Sequences;
+  if (Error E = readGlobalSequences((*BufferOrErr)->getBuffer(), Sequences))
+    report_fatal_error("invalid outliner sequences in '" + Filename +
+                       "': " + toString(std::move(E)));
+
+  for (GlobalSequence &Seq : Sequences) {
+    GlobalSequenceLengths.insert(Seq.InstrHashes.size());
+    stable_hash SeqHash = getSequenceHash(Seq.InstrHashes);
+    GlobalSequences.try_emplace(SeqHash, std::move(Seq));
+  }
+}
+
+void MachineOutliner::writeRecordedSequences(const Module &M,
+                                             StringRef Directory) {
+  // The backends of a ThinLTO link, in one process or several, each write a
+  // file named after their module, so that they never write to the same file
+  // and a rerun replaces the records of the previous one. The file is renamed
+  // into place once complete, so that the thin link never reads a partial
+  // file.
+  SmallString<128> Path(Directory);
+  if (std::error_code EC = sys::fs::create_directories(Path))
+    report_fatal_error("cannot create '" + Path + "': " + EC.message());
+  SmallString<32> Name =
+      MD5::hash(arrayRefFromStringRef(M.getModuleIdentifier())).digest();
+  sys::path::append(Path, Name + ".outliner");
+
+  int FD;
+  SmallString<128> TempPath;
+  if (std::error_code EC =
+          sys::fs::createUniqueFile(Path + ".%%%%%%.tmp", FD, TempPath))
+    report_fatal_error("cannot write outliner sequences to '" + Path +
+                       "': " + EC.message());
+  {
+    raw_fd_ostream OS(FD, /*shouldClose=*/true);
+    writeGlobalSequences(OS, RecordedSequences);
+    OS.close();
+    if (OS.has_error()) {
+      sys::fs::remove(TempPath);
+      report_fatal_error("cannot write outliner sequences to '" + TempPath +
+                         "': " + OS.error().message());
+    }
+  }
+  if (std::error_code EC = sys::fs::rename(TempPath, Path)) {
+    sys::fs::remove(TempPath);
+    report_fatal_error("cannot write outliner sequences to '" + Path +
+                       "': " + EC.message());
+  }
+}
+
+Error outliner::readGlobalSequences(StringRef Buffer,
+                                    std::vector<GlobalSequence> &Sequences) {
+  SmallVector<StringRef, 8> Lines;
+  Buffer.split(Lines, '\n', -1, /*KeepEmpty=*/false);
+  for (StringRef Line : Lines) {
+    Line = Line.trim();
+    if (Line.empty() || Line.startswith("#"))
+      continue;
+
+    // <occurrences> <modules> <size> <call overhead> <frame overhead> <hashes>
+    SmallVector<StringRef, 6> Fields;
+    Line.split(Fields, ' ', -1, /*KeepEmpty=*/false);
+    GlobalSequence Seq;
+    if (Fields.size() != 6 || Fields[0].getAsInteger(10, Seq.Occurrences) ||
+        Fields[1].getAsInteger(10, Seq.NumModules) ||
+        Fields[2].getAsInteger(10, Seq.SequenceSize) ||
+        Fields[3].getAsInteger(10, Seq.CallOverhead) ||
+        Fields[4].getAsInteger(10, Seq.FrameOverhead))
+      return createStringError(inconvertibleErrorCode(),
+                               "malformed sequence '%s'", Line.str().c_str());
+
+    SmallVector<StringRef, 16> Hashes;
+    Fields[5].split(Hashes, ',');
+    for (StringRef Hash : Hashes) {
+      stable_hash Value;
+      if (Hash.getAsInteger(16, Value) || !Value)
+        return createStringError(inconvertibleErrorCode(),
+                                 "malformed hash '%s'", Hash.str().c_str());
+      Seq.InstrHashes.push_back(Value);
+    }
+    Sequences.push_back(std::move(Seq));
+  }
+  return Error::success();
+}
+
+void outliner::writeGlobalSequences(raw_ostream &OS,
+                                    ArrayRef<GlobalSequence> Sequences) {
+  for (const GlobalSequence &Seq : Sequences) {
+    OS << Seq.Occurrences << ' ' << Seq.NumModules << ' ' << Seq.SequenceSize
+       << ' ' << Seq.CallOverhead << ' ' << Seq.FrameOverhead << ' ';
+    interleave(
+        Seq.InstrHashes, OS, [&](stable_hash Hash) { OS.write_hex(Hash); },
+        ",");
+    OS << '\n';
+  }
+}
+
+std::vector<GlobalSequence>
+outliner::selectGlobalSequences(ArrayRef<GlobalSequence> Recorded) {
+  // Merge the records of the same sequence. Targets compute the same sizes
+  // for it everywhere, only keep the most pessimistic overheads.
+  MapVector<stable_hash, GlobalSequence> Merged;
+  for (const GlobalSequence &Seq : Recorded) {
+    auto Inserted =
+        Merged.insert({getSequenceHash(Seq.InstrHashes), GlobalSequence()});
+    GlobalSequence &M = Inserted.first->second;
+    if (Inserted.second) {
+      M = Seq;
+      continue;
+    }
+    M.Occurrences += Seq.Occurrences;
+    M.NumModules += Seq.NumModules;
+    M.SequenceSize = std::min(M.SequenceSize, Seq.SequenceSize);
+    M.CallOverhead = std::max(M.CallOverhead, Seq.CallOverhead);
+    M.FrameOverhead = std::max(M.FrameOverhead, Seq.FrameOverhead);
+  }
+
+  // Sequences found in a single module are already outlined there.
+  std::vector<GlobalSequence> Selected;
+  for (auto &Entry : Merged)
+    if (Entry.second.NumModules > 1 && Entry.second.getBenefit() >= 1)
+      Selected.push_back(std::move(Entry.second));
+
+  // Keep the output independent of the order the modules were recorded in.
+  llvm::sort(Selected,
+             [](const GlobalSequence &LHS, const GlobalSequence &RHS) {
+               if (LHS.getBenefit() != RHS.getBenefit())
+                 return LHS.getBenefit() > RHS.getBenefit();
+               return LHS.InstrHashes < RHS.InstrHashes;
+             });
+  return Selected;
+}
@@ -31,8 +31,11 @@
 #include "llvm/CodeGen/MachineRegisterInfo.h"
 #include "llvm/CodeGen/Register.h"
 #include "llvm/CodeGen/StableHashing.h"
+#include "llvm/CodeGen/TargetRegisterInfo.h"
+#include "llvm/CodeGen/TargetSubtargetInfo.h"
 #include "llvm/Config/llvm-config.h"
 #include "llvm/IR/Constants.h"
+#include "llvm/IR/GlobalValue.h"
 #include "llvm/MC/MCSymbol.h"
 #include "llvm/Support/Alignment.h"
 #include "llvm/Support/ErrorHandling.h"
@@ -52,10 +55,14 @@ STATISTIC(StableHashBailingTargetIndexNoName,
           "TargetIndex with no name");
 STATISTIC(StableHashBailingGlobalAddress,
           "Number of encountered unsupported MachineOperands that were "
-          "GlobalAddress while computing stable hashes");
+          "GlobalAddress with no name while computing stable hashes");
 STATISTIC(StableHashBailingBlockAddress,
           "Number of encountered unsupported MachineOperands that were "
           "BlockAddress while computing stable hashes");
+STATISTIC(StableHashBailingRegisterMask,
+          "Number of encountered unsupported MachineOperands that were "
+          "RegisterMasks outside of a MachineFunction while computing stable "
+          "hashes");
 STATISTIC(StableHashBailingMetadataUnsupported,
           "Number of encountered unsupported MachineOperands that were "
           "Metadata of an unsupported kind while computing stable hashes");
@@ -97,9 +104,18 @@ stable_hash llvm::stableHashValue(const MachineOperand &MO) {
   case MachineOperand::MO_Metadata:
     StableHashBailingMetadataUnsupported++;
     return 0;
-  case MachineOperand::MO_GlobalAddress:
-    StableHashBailingGlobalAddress++;
-    return 0;
+  case MachineOperand::MO_GlobalAddress: {
+    // Named globals are identified by their name, which is the same in every
+    // module referring to them.
+    const GlobalValue *GV = MO.getGlobal();
+    if (!GV->hasName()) {
+      StableHashBailingGlobalAddress++;
+      return 0;
+    }
+    return stable_hash_combine(MO.getType(), MO.getTargetFlags(),
+                               stable_hash_combine_string(GV->getName()),
+                               MO.getOffset());
+  }
   case MachineOperand::MO_TargetIndex: {
     if (const char *Name = MO.getTargetIndexName())
       return stable_hash_combine(MO.getType(), MO.getTargetFlags(),
@@ -119,8 +135,22 @@ stable_hash llvm::stableHashValue(const MachineOperand &MO) {
                         stable_hash_combine_string(MO.getSymbolName()));
 
   case MachineOperand::MO_RegisterMask:
-  case MachineOperand::MO_RegisterLiveOut:
-    return hash_combine(MO.getType(), MO.getTargetFlags(), MO.getRegMask());
+  case MachineOperand::MO_RegisterLiveOut: {
+    // Hash the mask rather than its address, which differs from run to run.
+    const MachineInstr *MI = MO.getParent();
+    if (!MI || !MI->getMF()) {
+      StableHashBailingRegisterMask++;
+      return 0;
+    }
+    const TargetRegisterInfo *TRI =
+        MI->getMF()->getSubtarget().getRegisterInfo();
+    unsigned RegMaskSize = MachineOperand::getRegMaskSize(TRI->getNumRegs());
+    const uint32_t *RegMask = MO.getRegMask();
+    SmallVector<stable_hash> RegMaskHashes(RegMask, RegMask + RegMaskSize);
+    return stable_hash_combine(MO.getType(), MO.getTargetFlags(),
+                               stable_hash_combine_array(RegMaskHashes.data(),
+                                                         RegMaskHashes.size()));
+  }
 
   case MachineOperand::MO_ShuffleMask: {
     std::vector<llvm::stable_hash> ShuffleMaskHashes;
@@ -7087,8 +7087,8 @@ outliner::OutlinedFunction AArch64InstrInfo::getOutliningCandidateInfo(
     // Remove candidates with illegal stack modifying instructions
     llvm::erase_if(RepeatedSequenceLocs, hasIllegalSPModification);
 
-    // If the sequence doesn't have enough candidates left, then we're done.
-    if (RepeatedSequenceLocs.size() < 2)
+    // If no candidate is left, then we're done.
+    if (RepeatedSequenceLocs.empty())
       return outliner::OutlinedFunction();
   }
 
@@ -7126,8 +7126,8 @@ outliner::OutlinedFunction AArch64InstrInfo::getOutliningCandidateInfo(
     // the case that, say, 1 out of 20 candidates violate the restructions.)
     llvm::erase_if(RepeatedSequenceLocs, CantGuaranteeValueAcrossCall);
 
-    // If the sequence doesn't have enough candidates left, then we're done.
-    if (RepeatedSequenceLocs.size() < 2)
+    // If no candidate is left, then we're done.
+    if (RepeatedSequenceLocs.empty())
       return outliner::OutlinedFunction();
   }
 
@@ -7365,10 +7365,8 @@ outliner::OutlinedFunction AArch64InstrInfo::getOutliningCandidateInfo(
     }
 
     // If we dropped all of the candidates, bail out here.
-    if (RepeatedSequenceLocs.size() < 2) {
-      RepeatedSequenceLocs.clear();
+    if (RepeatedSequenceLocs.empty())
       return outliner::OutlinedFunction();
-    }
   }
 
   // Does every candidate's MBB contain a call? If so, then we might have a call
@@ -5891,8 +5891,8 @@ outliner::OutlinedFunction ARMBaseInstrInfo::getOutliningCandidateInfo(
     // the case that, say, 1 out of 20 candidates violate the restructions.)
     llvm::erase_if(RepeatedSequenceLocs, CantGuaranteeValueAcrossCall);
 
-    // If the sequence doesn't have enough candidates left, then we're done.
-    if (RepeatedSequenceLocs.size() < 2)
+    // If no candidate is left, then we're done.
+    if (RepeatedSequenceLocs.empty())
       return outliner::OutlinedFunction();
   }
 
@@ -5918,7 +5918,7 @@ outliner::OutlinedFunction ARMBaseInstrInfo::getOutliningCandidateInfo(
   else
     RepeatedSequenceLocs.erase(RepeatedSequenceLocs.begin(), NoBTI);
 
-  if (RepeatedSequenceLocs.size() < 2)
+  if (RepeatedSequenceLocs.empty())
     return outliner::OutlinedFunction();
 
   // Likewise, partition the candidates according to PAC-RET enablement.
@@ -5935,7 +5935,7 @@ outliner::OutlinedFunction ARMBaseInstrInfo::getOutliningCandidateInfo(
   else
     RepeatedSequenceLocs.erase(RepeatedSequenceLocs.begin(), NoPAC);
 
-  if (RepeatedSequenceLocs.size() < 2)
+  if (RepeatedSequenceLocs.empty())
     return outliner::OutlinedFunction();
 
   // At this point, we have only "safe" candidates to outline. Figure out
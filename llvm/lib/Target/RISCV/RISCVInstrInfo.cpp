@@ -1282,8 +1282,8 @@ outliner::OutlinedFunction RISCVInstrInfo::getOutliningCandidateInfo(
 
   llvm::erase_if(RepeatedSequenceLocs, CannotInsertCall);
 
-  // If the sequence doesn't have enough candidates left, then we're done.
-  if (RepeatedSequenceLocs.size() < 2)
+  // If no candidate is left, then we're done.
+  if (RepeatedSequenceLocs.empty())
     return outliner::OutlinedFunction();
 
   unsigned SequenceSize = 0;
@@ -16,9 +16,19 @@
 // passing, which is a valid use-case too, but hasn't been explored much in
 // terms of performance uplifts, cost-model and compile-time impact.
 //
+// With a profile, hot call sites get a higher bonus and cold ones are not
+// specialized at all. The value profile of indirect calls through a function
+// pointer argument tells which callbacks are actually called, and small
+// integer literals (typically enumerators) passed by hot call sites are
+// specialized on, too. Functions which are not local to the module, like
+// those imported by ThinLTO, are specialized for their hot call sites into
+// internal clones. The total size of the clones is bounded by a budget
+// relative to the size of the module.
+//
 // Current limitations:
 // - It does not yet handle integer ranges. We do support "literal constants",
-//   but that's off by default under an option.
+//   but that's off by default under an option, except for small integers at
+//   hot call sites.
 // - The cost-model could be further looked into (it mainly focuses on inlining
 //   benefits),
 //
@@ -46,13 +56,16 @@
 //===----------------------------------------------------------------------===//
 
 #include "llvm/ADT/Statistic.h"
+#include "llvm/Analysis/BlockFrequencyInfo.h"
 #include "llvm/Analysis/CodeMetrics.h"
 #include "llvm/Analysis/InlineCost.h"
 #include "llvm/Analysis/LoopInfo.h"
+#include "llvm/Analysis/ProfileSummaryInfo.h"
 #include "llvm/Analysis/TargetTransformInfo.h"
 #include "llvm/Analysis/ValueLattice.h"
 #include "llvm/Analysis/ValueLatticeUtils.h"
 #include "llvm/IR/IntrinsicInst.h"
+#include "llvm/ProfileData/InstrProf.h"
 #include "llvm/Transforms/Scalar/SCCP.h"
 #include "llvm/Transforms/Utils/Cloning.h"
 #include "llvm/Transforms/Utils/SCCPSolver.h"
@@ -108,6 +121,30 @@ static cl::opt<bool> EnableSpecializationForLiteralConstant(
     cl::desc("Enable specialization of functions that take a literal constant "
              "as an argument."));
 
+static cl::opt<unsigned> HotCallSiteBonusFactor(
+    "func-specialization-hot-bonus-factor", cl::init(4), cl::Hidden,
+    cl::desc("Scale the bonus of specializing for a hot call site, or on a "
+             "hot indirect call target, by this factor"));
+
+static cl::opt<unsigned> MaxHotLiteral(
+    "func-specialization-max-hot-literal", cl::init(16), cl::Hidden,
+    cl::desc("Specialize hot call sites on integer literals up to this value, "
+             "even if literal constants are otherwise disabled"));
+
+static cl::opt<unsigned> SizeBudgetPercent(
+    "func-specialization-size-budget", cl::init(100), cl::Hidden,
+    cl::desc("Maximum size of all the specializations, as a percentage of the "
+             "number of instructions in the module"));
+
+static cl::opt<bool> SpecializeNonLocal(
+    "func-specialization-non-local", cl::init(true), cl::Hidden,
+    cl::desc("With a profile, specialize functions which are not local to the "
+             "module, like those imported by ThinLTO, for their hot call "
+             "sites"));
+
+// The number of indirect call targets read from the value profile.
+static constexpr uint32_t MaxNumIndirectCallTargets = 8;
+
 namespace {
 // Bookkeeping struct to pass data from the analysis and profitability phase
 // to the actual transform helper functions.
@@ -276,6 +313,15 @@ class FunctionSpecializer {
   std::function<TargetTransformInfo &(Function &)> GetTTI;
   std::function<TargetLibraryInfo &(Function &)> GetTLI;
 
+  /// Profile information, if the module has a profile summary.
+  ProfileSummaryInfo *PSI;
+  std::function<BlockFrequencyInfo &(Function &)> GetBFI;
+
+  /// The number of instructions the clones may add to the module, and the
+  /// number they added so far.
+  uint64_t SizeBudget;
+  uint64_t SpecializedSize = 0;
+
   SmallPtrSet<Function *, 4> SpecializedFuncs;
   SmallPtrSet<Function *, 4> FullySpecialized;
   SmallVector<Instruction *> ReplacedWithConstant;
@@ -285,8 +331,12 @@ public:
   FunctionSpecializer(SCCPSolver &Solver,
                       std::function<AssumptionCache &(Function &)> GetAC,
                       std::function<TargetTransformInfo &(Function &)> GetTTI,
-                      std::function<TargetLibraryInfo &(Function &)> GetTLI)
-      : Solver(Solver), GetAC(GetAC), GetTTI(GetTTI), GetTLI(GetTLI) {}
+                      std::function<TargetLibraryInfo &(Function &)> GetTLI,
+                      ProfileSummaryInfo *PSI,
+                      std::function<BlockFrequencyInfo &(Function &)> GetBFI,
+                      uint64_t SizeBudget)
+      : Solver(Solver), GetAC(GetAC), GetTTI(GetTTI), GetTLI(GetTLI),
+        PSI(PSI), GetBFI(GetBFI), SizeBudget(SizeBudget) {}
 
   ~FunctionSpecializer() {
     // Eliminate dead code.
@@ -320,9 +370,17 @@ public:
         continue;
       }
 
-      Changed = true;
-      for (auto &Entry : Specializations)
+      // A clone is at most as big as the original function.
+      unsigned Size = F->getInstructionCount();
+      for (auto &Entry : Specializations) {
+        if (SpecializedSize + Size > SizeBudget) {
+          LLVM_DEBUG(dbgs() << "FnSpecialization: Size budget exhausted\n");
+          break;
+        }
+        SpecializedSize += Size;
         specializeFunction(F, Entry.second, WorkList);
+        Changed = true;
+      }
     }
 
     updateSpecializedFuncs(Candidates, WorkList);
@@ -330,6 +388,20 @@ public:
     return Changed;
   }
 
+  /// Whether the module has a profile to tell hot and cold call sites apart.
+  bool hasProfile() const {
+    return PSI && PSI->hasProfileSummary() && GetBFI;
+  }
+
+  bool isHotCallSite(CallBase &CS) {
+    return hasProfile() && PSI->isHotCallSite(CS, &GetBFI(*CS.getFunction()));
+  }
+
+  bool isColdCallSite(CallBase &CS) {
+    return hasProfile() &&
+           PSI->isColdCallSite(CS, &GetBFI(*CS.getFunction()));
+  }
+
   void removeDeadInstructions() {
     for (auto *I : ReplacedWithConstant) {
       LLVM_DEBUG(dbgs() << "FnSpecialization: Removing dead instruction " << *I
@@ -447,8 +519,12 @@ private:
 
         if (I.second)
           S.Gain = ForceFunctionSpecialization ? 1 : 0 - Cost;
-        if (!ForceFunctionSpecialization)
-          S.Gain += getSpecializationBonus(&FormalArg, ActualArg);
+        if (!ForceFunctionSpecialization) {
+          InstructionCost Bonus = getSpecializationBonus(&FormalArg, ActualArg);
+          if (isHotCallSite(*Call))
+            Bonus *= HotCallSiteBonusFactor;
+          S.Gain += Bonus;
+        }
         S.Args.push_back({&FormalArg, ActualArg});
       }
     }
@@ -497,7 +573,9 @@ private:
 
     // If we're optimizing the function for size, we shouldn't specialize it.
     if (F->hasOptSize() ||
-        shouldOptimizeForSize(F, nullptr, nullptr, PGSOQueryType::IRPass))
+        shouldOptimizeForSize(F, hasProfile() ? PSI : nullptr,
+                              hasProfile() ? &GetBFI(*F) : nullptr,
+                              PGSOQueryType::IRPass))
       return false;
 
     // Exit if the function is not executable. There's no point in specializing
@@ -519,6 +597,14 @@ private:
     ValueToValueMapTy Mappings;
     Function *Clone = cloneCandidateFunction(F, Mappings);
 
+    // Callers in other modules keep calling the original function, the clone
+    // is only called from this one.
+    if (!Clone->hasLocalLinkage()) {
+      Clone->setVisibility(GlobalValue::DefaultVisibility);
+      Clone->setLinkage(GlobalValue::InternalLinkage);
+      Clone->setComdat(nullptr);
+    }
+
     // Rewrite calls to the function so that they call the clone instead.
     rewriteCallSites(Clone, S.Args, Mappings);
 
@@ -532,7 +618,10 @@ private:
     NbFunctionsSpecialized++;
 
     // If the function has been completely specialized, the original function
-    // is no longer needed. Mark it unreachable.
+    // is no longer needed. Mark it unreachable. Other modules may still call
+    // functions which are not local to this one.
+    if (!F->hasLocalLinkage() && !F->hasAvailableExternallyLinkage())
+      return;
     if (F->getNumUses() == 0 || all_of(F->users(), [F](User *U) {
           if (auto *CS = dyn_cast<CallBase>(U))
             return CS->getFunction() == F;
@@ -625,6 +714,9 @@ private:
       auto *CS = cast<CallBase>(U);
       if (CS->getCalledOperand() != A)
         continue;
+      unsigned Weight = getIndirectCallWeight(*CS, CalledFunction);
+      if (!Weight)
+        continue;
 
       // Get the cost of inlining the called function at this call site. Note
       // that this is only an estimate. The called function may eventually
@@ -641,11 +733,12 @@ private:
           getInlineCost(*CS, CalledFunction, Params, CalleeTTI, GetAC, GetTLI);
 
       // We clamp the bonus for this call to be between zero and the default
-      // threshold.
+      // threshold, and weight it by how often the value profile saw the call
+      // go to the called function.
       if (IC.isAlways())
-        Bonus += Params.DefaultThreshold;
+        Bonus += Params.DefaultThreshold * Weight;
       else if (IC.isVariable() && IC.getCostDelta() > 0)
-        Bonus += IC.getCostDelta();
+        Bonus += IC.getCostDelta() * Weight;
 
       LLVM_DEBUG(dbgs() << "FnSpecialization:   Inlining bonus " << Bonus
                         << " for user " << *U << "\n");
@@ -654,6 +747,33 @@ private:
     return TotalCost + Bonus;
   }
 
+  /// Weight of promoting the indirect call \p CS to a call to \p Callee,
+  /// according to its value profile: zero if the profile never saw the call
+  /// go to \p Callee, the hot bonus factor if it is a hot target, and one
+  /// without profile data.
+  unsigned getIndirectCallWeight(CallBase &CS, Function *Callee) {
+    if (!hasProfile())
+      return 1;
+
+    InstrProfValueData ValueData[MaxNumIndirectCallTargets];
+    uint32_t NumVals;
+    uint64_t TotalCount;
+    if (!getValueProfDataFromInst(CS, IPVK_IndirectCallTarget,
+                                  MaxNumIndirectCallTargets, ValueData, NumVals,
+                                  TotalCount))
+      return 1;
+
+    uint64_t Target = IndexedInstrProf::ComputeHash(getPGOFuncName(*Callee));
+    for (uint32_t I = 0; I < NumVals; ++I) {
+      if (ValueData[I].Value != Target)
+        continue;
+      return PSI->isHotCount(ValueData[I].Count) ? HotCallSiteBonusFactor : 1;
+    }
+    // Only the most frequent targets are recorded, so a missing target may
+    // still be called, but rarely.
+    return NumVals < MaxNumIndirectCallTargets ? 0 : 1;
+  }
+
   /// Determine if we should specialize a function based on the incoming values
   /// of the given argument.
   ///
@@ -692,7 +812,8 @@ private:
     // might be beneficial to take the occurrences into account in the cost
     // model, so we would need to find the unique constants.
     //
-    // TODO 2: this currently does not support constants, i.e. integer ranges.
+    // TODO 2: this currently does not support constants, i.e. integer ranges,
+    // besides small literals at hot call sites.
     //
     getPossibleConstants(A, Constants);
 
@@ -730,6 +851,12 @@ private:
       if (!Solver.isBlockExecutable(CS.getParent()))
         continue;
 
+      // Cold call sites are not worth a clone. Functions which are not local
+      // to the module are only specialized for hot ones.
+      bool IsHot = isHotCallSite(CS);
+      if (isColdCallSite(CS) || (!F->hasLocalLinkage() && !IsHot))
+        continue;
+
       auto *V = CS.getArgOperand(A->getArgNo());
       if (isa<PoisonValue>(V))
         return;
@@ -746,8 +873,20 @@ private:
           return;
       }
 
-      if (isa<Constant>(V) && (Solver.getLatticeValueFor(V).isConstant() ||
-                               EnableSpecializationForLiteralConstant))
+      // Small integers passed by hot call sites are likely enumerators
+      // selecting a code path in the callee, and functions are likely
+      // callbacks it calls.
+      auto *CI = dyn_cast<ConstantInt>(V);
+      bool IsHotLiteral =
+          IsHot && ((CI && CI->getValue().ule(MaxHotLiteral)) ||
+                    isa<Function>(V));
+
+      // The solver only visits the call sites of argument-tracked functions,
+      // the operands of the others have no lattice value.
+      if (isa<Constant>(V) &&
+          (IsHotLiteral || EnableSpecializationForLiteralConstant ||
+           (Solver.isArgumentTrackedFunction(F) &&
+            Solver.getLatticeValueFor(V).isConstant())))
         Constants.push_back({&CS, cast<Constant>(V)});
     }
   }
@@ -828,11 +967,24 @@ bool llvm::runFunctionSpecialization(
     std::function<TargetLibraryInfo &(Function &)> GetTLI,
     std::function<TargetTransformInfo &(Function &)> GetTTI,
     std::function<AssumptionCache &(Function &)> GetAC,
-    function_ref<AnalysisResultsForFn(Function &)> GetAnalysis) {
+    function_ref<AnalysisResultsForFn(Function &)> GetAnalysis,
+    ProfileSummaryInfo *PSI,
+    std::function<BlockFrequencyInfo &(Function &)> GetBFI) {
+  bool HasProfile = PSI && PSI->hasProfileSummary() && GetBFI;
+  uint64_t ModuleSize = 0;
+  for (Function &F : M)
+    ModuleSize += F.getInstructionCount();
+
   SCCPSolver Solver(DL, GetTLI, M.getContext());
-  FunctionSpecializer FS(Solver, GetAC, GetTTI, GetTLI);
+  FunctionSpecializer FS(Solver, GetAC, GetTTI, GetTLI, PSI, GetBFI,
+                         ModuleSize * SizeBudgetPercent / 100);
   bool Changed = false;
 
+  // Functions whose callers are not all known are specialized for the hot
+  // call sites in this module. Interposable definitions may not be the ones
+  // that run.
+  SmallVector<Function *, 16> UntrackedFuncs;
+
   // Loop over all functions, marking arguments to those with their addresses
   // taken or that are external as overdefined.
   for (Function &F : M) {
@@ -857,6 +1009,9 @@ bool llvm::runFunctionSpecialization(
                         << "has its address taken\n");
     }
 
+    if (HasProfile && SpecializeNonLocal && !F.isInterposable())
+      UntrackedFuncs.push_back(&F);
+
     // Assume the function is called.
     Solver.markBlockExecutable(&F.front());
 
@@ -877,10 +1032,11 @@ bool llvm::runFunctionSpecialization(
   auto &TrackedFuncs = Solver.getArgumentTrackedFunctions();
   SmallVector<Function *, 16> FuncDecls(TrackedFuncs.begin(),
                                         TrackedFuncs.end());
+  FuncDecls.append(UntrackedFuncs.begin(), UntrackedFuncs.end());
 
-  // No tracked functions, so nothing to do: don't run the solver and remove
+  // No candidate functions, so nothing to do: don't run the solver and remove
   // the ssa_copy intrinsics that may have been introduced.
-  if (TrackedFuncs.empty()) {
+  if (FuncDecls.empty()) {
     removeSSACopy(M);
     return false;
   }
@@ -12,7 +12,9 @@
 
 #include "llvm/Transforms/IPO/SCCP.h"
 #include "llvm/Analysis/AssumptionCache.h"
+#include "llvm/Analysis/BlockFrequencyInfo.h"
 #include "llvm/Analysis/PostDominators.h"
+#include "llvm/Analysis/ProfileSummaryInfo.h"
 #include "llvm/Analysis/TargetLibraryInfo.h"
 #include "llvm/Analysis/TargetTransformInfo.h"
 #include "llvm/InitializePasses.h"
@@ -125,8 +127,13 @@ PreservedAnalyses FunctionSpecializationPass::run(Module &M,
                 F, DT, FAM.getResult<AssumptionAnalysis>(F)),
             &DT, FAM.getCachedResult<PostDominatorTreeAnalysis>(F)};
   };
+  auto *PSI = &AM.getResult<ProfileSummaryAnalysis>(M);
+  auto GetBFI = [&FAM](Function &F) -> BlockFrequencyInfo & {
+    return FAM.getResult<BlockFrequencyAnalysis>(F);
+  };
 
-  if (!runFunctionSpecialization(M, DL, GetTLI, GetTTI, GetAC, GetAnalysis))
+  if (!runFunctionSpecialization(M, DL, GetTLI, GetTTI, GetAC, GetAnalysis,
+                                 PSI, GetBFI))
     return PreservedAnalyses::all();
 
   PreservedAnalyses PA;
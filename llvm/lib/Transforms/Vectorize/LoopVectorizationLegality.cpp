@@ -1196,6 +1196,96 @@ bool LoopVectorizationLegality::canVectorizeWithIfConvert() {
   return true;
 }
 
+bool LoopVectorizationLegality::canVectorizeUncountableExits() {
+  if (!isa<SCEVCouldNotCompute>(PSE.getBackedgeTakenCount()))
+    return true;
+
+  ScalarEvolution &SE = *PSE.getSE();
+  if (!VectorizerParams::EarlyExitVectorization ||
+      isa<SCEVCouldNotCompute>(SE.getExitCount(TheLoop,
+                                               TheLoop->getLoopLatch()))) {
+    reportVectorizationFailure("Cannot compute the loop trip count",
+                               "could not determine number of loop iterations",
+                               "CantComputeNumberOfIterations", ORE, TheLoop);
+    return false;
+  }
+
+  // The scalar loop resumes from the start of the vector iteration that
+  // takes an exit, which only inductions know how to do.
+  if (!Reductions.empty() || !FirstOrderRecurrences.empty()) {
+    reportVectorizationFailure(
+        "Recurrences in a loop with an uncountable exit",
+        "cannot vectorize reductions in a loop with an uncountable exit",
+        "UncountableExitRecurrence", ORE, TheLoop);
+    return false;
+  }
+
+  SmallVector<BasicBlock *, 4> ExitingBlocks;
+  TheLoop->getExitingBlocks(ExitingBlocks);
+  for (BasicBlock *BB : ExitingBlocks) {
+    if (!isa<SCEVCouldNotCompute>(SE.getExitCount(TheLoop, BB)))
+      continue;
+
+    auto *BI = dyn_cast<BranchInst>(BB->getTerminator());
+    bool IsSupported = BI && BI->isConditional() &&
+                       TheLoop->contains(BI->getSuccessor(0)) !=
+                           TheLoop->contains(BI->getSuccessor(1));
+    // Loads are only known to be dereferenceable up to the maximum trip count
+    // of the loop. An exit with a maximum of its own would lower it, while
+    // the vector loop may run past that maximum before checking the exit.
+    if (!IsSupported ||
+        !isa<SCEVCouldNotCompute>(
+            SE.getExitCount(TheLoop, BB, ScalarEvolution::ConstantMaximum))) {
+      reportVectorizationFailure(
+          "Unsupported uncountable exit",
+          "loop control flow is not understood by vectorizer",
+          "CFGNotUnderstood", ORE, TheLoop, BB->getTerminator());
+      UncountableExitingBlocks.clear();
+      return false;
+    }
+    UncountableExitingBlocks.push_back(BB);
+  }
+
+  // Lanes past the one taking the exit are evaluated as well. Loads are only
+  // known to be dereferenceable for a constant maximum trip count, a search
+  // bounded by an unknown value is not vectorized.
+  for (BasicBlock *BB : TheLoop->blocks()) {
+    for (Instruction &I : *BB) {
+      if (isa<PHINode>(I) || isa<BranchInst>(I) || isa<DbgInfoIntrinsic>(I))
+        continue;
+      if (auto *LI = dyn_cast<LoadInst>(&I)) {
+        if (LI->isSimple() && !mustSuppressSpeculation(*LI) &&
+            isDereferenceableAndAlignedInLoop(LI, TheLoop, SE, *DT))
+          continue;
+      } else if (!I.mayHaveSideEffects() && isSafeToSpeculativelyExecute(&I)) {
+        continue;
+      }
+      reportVectorizationFailure(
+          "Cannot speculate instruction in a loop with an uncountable exit",
+          "instruction cannot be executed speculatively in a loop with an "
+          "uncountable exit",
+          "UncountableExitSpeculation", ORE, TheLoop, &I);
+      UncountableExitingBlocks.clear();
+      return false;
+    }
+  }
+
+  LLVM_DEBUG(dbgs() << "LV: Found " << UncountableExitingBlocks.size()
+                    << " uncountable exit(s).\n");
+  return true;
+}
+
+const SCEV *LoopVectorizationLegality::getCountableBackedgeTakenCount() const {
+  ScalarEvolution &SE = *PSE.getSE();
+  SmallVector<BasicBlock *, 4> ExitingBlocks;
+  TheLoop->getExitingBlocks(ExitingBlocks);
+  SmallVector<const SCEV *, 4> ExitCounts;
+  for (BasicBlock *BB : ExitingBlocks)
+    if (!is_contained(UncountableExitingBlocks, BB))
+      ExitCounts.push_back(SE.getExitCount(TheLoop, BB));
+  return SE.getUMinFromMismatchedTypes(ExitCounts);
+}
+
 // Helper function to canVectorizeLoopNestCFG.
 bool LoopVectorizationLegality::canVectorizeLoopCFG(Loop *Lp,
                                                     bool UseVPlanNativePath) {
@@ -1322,6 +1412,15 @@ bool LoopVectorizationLegality::canVectorize(bool UseVPlanNativePath) {
       return false;
   }
 
+  // Check if the vector loop can check the exits that cannot be counted.
+  if (!canVectorizeUncountableExits()) {
+    LLVM_DEBUG(dbgs() << "LV: Can't vectorize the uncountable exits\n");
+    if (DoExtraAnalysis)
+      Result = false;
+    else
+      return false;
+  }
+
   // Go over each instruction and look at memory deps.
   if (!canVectorizeMemory()) {
     LLVM_DEBUG(dbgs() << "LV: Can't vectorize due to memory conflicts\n");
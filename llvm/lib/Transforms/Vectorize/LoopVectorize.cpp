@@ -547,6 +547,10 @@ protected:
                     BasicBlock *MiddleBlock, BasicBlock *VectorHeader,
                     VPlan &Plan);
 
+  /// When the vector loop left through an uncountable exit, make the scalar
+  /// loop resume the inductions from the start of the last vector iteration.
+  void fixUncountableExitResumeValues(VPTransformState &State, VPlan &Plan);
+
   /// Handle all cross-iteration phis in the header.
   void fixCrossIterationPHIs(VPTransformState &State);
 
@@ -2810,7 +2814,11 @@ Value *InnerLoopVectorizer::getOrCreateTripCount(BasicBlock *InsertBlock) {
   IRBuilder<> Builder(InsertBlock->getTerminator());
   // Find the loop boundaries.
   ScalarEvolution *SE = PSE.getSE();
-  const SCEV *BackedgeTakenCount = PSE.getBackedgeTakenCount();
+  // The vector loop leaves early through the uncountable exits, its trip count
+  // is bounded by the other ones.
+  const SCEV *BackedgeTakenCount = Legal->hasUncountableEarlyExit()
+                                       ? Legal->getCountableBackedgeTakenCount()
+                                       : PSE.getBackedgeTakenCount();
   assert(!isa<SCEVCouldNotCompute>(BackedgeTakenCount) &&
          "Invalid loop count");
 
@@ -3295,6 +3303,47 @@ InnerLoopVectorizer::createVectorizedLoopSkeleton() {
   return {completeLoopSkeleton(OrigLoopID), nullptr};
 }
 
+void InnerLoopVectorizer::fixUncountableExitResumeValues(
+    VPTransformState &State, VPlan &Plan) {
+  VPBasicBlock *ExitingVPBB = Plan.getVectorLoopRegion()->getExitingBasicBlock();
+  auto AnyExit = find_if(*ExitingVPBB, [](VPRecipeBase &R) {
+    auto *VPI = dyn_cast<VPInstruction>(&R);
+    return VPI && VPI->getOpcode() == VPInstruction::AnyOf;
+  });
+  assert(AnyExit != ExitingVPBB->end() && "no uncountable exit condition");
+
+  // Which of the lanes takes the exit is not known, the scalar loop re-executes
+  // the whole vector iteration and finds it.
+  IRBuilder<> B(LoopMiddleBlock->getTerminator());
+  Value *EarlyExit = State.get(cast<VPInstruction>(&*AnyExit), 0);
+  Value *IterStart = State.get(Plan.getCanonicalIV(), 0);
+  for (auto &InductionEntry : Legal->getInductionVars()) {
+    PHINode *OrigPhi = InductionEntry.first;
+    const InductionDescriptor &II = InductionEntry.second;
+
+    Value *Resume = IterStart;
+    if (OrigPhi != Legal->getPrimaryInduction()) {
+      if (II.getInductionBinOp() && isa<FPMathOperator>(II.getInductionBinOp()))
+        B.setFastMathFlags(II.getInductionBinOp()->getFastMathFlags());
+      Type *StepType = II.getStep()->getType();
+      Instruction::CastOps CastOp =
+          CastInst::getCastOpcode(IterStart, true, StepType, true);
+      Value *Index = B.CreateCast(CastOp, IterStart, StepType);
+      Value *Step =
+          CreateStepValue(II.getStep(), *PSE.getSE(), &*B.GetInsertPoint());
+      Resume = emitTransformedIndex(B, Index, II.getStartValue(), Step, II);
+      B.clearFastMathFlags();
+    }
+
+    auto *BCResumeVal =
+        cast<PHINode>(OrigPhi->getIncomingValueForBlock(LoopScalarPreHeader));
+    Value *EndValue = BCResumeVal->getIncomingValueForBlock(LoopMiddleBlock);
+    BCResumeVal->setIncomingValueForBlock(
+        LoopMiddleBlock,
+        B.CreateSelect(EarlyExit, Resume, EndValue, "early.exit.resume"));
+  }
+}
+
 // Fix up external users of the induction variable. At this point, we are
 // in LCSSA form, with all external PHIs that use the IV having one input value,
 // coming from the remainder loop. We need those PHIs to also have a correct
@@ -3662,6 +3711,9 @@ void InnerLoopVectorizer::fixVectorizedLoop(VPTransformState &State,
   // This is the second stage of vectorizing recurrences.
   fixCrossIterationPHIs(State);
 
+  if (Legal->hasUncountableEarlyExit())
+    fixUncountableExitResumeValues(State, Plan);
+
   // Forget the original basic block.
   PSE.getSE()->forgetLoop(OrigLoop);
 
@@ -8002,6 +8054,25 @@ VPValue *VPRecipeBuilder::createEdgeMask(BasicBlock *Src, BasicBlock *Dst,
   return EdgeMaskCache[Edge] = EdgeMask;
 }
 
+VPValue *VPRecipeBuilder::createUncountableExitMask(BasicBlock *ExitingBB,
+                                                    VPlanPtr &Plan) {
+  // Unlike other exit edges, this one is live in the vector loop, and the
+  // mask has to be restricted by the branch condition.
+  auto *BI = cast<BranchInst>(ExitingBB->getTerminator());
+  VPValue *ExitMask = Plan->getOrAddVPValue(BI->getCondition());
+  assert(ExitMask && "No mask found for exit condition");
+  if (OrigLoop->contains(BI->getSuccessor(0)))
+    ExitMask = Builder.createNot(ExitMask, BI->getDebugLoc());
+
+  if (VPValue *SrcMask = createBlockInMask(ExitingBB, Plan)) {
+    VPValue *False = Plan->getOrAddVPValue(
+        ConstantInt::getFalse(BI->getCondition()->getType()));
+    ExitMask =
+        Builder.createSelect(SrcMask, ExitMask, False, BI->getDebugLoc());
+  }
+  return ExitMask;
+}
+
 VPValue *VPRecipeBuilder::createBlockInMask(BasicBlock *BB, VPlanPtr &Plan) {
   assert(OrigLoop->contains(BB) && "Block is not a part of a loop");
 
@@ -8870,6 +8941,23 @@ VPlanPtr LoopVectorizationPlanner::buildVPlanWithVPRecipes(
 
   addUsersInExitBlock(HeaderVPBB, MiddleVPBB, OrigLoop, *Plan);
 
+  // Leave the vector loop as soon as any lane takes one of the uncountable
+  // exits.
+  if (Legal->hasUncountableEarlyExit()) {
+    VPBasicBlock *ExitingVPBB = TopRegion->getExitingBasicBlock();
+    auto *Term = cast<VPInstruction>(&ExitingVPBB->back());
+    assert(Term->getOpcode() == VPInstruction::BranchOnCount &&
+           "tail folding is not supported with uncountable exits");
+    Builder.setInsertPoint(ExitingVPBB, Term->getIterator());
+    VPValue *ExitMask = nullptr;
+    for (BasicBlock *ExitingBB : Legal->getUncountableExitingBlocks()) {
+      VPValue *Mask = RecipeBuilder.createUncountableExitMask(ExitingBB, Plan);
+      ExitMask = ExitMask ? Builder.createOr(ExitMask, Mask, DebugLoc()) : Mask;
+    }
+    Term->addOperand(Builder.createNaryOp(VPInstruction::AnyOf, {ExitMask},
+                                          DebugLoc(), "early.exit"));
+  }
+
   assert(isa<VPRegionBlock>(Plan->getVectorLoopRegion()) &&
          !Plan->getVectorLoopRegion()->getEntryBasicBlock()->empty() &&
          "entry block must be set to a VPRegionBlock having a non-empty entry "
@@ -140,6 +140,10 @@ public:
   /// and DST.
   VPValue *createEdgeMask(BasicBlock *Src, BasicBlock *Dst, VPlanPtr &Plan);
 
+  /// A helper function that computes the mask of the lanes leaving the loop
+  /// through the exiting block \p ExitingBB, whose exit count is unknown.
+  VPValue *createUncountableExitMask(BasicBlock *ExitingBB, VPlanPtr &Plan);
+
   /// Mark given ingredient for recording its recipe once one is created for
   /// it.
   void recordRecipeOf(Instruction *I) {
@@ -788,6 +788,10 @@ public:
     // canonical IV separately for each unrolled part.
     CanonicalIVIncrementForPart,
     CanonicalIVIncrementForPartNUW,
+    // Whether any lane of any part of a mask is set, as a single scalar.
+    AnyOf,
+    // Branch to the exit once the IV reaches the trip count, or if an optional
+    // third operand is true.
     BranchOnCount,
     BranchOnCond
   };
@@ -296,6 +296,20 @@ void VPInstruction::generateInstruction(VPTransformState &State,
     State.set(this, Next, Part);
     break;
   }
+  case VPInstruction::AnyOf: {
+    if (Part != 0) {
+      State.set(this, State.get(this, 0), Part);
+      break;
+    }
+    Value *Any = State.get(getOperand(0), 0);
+    for (unsigned P = 1; P < State.UF; ++P)
+      Any = Builder.CreateOr(Any, State.get(getOperand(0), P));
+    if (Any->getType()->isVectorTy())
+      Any = Builder.CreateOrReduce(Any);
+    Any->setName(Name);
+    State.set(this, Any, Part);
+    break;
+  }
   case VPInstruction::BranchOnCond: {
     if (Part != 0)
       break;
@@ -324,6 +338,8 @@ void VPInstruction::generateInstruction(VPTransformState &State,
     Value *IV = State.get(getOperand(0), Part);
     Value *TC = State.get(getOperand(1), Part);
     Value *Cond = Builder.CreateICmpEQ(IV, TC);
+    if (getNumOperands() > 2)
+      Cond = Builder.CreateOr(Cond, State.get(getOperand(2), Part));
 
     // Now create the branch.
     auto *Plan = getParent()->getPlan();
@@ -394,6 +410,9 @@ void VPInstruction::print(raw_ostream &O, const Twine &Indent,
   case VPInstruction::CanonicalIVIncrementNUW:
     O << "VF * UF +(nuw) ";
     break;
+  case VPInstruction::AnyOf:
+    O << "any-of";
+    break;
   case VPInstruction::BranchOnCond:
     O << "branch-on-cond";
     break;
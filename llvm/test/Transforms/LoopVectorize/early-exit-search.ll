@@ -0,0 +1,81 @@
+; RUN: opt -passes=loop-vectorize -enable-early-exit-vectorization -force-vector-width=4 -force-vector-interleave=1 -S < %s | FileCheck %s
+; RUN: opt -passes=loop-vectorize -force-vector-width=4 -force-vector-interleave=1 -S < %s | FileCheck %s --check-prefix=OFF
+
+; Search a fixed-size array. The vector loop leaves as soon as a lane finds
+; the value, the scalar loop then re-executes that vector iteration to find
+; the lane. Without an early exit, it resumes after the last vector iteration.
+
+define i64 @search(ptr noundef nonnull align 4 dereferenceable(4096) %a, i32 %x) {
+; CHECK-LABEL: @search(
+; CHECK:       vector.body:
+; CHECK-NEXT:    [[INDEX:%.*]] = phi i64 [ 0, %vector.ph ], [ [[INDEX_NEXT:%.*]], %vector.body ]
+; CHECK:         [[WIDE_LOAD:%.*]] = load <4 x i32>, ptr {{%.*}}, align 4
+; CHECK-NEXT:    [[FOUND:%.*]] = icmp eq <4 x i32> [[WIDE_LOAD]], {{%.*}}
+; CHECK:         [[INDEX_NEXT]] = add nuw i64 [[INDEX]], 4
+; CHECK-NEXT:    [[EARLY_EXIT:%.*]] = call i1 @llvm.vector.reduce.or.v4i1(<4 x i1> [[FOUND]])
+; CHECK-NEXT:    [[LATCH_EXIT:%.*]] = icmp eq i64 [[INDEX_NEXT]], 1020
+; CHECK-NEXT:    [[EXIT:%.*]] = or i1 [[LATCH_EXIT]], [[EARLY_EXIT]]
+; CHECK-NEXT:    br i1 [[EXIT]], label %middle.block, label %vector.body
+; CHECK:       middle.block:
+; CHECK-NEXT:    [[RESUME:%.*]] = select i1 [[EARLY_EXIT]], i64 [[INDEX]], i64 1020
+; CHECK-NEXT:    br label %scalar.ph
+; CHECK:       scalar.ph:
+; CHECK-NEXT:    [[BC_RESUME_VAL:%.*]] = phi i64 [ [[RESUME]], %middle.block ], [ 0, %entry ]
+; CHECK-NEXT:    br label %loop
+; CHECK:       loop:
+; CHECK-NEXT:    [[IV:%.*]] = phi i64 [ [[BC_RESUME_VAL]], %scalar.ph ], [ [[IV_NEXT:%.*]], %latch ]
+; CHECK:       exit:
+; CHECK-NEXT:    [[R:%.*]] = phi i64 [ [[IV]], %loop ], [ -1, %latch ]
+; CHECK-NEXT:    ret i64 [[R]]
+;
+; OFF-LABEL: @search(
+; OFF-NOT:     vector.body:
+; OFF:         ret i64
+;
+entry:
+  br label %loop
+
+loop:
+  %iv = phi i64 [ 0, %entry ], [ %iv.next, %latch ]
+  %gep = getelementptr inbounds i32, ptr %a, i64 %iv
+  %v = load i32, ptr %gep, align 4
+  %found = icmp eq i32 %v, %x
+  br i1 %found, label %exit, label %latch
+
+latch:
+  %iv.next = add nuw nsw i64 %iv, 1
+  %done = icmp eq i64 %iv.next, 1024
+  br i1 %done, label %exit, label %loop
+
+exit:
+  %r = phi i64 [ %iv, %loop ], [ -1, %latch ]
+  ret i64 %r
+}
+
+; The trip count is unknown, so are the bytes the vector loop may read past
+; the element the search finds.
+
+define i64 @search_unbounded(ptr noundef nonnull align 4 dereferenceable(4096) %a, i64 %n, i32 %x) {
+; CHECK-LABEL: @search_unbounded(
+; CHECK-NOT:   vector.body:
+; CHECK:       ret i64
+;
+entry:
+  br label %loop
+
+loop:
+  %iv = phi i64 [ 0, %entry ], [ %iv.next, %latch ]
+  %gep = getelementptr inbounds i32, ptr %a, i64 %iv
+  %v = load i32, ptr %gep, align 4
+  %found = icmp eq i32 %v, %x
+  br i1 %found, label %exit, label %latch
+
+latch:
+  %iv.next = add nuw nsw i64 %iv, 1
+  %done = icmp eq i64 %iv.next, %n
+  br i1 %done, label %exit, label %loop
+
+exit:
+  %r = phi i64 [ %iv, %loop ], [ -1, %latch ]
+  ret i64 %r
+}
@@ -17,6 +17,7 @@
 
 #include "llvm/Bitcode/BitcodeReader.h"
 #include "llvm/CodeGen/CommandFlags.h"
+#include "llvm/CodeGen/MachineOutliner.h"
 #include "llvm/Config/llvm-config.h"
 #include "llvm/IR/DiagnosticPrinter.h"
 #include "llvm/LTO/LTO.h"
@@ -26,6 +27,7 @@
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/FileSystem.h"
 #include "llvm/Support/InitLLVM.h"
+#include "llvm/Support/Path.h"
 #include "llvm/Support/PluginLoader.h"
 #include "llvm/Support/TargetSelect.h"
 #include "llvm/Support/Threading.h"
@@ -216,7 +218,8 @@ template <typename T> static T check(ErrorOr<T> E, std::string Msg) {
 }
 
 static int usage() {
-  errs() << "Available subcommands: dump-symtab run\n";
+  errs() << "Available subcommands: dump-symtab merge-outliner-summaries "
+            "run\n";
   return 1;
 }
 
@@ -532,6 +535,40 @@ static int dumpSymtab(int argc, char **argv) {
   return 0;
 }
 
+// The thin link of whole-program machine outlining: merges the sequences
+// recorded by the backends with -machine-outliner-summary-out, and writes the
+// ones to outline across modules for -machine-outliner-global-sequences. The
+// inputs are summary files, or directories of them.
+static int mergeOutlinerSummaries(int argc, char **argv) {
+  cl::ParseCommandLineOptions(argc, argv, "Machine outliner summary merger");
+
+  std::vector<std::string> Files;
+  for (const std::string &F : InputFilenames) {
+    if (!sys::fs::is_directory(F)) {
+      Files.push_back(F);
+      continue;
+    }
+    std::error_code EC;
+    for (sys::fs::directory_iterator I(F, EC), E; I != E && !EC;
+         I.increment(EC))
+      if (sys::path::extension(I->path()) == ".outliner")
+        Files.push_back(I->path());
+    check(EC, F);
+  }
+
+  std::vector<outliner::GlobalSequence> Recorded;
+  for (const std::string &F : Files) {
+    std::unique_ptr<MemoryBuffer> MB = check(MemoryBuffer::getFile(F), F);
+    check(outliner::readGlobalSequences(MB->getBuffer(), Recorded), F);
+  }
+
+  std::error_code EC;
+  raw_fd_ostream OS(OutputFilename, EC, sys::fs::OF_Text);
+  check(EC, OutputFilename);
+  outliner::writeGlobalSequences(OS, outliner::selectGlobalSequences(Recorded));
+  return 0;
+}
+
 int main(int argc, char **argv) {
   InitLLVM X(argc, argv);
   InitializeAllTargets();
@@ -550,6 +587,8 @@ int main(int argc, char **argv) {
   argv[1] = argv[0];
   if (Subcommand == "dump-symtab")
     return dumpSymtab(argc - 1, argv + 1);
+  if (Subcommand == "merge-outliner-summaries")
+    return mergeOutlinerSummaries(argc - 1, argv + 1);
   if (Subcommand == "run")
     return run(argc - 1, argv + 1);
   return usage();
@@ -0,0 +1,132 @@
+//===- LoopAccessAnalysisTest.cpp - LoopAccessAnalysis unit tests ---------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Analysis/LoopAccessAnalysis.h"
+#include "llvm/Analysis/AliasAnalysis.h"
+#include "llvm/Analysis/AssumptionCache.h"
+#include "llvm/Analysis/BasicAliasAnalysis.h"
+#include "llvm/Analysis/LoopInfo.h"
+#include "llvm/Analysis/OptimizationRemarkEmitter.h"
+#include "llvm/Analysis/ScalarEvolution.h"
+#include "llvm/Analysis/TargetLibraryInfo.h"
+#include "llvm/AsmParser/Parser.h"
+#include "llvm/IR/Dominators.h"
+#include "llvm/Support/SourceMgr.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+
+namespace {
+
+// Searches 100 elements for %x: the exit taken when it is found depends on
+// the loaded data, so SCEV cannot count it.
+const char *SearchLoopIR = R"(
+define i64 @search(i32* dereferenceable(400) %a, i32* %b, i32 %x) {
+entry:
+  br label %loop
+loop:
+  %iv = phi i64 [ 0, %entry ], [ %iv.next, %latch ]
+  %gep = getelementptr inbounds i32, i32* %a, i64 %iv
+  %v = load i32, i32* %gep, align 4
+  %found = icmp eq i32 %v, %x
+  br i1 %found, label %exit, label %latch
+latch:
+  %iv.next = add nuw nsw i64 %iv, 1
+  %done = icmp eq i64 %iv.next, 100
+  br i1 %done, label %exit, label %loop
+exit:
+  %r = phi i64 [ %iv, %loop ], [ 100, %latch ]
+  ret i64 %r
+}
+
+define i64 @search_and_store(i32* dereferenceable(400) %a, i32* %b, i32 %x) {
+entry:
+  br label %loop
+loop:
+  %iv = phi i64 [ 0, %entry ], [ %iv.next, %latch ]
+  %gep = getelementptr inbounds i32, i32* %a, i64 %iv
+  %v = load i32, i32* %gep, align 4
+  %found = icmp eq i32 %v, %x
+  br i1 %found, label %exit, label %latch
+latch:
+  %gep.b = getelementptr inbounds i32, i32* %b, i64 %iv
+  store i32 %v, i32* %gep.b, align 4
+  %iv.next = add nuw nsw i64 %iv, 1
+  %done = icmp eq i64 %iv.next, 100
+  br i1 %done, label %exit, label %loop
+exit:
+  %r = phi i64 [ %iv, %loop ], [ 100, %latch ]
+  ret i64 %r
+}
+)";
+
+class LoopAccessAnalysisTest : public testing::Test {
+protected:
+  LoopAccessAnalysisTest() {
+    SMDiagnostic Err;
+    M = parseAssemblyString(SearchLoopIR, Err, Context);
+    if (!M)
+      Err.print("LoopAccessAnalysisTest", errs());
+  }
+
+  ~LoopAccessAnalysisTest() override {
+    VectorizerParams::EarlyExitVectorization = false;
+  }
+
+  /// Run the analysis on the only loop of \p FuncName and pass the result to
+  /// \p Test.
+  void runWithLAI(StringRef FuncName,
+                  function_ref<void(const LoopAccessInfo &LAI)> Test) {
+    ASSERT_TRUE(M);
+    Function *F = M->getFunction(FuncName);
+    ASSERT_NE(F, nullptr) << "Could not find " << FuncName;
+
+    TargetLibraryInfoImpl TLII;
+    TargetLibraryInfo TLI(TLII);
+    AssumptionCache AC(*F);
+    DominatorTree DT(*F);
+    LoopInfo LI(DT);
+    ScalarEvolution SE(*F, TLI, AC, DT, LI);
+    BasicAAResult BasicAA(M->getDataLayout(), *F, TLI, AC, &DT);
+    AAResults AA(TLI);
+    AA.addAAResult(BasicAA);
+
+    ASSERT_EQ(LI.end() - LI.begin(), 1);
+    LoopAccessInfo LAI(*LI.begin(), &SE, &TLI, &AA, &DT, &LI);
+    Test(LAI);
+  }
+
+  LLVMContext Context;
+  std::unique_ptr<Module> M;
+};
+
+TEST_F(LoopAccessAnalysisTest, UncountableExitNeedsEarlyExitVectorization) {
+  runWithLAI("search", [](const LoopAccessInfo &LAI) {
+    EXPECT_FALSE(LAI.canVectorizeMemory());
+    ASSERT_NE(LAI.getReport(), nullptr);
+    EXPECT_EQ(LAI.getReport()->getRemarkName(),
+              "CantComputeNumberOfIterations");
+  });
+
+  VectorizerParams::EarlyExitVectorization = true;
+  runWithLAI("search", [](const LoopAccessInfo &LAI) {
+    EXPECT_TRUE(LAI.canVectorizeMemory());
+  });
+}
+
+TEST_F(LoopAccessAnalysisTest, UncountableExitWithStore) {
+  VectorizerParams::EarlyExitVectorization = true;
+  runWithLAI("search_and_store", [](const LoopAccessInfo &LAI) {
+    EXPECT_FALSE(LAI.canVectorizeMemory());
+    ASSERT_NE(LAI.getReport(), nullptr);
+    EXPECT_EQ(LAI.getReport()->getRemarkName(),
+              "CantComputeNumberOfIterations");
+  });
+}
+
+} // namespace
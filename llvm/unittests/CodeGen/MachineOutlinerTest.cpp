@@ -0,0 +1,115 @@
+//===- MachineOutlinerTest.cpp - whole-program outliner summary tests -----===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/CodeGen/MachineOutliner.h"
+#include "llvm/Support/raw_ostream.h"
+#include "llvm/Testing/Support/Error.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+using namespace outliner;
+
+namespace {
+
+GlobalSequence makeSequence(std::vector<stable_hash> InstrHashes,
+                            unsigned Occurrences, unsigned NumModules = 1) {
+  GlobalSequence Seq;
+  Seq.InstrHashes = std::move(InstrHashes);
+  Seq.Occurrences = Occurrences;
+  Seq.NumModules = NumModules;
+  Seq.SequenceSize = 12;
+  Seq.CallOverhead = 4;
+  Seq.FrameOverhead = 4;
+  return Seq;
+}
+
+TEST(MachineOutlinerTest, GlobalSequencesRoundTrip) {
+  std::vector<GlobalSequence> Written = {
+      makeSequence({0x1, 0xabcdef0123456789}, 3),
+      makeSequence({0xffffffffffffffff, 0x2, 0x3}, 2, 2)};
+  std::string Buffer;
+  raw_string_ostream OS(Buffer);
+  writeGlobalSequences(OS, Written);
+
+  std::vector<GlobalSequence> Read;
+  ASSERT_THAT_ERROR(readGlobalSequences(OS.str(), Read), Succeeded());
+  ASSERT_EQ(Read.size(), Written.size());
+  for (unsigned I = 0; I < Read.size(); ++I) {
+    EXPECT_EQ(Read[I].InstrHashes, Written[I].InstrHashes);
+    EXPECT_EQ(Read[I].Occurrences, Written[I].Occurrences);
+    EXPECT_EQ(Read[I].NumModules, Written[I].NumModules);
+    EXPECT_EQ(Read[I].SequenceSize, Written[I].SequenceSize);
+    EXPECT_EQ(Read[I].CallOverhead, Written[I].CallOverhead);
+    EXPECT_EQ(Read[I].FrameOverhead, Written[I].FrameOverhead);
+  }
+}
+
+TEST(MachineOutlinerTest, ReadSkipsCommentsAndAppends) {
+  std::vector<GlobalSequence> Read = {makeSequence({0x1}, 2)};
+  ASSERT_THAT_ERROR(readGlobalSequences("# comment\n\n2 1 12 4 4 a,b\n", Read),
+                    Succeeded());
+  ASSERT_EQ(Read.size(), 2u);
+  EXPECT_EQ(Read[1].InstrHashes, (std::vector<stable_hash>{0xa, 0xb}));
+}
+
+TEST(MachineOutlinerTest, ReadRejectsMalformedSequences) {
+  std::vector<GlobalSequence> Read;
+  // Missing field.
+  EXPECT_THAT_ERROR(readGlobalSequences("2 1 12 4 a,b\n", Read), Failed());
+  // Non-numeric count.
+  EXPECT_THAT_ERROR(readGlobalSequences("x 1 12 4 4 a,b\n", Read), Failed());
+  // Invalid and zero hashes.
+  EXPECT_THAT_ERROR(readGlobalSequences("2 1 12 4 4 a,g\n", Read), Failed());
+  EXPECT_THAT_ERROR(readGlobalSequences("2 1 12 4 4 a,0\n", Read), Failed());
+  EXPECT_THAT_ERROR(readGlobalSequences("2 1 12 4 4 a,,b\n", Read), Failed());
+}
+
+TEST(MachineOutlinerTest, SelectMergesModules) {
+  GlobalSequence InOneModule = makeSequence({0x1, 0x2}, 5);
+  GlobalSequence FirstModule = makeSequence({0x3, 0x4}, 2);
+  GlobalSequence SecondModule = makeSequence({0x3, 0x4}, 3);
+  SecondModule.CallOverhead = 6;
+  std::vector<GlobalSequence> Selected =
+      selectGlobalSequences({InOneModule, FirstModule, SecondModule});
+
+  // The sequence found in one module is already outlined there.
+  ASSERT_EQ(Selected.size(), 1u);
+  EXPECT_EQ(Selected[0].InstrHashes, FirstModule.InstrHashes);
+  EXPECT_EQ(Selected[0].Occurrences, 5u);
+  EXPECT_EQ(Selected[0].NumModules, 2u);
+  // The most pessimistic overhead is kept.
+  EXPECT_EQ(Selected[0].CallOverhead, 6u);
+}
+
+TEST(MachineOutlinerTest, SelectDropsUnprofitableSequences) {
+  // Calling costs as much as the sequence itself.
+  GlobalSequence First = makeSequence({0x1, 0x2}, 1);
+  First.SequenceSize = 4;
+  GlobalSequence Second = First;
+  EXPECT_TRUE(selectGlobalSequences({First, Second}).empty());
+}
+
+TEST(MachineOutlinerTest, SelectIsIndependentOfOrder) {
+  std::vector<GlobalSequence> Recorded = {
+      makeSequence({0x1}, 2), makeSequence({0x2, 0x3}, 4),
+      makeSequence({0x1}, 2), makeSequence({0x2, 0x3}, 4),
+      makeSequence({0x4}, 3), makeSequence({0x4}, 3)};
+  std::vector<GlobalSequence> Reversed(Recorded.rbegin(), Recorded.rend());
+
+  std::vector<GlobalSequence> Selected = selectGlobalSequences(Recorded);
+  std::vector<GlobalSequence> SelectedReversed =
+      selectGlobalSequences(Reversed);
+  ASSERT_EQ(Selected.size(), 3u);
+  ASSERT_EQ(SelectedReversed.size(), Selected.size());
+  for (unsigned I = 0; I < Selected.size(); ++I)
+    EXPECT_EQ(Selected[I].InstrHashes, SelectedReversed[I].InstrHashes);
+  // The most profitable sequence comes first.
+  EXPECT_EQ(Selected[0].InstrHashes, (std::vector<stable_hash>{0x2, 0x3}));
+}
+
+} // namespace
@@ -0,0 +1,331 @@
+//===- FunctionSpecializationTest.cpp - Function specialization unit tests ===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "llvm/Analysis/AssumptionCache.h"
+#include "llvm/Analysis/BlockFrequencyInfo.h"
+#include "llvm/Analysis/BranchProbabilityInfo.h"
+#include "llvm/Analysis/LoopInfo.h"
+#include "llvm/Analysis/PostDominators.h"
+#include "llvm/Analysis/ProfileSummaryInfo.h"
+#include "llvm/Analysis/TargetLibraryInfo.h"
+#include "llvm/Analysis/TargetTransformInfo.h"
+#include "llvm/AsmParser/Parser.h"
+#include "llvm/IR/Constants.h"
+#include "llvm/IR/Dominators.h"
+#include "llvm/IR/InstIterator.h"
+#include "llvm/IR/Instructions.h"
+#include "llvm/IR/Module.h"
+#include "llvm/IR/PassInstrumentation.h"
+#include "llvm/ProfileData/InstrProf.h"
+#include "llvm/Support/CommandLine.h"
+#include "llvm/Support/SourceMgr.h"
+#include "llvm/Transforms/IPO/SCCP.h"
+#include "gtest/gtest.h"
+
+using namespace llvm;
+
+namespace {
+
+// @compute is external: callers in other modules keep calling it. Its hot
+// call sites pass small literals, its cold one is not worth a clone.
+const char *ModuleIR = R"(
+define i32 @compute(i32 %mode, i32 %x) !prof !14 {
+entry:
+  switch i32 %mode, label %default [
+    i32 0, label %add
+    i32 1, label %mul
+  ]
+add:
+  %a = add i32 %x, 1
+  ret i32 %a
+mul:
+  %m = mul i32 %x, 3
+  ret i32 %m
+default:
+  ret i32 %x
+}
+
+define i32 @hot_caller(i32 %x) !prof !14 {
+  %r0 = call i32 @compute(i32 0, i32 %x)
+  %r1 = call i32 @compute(i32 1, i32 %r0)
+  ret i32 %r1
+}
+
+define i32 @cold_caller(i32 %x) !prof !15 {
+  %r = call i32 @compute(i32 2, i32 %x)
+  ret i32 %r
+}
+
+!llvm.module.flags = !{!0}
+
+!0 = !{i32 1, !"ProfileSummary", !1}
+!1 = !{!2, !3, !4, !5, !6, !7, !8, !9}
+!2 = !{!"ProfileFormat", !"InstrProf"}
+!3 = !{!"TotalCount", i64 10000}
+!4 = !{!"MaxCount", i64 1000}
+!5 = !{!"MaxInternalCount", i64 1}
+!6 = !{!"MaxFunctionCount", i64 1000}
+!7 = !{!"NumCounts", i64 3}
+!8 = !{!"NumFunctions", i64 3}
+!9 = !{!"DetailedSummary", !10}
+!10 = !{!11, !12, !13}
+!11 = !{i32 10000, i64 1000, i32 1}
+!12 = !{i32 990000, i64 300, i32 3}
+!13 = !{i32 999999, i64 5, i32 10}
+!14 = !{!"function_entry_count", i64 1000}
+!15 = !{!"function_entry_count", i64 1}
+)";
+
+// @apply calls its callback through a pointer, the value profile of the
+// indirect call only saw @hot_target. The arithmetic makes @apply costlier to
+// clone than the promotion of a call it does not inline is worth.
+const char *CallbackIR = R"(
+define internal i32 @apply(ptr %fn, i32 %x) !prof !14 {
+entry:
+  %x1 = add i32 %x, 1
+  %x2 = mul i32 %x1, 3
+  %x3 = add i32 %x2, 5
+  %x4 = mul i32 %x3, 7
+  %x5 = add i32 %x4, 11
+  %x6 = mul i32 %x5, 13
+  %x7 = add i32 %x6, 17
+  %x8 = mul i32 %x7, 19
+  %r = call i32 %fn(i32 %x8)
+  ret i32 %r
+}
+
+define i32 @hot_target(i32 %x) {
+  %a = add i32 %x, 1
+  ret i32 %a
+}
+
+define i32 @cold_target(i32 %x) {
+  %m = mul i32 %x, 3
+  ret i32 %m
+}
+
+define i32 @caller(i32 %x) !prof !14 {
+  %r0 = call i32 @apply(ptr @hot_target, i32 %x)
+  %r1 = call i32 @apply(ptr @cold_target, i32 %r0)
+  ret i32 %r1
+}
+
+!llvm.module.flags = !{!0}
+
+!0 = !{i32 1, !"ProfileSummary", !1}
+!1 = !{!2, !3, !4, !5, !6, !7, !8, !9}
+!2 = !{!"ProfileFormat", !"InstrProf"}
+!3 = !{!"TotalCount", i64 10000}
+!4 = !{!"MaxCount", i64 1000}
+!5 = !{!"MaxInternalCount", i64 1}
+!6 = !{!"MaxFunctionCount", i64 1000}
+!7 = !{!"NumCounts", i64 3}
+!8 = !{!"NumFunctions", i64 3}
+!9 = !{!"DetailedSummary", !10}
+!10 = !{!11, !12, !13}
+!11 = !{i32 10000, i64 1000, i32 1}
+!12 = !{i32 990000, i64 300, i32 3}
+!13 = !{i32 999999, i64 5, i32 10}
+!14 = !{!"function_entry_count", i64 1000}
+)";
+
+template <typename T> cl::opt<T> &getOption(StringRef Name) {
+  return *static_cast<cl::opt<T> *>(cl::getRegisteredOptions()[Name]);
+}
+
+class FunctionSpecializationTest : public testing::Test {
+protected:
+  FunctionSpecializationTest() {
+    parseModule(ModuleIR);
+
+    FAM.registerPass([] { return TargetLibraryAnalysis(); });
+    FAM.registerPass([] { return TargetIRAnalysis(); });
+    FAM.registerPass([] { return AssumptionAnalysis(); });
+    FAM.registerPass([] { return DominatorTreeAnalysis(); });
+    FAM.registerPass([] { return PostDominatorTreeAnalysis(); });
+    FAM.registerPass([] { return LoopAnalysis(); });
+    FAM.registerPass([] { return BranchProbabilityAnalysis(); });
+    FAM.registerPass([] { return BlockFrequencyAnalysis(); });
+    FAM.registerPass([] { return PassInstrumentationAnalysis(); });
+    FAM.registerPass([&] { return ModuleAnalysisManagerFunctionProxy(MAM); });
+    MAM.registerPass([] { return ProfileSummaryAnalysis(); });
+    MAM.registerPass([] { return PassInstrumentationAnalysis(); });
+    MAM.registerPass([&] { return FunctionAnalysisManagerModuleProxy(FAM); });
+
+    // Leave the cost model out, only the profile and the budget decide.
+    getOption<bool>("force-function-specialization") = true;
+  }
+
+  ~FunctionSpecializationTest() override {
+    getOption<bool>("force-function-specialization") = false;
+    getOption<unsigned>("func-specialization-size-budget") = 100;
+  }
+
+  void parseModule(const char *IR) {
+    SMDiagnostic Err;
+    M = parseAssemblyString(IR, Err, Context);
+    if (!M)
+      Err.print("FunctionSpecializationTest", errs());
+  }
+
+  void runFunctionSpecialization() {
+    ASSERT_TRUE(M);
+    FunctionSpecializationPass().run(*M, MAM);
+  }
+
+  /// The clones of \p Name.
+  SmallVector<Function *> getClones(StringRef Name = "compute") {
+    SmallVector<Function *> Clones;
+    for (Function &F : *M)
+      if (F.getName().startswith((Name + ".").str()))
+        Clones.push_back(&F);
+    return Clones;
+  }
+
+  /// The callee of the call in \p Caller with \p Mode as first argument.
+  Function *getCallee(StringRef Caller, uint64_t Mode) {
+    for (Instruction &I : instructions(*M->getFunction(Caller)))
+      if (auto *Call = dyn_cast<CallInst>(&I))
+        if (auto *Arg = dyn_cast<ConstantInt>(Call->getArgOperand(0)))
+          if (Arg->getZExtValue() == Mode)
+            return Call->getCalledFunction();
+    return nullptr;
+  }
+
+  LLVMContext Context;
+  std::unique_ptr<Module> M;
+  FunctionAnalysisManager FAM;
+  ModuleAnalysisManager MAM;
+};
+
+TEST_F(FunctionSpecializationTest, NonLocalClonesAreInternal) {
+  // Two clones of @compute are larger than the rest of the module.
+  getOption<unsigned>("func-specialization-size-budget") = 200;
+  runFunctionSpecialization();
+
+  auto Clones = getClones();
+  ASSERT_EQ(Clones.size(), 2u);
+  for (Function *Clone : Clones) {
+    EXPECT_TRUE(Clone->hasInternalLinkage()) << Clone->getName().str();
+    EXPECT_TRUE(Clone->hasDefaultVisibility()) << Clone->getName().str();
+  }
+
+  // Other modules may still call the original.
+  Function *Compute = M->getFunction("compute");
+  EXPECT_TRUE(Compute->hasExternalLinkage());
+  EXPECT_FALSE(Compute->isDeclaration());
+
+  // The hot call sites call the clones, the cold one the original.
+  EXPECT_TRUE(is_contained(Clones, getCallee("hot_caller", 0)));
+  EXPECT_TRUE(is_contained(Clones, getCallee("hot_caller", 1)));
+  EXPECT_NE(getCallee("hot_caller", 0), getCallee("hot_caller", 1));
+  EXPECT_EQ(getCallee("cold_caller", 2), Compute);
+}
+
+TEST_F(FunctionSpecializationTest, SizeBudgetLimitsClones) {
+  // Leave room for a single clone of @compute.
+  ASSERT_TRUE(M);
+  uint64_t ModuleSize = 0;
+  for (Function &F : *M)
+    ModuleSize += F.getInstructionCount();
+  uint64_t CloneSize = M->getFunction("compute")->getInstructionCount();
+  getOption<unsigned>("func-specialization-size-budget") =
+      divideCeil(CloneSize * 100, ModuleSize);
+
+  runFunctionSpecialization();
+  EXPECT_EQ(getClones().size(), 1u);
+}
+
+TEST_F(FunctionSpecializationTest, NoBudgetNoClones) {
+  getOption<unsigned>("func-specialization-size-budget") = 0;
+  runFunctionSpecialization();
+  EXPECT_TRUE(getClones().empty());
+  EXPECT_EQ(getCallee("hot_caller", 0), M->getFunction("compute"));
+}
+
+// Specialization is left to the cost model: the bonus of promoting the
+// indirect call in @apply decides, weighted by its value profile.
+class FunctionSpecializationCallbackTest : public FunctionSpecializationTest {
+protected:
+  FunctionSpecializationCallbackTest() {
+    parseModule(CallbackIR);
+    if (M) {
+      Function *HotTarget = M->getFunction("hot_target");
+      InstrProfValueData Targets[] = {
+          {IndexedInstrProf::ComputeHash(getPGOFuncName(*HotTarget)), 1000}};
+      for (Instruction &I : instructions(*M->getFunction("apply")))
+        if (auto *Call = dyn_cast<CallInst>(&I))
+          if (Call->isIndirectCall())
+            annotateValueSite(*M, *Call, Targets, 1000,
+                              IPVK_IndirectCallTarget, 1);
+    }
+
+    getOption<bool>("force-function-specialization") = false;
+    getOption<unsigned>("func-specialization-size-threshold") = 0;
+  }
+
+  ~FunctionSpecializationCallbackTest() override {
+    getOption<unsigned>("func-specialization-size-threshold") = 100;
+    getOption<unsigned>("func-specialization-hot-bonus-factor") = 4;
+  }
+
+  /// The callee of the call in @caller passing \p Target.
+  Function *getCalleeFor(StringRef Target) {
+    Function *TargetFn = M->getFunction(Target);
+    for (Instruction &I : instructions(*M->getFunction("caller")))
+      if (auto *Call = dyn_cast<CallInst>(&I))
+        if (Call->getArgOperand(0) == TargetFn)
+          return Call->getCalledFunction();
+    return nullptr;
+  }
+};
+
+TEST_F(FunctionSpecializationCallbackTest, ProfiledTargetIsSpecialized) {
+  runFunctionSpecialization();
+
+  // The profile never saw @cold_target called, promoting it is worth nothing.
+  auto Clones = getClones("apply");
+  ASSERT_EQ(Clones.size(), 1u);
+  EXPECT_EQ(getCalleeFor("hot_target"), Clones[0]);
+  EXPECT_EQ(getCalleeFor("cold_target"), M->getFunction("apply"));
+}
+
+TEST_F(FunctionSpecializationCallbackTest, NonLocalHotCallback) {
+  // The solver does not track the arguments of external functions, the
+  // callbacks passed by hot call sites are specialized on all the same.
+  ASSERT_TRUE(M);
+  M->getFunction("apply")->setLinkage(GlobalValue::ExternalLinkage);
+  runFunctionSpecialization();
+
+  auto Clones = getClones("apply");
+  ASSERT_EQ(Clones.size(), 1u);
+  EXPECT_TRUE(Clones[0]->hasInternalLinkage());
+  EXPECT_EQ(getCalleeFor("hot_target"), Clones[0]);
+  EXPECT_EQ(getCalleeFor("cold_target"), M->getFunction("apply"));
+}
+
+TEST_F(FunctionSpecializationCallbackTest, HotBonusFactorScalesGain) {
+  // Without the hot bonus, neither the hot call site nor the hot target of
+  // the value profile make up for the cost of the clone.
+  getOption<unsigned>("func-specialization-hot-bonus-factor") = 0;
+  runFunctionSpecialization();
+
+  EXPECT_TRUE(getClones("apply").empty());
+  EXPECT_EQ(getCalleeFor("hot_target"), M->getFunction("apply"));
+}
+
+TEST_F(FunctionSpecializationCallbackTest, ColdCallSitesAreSkipped) {
+  ASSERT_TRUE(M);
+  M->getFunction("caller")->setEntryCount(1);
+  runFunctionSpecialization();
+
+  EXPECT_TRUE(getClones("apply").empty());
+  EXPECT_EQ(getCalleeFor("hot_target"), M->getFunction("apply"));
+}
+
+} // namespace
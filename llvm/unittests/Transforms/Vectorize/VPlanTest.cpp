@@ -764,6 +764,37 @@ No successors
     EXPECT_EQ("EMIT vp<%4> = mul vp<%2> vp<%1>", I4Dump);
   }
 }
+
+TEST(VPInstructionTest, printUncountableExit) {
+  VPInstruction *IV = new VPInstruction(Instruction::Add, {});
+  VPInstruction *Mask = new VPInstruction(Instruction::ICmp, {IV});
+  VPInstruction *AnyOf = new VPInstruction(VPInstruction::AnyOf, {Mask});
+  VPInstruction *Branch =
+      new VPInstruction(VPInstruction::BranchOnCount, {IV, IV, AnyOf});
+
+  VPBasicBlock *VPBB1 = new VPBasicBlock();
+  VPBB1->appendRecipe(IV);
+  VPBB1->appendRecipe(Mask);
+  VPBB1->appendRecipe(AnyOf);
+  VPBB1->appendRecipe(Branch);
+  VPBB1->setName("bb1");
+
+  VPlan Plan;
+  Plan.setEntry(VPBB1);
+
+  // The exit flag is the optional third operand of the branch.
+  const char *ExpectedStr = R"(bb1:
+  EMIT vp<%1> = add
+  EMIT vp<%2> = icmp vp<%1>
+  EMIT vp<%3> = any-of vp<%2>
+  EMIT branch-on-count  vp<%1> vp<%1> vp<%3>
+No successors
+)";
+  std::string Dump;
+  raw_string_ostream OS(Dump);
+  VPBB1->print(OS);
+  EXPECT_EQ(ExpectedStr, Dump);
+}
 #endif
 
 TEST(VPRecipeTest, CastVPInstructionToVPUser) {
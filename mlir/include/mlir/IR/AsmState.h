@@ -16,10 +16,13 @@
 
 #include "mlir/IR/OperationSupport.h"
 #include "mlir/Support/LLVM.h"
+#include "llvm/Support/ErrorOr.h"
+#include "llvm/Support/MemAlloc.h"
 
 #include <memory>
 
 namespace mlir {
+class AsmResourceBlob;
 class AsmResourcePrinter;
 class Operation;
 
@@ -106,6 +109,9 @@ public:
         key, ArrayRef<char>((const char *)data.data(), data.size() * sizeof(T)),
         alignof(T));
   }
+  /// Build an resource entry represented by the given resource blob. This is
+  /// a useful overload if a blob already exists in-memory.
+  void buildBlob(StringRef key, const AsmResourceBlob &blob);
 };
 
 /// This class represents a processed binary blob of data. A resource blob is
@@ -117,19 +123,36 @@ public:
   using DeleterFn = llvm::unique_function<void(const void *data, size_t size)>;
 
   AsmResourceBlob() = default;
-  AsmResourceBlob(ArrayRef<char> data, DeleterFn deleter, bool dataIsMutable)
-      : data(data), deleter(std::move(deleter)), dataIsMutable(dataIsMutable) {}
+  AsmResourceBlob(ArrayRef<char> data, size_t dataAlignment, DeleterFn deleter,
+                  bool dataIsMutable)
+      : data(data), dataAlignment(dataAlignment), deleter(std::move(deleter)),
+        dataIsMutable(dataIsMutable) {}
   /// Utility constructor that initializes a blob with a non-char type T.
   template <typename T, typename DelT>
   AsmResourceBlob(ArrayRef<T> data, DelT &&deleteFn, bool dataIsMutable)
       : data((const char *)data.data(), data.size() * sizeof(T)),
+        dataAlignment(alignof(T)),
         deleter([deleteFn = std::forward<DelT>(deleteFn)](const void *data,
                                                           size_t size) {
           return deleteFn((const T *)data, size);
         }),
         dataIsMutable(dataIsMutable) {}
   AsmResourceBlob(AsmResourceBlob &&) = default;
-  AsmResourceBlob &operator=(AsmResourceBlob &&) = default;
+  AsmResourceBlob &operator=(AsmResourceBlob &&rhs) {
+    if (this == &rhs)
+      return *this;
+
+    // Delete the current blob if necessary.
+    if (deleter)
+      deleter(data.data(), data.size());
+
+    // Take the data entries from rhs.
+    data = rhs.data;
+    dataAlignment = rhs.dataAlignment;
+    deleter = std::move(rhs.deleter);
+    dataIsMutable = rhs.dataIsMutable;
+    return *this;
+  }
   AsmResourceBlob(const AsmResourceBlob &) = delete;
   AsmResourceBlob &operator=(const AsmResourceBlob &) = delete;
   ~AsmResourceBlob() {
@@ -137,6 +160,9 @@ public:
       deleter(data.data(), data.size());
   }
 
+  /// Return the alignment of the underlying data.
+  size_t getDataAlignment() const { return dataAlignment; }
+
   /// Return the raw underlying data of this blob.
   ArrayRef<char> getData() const { return data; }
 
@@ -159,6 +185,9 @@ private:
   /// The raw, properly aligned, blob data.
   ArrayRef<char> data;
 
+  /// The alignment of the data.
+  size_t dataAlignment = 0;
+
   /// An optional deleter function used to deallocate the underlying data when
   /// necessary.
   DeleterFn deleter;
@@ -167,6 +196,86 @@ private:
   bool dataIsMutable;
 };
 
+inline void AsmResourceBuilder::buildBlob(StringRef key,
+                                          const AsmResourceBlob &blob) {
+  buildBlob(key, blob.getData(), blob.getDataAlignment());
+}
+
+/// This class provides a utility wrapper around AsmResourceBlob for allocating
+/// heap memory via the LLVM allocator.
+class HeapAsmResourceBlob {
+public:
+  /// Create a new heap allocated blob with the given size and alignment.
+  /// `dataIsMutable` indicates if the allocated data can be mutated. By
+  /// default, we treat heap allocated blobs as mutable.
+  static AsmResourceBlob allocate(size_t size, size_t align,
+                                  bool dataIsMutable = true) {
+    return wrap((char *)llvm::allocate_buffer(size, align), size, align,
+                dataIsMutable);
+  }
+  /// Create a new heap allocated blob and copy the provided data into it.
+  static AsmResourceBlob allocateAndCopy(ArrayRef<char> data, size_t align,
+                                         bool dataIsMutable = true) {
+    char *buffer = (char *)llvm::allocate_buffer(data.size(), align);
+    std::memcpy(buffer, data.data(), data.size());
+    return wrap(buffer, data.size(), align, dataIsMutable);
+  }
+  template <typename T>
+  static std::enable_if_t<!std::is_same<T, char>::value, AsmResourceBlob>
+  allocateAndCopy(ArrayRef<T> data, bool dataIsMutable = true) {
+    return allocateAndCopy(
+        ArrayRef<char>((const char *)data.data(), data.size() * sizeof(T)),
+        alignof(T), dataIsMutable);
+  }
+
+private:
+  /// Wrap a buffer returned by `llvm::allocate_buffer` into a blob owning it.
+  static AsmResourceBlob wrap(char *buffer, size_t size, size_t align,
+                              bool dataIsMutable) {
+    return AsmResourceBlob(
+        ArrayRef<char>(buffer, size), align,
+        [align](const void *data, size_t size) {
+          llvm::deallocate_buffer(const_cast<void *>(data), size, align);
+        },
+        dataIsMutable);
+  }
+};
+
+/// This class provides a utility wrapper around AsmResourceBlob for creating
+/// blobs that reference data owned by somebody else, which must outlive the
+/// blob. No copy is made, and the data is never freed by the blob.
+class UnmanagedAsmResourceBlob {
+public:
+  /// Create a new unmanaged resource directly referencing the provided data.
+  /// `dataIsMutable` indicates if the allocated data can be mutated. By
+  /// default, we treat unmanaged blobs as immutable.
+  static AsmResourceBlob allocate(ArrayRef<char> data, size_t align,
+                                  bool dataIsMutable = false) {
+    return AsmResourceBlob(data, align, /*deleter=*/{}, dataIsMutable);
+  }
+  template <typename T>
+  static std::enable_if_t<!std::is_same<T, char>::value, AsmResourceBlob>
+  allocate(ArrayRef<T> data, bool dataIsMutable = false) {
+    return allocate(
+        ArrayRef<char>((const char *)data.data(), data.size() * sizeof(T)),
+        alignof(T), dataIsMutable);
+  }
+};
+
+/// This class provides a utility wrapper around AsmResourceBlob for mapping a
+/// section of a file into memory. The section is not read up front: its pages
+/// are only loaded when the data is first accessed, are shared with the page
+/// cache of the system, and are unmapped when the blob is destroyed.
+class FileAsmResourceBlob {
+public:
+  /// Map `size` bytes starting at `offset` within the file at `path`. If the
+  /// mapped data does not satisfy `align`, which happens when `offset` is not
+  /// aligned, the data is copied into a heap allocated blob instead. Mapped
+  /// blobs are immutable.
+  static llvm::ErrorOr<AsmResourceBlob>
+  allocate(StringRef path, uint64_t offset, uint64_t size, size_t align);
+};
+
 /// This class represents a single parsed resource entry.
 class AsmParsedResourceEntry {
 public:
@@ -197,6 +306,14 @@ public:
   /// allocated, the given allocator function is invoked.
   virtual FailureOr<AsmResourceBlob>
   parseAsBlob(BlobAllocatorFn allocator) const = 0;
+
+  /// Parse the resource entry represented by a binary blob using heap
+  /// allocation.
+  FailureOr<AsmResourceBlob> parseAsBlob() const {
+    return parseAsBlob([](unsigned size, unsigned align) {
+      return HeapAsmResourceBlob::allocate(size, align);
+    });
+  }
 };
 
 //===----------------------------------------------------------------------===//
@@ -17,8 +17,12 @@
 
 namespace mlir {
 class AffineMap;
+class AsmResourceBlob;
 class BoolAttr;
+class BuiltinDialect;
 class DenseIntElementsAttr;
+template <typename T>
+struct DialectResourceBlobHandle;
 class FlatSymbolRefAttr;
 class FunctionType;
 class IntegerSet;
@@ -27,6 +31,10 @@ class Location;
 class Operation;
 class ShapedType;
 
+/// A handle used to reference the resource blobs of DenseResourceElementsAttr.
+/// The blobs are owned by the blob manager of the builtin dialect.
+using DenseResourceElementsHandle = DialectResourceBlobHandle<BuiltinDialect>;
+
 //===----------------------------------------------------------------------===//
 // Elements Attributes
 //===----------------------------------------------------------------------===//
@@ -19,6 +19,7 @@
 #include "mlir/IR/OperationSupport.h"
 #include "mlir/IR/Region.h"
 #include "llvm/ADT/Twine.h"
+#include <atomic>
 
 namespace mlir {
 /// Operation is a basic unit of execution within MLIR. Operations can
@@ -28,7 +29,8 @@ namespace mlir {
 class alignas(8) Operation final
     : public llvm::ilist_node_with_parent<Operation, Block>,
       private llvm::TrailingObjects<Operation, detail::OperandStorage,
-                                    BlockOperand, Region, OpOperand> {
+                                    BlockOperand, Region, Attribute,
+                                    OpOperand> {
 public:
   /// Create a new Operation with the specific fields.
   static Operation *create(Location location, OperationName name,
@@ -351,25 +353,39 @@ public:
   // Operations may optionally carry a list of attributes that associate
   // constants to names.  Attributes may be dynamically added and removed over
   // the lifetime of an operation.
+  //
+  // The inherent attributes of a registered operation, i.e. the ones named in
+  // `getName().getAttributeNames()`, are stored inline in the operation, and
+  // can be accessed by their index in that list without any lookup. Setting
+  // them does not unique a new attribute dictionary. The other, discardable,
+  // attributes are held in a dictionary. The methods below taking a name or a
+  // dictionary work on both kinds.
 
   /// Return all of the attributes on this operation.
-  ArrayRef<NamedAttribute> getAttrs() { return attrs.getValue(); }
+  ArrayRef<NamedAttribute> getAttrs() { return getAttrDictionary().getValue(); }
 
-  /// Return all of the attributes on this operation as a DictionaryAttr.
-  DictionaryAttr getAttrDictionary() { return attrs; }
+  /// Return all of the attributes on this operation as a DictionaryAttr. The
+  /// dictionary is only built, and cached, when the operation has inherent
+  /// attributes.
+  DictionaryAttr getAttrDictionary();
 
   /// Set the attribute dictionary on this operation.
-  void setAttrs(DictionaryAttr newAttrs) {
-    assert(newAttrs && "expected valid attribute dictionary");
-    attrs = newAttrs;
-  }
+  void setAttrs(DictionaryAttr newAttrs);
   void setAttrs(ArrayRef<NamedAttribute> newAttrs) {
     setAttrs(DictionaryAttr::get(getContext(), newAttrs));
   }
 
   /// Return the specified attribute if present, null otherwise.
-  Attribute getAttr(StringAttr name) { return attrs.get(name); }
-  Attribute getAttr(StringRef name) { return attrs.get(name); }
+  Attribute getAttr(StringAttr name) {
+    if (Optional<unsigned> index = getInherentAttrIndex(name))
+      return getInherentAttrStorage()[*index];
+    return attrs.get(name);
+  }
+  Attribute getAttr(StringRef name) {
+    if (Optional<unsigned> index = getInherentAttrIndex(name))
+      return getInherentAttrStorage()[*index];
+    return attrs.get(name);
+  }
 
   template <typename AttrClass>
   AttrClass getAttrOfType(StringAttr name) {
@@ -382,8 +398,8 @@ public:
 
   /// Return true if the operation has an attribute with the provided name,
   /// false otherwise.
-  bool hasAttr(StringAttr name) { return attrs.contains(name); }
-  bool hasAttr(StringRef name) { return attrs.contains(name); }
+  bool hasAttr(StringAttr name) { return static_cast<bool>(getAttr(name)); }
+  bool hasAttr(StringRef name) { return static_cast<bool>(getAttr(name)); }
   template <typename AttrClass, typename NameT>
   bool hasAttrOfType(NameT &&name) {
     return static_cast<bool>(
@@ -393,9 +409,9 @@ public:
   /// If the an attribute exists with the specified name, change it to the new
   /// value. Otherwise, add a new attribute with the specified name/value.
   void setAttr(StringAttr name, Attribute value) {
-    NamedAttrList attributes(attrs);
-    if (attributes.set(name, value) != value)
-      attrs = attributes.getDictionary(getContext());
+    if (Optional<unsigned> index = getInherentAttrIndex(name))
+      return setInherentAttr(*index, value);
+    setDiscardableAttr(name, value);
   }
   void setAttr(StringRef name, Attribute value) {
     setAttr(StringAttr::get(getContext(), name), value);
@@ -405,16 +421,50 @@ public:
   /// attribute that was erased, or nullptr if there was no attribute with such
   /// name.
   Attribute removeAttr(StringAttr name) {
-    NamedAttrList attributes(attrs);
-    Attribute removedAttr = attributes.erase(name);
-    if (removedAttr)
-      attrs = attributes.getDictionary(getContext());
-    return removedAttr;
+    if (Optional<unsigned> index = getInherentAttrIndex(name))
+      return removeInherentAttr(*index);
+    return removeDiscardableAttr(name);
   }
   Attribute removeAttr(StringRef name) {
     return removeAttr(StringAttr::get(getContext(), name));
   }
 
+  /// Return the inherent attribute at `index` in the attribute names of the
+  /// registered operation, or null if it is not set.
+  Attribute getInherentAttr(unsigned index) {
+    if (index < numInherentAttrs)
+      return getInherentAttrStorage()[index];
+    // The operation was created before its name was registered.
+    return attrs.get(getName().getAttributeNames()[index]);
+  }
+
+  /// Set the inherent attribute at `index` in the attribute names of the
+  /// registered operation.
+  void setInherentAttr(unsigned index, Attribute value) {
+    assert(value && "expected valid attribute value");
+    if (index >= numInherentAttrs)
+      return setDiscardableAttr(getName().getAttributeNames()[index], value);
+    Attribute &slot = getInherentAttrStorage()[index];
+    if (slot != value) {
+      slot = value;
+      invalidateAttrDictionary();
+    }
+  }
+
+  /// Remove the inherent attribute at `index` in the attribute names of the
+  /// registered operation. Return the attribute that was erased, or nullptr if
+  /// it was not set.
+  Attribute removeInherentAttr(unsigned index) {
+    if (index >= numInherentAttrs)
+      return removeDiscardableAttr(getName().getAttributeNames()[index]);
+    Attribute removedAttr = getInherentAttrStorage()[index];
+    if (removedAttr) {
+      getInherentAttrStorage()[index] = nullptr;
+      invalidateAttrDictionary();
+    }
+    return removedAttr;
+  }
+
   /// A utility iterator that filters out non-dialect attributes.
   class dialect_attr_iterator
       : public llvm::filter_iterator<ArrayRef<NamedAttribute>::iterator,
@@ -692,7 +742,7 @@ private:
 private:
   Operation(Location location, OperationName name, unsigned numResults,
             unsigned numSuccessors, unsigned numRegions,
-            DictionaryAttr attributes, bool hasOperandStorage);
+            unsigned numInherentAttrs, bool hasOperandStorage);
 
   // Operations are deleted through the destroy() member because they are
   // allocated with malloc.
@@ -713,6 +763,33 @@ private:
     return prefixAllocSize(numOutOfLineResults, numInlineResults);
   }
 
+  /// Returns the inline storage of the inherent attributes.
+  MutableArrayRef<Attribute> getInherentAttrStorage() {
+    return {getTrailingObjects<Attribute>(), numInherentAttrs};
+  }
+
+  /// Returns the index of `attrName` in the inherent attribute storage, or
+  /// None if it is not an inherent attribute stored inline.
+  template <typename NameT>
+  Optional<unsigned> getInherentAttrIndex(NameT attrName) {
+    if (!numInherentAttrs)
+      return llvm::None;
+    ArrayRef<StringAttr> names = getName().getAttributeNames();
+    for (unsigned i = 0; i != numInherentAttrs; ++i)
+      if (names[i] == attrName)
+        return i;
+    return llvm::None;
+  }
+
+  /// Drop the cached dictionary of all the attributes after a change.
+  void invalidateAttrDictionary() {
+    attrsCache.store(nullptr, std::memory_order_relaxed);
+  }
+
+  /// Set or remove an attribute in the discardable attribute dictionary.
+  void setDiscardableAttr(StringAttr name, Attribute value);
+  Attribute removeDiscardableAttr(StringAttr name);
+
   /// Returns the operand storage object.
   detail::OperandStorage &getOperandStorage() {
     assert(hasOperandStorage && "expected operation to have operand storage");
@@ -774,9 +851,18 @@ private:
   /// This holds the name of the operation.
   OperationName name;
 
-  /// This holds general named attributes for the operation.
+  /// The number of inherent attributes stored inline.
+  const unsigned numInherentAttrs;
+
+  /// This holds the discardable named attributes for the operation, or all of
+  /// them if the operation has no inline inherent attributes.
   DictionaryAttr attrs;
 
+  /// The dictionary of all the attributes, when the operation has inline
+  /// inherent attributes. Built on demand, null when stale. It is atomic as
+  /// concurrent readers of the operation may build it at the same time.
+  std::atomic<const void *> attrsCache{nullptr};
+
   // allow ilist_traits access to 'block' field.
   friend struct llvm::ilist_traits<Operation>;
 
@@ -791,7 +877,7 @@ private:
 
   // This stuff is used by the TrailingObjects template.
   friend llvm::TrailingObjects<Operation, detail::OperandStorage, BlockOperand,
-                               Region, OpOperand>;
+                               Region, Attribute, OpOperand>;
   size_t numTrailingObjects(OverloadToken<detail::OperandStorage>) const {
     return hasOperandStorage ? 1 : 0;
   }
@@ -799,6 +885,9 @@ private:
     return numSuccs;
   }
   size_t numTrailingObjects(OverloadToken<Region>) const { return numRegions; }
+  size_t numTrailingObjects(OverloadToken<Attribute>) const {
+    return numInherentAttrs;
+  }
 };
 
 inline raw_ostream &operator<<(raw_ostream &os, const Operation &op) {
@@ -206,6 +206,13 @@ public:
   /// Return the name of this operation as a StringAttr.
   StringAttr getIdentifier() const { return impl->name; }
 
+  /// Return the list of cached attribute names registered to this operation,
+  /// which is empty if the operation is not registered. See
+  /// RegisteredOperationName::getAttributeNames.
+  ArrayRef<StringAttr> getAttributeNames() const {
+    return impl->attributeNames;
+  }
+
   void print(raw_ostream &os) const;
   void dump() const;
 
@@ -41,6 +41,9 @@ struct CIROpAsmDialectInterface : public OpAsmDialectInterface {
 
   AliasResult getAlias(Type type, raw_ostream &os) const final {
     if (auto structType = type.dyn_cast<StructType>()) {
+      // Unnamed structs, such as the ABI register pairs, are printed inline.
+      if (structType.getTypeName().getValue().empty())
+        return AliasResult::NoAlias;
       os << structType.getTypeName();
       return AliasResult::OverridableAlias;
     }
@@ -1268,6 +1271,126 @@ FunctionType CallOp::getCalleeType() {
   return FunctionType::get(getContext(), getOperandTypes(), getResultTypes());
 }
 
+void CallOp::getEffects(
+    SmallVectorImpl<SideEffects::EffectInstance<MemoryEffects::Effect>>
+        &effects) {
+  auto callee = SymbolTable::lookupNearestSymbolFrom<FuncOp>(
+      *this, (*this)->getAttrOfType<FlatSymbolRefAttr>("callee"));
+
+  // A call that may unwind has control effects, which are not modeled: keep
+  // it in place by assuming it can do anything.
+  if (!callee || !callee.nothrow() || !callee.memory_effects()) {
+    effects.emplace_back(MemoryEffects::Read::get());
+    effects.emplace_back(MemoryEffects::Write::get());
+    return;
+  }
+  if (*callee.memory_effects() == FuncMemoryEffects::read)
+    effects.emplace_back(MemoryEffects::Read::get());
+}
+
+//===----------------------------------------------------------------------===//
+// AwaitOp
+//===----------------------------------------------------------------------===//
+
+void AwaitOp::build(OpBuilder &builder, OperationState &result,
+                    cir::AwaitKind kind, TypeRange resultTypes,
+                    function_ref<void(OpBuilder &, Location)> readyBuilder,
+                    function_ref<void(OpBuilder &, Location)> suspendBuilder,
+                    function_ref<void(OpBuilder &, Location)> resumeBuilder) {
+  OpBuilder::InsertionGuard guard(builder);
+  result.addAttribute(kindAttrName(result.name),
+                      cir::AwaitKindAttr::get(builder.getContext(), kind));
+  result.addTypes(resultTypes);
+
+  Region *readyRegion = result.addRegion();
+  builder.createBlock(readyRegion);
+  readyBuilder(builder, result.location);
+
+  Region *suspendRegion = result.addRegion();
+  builder.createBlock(suspendRegion);
+  suspendBuilder(builder, result.location);
+
+  Region *resumeRegion = result.addRegion();
+  builder.createBlock(resumeRegion);
+  resumeBuilder(builder, result.location);
+}
+
+/// Given the region at `index`, or the parent operation if `index` is None,
+/// return the successor regions. These are the regions that may be selected
+/// during the flow of control. `operands` is a set of optional attributes
+/// that correspond to a constant value for each operand, or null if that
+/// operand is not a constant.
+void AwaitOp::getSuccessorRegions(Optional<unsigned> index,
+                                  ArrayRef<Attribute> operands,
+                                  SmallVectorImpl<RegionSuccessor> &regions) {
+  // The resume region branches back to the parent operation.
+  if (index.hasValue()) {
+    if (*index == 2) {
+      regions.push_back(RegionSuccessor(getResults()));
+      return;
+    }
+    // Both ready and a vetoed suspend continue in the resume region, a ready
+    // region that yields false continues in the suspend region.
+    if (*index == 0)
+      regions.push_back(RegionSuccessor(&this->suspend()));
+    regions.push_back(RegionSuccessor(&this->resume()));
+    return;
+  }
+
+  regions.push_back(RegionSuccessor(&this->ready()));
+}
+
+LogicalResult AwaitOp::verify() {
+  // Whether all the plain 'cir.yield's terminating `r` yield `types`.
+  auto yieldsTypes = [](Region &r, TypeRange types) {
+    for (Block &block : r) {
+      if (block.empty())
+        continue;
+      auto yield = dyn_cast<YieldOp>(block.back());
+      if (yield && (!yield.isPlain() || yield.args().getTypes() != types))
+        return false;
+    }
+    return true;
+  };
+
+  if (ready().empty() || suspend().empty() || resume().empty())
+    return emitOpError() << "expects non-empty ready, suspend and resume";
+
+  auto boolTy = cir::BoolType::get(getContext());
+  if (!yieldsTypes(ready(), boolTy))
+    return emitOpError() << "ready region must yield a '!cir.bool'";
+  // The suspend region yields nothing, or whether to suspend at all.
+  if (!yieldsTypes(suspend(), {}) && !yieldsTypes(suspend(), boolTy))
+    return emitOpError() << "suspend region must yield nothing or a "
+                            "'!cir.bool'";
+  if (!yieldsTypes(resume(), getResultTypes()))
+    return emitOpError() << "resume region must yield the result types";
+  return success();
+}
+
+//===----------------------------------------------------------------------===//
+// CoroAllocFrameOp
+//===----------------------------------------------------------------------===//
+
+LogicalResult CoroAllocFrameOp::verify() {
+  auto fnOp = getOperation()->getParentOfType<cir::FuncOp>();
+  if (!fnOp || !fnOp.coroutine())
+    return emitOpError() << "expects a parent 'cir.func' marked as coroutine";
+
+  if (isElided() != storage_size().hasValue())
+    return emitOpError() << "expects storage and storage_size together";
+
+  // Elided allocations still need the region when the frame does not fit the
+  // storage.
+  if (alloc().empty())
+    return emitOpError() << "requires an alloc region";
+  auto &entry = alloc().front();
+  if (entry.getNumArguments() != 1 ||
+      !entry.getArgument(0).getType().isa<IntegerType>())
+    return emitOpError() << "alloc region expects the frame size argument";
+  return success();
+}
+
 //===----------------------------------------------------------------------===//
 // CIR defined traits
 //===----------------------------------------------------------------------===//
@@ -17,6 +17,7 @@
 #include "mlir/IR/DialectImplementation.h"
 
 #include "llvm/ADT/STLExtras.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/TypeSwitch.h"
 
 #define GET_TYPEDEF_CLASSES
@@ -75,17 +76,31 @@ Type StructType::parse(mlir::AsmParser &parser) {
   std::string typeName;
   if (parser.parseString(&typeName))
     return Type();
+  // Members follow the name, comma separated, as printed below.
   llvm::SmallVector<Type> members;
+  if (parser.parseComma())
+    return Type();
   Type nextMember;
-  while (mlir::succeeded(parser.parseType(nextMember)))
+  while (true) {
+    auto parseResult = parser.parseOptionalType(nextMember);
+    if (!parseResult.hasValue())
+      break;
+    if (mlir::failed(*parseResult))
+      return Type();
     members.push_back(nextMember);
+    if (mlir::failed(parser.parseOptionalComma()))
+      break;
+  }
   if (parser.parseGreater())
     return Type();
   return get(parser.getContext(), members, typeName);
 }
 
 void StructType::print(mlir::AsmPrinter &printer) const {
-  printer << '<' << getTypeName() << ", ";
+  // The name is a string, quoted and escaped as the parser expects it.
+  printer << "<\"";
+  llvm::printEscapedString(getTypeName().getValue(), printer.getStream());
+  printer << "\", ";
   llvm::interleaveComma(getMembers(), printer);
   printer << '>';
 }
@@ -0,0 +1,446 @@
+//===- CoroElide.cpp - elide nested coroutine frame allocations -----------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// LLVM's CoroElide only fires once the ramp function of a coroutine has been
+// inlined into its caller, which the inliner rarely decides to do before the
+// coroutine is split. In CIR the coroutine structure is still explicit, so
+// the decision can be made up front: when the frame of a coroutine cannot be
+// reached once its caller returns, the coroutine lifetime is nested in the
+// caller's and the frame can live in the caller's stack.
+//
+// The coroutine itself is left alone, so its suspend points keep returning to
+// whoever resumed it. The call is redirected to a copy of the coroutine that
+// takes the storage for its frame as an extra argument; the frame only falls
+// back to the heap when it turns out not to fit once it is laid out.
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Dialect/CIR/Passes.h"
+
+#include "PassDetail.h"
+#include "mlir/Dialect/CIR/IR/CIRDialect.h"
+
+#include "mlir/IR/SymbolTable.h"
+#include "mlir/Interfaces/LoopLikeInterface.h"
+#include "llvm/ADT/SmallBitVector.h"
+#include "llvm/Support/MathExtras.h"
+
+using namespace mlir;
+using namespace cir;
+
+// The frame starts with the resume and destroy function pointers and the
+// index of the current suspend point.
+static constexpr uint64_t FrameHeaderSize = 24;
+
+// Every value stored in the frame gets a slot with the maximum fundamental
+// alignment, unless its alloca asks for more.
+static constexpr uint64_t FrameSlotAlign = 16;
+
+// How deep the escape analysis follows tracked values into callees.
+static constexpr unsigned MaxCallDepth = 4;
+
+/// Upper bound of the store size of `ty`, or None for types whose size is
+/// not known in CIR.
+static Optional<uint64_t> getTypeSizeBound(Type ty) {
+  if (auto intTy = ty.dyn_cast<IntegerType>())
+    return llvm::divideCeil(intTy.getWidth(), 8);
+  if (auto fltTy = ty.dyn_cast<FloatType>())
+    return llvm::divideCeil(fltTy.getWidth(), 8);
+  if (ty.isa<cir::PointerType>())
+    return 8;
+  if (ty.isa<cir::BoolType>())
+    return 1;
+  if (auto arrTy = ty.dyn_cast<cir::ArrayType>()) {
+    auto eltSize = getTypeSizeBound(arrTy.getEltType());
+    if (!eltSize)
+      return llvm::None;
+    return *eltSize * arrTy.getSize();
+  }
+  if (auto structTy = ty.dyn_cast<cir::StructType>()) {
+    // Assume every member needs padding up to the next slot.
+    uint64_t size = 0;
+    for (auto member : structTy.getMembers()) {
+      auto memberSize = getTypeSizeBound(member);
+      if (!memberSize)
+        return llvm::None;
+      size += llvm::alignTo(*memberSize, FrameSlotAlign);
+    }
+    return size;
+  }
+  return llvm::None;
+}
+
+/// Whether the body of `fn` is the one that runs at every call, so that its
+/// uses of the arguments can be relied on.
+static bool hasExactDefinition(cir::FuncOp fn) {
+  if (fn.isDeclaration())
+    return false;
+  switch (fn.linkage()) {
+  case GlobalLinkageKind::ExternalLinkage:
+  case GlobalLinkageKind::InternalLinkage:
+  case GlobalLinkageKind::PrivateLinkage:
+  case GlobalLinkageKind::LinkOnceODRLinkage:
+  case GlobalLinkageKind::WeakODRLinkage:
+    return true;
+  default:
+    return false;
+  }
+}
+
+/// The value `addr` is an offset or a cast of.
+static Value getUnderlyingObject(Value addr) {
+  while (true) {
+    if (auto cast = addr.getDefiningOp<CastOp>()) {
+      addr = cast.src();
+      continue;
+    }
+    if (auto stride = addr.getDefiningOp<PtrStrideOp>()) {
+      addr = stride.base();
+      continue;
+    }
+    if (auto member = addr.getDefiningOp<StructElementAddr>()) {
+      addr = member.struct_addr();
+      continue;
+    }
+    return addr;
+  }
+}
+
+/// Whether `block` may run again after it ran once, through a branch back to
+/// it.
+static bool isInCycle(Block *block) {
+  SmallVector<Block *> worklist(block->getSuccessors());
+  SmallPtrSet<Block *, 8> visited;
+  while (!worklist.empty()) {
+    Block *succ = worklist.pop_back_val();
+    if (succ == block)
+      return true;
+    if (visited.insert(succ).second)
+      worklist.append(succ->succ_begin(), succ->succ_end());
+  }
+  return false;
+}
+
+/// Whether `op` may run more than once per invocation of the function
+/// holding it: it is nested in a loop, or in a block that branches back to
+/// itself.
+static bool mayRunAgain(Operation *op) {
+  for (; !isa<cir::FuncOp>(op); op = op->getParentOp()) {
+    if (isInCycle(op->getBlock()))
+      return true;
+    if (isa<LoopLikeOpInterface>(op->getParentOp()))
+      return true;
+  }
+  return false;
+}
+
+namespace {
+/// Where tracked values leave a function to its callers: through its
+/// results, or stored into the memory its arguments point to.
+struct Outflow {
+  bool results = false;
+  llvm::SmallBitVector args;
+};
+
+/// Escape analysis of a coroutine frame pointer.
+///
+/// Tracked values may be the frame pointer, or point to memory that may hold
+/// it: the promise, the object owning the coroutine handle, the locals it is
+/// copied into. Whatever is loaded from them is tracked too, whatever its
+/// type, since a handle may be punned to an integer. They may be overwritten,
+/// copied into allocas of the function, compared, used to resume or destroy
+/// the coroutine, and passed to functions that in turn do not let them
+/// escape. Any other use could publish the frame pointer where it outlives
+/// the function.
+class FrameEscapeAnalysis {
+public:
+  FrameEscapeAnalysis(SymbolTable &symbolTable) : symbolTable(symbolTable) {}
+
+  /// Whether the values in `roots`, used in `fn`, escape. If `outflow` is
+  /// given, they may also leave `fn` to its callers, which `outflow`
+  /// reports.
+  bool escapes(cir::FuncOp fn, ArrayRef<Value> roots,
+               Outflow *outflow = nullptr, unsigned depth = 0);
+
+private:
+  SymbolTable &symbolTable;
+};
+} // namespace
+
+bool FrameEscapeAnalysis::escapes(cir::FuncOp fn, ArrayRef<Value> roots,
+                                  Outflow *outflow, unsigned depth) {
+  SmallVector<Value> worklist(roots.begin(), roots.end());
+  SmallPtrSet<Value, 16> tracked;
+  if (outflow)
+    outflow->args.resize(fn.getNumArguments());
+
+  while (!worklist.empty()) {
+    Value v = worklist.pop_back_val();
+    if (!tracked.insert(v).second)
+      continue;
+
+    for (OpOperand &use : v.getUses()) {
+      Operation *user = use.getOwner();
+
+      // Values computed from tracked values are tracked in turn.
+      if (isa<LoadOp, CastOp, PtrStrideOp, BinOp, StructElementAddr,
+              CoroPromiseOp>(user)) {
+        worklist.append(user->result_begin(), user->result_end());
+        continue;
+      }
+      if (isa<CmpOp, CoroFreeFrameOp, CoroResumeOp, CoroDestroyOp,
+              CoroDoneOp>(user))
+        continue;
+
+      if (auto store = dyn_cast<StoreOp>(user)) {
+        // Overwriting tracked memory does not publish anything.
+        if (store.addr() == v)
+          continue;
+        Value object = getUnderlyingObject(store.addr());
+        if (object.getDefiningOp<AllocaOp>()) {
+          worklist.push_back(object);
+          continue;
+        }
+        auto arg = object.dyn_cast<BlockArgument>();
+        if (outflow && arg && arg.getOwner() == &fn.getBody().front()) {
+          outflow->args.set(arg.getArgNumber());
+          continue;
+        }
+        return true;
+      }
+
+      if (isa<ReturnOp>(user)) {
+        if (!outflow)
+          return true;
+        outflow->results = true;
+        continue;
+      }
+
+      // Leaving a region with a tracked value tracks the results of the
+      // operation holding it.
+      if (isa<YieldOp>(user)) {
+        Operation *parent = user->getParentOp();
+        if (isa<cir::FuncOp>(parent))
+          return true;
+        worklist.append(parent->result_begin(), parent->result_end());
+        continue;
+      }
+
+      // Follow the value into the callee, and track what it passes back.
+      if (auto call = dyn_cast<CallOp>(user)) {
+        auto callee = symbolTable.lookup<cir::FuncOp>(call.callee());
+        if (!callee || !hasExactDefinition(callee) || depth == MaxCallDepth)
+          return true;
+        Outflow calleeOutflow;
+        Value arg = callee.getArgument(use.getOperandNumber());
+        if (escapes(callee, arg, &calleeOutflow, depth + 1))
+          return true;
+        if (calleeOutflow.results)
+          worklist.append(call->result_begin(), call->result_end());
+        for (unsigned argNo : calleeOutflow.args.set_bits())
+          worklist.push_back(call.getOperand(argNo));
+        continue;
+      }
+
+      return true;
+    }
+  }
+  return false;
+}
+
+namespace {
+struct CoroElidePass : public CoroElideBase<CoroElidePass> {
+  CoroElidePass() = default;
+  void runOnOperation() override;
+
+  CoroAllocFrameOp getElidableFrame(cir::FuncOp callee, Outflow &outflow);
+  bool isNestedInCaller(CallOp call, const Outflow &outflow);
+  Optional<uint64_t> getFrameSizeBound(cir::FuncOp callee);
+  cir::FuncOp getElidedCoroutine(cir::FuncOp callee, uint64_t frameSize);
+  void elide(CallOp call, cir::FuncOp elided, uint64_t frameSize);
+
+  SymbolTable *symbolTable = nullptr;
+  FrameEscapeAnalysis *escapeAnalysis = nullptr;
+  DenseMap<Operation *, cir::FuncOp> elidedCoroutines;
+};
+} // namespace
+
+/// The heap allocated frame of `callee` if its allocation can be elided: its
+/// body is known and the frame pointer only leaves it to the caller, as
+/// described by `outflow`, usually in the object it returns.
+CoroAllocFrameOp CoroElidePass::getElidableFrame(cir::FuncOp callee,
+                                                 Outflow &outflow) {
+  if (!callee.coroutine() || !hasExactDefinition(callee))
+    return nullptr;
+
+  CoroAllocFrameOp frame;
+  auto walkResult = callee.walk([&](CoroAllocFrameOp allocFrame) {
+    if (frame || allocFrame.isElided())
+      return WalkResult::interrupt();
+    frame = allocFrame;
+    return WalkResult::advance();
+  });
+  if (walkResult.wasInterrupted() || !frame)
+    return nullptr;
+
+  // The suspend points of the coroutine may hand its handle over to the
+  // awaiters, which must not keep it. The handle may also be recovered from
+  // the promise, as get_return_object usually does.
+  SmallVector<Value> roots{frame.getResult()};
+  callee.walk([&](Operation *op) {
+    if (auto alloca = dyn_cast<AllocaOp>(op)) {
+      if (alloca.isCoroPromise())
+        roots.push_back(alloca.getResult());
+    } else if (auto promise = dyn_cast<CoroPromiseOp>(op)) {
+      if (promise.from_promise())
+        roots.push_back(promise.getResult());
+    }
+  });
+  if (escapeAnalysis->escapes(callee, roots, &outflow))
+    return nullptr;
+  return frame;
+}
+
+/// The coroutine started by `call` cannot outlive its caller if nothing the
+/// frame pointer flows into, usually the object owning the coroutine handle,
+/// escapes from the caller.
+///
+/// The caller holds a single frame storage per call, so the call must also
+/// run at most once: nothing proves that the coroutine started by one
+/// iteration of a loop is destroyed before the next one starts another in
+/// the same storage, since the frame pointer may still be held in a local.
+bool CoroElidePass::isNestedInCaller(CallOp call, const Outflow &outflow) {
+  if (mayRunAgain(call))
+    return false;
+
+  SmallVector<Value> roots;
+  if (outflow.results)
+    roots.append(call.result_begin(), call.result_end());
+  for (unsigned argNo : outflow.args.set_bits())
+    roots.push_back(call.getOperand(argNo));
+  auto caller = call->getParentOfType<cir::FuncOp>();
+  return !escapeAnalysis->escapes(caller, roots);
+}
+
+/// Upper bound of the size of the frame of `callee`: besides the header, the
+/// frame holds at most its allocas (promise, parameter copies and locals) and
+/// the values live across a suspend point. This only sizes the storage, a
+/// frame that turns out larger is still allocated on the heap.
+Optional<uint64_t> CoroElidePass::getFrameSizeBound(cir::FuncOp callee) {
+  uint64_t size = FrameHeaderSize;
+  auto walkResult = callee.walk([&](Operation *op) {
+    if (auto alloca = dyn_cast<AllocaOp>(op)) {
+      auto allocaSize = getTypeSizeBound(alloca.type());
+      if (!allocaSize)
+        return WalkResult::interrupt();
+      uint64_t align = FrameSlotAlign;
+      if (alloca.alignment())
+        align = std::max<uint64_t>(align, *alloca.alignment());
+      size = llvm::alignTo(size, align) + *allocaSize;
+      return WalkResult::advance();
+    }
+    for (Type resTy : op->getResultTypes()) {
+      auto resSize = getTypeSizeBound(resTy);
+      if (!resSize)
+        return WalkResult::interrupt();
+      size = llvm::alignTo(size, FrameSlotAlign) + *resSize;
+    }
+    return WalkResult::advance();
+  });
+
+  if (walkResult.wasInterrupted())
+    return llvm::None;
+  return llvm::alignTo(size, FrameSlotAlign);
+}
+
+/// A copy of `callee` taking the storage of its frame as an extra, last
+/// argument of `frameSize` bytes.
+cir::FuncOp CoroElidePass::getElidedCoroutine(cir::FuncOp callee,
+                                              uint64_t frameSize) {
+  auto &elided = elidedCoroutines[callee];
+  if (elided)
+    return elided;
+
+  auto *ctx = callee.getContext();
+  auto storageTy = cir::PointerType::get(ctx, IntegerType::get(ctx, 8));
+  elided = cast<cir::FuncOp>(callee->clone());
+  elided.setName((callee.getName() + ".elided").str());
+  elided.linkageAttr(
+      GlobalLinkageKindAttr::get(ctx, GlobalLinkageKind::InternalLinkage));
+  elided.insertArgument(elided.getNumArguments(), storageTy,
+                        DictionaryAttr::get(ctx), callee.getLoc());
+  symbolTable->insert(elided, std::next(Block::iterator(callee)));
+
+  CoroAllocFrameOp allocFrame;
+  elided.walk([&](CoroAllocFrameOp op) { allocFrame = op; });
+  allocFrame.storageMutable().assign(
+      elided.getArgument(elided.getNumArguments() - 1));
+  allocFrame.storage_sizeAttr(
+      IntegerAttr::get(IntegerType::get(ctx, 64), frameSize));
+  return elided;
+}
+
+void CoroElidePass::elide(CallOp call, cir::FuncOp elided,
+                          uint64_t frameSize) {
+  auto caller = call->getParentOfType<cir::FuncOp>();
+  auto loc = call.getLoc();
+  OpBuilder builder(call);
+
+  // Allocate the frame storage at the entry of the caller.
+  Value storage;
+  {
+    OpBuilder::InsertionGuard guard(builder);
+    builder.setInsertionPointToStart(&caller.getBody().front());
+    auto i8Ty = builder.getIntegerType(8);
+    auto storageTy = cir::ArrayType::get(builder.getContext(), i8Ty, frameSize);
+    auto storageAlloca = builder.create<AllocaOp>(
+        loc, cir::PointerType::get(builder.getContext(), storageTy), storageTy,
+        "coro.frame", InitStyle::uninitialized,
+        builder.getI64IntegerAttr(FrameSlotAlign));
+    storage = builder.create<CastOp>(
+        loc, cir::PointerType::get(builder.getContext(), i8Ty),
+        CastKind::array_to_ptrdecay, storageAlloca);
+  }
+
+  SmallVector<Value> operands(call.getOperands());
+  operands.push_back(storage);
+  auto elidedCall = builder.create<CallOp>(loc, elided, operands);
+  call.replaceAllUsesWith(elidedCall.getResults());
+  call.erase();
+}
+
+void CoroElidePass::runOnOperation() {
+  ModuleOp module = getOperation();
+  SymbolTable moduleSymbolTable(module);
+  FrameEscapeAnalysis moduleEscapeAnalysis(moduleSymbolTable);
+  symbolTable = &moduleSymbolTable;
+  escapeAnalysis = &moduleEscapeAnalysis;
+  elidedCoroutines.clear();
+
+  SmallVector<std::pair<CallOp, cir::FuncOp>> candidates;
+  module.walk([&](CallOp call) {
+    auto callee = symbolTable->lookup<cir::FuncOp>(call.callee());
+    if (!callee || callee == call->getParentOfType<cir::FuncOp>())
+      return;
+    Outflow outflow;
+    if (getElidableFrame(callee, outflow) && isNestedInCaller(call, outflow))
+      candidates.push_back({call, callee});
+  });
+
+  for (auto &candidate : candidates) {
+    auto frameSize = getFrameSizeBound(candidate.second);
+    if (!frameSize)
+      continue;
+    elide(candidate.first,
+          getElidedCoroutine(candidate.second, *frameSize), *frameSize);
+  }
+}
+
+std::unique_ptr<Pass> mlir::createCoroElidePass() {
+  return std::make_unique<CoroElidePass>();
+}
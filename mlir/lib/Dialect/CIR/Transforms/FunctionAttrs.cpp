@@ -0,0 +1,291 @@
+//===- FunctionAttrs.cpp - infer effect attributes of CIR functions -------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Bottom-up walk over the strongly connected components of the call graph,
+// similar to LLVM's FunctionAttrs: functions in an SCC get `nothrow` and
+// `memory_effects` when every operation in the SCC allows it, assuming the
+// SCC itself does not throw or touch memory. Once set, these attributes make
+// `cir.call` look side effect free (or read-only) to the rest of MLIR.
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Dialect/CIR/Passes.h"
+
+#include "PassDetail.h"
+#include "mlir/Dialect/CIR/IR/CIRDialect.h"
+
+#include "mlir/Analysis/CallGraph.h"
+#include "mlir/IR/SymbolTable.h"
+#include "llvm/ADT/SCCIterator.h"
+
+using namespace mlir;
+using namespace cir;
+
+namespace {
+/// The call graph without its edges into the external node. Calls to
+/// declarations resolve to the external node, which has an edge to every
+/// function: with these edges, all the functions calling a declaration would
+/// end up in the same SCC.
+struct DefinedCallGraph {
+  const CallGraph *callGraph;
+};
+} // namespace
+
+namespace llvm {
+template <>
+struct GraphTraits<DefinedCallGraph> {
+  using NodeRef = CallGraphNode *;
+  static NodeRef getEntryNode(DefinedCallGraph graph) {
+    return graph.callGraph->getExternalNode();
+  }
+
+  static bool isDefined(const CallGraphNode::Edge &edge) {
+    return !edge.getTarget()->isExternal();
+  }
+  static NodeRef unwrap(const CallGraphNode::Edge &edge) {
+    return edge.getTarget();
+  }
+
+  using ChildIteratorType = mapped_iterator<
+      filter_iterator<CallGraphNode::iterator, decltype(&isDefined)>,
+      decltype(&unwrap)>;
+  static ChildIteratorType child_begin(NodeRef node) {
+    return {make_filter_range(*node, &isDefined).begin(), &unwrap};
+  }
+  static ChildIteratorType child_end(NodeRef node) {
+    return {make_filter_range(*node, &isDefined).end(), &unwrap};
+  }
+};
+} // namespace llvm
+
+/// Whether the body of `fn` is the one that runs at every call. Inference
+/// runs before any CIR optimization, so the bodies of ODR functions are
+/// still the source definition, which every other copy is equivalent to.
+static bool hasExactDefinition(FuncOp fn) {
+  if (fn.isDeclaration() || fn.coroutine())
+    return false;
+  switch (fn.linkage()) {
+  case GlobalLinkageKind::ExternalLinkage:
+  case GlobalLinkageKind::InternalLinkage:
+  case GlobalLinkageKind::PrivateLinkage:
+  case GlobalLinkageKind::LinkOnceODRLinkage:
+  case GlobalLinkageKind::WeakODRLinkage:
+    return true;
+  default:
+    return false;
+  }
+}
+
+/// Whether `addr` points into an alloca of the function it is used in, which
+/// callers cannot observe.
+static bool isLocalMemory(Value addr) {
+  while (true) {
+    if (addr.getDefiningOp<AllocaOp>())
+      return true;
+    if (auto cast = addr.getDefiningOp<CastOp>()) {
+      addr = cast.src();
+      continue;
+    }
+    if (auto stride = addr.getDefiningOp<PtrStrideOp>()) {
+      addr = stride.base();
+      continue;
+    }
+    return false;
+  }
+}
+
+/// Whether some successor of `op` comes before it in its region, i.e. the
+/// unstructured control flow may loop.
+static bool hasBackEdge(Operation *op) {
+  if (op->getNumSuccessors() == 0)
+    return false;
+  SmallPtrSet<Block *, 4> succs(op->getSuccessors().begin(),
+                                op->getSuccessors().end());
+  for (Block &block : *op->getParentRegion()) {
+    if (succs.count(&block))
+      return true;
+    if (&block == op->getBlock())
+      return false;
+  }
+  return false;
+}
+
+/// Whether the pointer returned by `fn` is only ever produced by functions
+/// returning unaliased pointers, and not captured before being returned.
+/// Values may go through allocas (e.g. the return slot) on their way.
+static bool returnsNoAliasPointer(FuncOp fn, SymbolTable &symbolTable) {
+  if (fn.getNumResults() != 1 ||
+      !fn.getResultTypes()[0].isa<cir::PointerType>())
+    return false;
+
+  SmallVector<Value> worklist;
+  fn.walk([&](ReturnOp ret) {
+    worklist.append(ret.input().begin(), ret.input().end());
+  });
+  SmallPtrSet<Value, 8> visited;
+
+  while (!worklist.empty()) {
+    Value v = worklist.pop_back_val();
+    if (!visited.insert(v).second)
+      continue;
+
+    // An alloca holding the pointer: only load it and store into it.
+    if (v.getDefiningOp<AllocaOp>()) {
+      for (Operation *user : v.getUsers()) {
+        if (auto load = dyn_cast<LoadOp>(user)) {
+          worklist.push_back(load.getResult());
+          continue;
+        }
+        auto store = dyn_cast<StoreOp>(user);
+        if (!store || store.addr() != v || store.value() == v)
+          return false;
+        worklist.push_back(store.value());
+      }
+      continue;
+    }
+
+    // The pointer itself: a fresh one from an allocation function, or a copy
+    // loaded from one of the allocas above.
+    if (auto call = v.getDefiningOp<CallOp>()) {
+      auto callee = symbolTable.lookup<FuncOp>(call.callee());
+      if (!callee || !callee.hasNoAliasResult())
+        return false;
+    } else if (auto load = v.getDefiningOp<LoadOp>()) {
+      if (!load.addr().getDefiningOp<AllocaOp>())
+        return false;
+      worklist.push_back(load.addr());
+    } else {
+      return false;
+    }
+
+    for (OpOperand &use : v.getUses()) {
+      Operation *user = use.getOwner();
+      if (isa<ReturnOp>(user))
+        continue;
+      auto store = dyn_cast<StoreOp>(user);
+      if (!store || store.value() != v ||
+          !store.addr().getDefiningOp<AllocaOp>())
+        return false;
+      worklist.push_back(store.addr());
+    }
+  }
+  return true;
+}
+
+namespace {
+struct FunctionAttrsPass : public FunctionAttrsBase<FunctionAttrsPass> {
+  FunctionAttrsPass() = default;
+  void runOnOperation() override;
+
+  void inferSCC(ArrayRef<FuncOp> scc, SymbolTable &symbolTable);
+};
+} // namespace
+
+void FunctionAttrsPass::inferSCC(ArrayRef<FuncOp> scc,
+                                 SymbolTable &symbolTable) {
+  if (!llvm::all_of(scc, hasExactDefinition))
+    return;
+
+  SmallPtrSet<Operation *, 4> sccFuncs;
+  for (auto fn : scc)
+    sccFuncs.insert(fn);
+
+  bool mayThrow = false;
+  bool mayWrite = false;
+  bool mayRead = false;
+  // Recursion and loops may not terminate, see the `memory_effects`
+  // definition.
+  bool mayNotReturn = scc.size() > 1;
+
+  auto visit = [&](Operation *op) {
+    if (auto call = dyn_cast<CallOp>(op)) {
+      auto callee = symbolTable.lookup<FuncOp>(call.callee());
+      if (callee && sccFuncs.count(callee)) {
+        mayNotReturn = true;
+        return;
+      }
+      if (!callee || !callee.nothrow())
+        mayThrow = true;
+      if (!callee || !callee.memory_effects())
+        mayWrite = true;
+      else if (*callee.memory_effects() == FuncMemoryEffects::read)
+        mayRead = true;
+      return;
+    }
+
+    if (isa<LoopOp>(op) || hasBackEdge(op)) {
+      mayNotReturn = true;
+      return;
+    }
+
+    // Region holding operations only structure the control flow, and their
+    // nested operations are visited on their own. Terminators only transfer
+    // control.
+    if (op->getNumRegions() != 0 || op->hasTrait<OpTrait::IsTerminator>())
+      return;
+
+    auto effectsOp = dyn_cast<MemoryEffectOpInterface>(op);
+    if (!effectsOp) {
+      mayWrite = true;
+      return;
+    }
+    SmallVector<MemoryEffects::EffectInstance> effects;
+    effectsOp.getEffects(effects);
+    for (auto &effect : effects) {
+      if (isa<MemoryEffects::Allocate>(effect.getEffect()))
+        continue;
+      if (effect.getValue() && isLocalMemory(effect.getValue()))
+        continue;
+      if (isa<MemoryEffects::Read>(effect.getEffect()))
+        mayRead = true;
+      else
+        mayWrite = true;
+    }
+  };
+  for (auto fn : scc)
+    fn.walk(visit);
+
+  auto *ctx = &getContext();
+  for (auto fn : scc) {
+    if (!mayThrow && !fn.nothrow())
+      fn.nothrowAttr(UnitAttr::get(ctx));
+
+    if (!mayWrite && !mayNotReturn &&
+        fn.memory_effects() != FuncMemoryEffects::none)
+      fn.memory_effectsAttr(FuncMemoryEffectsAttr::get(
+          ctx, mayRead ? FuncMemoryEffects::read : FuncMemoryEffects::none));
+
+    if (!fn.hasNoAliasResult() && returnsNoAliasPointer(fn, symbolTable))
+      fn.setResultAttr(0, FuncOp::getNoAliasResultAttrName(),
+                       UnitAttr::get(ctx));
+  }
+}
+
+void FunctionAttrsPass::runOnOperation() {
+  ModuleOp module = getOperation();
+  SymbolTable symbolTable(module);
+  CallGraph callGraph(module);
+
+  // SCCs come callees first.
+  for (auto it = llvm::scc_begin(DefinedCallGraph{&callGraph}); !it.isAtEnd();
+       ++it) {
+    SmallVector<FuncOp, 4> scc;
+    for (const CallGraphNode *node : *it) {
+      if (node->isExternal())
+        continue;
+      if (auto fn = dyn_cast<FuncOp>(node->getCallableRegion()->getParentOp()))
+        scc.push_back(fn);
+    }
+    if (!scc.empty())
+      inferSCC(scc, symbolTable);
+  }
+}
+
+std::unique_ptr<Pass> mlir::createFunctionAttrsPass() {
+  return std::make_unique<FunctionAttrsPass>();
+}
@@ -0,0 +1,389 @@
+//===- PerfLint.cpp - report performance anti-patterns in C++ code --------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// Once lowered to LLVM IR, a copy constructor is just another call and an
+// aggregate copy just a memcpy. CIR still knows which calls construct
+// objects and which loads and stores move whole aggregates, which makes it
+// the right level to flag code that quietly copies or allocates too much.
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Dialect/CIR/Passes.h"
+
+#include "PassDetail.h"
+#include "mlir/Dialect/CIR/IR/CIRDialect.h"
+
+#include "llvm/ADT/StringSwitch.h"
+#include "llvm/Demangle/Demangle.h"
+#include "llvm/Remarks/Remark.h"
+#include "llvm/Remarks/RemarkSerializer.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/MathExtras.h"
+#include "llvm/Support/raw_ostream.h"
+
+using namespace mlir;
+using namespace cir;
+
+/// Store size and alignment of `ty` with a natural layout, or None for types
+/// whose size is not known in CIR.
+static Optional<std::pair<uint64_t, uint64_t>> getSizeAndAlign(Type ty) {
+  auto scalar = [](uint64_t bits) -> std::pair<uint64_t, uint64_t> {
+    uint64_t size = llvm::divideCeil(bits, 8);
+    return {size, llvm::PowerOf2Ceil(size)};
+  };
+  if (auto intTy = ty.dyn_cast<IntegerType>())
+    return scalar(intTy.getWidth());
+  if (auto fltTy = ty.dyn_cast<FloatType>())
+    return scalar(fltTy.getWidth());
+  if (ty.isa<cir::PointerType>())
+    return std::make_pair<uint64_t, uint64_t>(8, 8);
+  if (ty.isa<cir::BoolType>())
+    return std::make_pair<uint64_t, uint64_t>(1, 1);
+  if (auto arrTy = ty.dyn_cast<cir::ArrayType>()) {
+    auto elt = getSizeAndAlign(arrTy.getEltType());
+    if (!elt)
+      return llvm::None;
+    return std::make_pair(elt->first * arrTy.getSize(), elt->second);
+  }
+  if (auto structTy = ty.dyn_cast<cir::StructType>()) {
+    uint64_t size = 0, align = 1;
+    for (auto member : structTy.getMembers()) {
+      auto m = getSizeAndAlign(member);
+      if (!m)
+        return llvm::None;
+      size = llvm::alignTo(size, m->second) + m->first;
+      align = std::max(align, m->second);
+    }
+    return std::make_pair(llvm::alignTo(size, align), align);
+  }
+  return llvm::None;
+}
+
+static Optional<uint64_t> getTypeSize(Type ty) {
+  auto sizeAndAlign = getSizeAndAlign(ty);
+  if (!sizeAndAlign)
+    return llvm::None;
+  return sizeAndAlign->first;
+}
+
+/// Name of `ty` as written in diagnostics.
+static std::string getTypeName(Type ty) {
+  if (auto structTy = ty.dyn_cast<cir::StructType>())
+    return structTy.getTypeName().str();
+  std::string name;
+  llvm::raw_string_ostream os(name);
+  ty.print(os);
+  return os.str();
+}
+
+/// First file location found in `loc`.
+static Optional<FileLineColLoc> getFileLoc(Location loc) {
+  if (auto fileLoc = loc.dyn_cast<FileLineColLoc>())
+    return fileLoc;
+  if (auto fusedLoc = loc.dyn_cast<FusedLoc>())
+    for (auto l : fusedLoc.getLocations())
+      if (auto fileLoc = getFileLoc(l))
+        return fileLoc;
+  return llvm::None;
+}
+
+/// Whether `addr` is where the enclosing function builds its result: the
+/// sret argument when it returns in memory, the `__retval` alloca otherwise.
+static bool isReturnSlot(Value addr) {
+  while (auto cast = addr.getDefiningOp<CastOp>())
+    addr = cast.src();
+  if (auto alloca = addr.getDefiningOp<AllocaOp>())
+    return alloca.name() == "__retval";
+
+  auto arg = addr.dyn_cast<BlockArgument>();
+  if (!arg)
+    return false;
+  auto func = dyn_cast<FuncOp>(arg.getOwner()->getParentOp());
+  return func && arg.getOwner()->isEntryBlock() &&
+         func.getArgAttr(arg.getArgNumber(), FuncOp::getSRetArgAttrName());
+}
+
+/// The aggregate argument `argNo` of `func` passes by value, or a null type:
+/// either the aggregate itself, or the pointer to the copy the caller makes
+/// for the ABI.
+static Type getByValArgType(FuncOp func, unsigned argNo) {
+  Type ty = func.getArgumentTypes()[argNo];
+  if (ty.isa<cir::StructType>())
+    return ty;
+  if (func.getArgAttr(argNo, FuncOp::getByValArgAttrName()))
+    return ty.cast<cir::PointerType>().getPointee();
+  return nullptr;
+}
+
+static bool isHeapAllocFn(StringRef name) {
+  // operator new and operator new[], whatever their overload.
+  if (name.startswith("_Znw") || name.startswith("_Zna"))
+    return true;
+  return llvm::StringSwitch<bool>(name)
+      .Cases("malloc", "calloc", "realloc", "aligned_alloc", true)
+      .Cases("strdup", "strndup", true)
+      .Default(false);
+}
+
+namespace {
+struct PerfLintPass : public PerfLintBase<PerfLintPass> {
+  PerfLintPass() = default;
+  PerfLintPass(StringRef report) { reportFile = report.str(); }
+  void runOnOperation() override;
+
+  void checkFunc(FuncOp func);
+  void checkCall(CallOp call);
+  void checkStore(StoreOp store);
+
+  void report(Operation *op, StringRef check, const Twine &msg);
+
+  struct Options {
+    enum : unsigned {
+      None = 0,
+      CopyInLoop = 1,
+      LargeByValue = 1 << 1,
+      AllocInLoop = 1 << 2,
+      StringInLoop = 1 << 3,
+      All = CopyInLoop | LargeByValue | AllocInLoop | StringInLoop,
+    };
+    unsigned val = None;
+
+    void parseOptions(PerfLintPass &pass) {
+      for (auto &check : pass.checksList) {
+        val |= StringSwitch<unsigned>(check)
+                   .Case("copy-in-loop", CopyInLoop)
+                   .Case("large-by-value", LargeByValue)
+                   .Case("alloc-in-loop", AllocInLoop)
+                   .Case("string-in-loop", StringInLoop)
+                   .Case("all", All)
+                   .Default(None);
+      }
+      if (val == None)
+        val = All;
+    }
+
+    bool checkCopyInLoop() { return val & CopyInLoop; }
+    bool checkLargeByValue() { return val & LargeByValue; }
+    bool checkAllocInLoop() { return val & AllocInLoop; }
+    bool checkStringInLoop() { return val & StringInLoop; }
+  } opts;
+
+  /// What the mangled name of a callee tells about it.
+  struct CalleeInfo {
+    bool isCtor = false;
+    bool takesRValueRef = false;
+    bool isString = false;
+    std::string className;
+  };
+  const CalleeInfo &getCalleeInfo(StringRef name);
+  llvm::StringMap<CalleeInfo> calleeInfos;
+
+  bool isLarge(Type ty) {
+    auto size = getTypeSize(ty);
+    return size && *size >= largeAggregateSize;
+  }
+
+  /// Set while running when a report file is requested.
+  llvm::remarks::RemarkSerializer *serializer = nullptr;
+};
+} // namespace
+
+const PerfLintPass::CalleeInfo &PerfLintPass::getCalleeInfo(StringRef name) {
+  auto it = calleeInfos.find(name);
+  if (it != calleeInfos.end())
+    return it->second;
+
+  CalleeInfo &info = calleeInfos[name];
+  // The demangler keeps pointing into the name it parsed.
+  std::string mangled = name.str();
+  llvm::ItaniumPartialDemangler demangler;
+  if (demangler.partialDemangle(mangled.c_str()) ||
+      !demangler.isCtorOrDtor())
+    return info;
+
+  auto take = [](char *buf) {
+    std::string s = buf ? buf : "";
+    std::free(buf);
+    return s;
+  };
+  size_t n = 0;
+  std::string baseName = take(demangler.getFunctionBaseName(nullptr, &n));
+  if (StringRef(baseName).startswith("~"))
+    return info;
+
+  info.isCtor = true;
+  info.className = take(demangler.getFunctionDeclContextName(nullptr, &n));
+  info.takesRValueRef = StringRef(take(demangler.getFunctionParameters(
+                                      nullptr, &n)))
+                            .endswith("&&)");
+  StringRef className = info.className;
+  info.isString = className == "std::string" ||
+                  (className.startswith("std::") &&
+                   className.contains("basic_string<"));
+  return info;
+}
+
+void PerfLintPass::report(Operation *op, StringRef check, const Twine &msg) {
+  std::string text = msg.str();
+  auto diag = emitRemarks ? op->emitRemark() : op->emitWarning();
+  diag << text << " [" << check << "]";
+
+  if (!serializer)
+    return;
+  llvm::remarks::Remark remark;
+  remark.RemarkType = llvm::remarks::Type::Analysis;
+  remark.PassName = getArgument();
+  remark.RemarkName = check;
+  if (auto func = op->getParentOfType<FuncOp>())
+    remark.FunctionName = func.getName();
+  else if (auto func = dyn_cast<FuncOp>(op))
+    remark.FunctionName = func.getName();
+  if (auto fileLoc = getFileLoc(op->getLoc()))
+    remark.Loc = llvm::remarks::RemarkLocation{
+        fileLoc->getFilename().getValue(), fileLoc->getLine(),
+        fileLoc->getColumn()};
+  remark.Args.push_back({"String", text, llvm::None});
+  serializer->emit(remark);
+}
+
+void PerfLintPass::checkFunc(FuncOp func) {
+  if (!opts.checkLargeByValue() || func.isDeclaration())
+    return;
+
+  // The sret argument does not count as a parameter of the source function.
+  unsigned paramNo = 0;
+  for (unsigned argNo = 0, e = func.getNumArguments(); argNo != e; ++argNo) {
+    if (func.getArgAttr(argNo, FuncOp::getSRetArgAttrName()))
+      continue;
+    ++paramNo;
+    Type ty = getByValArgType(func, argNo);
+    if (!ty || !ty.isa<cir::StructType>() || !isLarge(ty))
+      continue;
+    report(func, "large-by-value",
+           "parameter " + Twine(paramNo) + " of type '" + getTypeName(ty) +
+               "' (" + Twine(*getTypeSize(ty)) +
+               " bytes) is passed by value; consider passing it by "
+               "reference");
+  }
+}
+
+void PerfLintPass::checkCall(CallOp call) {
+  StringRef name = call.callee();
+  auto loop = call->getParentOfType<LoopOp>();
+
+  if (loop && opts.checkAllocInLoop() && isHeapAllocFn(name)) {
+    report(call, "alloc-in-loop",
+           "heap allocation on every loop iteration; consider hoisting it "
+           "out of the loop or reusing the storage");
+    return;
+  }
+
+  const CalleeInfo &info = getCalleeInfo(name);
+  if (!info.isCtor)
+    return;
+
+  auto args = call.getArgOperands();
+  bool isCopy = args.size() == 2 && !info.takesRValueRef &&
+                args[0].getType() == args[1].getType();
+  if (isCopy && opts.checkLargeByValue() && isReturnSlot(args[0])) {
+    report(call, "large-by-value",
+           "'" + info.className +
+               "' is copied into the return value; copy elision does not "
+               "apply");
+    return;
+  }
+  if (!loop)
+    return;
+
+  if (isCopy && opts.checkCopyInLoop()) {
+    report(call, "copy-in-loop",
+           "'" + info.className +
+               "' is copied on every loop iteration; consider binding it by "
+               "reference");
+    return;
+  }
+
+  // Locals and temporaries are constructed into allocas, which CIRGen may
+  // have hoisted out of the loop: what matters is where the construction
+  // happens.
+  if (info.isString && opts.checkStringInLoop() && !args.empty() &&
+      args[0].getDefiningOp<AllocaOp>()) {
+    report(call, "string-in-loop",
+           "'" + info.className +
+               "' is constructed on every loop iteration; consider hoisting "
+               "it out of the loop");
+  }
+}
+
+void PerfLintPass::checkStore(StoreOp store) {
+  // Trivially copyable aggregates are copied by a load and a store.
+  auto load = store.value().getDefiningOp<LoadOp>();
+  Type ty = store.value().getType();
+  if (!load || !ty.isa<cir::StructType>() || !isLarge(ty))
+    return;
+
+  if (opts.checkLargeByValue() && isReturnSlot(store.addr())) {
+    report(store, "large-by-value",
+           "'" + getTypeName(ty) + "' (" + Twine(*getTypeSize(ty)) +
+               " bytes) is copied into the return value; copy elision does "
+               "not apply");
+    return;
+  }
+
+  if (opts.checkCopyInLoop() && store->getParentOfType<LoopOp>())
+    report(store, "copy-in-loop",
+           "'" + getTypeName(ty) + "' (" + Twine(*getTypeSize(ty)) +
+               " bytes) is copied on every loop iteration; consider "
+               "binding it by reference");
+}
+
+void PerfLintPass::runOnOperation() {
+  opts.parseOptions(*this);
+  ModuleOp module = getOperation();
+
+  std::unique_ptr<llvm::raw_fd_ostream> reportOS;
+  std::unique_ptr<llvm::remarks::RemarkSerializer> reportSerializer;
+  if (!reportFile.empty()) {
+    std::error_code ec;
+    reportOS = std::make_unique<llvm::raw_fd_ostream>(reportFile, ec,
+                                                      llvm::sys::fs::OF_Text);
+    if (ec) {
+      module.emitError("cannot open report file '")
+          << reportFile << "': " << ec.message();
+      return signalPassFailure();
+    }
+    auto serializerOrErr = llvm::remarks::createRemarkSerializer(
+        llvm::remarks::Format::YAML, llvm::remarks::SerializerMode::Separate,
+        *reportOS);
+    if (!serializerOrErr) {
+      module.emitError(llvm::toString(serializerOrErr.takeError()));
+      return signalPassFailure();
+    }
+    reportSerializer = std::move(*serializerOrErr);
+    serializer = reportSerializer.get();
+  }
+
+  module.walk([&](Operation *op) {
+    if (auto func = dyn_cast<FuncOp>(op))
+      checkFunc(func);
+    else if (auto call = dyn_cast<CallOp>(op))
+      checkCall(call);
+    else if (auto store = dyn_cast<StoreOp>(op))
+      checkStore(store);
+  });
+
+  serializer = nullptr;
+}
+
+std::unique_ptr<Pass> mlir::createPerfLintPass() {
+  return std::make_unique<PerfLintPass>();
+}
+
+std::unique_ptr<Pass> mlir::createPerfLintPass(StringRef reportFile) {
+  return std::make_unique<PerfLintPass>(reportFile);
+}
@@ -0,0 +1,245 @@
+//===- RaiseContainerLoops.cpp - canonicalize loops over containers -------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// A range-for over a `std::vector`, or a loop written with its iterators,
+// reaches LLVM as calls to `operator!=`, `operator++` and `operator*` taking
+// the address of the iterator objects. Until those calls are inlined, the
+// iterators live in memory that escapes every iteration, and the end of the
+// range is reloaded by each comparison, which keeps the loop from being
+// recognized as counted and vectorized.
+//
+// CIR still names the callees, so the iterator classes of the standard
+// libraries can be recognized before inlining. Their operations only wrap a
+// pointer, so the loop is rewritten to step that pointer itself: it lives in
+// an alloca nothing else refers to, and the end pointer is read once before
+// the loop.
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Dialect/CIR/Passes.h"
+
+#include "PassDetail.h"
+#include "mlir/Dialect/CIR/IR/CIRDialect.h"
+
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Demangle/Demangle.h"
+
+using namespace mlir;
+using namespace cir;
+
+/// Whether `name` is a vector iterator class of libstdc++ or libc++, whose
+/// only member is the pointer to the current element.
+static bool isVectorIterator(StringRef name) {
+  if (name.contains("__gnu_cxx::__normal_iterator<"))
+    return name.contains(", std::vector<");
+  if (name.contains("::__wrap_iter<"))
+    return true;
+  return false;
+}
+
+namespace {
+/// Iterator operations the pass knows the semantics of.
+enum class IterOp { None, NotEqual, Increment, Deref };
+
+struct RaiseContainerLoopsPass
+    : public RaiseContainerLoopsBase<RaiseContainerLoopsPass> {
+  RaiseContainerLoopsPass() = default;
+  void runOnOperation() override;
+
+  IterOp getIterOp(StringRef callee);
+  bool raise(LoopOp loop);
+
+  llvm::StringMap<IterOp> iterOps;
+};
+} // namespace
+
+IterOp RaiseContainerLoopsPass::getIterOp(StringRef callee) {
+  auto it = iterOps.find(callee);
+  if (it != iterOps.end())
+    return it->second;
+
+  IterOp &op = iterOps[callee];
+  op = IterOp::None;
+  // The demangler keeps pointing into the name it parsed.
+  std::string mangled = callee.str();
+  llvm::ItaniumPartialDemangler demangler;
+  if (demangler.partialDemangle(mangled.c_str()) ||
+      !demangler.isFunction() || demangler.isCtorOrDtor())
+    return op;
+
+  auto take = [](char *buf) {
+    std::string s = buf ? buf : "";
+    std::free(buf);
+    return s;
+  };
+  size_t n = 0;
+  std::string baseName = take(demangler.getFunctionBaseName(nullptr, &n));
+  std::string context = take(demangler.getFunctionDeclContextName(nullptr, &n));
+  std::string params = take(demangler.getFunctionParameters(nullptr, &n));
+
+  // The comparison is a non-member function template in both libraries.
+  if (baseName == "operator!=") {
+    if (isVectorIterator(params))
+      op = IterOp::NotEqual;
+    return op;
+  }
+  if (!isVectorIterator(context))
+    return op;
+  // Both the prefix and the postfix increment, whose result is checked to
+  // be unused.
+  if (baseName == "operator++")
+    op = IterOp::Increment;
+  else if (baseName == "operator*" || baseName == "operator->")
+    op = IterOp::Deref;
+  return op;
+}
+
+/// The type of the pointer an iterator of type `ty` wraps, if it is a class
+/// holding nothing else.
+static cir::PointerType getWrappedPointerType(Type ty) {
+  auto structTy = ty.dyn_cast<cir::StructType>();
+  if (!structTy || structTy.getMembers().size() != 1)
+    return {};
+  return structTy.getMembers()[0].dyn_cast<cir::PointerType>();
+}
+
+/// Rewrite `loop` when it is controlled by the comparison of a vector
+/// iterator with an end iterator, both set before the loop and only used by
+/// iterator operations within it.
+bool RaiseContainerLoopsPass::raise(LoopOp loop) {
+  CallOp cond;
+  auto walkResult = loop.cond().walk([&](CallOp call) {
+    if (getIterOp(call.callee()) != IterOp::NotEqual)
+      return WalkResult::advance();
+    if (cond)
+      return WalkResult::interrupt();
+    cond = call;
+    return WalkResult::advance();
+  });
+  if (!cond || walkResult.wasInterrupted() || cond.getNumOperands() != 2)
+    return false;
+
+  auto itAlloca = cond.getOperand(0).getDefiningOp<AllocaOp>();
+  auto endAlloca = cond.getOperand(1).getDefiningOp<AllocaOp>();
+  if (!itAlloca || !endAlloca || itAlloca == endAlloca ||
+      itAlloca.type() != endAlloca.type())
+    return false;
+  auto eltPtrTy = getWrappedPointerType(itAlloca.type());
+  if (!eltPtrTy)
+    return false;
+
+  // Stores before the loop set the iterators, only the iterator operations
+  // below read or update them afterwards.
+  auto isSetBeforeLoop = [&](Operation *user, Value addr) {
+    auto store = dyn_cast<StoreOp>(user);
+    return store && store.addr() == addr &&
+           store->getBlock() == loop->getBlock() &&
+           store->isBeforeInBlock(loop);
+  };
+
+  SmallVector<CallOp> compares, increments, derefs;
+  for (Operation *user : endAlloca.getResult().getUsers()) {
+    if (isSetBeforeLoop(user, endAlloca))
+      continue;
+    auto call = dyn_cast<CallOp>(user);
+    if (!call || !loop->isProperAncestor(call) ||
+        getIterOp(call.callee()) != IterOp::NotEqual)
+      return false;
+  }
+  for (OpOperand &use : itAlloca.getResult().getUses()) {
+    Operation *user = use.getOwner();
+    if (isSetBeforeLoop(user, itAlloca))
+      continue;
+    auto call = dyn_cast<CallOp>(user);
+    if (!call || !loop->isProperAncestor(call))
+      return false;
+    switch (getIterOp(call.callee())) {
+    case IterOp::NotEqual: {
+      // Against the end iterator only.
+      if (call.getNumOperands() != 2 ||
+          call.getOperand(1 - use.getOperandNumber()) != endAlloca)
+        return false;
+      compares.push_back(call);
+      break;
+    }
+    case IterOp::Increment:
+      if (use.getOperandNumber() != 0 || !call->use_empty())
+        return false;
+      increments.push_back(call);
+      break;
+    case IterOp::Deref:
+      if (call.getNumOperands() != 1 || call.getNumResults() != 1 ||
+          call.getResult(0).getType() != eltPtrTy)
+        return false;
+      derefs.push_back(call);
+      break;
+    case IterOp::None:
+      return false;
+    }
+  }
+  if (increments.empty())
+    return false;
+
+  // The new induction variable lives next to the iterator.
+  auto loc = loop.getLoc();
+  auto *ctx = &getContext();
+  auto slotTy = cir::PointerType::get(ctx, eltPtrTy);
+  OpBuilder builder(itAlloca);
+  builder.setInsertionPointAfter(itAlloca);
+  Value ptrAddr = builder.create<AllocaOp>(
+      loc, slotTy, eltPtrTy, (itAlloca.name() + ".ptr").str(),
+      InitStyle::uninitialized, itAlloca.alignmentAttr());
+
+  // The iterator classes start with their pointer, read both right before
+  // the loop.
+  builder.setInsertionPoint(loop);
+  auto loadWrapped = [&](Value iterAddr) -> Value {
+    Value addr =
+        builder.create<CastOp>(loc, slotTy, CastKind::bitcast, iterAddr);
+    return builder.create<LoadOp>(loc, eltPtrTy, addr);
+  };
+  builder.create<StoreOp>(loc, loadWrapped(itAlloca), ptrAddr);
+  Value endPtr = loadWrapped(endAlloca);
+
+  for (auto call : compares) {
+    builder.setInsertionPoint(call);
+    Value cur = builder.create<LoadOp>(call.getLoc(), eltPtrTy, ptrAddr);
+    auto cmp = builder.create<CmpOp>(call.getLoc(), call.getResult(0).getType(),
+                                     CmpOpKind::ne, cur, endPtr);
+    call.getResult(0).replaceAllUsesWith(cmp);
+    call.erase();
+  }
+  for (auto call : increments) {
+    builder.setInsertionPoint(call);
+    auto callLoc = call.getLoc();
+    Value cur = builder.create<LoadOp>(callLoc, eltPtrTy, ptrAddr);
+    auto one = builder.create<ConstantOp>(callLoc, builder.getI64Type(),
+                                          builder.getI64IntegerAttr(1));
+    Value next = builder.create<PtrStrideOp>(callLoc, eltPtrTy, cur, one);
+    builder.create<StoreOp>(callLoc, next, ptrAddr);
+    call.erase();
+  }
+  for (auto call : derefs) {
+    builder.setInsertionPoint(call);
+    Value cur = builder.create<LoadOp>(call.getLoc(), eltPtrTy, ptrAddr);
+    call.getResult(0).replaceAllUsesWith(cur);
+    call.erase();
+  }
+  return true;
+}
+
+void RaiseContainerLoopsPass::runOnOperation() {
+  SmallVector<LoopOp> loops;
+  getOperation()->walk([&](LoopOp loop) { loops.push_back(loop); });
+  for (auto loop : loops)
+    raise(loop);
+}
+
+std::unique_ptr<Pass> mlir::createRaiseContainerLoopsPass() {
+  return std::make_unique<RaiseContainerLoopsPass>();
+}
@@ -20,6 +20,7 @@
 #include "mlir/IR/BuiltinTypes.h"
 #include "mlir/IR/Dialect.h"
 #include "mlir/IR/DialectImplementation.h"
+#include "mlir/IR/DialectResourceBlobManager.h"
 #include "mlir/IR/IntegerSet.h"
 #include "mlir/IR/MLIRContext.h"
 #include "mlir/IR/OpImplementation.h"
@@ -40,6 +41,7 @@
 #include "llvm/Support/CommandLine.h"
 #include "llvm/Support/Debug.h"
 #include "llvm/Support/Endian.h"
+#include "llvm/Support/MemoryBuffer.h"
 #include "llvm/Support/Regex.h"
 #include "llvm/Support/SaveAndRestore.h"
 #include "llvm/Support/Threading.h"
@@ -1269,6 +1271,32 @@ AsmResourceBuilder::~AsmResourceBuilder() = default;
 AsmResourceParser::~AsmResourceParser() = default;
 AsmResourcePrinter::~AsmResourcePrinter() = default;
 
+llvm::ErrorOr<AsmResourceBlob>
+FileAsmResourceBlob::allocate(StringRef path, uint64_t offset, uint64_t size,
+                              size_t align) {
+  assert(llvm::isPowerOf2_64(align) && "expected power of 2 alignment");
+  llvm::ErrorOr<std::unique_ptr<llvm::MemoryBuffer>> bufferOrErr =
+      llvm::MemoryBuffer::getFileSlice(path, size, offset);
+  if (!bufferOrErr)
+    return bufferOrErr.getError();
+  std::unique_ptr<llvm::MemoryBuffer> buffer = std::move(*bufferOrErr);
+  ArrayRef<char> data(buffer->getBufferStart(), buffer->getBufferSize());
+
+  // The mapping starts at a page boundary, so the data is misaligned only if
+  // the section itself is.
+  if (!llvm::isAddrAligned(llvm::Align(align), data.data()))
+    return HeapAsmResourceBlob::allocateAndCopy(data, align,
+                                                /*dataIsMutable=*/false);
+
+  // Keep the buffer alive as long as the blob, releasing it unmaps the file.
+  return AsmResourceBlob(
+      data, align,
+      [buffer = std::move(buffer)](const void *, size_t) mutable {
+        buffer.reset();
+      },
+      /*dataIsMutable=*/false);
+}
+
 //===----------------------------------------------------------------------===//
 // AsmState
 //===----------------------------------------------------------------------===//
@@ -1856,6 +1884,12 @@ void AsmPrinter::Impl::printAttribute(Attribute attr,
       os << '>';
     }
 
+  } else if (auto resourceAttr = attr.dyn_cast<DenseResourceElementsAttr>()) {
+    // The data is only printed in the resource section, once per blob.
+    os << "dense_resource<";
+    printResourceHandle(resourceAttr.getRawHandle());
+    os << ">";
+
   } else if (auto sparseEltAttr = attr.dyn_cast<SparseElementsAttr>()) {
     if (printerFlags.shouldElideElementsAttr(sparseEltAttr.getIndices()) ||
         printerFlags.shouldElideElementsAttr(sparseEltAttr.getValues())) {
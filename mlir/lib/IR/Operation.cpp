@@ -26,8 +26,8 @@ using namespace mlir;
 /// Create a new Operation from operation state.
 Operation *Operation::create(const OperationState &state) {
   return create(state.location, state.name, state.types, state.operands,
-                state.attributes.getDictionary(state.getContext()),
-                state.successors, state.regions);
+                NamedAttrList(state.attributes), state.successors,
+                state.regions);
 }
 
 /// Create a new Operation with the specific fields.
@@ -59,6 +59,7 @@ Operation *Operation::create(Location location, OperationName name,
   unsigned numSuccessors = successors.size();
   unsigned numOperands = operands.size();
   unsigned numResults = resultTypes.size();
+  unsigned numInherentAttrs = name.getAttributeNames().size();
 
   // If the operation is known to have no operands, don't allocate an operand
   // storage.
@@ -68,9 +69,10 @@ Operation *Operation::create(Location location, OperationName name,
   // Compute the byte size for the operation and the operand storage. This takes
   // into account the size of the operation, its trailing objects, and its
   // prefixed objects.
-  size_t byteSize =
-      totalSizeToAlloc<detail::OperandStorage, BlockOperand, Region, OpOperand>(
-          needsOperandStorage ? 1 : 0, numSuccessors, numRegions, numOperands);
+  size_t byteSize = totalSizeToAlloc<detail::OperandStorage, BlockOperand,
+                                    Region, Attribute, OpOperand>(
+      needsOperandStorage ? 1 : 0, numSuccessors, numRegions, numInherentAttrs,
+      numOperands);
   size_t prefixByteSize = llvm::alignTo(
       Operation::prefixAllocSize(numTrailingResults, numInlineResults),
       alignof(Operation));
@@ -78,9 +80,29 @@ Operation *Operation::create(Location location, OperationName name,
   void *rawMem = mallocMem + prefixByteSize;
 
   // Create the new Operation.
-  Operation *op = ::new (rawMem) Operation(
-      location, name, numResults, numSuccessors, numRegions,
-      attributes.getDictionary(location.getContext()), needsOperandStorage);
+  Operation *op = ::new (rawMem)
+      Operation(location, name, numResults, numSuccessors, numRegions,
+                numInherentAttrs, needsOperandStorage);
+
+  // Initialize the attributes, the inherent ones go inline and only the others
+  // need a dictionary.
+  for (unsigned i = 0; i != numInherentAttrs; ++i)
+    new (&op->getInherentAttrStorage()[i]) Attribute();
+  if (numInherentAttrs == 0) {
+    op->attrs = attributes.getDictionary(location.getContext());
+  } else {
+    NamedAttrList discardableAttrs;
+    for (NamedAttribute attr : attributes) {
+      if (Optional<unsigned> index = op->getInherentAttrIndex(attr.getName())) {
+        assert(!op->getInherentAttrStorage()[*index] &&
+               "duplicate attribute name");
+        op->getInherentAttrStorage()[*index] = attr.getValue();
+      } else {
+        discardableAttrs.push_back(attr);
+      }
+    }
+    op->attrs = discardableAttrs.getDictionary(location.getContext());
+  }
 
   assert((numSuccessors == 0 || op->mightHaveTrait<OpTrait::IsTerminator>()) &&
          "unexpected successors in a non-terminator operation");
@@ -114,11 +136,10 @@ Operation *Operation::create(Location location, OperationName name,
 
 Operation::Operation(Location location, OperationName name, unsigned numResults,
                      unsigned numSuccessors, unsigned numRegions,
-                     DictionaryAttr attributes, bool hasOperandStorage)
+                     unsigned numInherentAttrs, bool hasOperandStorage)
     : location(location), numResults(numResults), numSuccs(numSuccessors),
       numRegions(numRegions), hasOperandStorage(hasOperandStorage), name(name),
-      attrs(attributes) {
-  assert(attributes && "unexpected null attribute dictionary");
+      numInherentAttrs(numInherentAttrs) {
 #ifndef NDEBUG
   if (!getDialect() && !getContext()->allowsUnregisteredDialects())
     llvm::report_fatal_error(
@@ -212,6 +233,68 @@ void Operation::insertOperands(unsigned index, ValueRange operands) {
   assert(operands.empty() && "inserting operands without an operand storage");
 }
 
+//===----------------------------------------------------------------------===//
+// Attributes
+//===----------------------------------------------------------------------===//
+
+DictionaryAttr Operation::getAttrDictionary() {
+  if (numInherentAttrs == 0)
+    return attrs;
+  if (const void *cached = attrsCache.load(std::memory_order_acquire))
+    return Attribute::getFromOpaquePointer(cached).cast<DictionaryAttr>();
+
+  NamedAttrList allAttrs(attrs);
+  ArrayRef<StringAttr> inherentAttrNames = getName().getAttributeNames();
+  for (unsigned i = 0; i != numInherentAttrs; ++i)
+    if (Attribute attr = getInherentAttrStorage()[i])
+      allAttrs.append(inherentAttrNames[i], attr);
+  DictionaryAttr allAttrsDict = allAttrs.getDictionary(getContext());
+  // Readers racing to build the dictionary all get the same uniqued one.
+  attrsCache.store(allAttrsDict.getAsOpaquePointer(),
+                   std::memory_order_release);
+  return allAttrsDict;
+}
+
+void Operation::setAttrs(DictionaryAttr newAttrs) {
+  assert(newAttrs && "expected valid attribute dictionary");
+  if (numInherentAttrs == 0) {
+    attrs = newAttrs;
+    return;
+  }
+
+  MutableArrayRef<Attribute> inherentAttrs = getInherentAttrStorage();
+  std::fill(inherentAttrs.begin(), inherentAttrs.end(), Attribute());
+  NamedAttrList discardableAttrs;
+  for (NamedAttribute attr : newAttrs) {
+    if (Optional<unsigned> index = getInherentAttrIndex(attr.getName()))
+      inherentAttrs[*index] = attr.getValue();
+    else
+      discardableAttrs.push_back(attr);
+  }
+  attrs = discardableAttrs.getAttrs().size() == newAttrs.size()
+              ? newAttrs
+              : discardableAttrs.getDictionary(getContext());
+  attrsCache.store(newAttrs.getAsOpaquePointer(), std::memory_order_relaxed);
+}
+
+void Operation::setDiscardableAttr(StringAttr name, Attribute value) {
+  NamedAttrList attributes(attrs);
+  if (attributes.set(name, value) != value) {
+    attrs = attributes.getDictionary(getContext());
+    invalidateAttrDictionary();
+  }
+}
+
+Attribute Operation::removeDiscardableAttr(StringAttr name) {
+  NamedAttrList attributes(attrs);
+  Attribute removedAttr = attributes.erase(name);
+  if (removedAttr) {
+    attrs = attributes.getDictionary(getContext());
+    invalidateAttrDictionary();
+  }
+  return removedAttr;
+}
+
 //===----------------------------------------------------------------------===//
 // Diagnostics
 //===----------------------------------------------------------------------===//
@@ -568,9 +651,15 @@ Operation *Operation::clone(BlockAndValueMapping &mapper,
   for (Block *successor : getSuccessors())
     successors.push_back(mapper.lookupOrDefault(successor));
 
-  // Create the new operation.
-  auto *newOp = create(getLoc(), getName(), getResultTypes(), operands, attrs,
-                       successors, getNumRegions());
+  // Create the new operation, copying the inherent attributes without going
+  // through a dictionary of all the attributes.
+  NamedAttrList newAttrs(attrs);
+  ArrayRef<StringAttr> inherentAttrNames = getName().getAttributeNames();
+  for (unsigned i = 0; i != numInherentAttrs; ++i)
+    if (Attribute attr = getInherentAttrStorage()[i])
+      newAttrs.append(inherentAttrNames[i], attr);
+  auto *newOp = create(getLoc(), getName(), getResultTypes(), operands,
+                       std::move(newAttrs), successors, getNumRegions());
 
   // Clone the regions.
   if (options.shouldCloneRegions()) {
@@ -49,8 +49,8 @@ static const char *const builderOpState = "odsState";
 static const char *const operandSegmentAttrName = "operand_segment_sizes";
 static const char *const resultSegmentAttrName = "result_segment_sizes";
 
-/// Code for an Op to lookup an attribute. Uses cached identifiers and subrange
-/// lookup.
+/// Code for an adaptor to lookup an attribute. Uses cached identifiers and
+/// subrange lookup.
 ///
 /// {0}: Code snippet to get the attribute's name or identifier.
 /// {1}: The lower bound on the sorted subrange.
@@ -61,6 +61,11 @@ static const char *const subrangeGetAttr =
     "::mlir::impl::get{4}AttrFromSortedRange({3}.begin() + {1}, {3}.end() - "
     "{2}, {0})";
 
+/// Code for an Op to get an inherent attribute, stored inline in the operation.
+///
+/// {0}: The index of the attribute in the attribute names of the op.
+static const char *const inlineGetAttr = "(*this)->getInherentAttr({0})";
+
 /// The logic to calculate the actual value range for a declared operand/result
 /// of an op with variadic operands/results. Note that this logic is not for
 /// general use; it assumes all variadic operands/results must have the same
@@ -243,17 +248,34 @@ public:
     }
   };
 
-  // Generate code for getting an attribute.
+  // Generate code for getting an attribute, or the named attribute if
+  // `isNamed` is set.
   Formatter getAttr(StringRef attrName, bool isNamed = false) const {
     assert(attrMetadata.count(attrName) && "expected attribute metadata");
     return [this, attrName, isNamed](raw_ostream &os) -> raw_ostream & {
+      if (emitForOp) {
+        std::string attr = formatv(inlineGetAttr, getAttrIndex(attrName));
+        if (!isNamed)
+          return os << attr;
+        return os << formatv("::mlir::NamedAttribute({0}, {1})",
+                             getAttrName(attrName), attr);
+      }
       const AttributeMetadata &attr = attrMetadata.find(attrName)->second;
-      return os << formatv(subrangeGetAttr, getAttrName(attrName),
+      return os << (isNamed ? "*" : "")
+                << formatv(subrangeGetAttr, getAttrName(attrName),
                            attr.lowerBound, attr.upperBound, getAttrRange(),
                            isNamed ? "Named" : "");
     };
   }
 
+  // Get the index of an attribute in the attribute names of the op, which is
+  // also its index in the inline attribute storage of the operation.
+  unsigned getAttrIndex(StringRef attrName) const {
+    auto it = attrMetadata.find(attrName);
+    assert(it != attrMetadata.end() && "expected attribute metadata");
+    return it - attrMetadata.begin();
+  }
+
   // Generate code for getting the name of an attribute.
   Formatter getAttrName(StringRef attrName) const {
     return [this, attrName](raw_ostream &os) -> raw_ostream & {
@@ -630,14 +652,96 @@ static void genNativeTraitAttrVerifier(MethodBody &body,
   }
 }
 
+// Generate the lookup of the attributes of an adaptor, walking its sorted
+// attribute range. Errors out if a required attribute is missing.
+template <typename GetVarNameFn>
+static void genSortedAttrRangeWalk(const OpOrAdaptorHelper &emitHelper,
+                                   MethodBody &body, GetVarNameFn getVarName) {
+  // Traverse the array until the required attribute is found. Return an error
+  // if the traversal reached the end.
+  //
+  // {0}: Code to get the name of the attribute.
+  // {1}: The emit error prefix.
+  // {2}: The name of the attribute.
+  const char *const findRequiredAttr = R"(while (true) {{
+  if (namedAttrIt == namedAttrRange.end())
+    return {1}"requires attribute '{2}'");
+  if (namedAttrIt->getName() == {0}) {{
+    tblgen_{2} = namedAttrIt->getValue();
+    break;
+  })";
+
+  // Emit a check to see if the iteration has encountered an optional attribute.
+  //
+  // {0}: Code to get the name of the attribute.
+  // {1}: The name of the attribute.
+  const char *const checkOptionalAttr = R"(
+  else if (namedAttrIt->getName() == {0}) {{
+    tblgen_{1} = namedAttrIt->getValue();
+  })";
+
+  // Emit the start of the loop for checking trailing attributes.
+  const char *const checkTrailingAttrs = R"(while (true) {
+  if (namedAttrIt == namedAttrRange.end()) {
+    break;
+  })";
+
+  body.indent() << formatv("auto namedAttrRange = {0};\n",
+                           emitHelper.getAttrRange());
+  body << "auto namedAttrIt = namedAttrRange.begin();\n";
+
+  // Iterate over the attributes in sorted order. Keep track of the optional
+  // attributes that may be encountered along the way.
+  SmallVector<const AttributeMetadata *> optionalAttrs;
+  for (const std::pair<StringRef, AttributeMetadata> &it :
+       emitHelper.getAttrMetadata()) {
+    const AttributeMetadata &metadata = it.second;
+    if (!metadata.isRequired) {
+      optionalAttrs.push_back(&metadata);
+      continue;
+    }
+
+    body << formatv("::mlir::Attribute {0};\n", getVarName(it.first));
+    for (const AttributeMetadata *optional : optionalAttrs) {
+      body << formatv("::mlir::Attribute {0};\n",
+                      getVarName(optional->attrName));
+    }
+    body << formatv(findRequiredAttr, emitHelper.getAttrName(it.first),
+                    emitHelper.emitErrorPrefix(), it.first);
+    for (const AttributeMetadata *optional : optionalAttrs) {
+      body << formatv(checkOptionalAttr,
+                      emitHelper.getAttrName(optional->attrName),
+                      optional->attrName);
+    }
+    body << "\n  ++namedAttrIt;\n}\n";
+    optionalAttrs.clear();
+  }
+  // Get trailing optional attributes.
+  if (!optionalAttrs.empty()) {
+    for (const AttributeMetadata *optional : optionalAttrs) {
+      body << formatv("::mlir::Attribute {0};\n",
+                      getVarName(optional->attrName));
+    }
+    body << checkTrailingAttrs;
+    for (const AttributeMetadata *optional : optionalAttrs) {
+      body << formatv(checkOptionalAttr,
+                      emitHelper.getAttrName(optional->attrName),
+                      optional->attrName);
+    }
+    body << "\n  ++namedAttrIt;\n}\n";
+  }
+  body.unindent();
+}
+
 // Generate attribute verification. If an op instance is not available, then
 // attribute checks that require one will not be emitted.
 //
 // Attribute verification is performed as follows:
 //
-// 1. Verify that all required attributes are present in sorted order. This
-// ensures that we can use subrange lookup even with potentially missing
-// attributes.
+// 1. Verify that all required attributes are present. For an op, they are read
+// from the inline attribute storage. For an adaptor, they are looked up in
+// sorted order, which ensures that we can use subrange lookup even with
+// potentially missing attributes.
 // 2. Verify native trait attributes so that other attributes may call methods
 // that depend on the validity of these attributes, e.g. segment size attributes
 // and operand or result getters.
@@ -673,35 +777,6 @@ static void genAttributeVerifier(
     return ::mlir::failure();
 )";
 
-  // Traverse the array until the required attribute is found. Return an error
-  // if the traversal reached the end.
-  //
-  // {0}: Code to get the name of the attribute.
-  // {1}: The emit error prefix.
-  // {2}: The name of the attribute.
-  const char *const findRequiredAttr = R"(while (true) {{
-  if (namedAttrIt == namedAttrRange.end())
-    return {1}"requires attribute '{2}'");
-  if (namedAttrIt->getName() == {0}) {{
-    tblgen_{2} = namedAttrIt->getValue();
-    break;
-  })";
-
-  // Emit a check to see if the iteration has encountered an optional attribute.
-  //
-  // {0}: Code to get the name of the attribute.
-  // {1}: The name of the attribute.
-  const char *const checkOptionalAttr = R"(
-  else if (namedAttrIt->getName() == {0}) {{
-    tblgen_{1} = namedAttrIt->getValue();
-  })";
-
-  // Emit the start of the loop for checking trailing attributes.
-  const char *const checkTrailingAttrs = R"(while (true) {
-  if (namedAttrIt == namedAttrRange.end()) {
-    break;
-  })";
-
   // Return true if a verifier can be emitted for the attribute: it is not a
   // derived attribute, it has a predicate, its condition is not empty, and, for
   // adaptors, the condition does not reference the op.
@@ -738,51 +813,30 @@ static void genAttributeVerifier(
     return (tblgenNamePrefix + attrName).str();
   };
 
-  body.indent() << formatv("auto namedAttrRange = {0};\n",
-                           emitHelper.getAttrRange());
-  body << "auto namedAttrIt = namedAttrRange.begin();\n";
-
-  // Iterate over the attributes in sorted order. Keep track of the optional
-  // attributes that may be encountered along the way.
-  SmallVector<const AttributeMetadata *> optionalAttrs;
-  for (const std::pair<StringRef, AttributeMetadata> &it :
-       emitHelper.getAttrMetadata()) {
-    const AttributeMetadata &metadata = it.second;
-    if (!metadata.isRequired) {
-      optionalAttrs.push_back(&metadata);
-      continue;
-    }
+  // Check that a required attribute read from the op is set.
+  //
+  // {0}: Attribute variable name.
+  // {1}: The emit error prefix.
+  // {2}: The name of the attribute.
+  const char *const checkRequiredInlineAttr = R"(if (!{0})
+  return {1}"requires attribute '{2}'");
+)";
 
-    body << formatv("::mlir::Attribute {0};\n", getVarName(it.first));
-    for (const AttributeMetadata *optional : optionalAttrs) {
-      body << formatv("::mlir::Attribute {0};\n",
-                      getVarName(optional->attrName));
-    }
-    body << formatv(findRequiredAttr, emitHelper.getAttrName(it.first),
-                    emitHelper.emitErrorPrefix(), it.first);
-    for (const AttributeMetadata *optional : optionalAttrs) {
-      body << formatv(checkOptionalAttr,
-                      emitHelper.getAttrName(optional->attrName),
-                      optional->attrName);
-    }
-    body << "\n  ++namedAttrIt;\n}\n";
-    optionalAttrs.clear();
-  }
-  // Get trailing optional attributes.
-  if (!optionalAttrs.empty()) {
-    for (const AttributeMetadata *optional : optionalAttrs) {
-      body << formatv("::mlir::Attribute {0};\n",
-                      getVarName(optional->attrName));
-    }
-    body << checkTrailingAttrs;
-    for (const AttributeMetadata *optional : optionalAttrs) {
-      body << formatv(checkOptionalAttr,
-                      emitHelper.getAttrName(optional->attrName),
-                      optional->attrName);
+  if (emitHelper.isEmittingForOp()) {
+    body.indent();
+    for (const std::pair<StringRef, AttributeMetadata> &it :
+         emitHelper.getAttrMetadata()) {
+      body << formatv("::mlir::Attribute {0} = {1};\n", getVarName(it.first),
+                      emitHelper.getAttr(it.first));
+      if (it.second.isRequired) {
+        body << formatv(checkRequiredInlineAttr, getVarName(it.first),
+                        emitHelper.emitErrorPrefix(), it.first);
+      }
     }
-    body << "\n  ++namedAttrIt;\n}\n";
+    body.unindent();
+  } else {
+    genSortedAttrRangeWalk(emitHelper, body, getVarName);
   }
-  body.unindent();
 
   // Emit the checks for segment attributes first so that the other constraints
   // can call operand and result getters.
@@ -1087,23 +1141,21 @@ void OpEmitter::genAttrSetters() {
   // Generate raw named setter type. This is a wrapper class that allows setting
   // to the attributes via setters instead of having to use the string interface
   // for better compile time verification.
-  auto emitAttrWithStorageType = [&](StringRef setterName, StringRef getterName,
+  auto emitAttrWithStorageType = [&](StringRef setterName, StringRef attrName,
                                      Attribute attr) {
     auto *method =
         opClass.addMethod("void", setterName + "Attr",
                           MethodParameter(attr.getStorageType(), "attr"));
     if (method)
-      method->body() << formatv("  (*this)->setAttr({0}AttrName(), attr);",
-                                getterName);
+      method->body() << formatv("  (*this)->setInherentAttr({0}, attr);",
+                                emitHelper.getAttrIndex(attrName));
   };
 
   for (const NamedAttribute &namedAttr : op.getAttributes()) {
     if (namedAttr.attr.isDerivedAttr())
       continue;
-    for (auto names : llvm::zip(op.getSetterNames(namedAttr.name),
-                                op.getGetterNames(namedAttr.name)))
-      emitAttrWithStorageType(std::get<0>(names), std::get<1>(names),
-                              namedAttr.attr);
+    for (StringRef setterName : op.getSetterNames(namedAttr.name))
+      emitAttrWithStorageType(setterName, namedAttr.name, namedAttr.attr);
   }
 }
 
@@ -1117,8 +1169,8 @@ void OpEmitter::genOptionalAttrRemovers() {
                                      "remove" + upperInitial + suffix + "Attr");
     if (!method)
       return;
-    method->body() << formatv("  return (*this)->removeAttr({0}AttrName());",
-                              op.getGetterName(name));
+    method->body() << formatv("  return (*this)->removeInherentAttr({0});",
+                              emitHelper.getAttrIndex(name));
   };
 
   for (const NamedAttribute &namedAttr : op.getAttributes())
@@ -1294,7 +1346,7 @@ void OpEmitter::genNamedOperandSetters() {
               "range.first, range.second";
       if (attrSizedOperands) {
         body << formatv(
-            ", ::mlir::MutableOperandRange::OperandSegment({0}u, *{1})", i,
+            ", ::mlir::MutableOperandRange::OperandSegment({0}u, {1})", i,
             emitHelper.getAttr(operandSegmentAttrName, /*isNamed=*/true));
       }
       body << ");\n";
@@ -0,0 +1,56 @@
+//===- CIRTypesTest.cpp - unit tests for the CIR types --------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/AsmParser/AsmParser.h"
+#include "mlir/Dialect/CIR/IR/CIRDialect.h"
+#include "mlir/IR/Builders.h"
+#include "gtest/gtest.h"
+
+using namespace mlir;
+
+namespace {
+
+class CIRTypesTest : public ::testing::Test {
+protected:
+  CIRTypesTest() : builder(&context) {
+    context.getOrLoadDialect<cir::CIRDialect>();
+  }
+
+  /// Prints `ty` and parses it back.
+  Type roundTrip(Type ty) {
+    std::string str;
+    llvm::raw_string_ostream os(str);
+    ty.print(os);
+    return parseType(os.str(), &context);
+  }
+
+  MLIRContext context;
+  Builder builder;
+};
+
+TEST_F(CIRTypesTest, StructTypeRoundTrip) {
+  // C++ class names have spaces, commas and angle brackets.
+  auto structTy = cir::StructType::get(
+      &context,
+      {builder.getI32Type(),
+       cir::PointerType::get(&context, builder.getI8Type())},
+      "std::pair<int, char *>");
+  EXPECT_EQ(roundTrip(structTy), structTy);
+
+  // Names needing escapes, and structs without members.
+  auto emptyTy = cir::StructType::get(&context, {}, "a \"quoted\" name\\");
+  EXPECT_EQ(roundTrip(emptyTy), emptyTy);
+
+  // Nested structs.
+  auto outerTy = cir::StructType::get(
+      &context, {structTy, cir::ArrayType::get(&context, emptyTy, 2)},
+      "Outer");
+  EXPECT_EQ(roundTrip(outerTy), outerTy);
+}
+
+} // namespace
@@ -0,0 +1,273 @@
+//===- CoroElideTest.cpp - unit tests for the CIR coroutine frame elision -===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Dialect/CIR/IR/CIRDialect.h"
+#include "mlir/Dialect/CIR/Passes.h"
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/Parser/Parser.h"
+#include "mlir/Pass/PassManager.h"
+#include "gtest/gtest.h"
+
+using namespace mlir;
+
+namespace {
+
+// A coroutine returning its frame pointer, as the coroutine handle held by
+// the object it returns would.
+const char *const coroutineDecls = R"mlir(
+  cir.func @_Znwm(i64) -> !cir.ptr<i8> attributes {sym_visibility = "private"}
+  cir.func @_ZdlPv(!cir.ptr<i8>) attributes {sym_visibility = "private"}
+  cir.func @publish(!cir.ptr<i8>) attributes {sym_visibility = "private"}
+  cir.global "private" internal @g : !cir.ptr<i8>
+
+  cir.func @peek(%arg0: !cir.ptr<i8>) -> i8 {
+    %0 = cir.load %arg0 : cir.ptr <i8>, i8
+    cir.return %0 : i8
+  }
+
+  cir.func @task() -> !cir.ptr<i8> attributes {coroutine} {
+    %0 = cir.coro.alloc_frame : !cir.ptr<i8> alloc {
+    ^bb0(%size: i64):
+      %1 = cir.call @_Znwm(%size) : (i64) -> !cir.ptr<i8>
+      cir.yield %1 : !cir.ptr<i8>
+    }
+    cir.return %0 : !cir.ptr<i8>
+  }
+
+  cir.func @leaky_task() -> !cir.ptr<i8> attributes {coroutine} {
+    %0 = cir.coro.alloc_frame : !cir.ptr<i8> alloc {
+    ^bb0(%size: i64):
+      %1 = cir.call @_Znwm(%size) : (i64) -> !cir.ptr<i8>
+      cir.yield %1 : !cir.ptr<i8>
+    }
+    cir.call @publish(%0) : (!cir.ptr<i8>) -> ()
+    cir.return %0 : !cir.ptr<i8>
+  }
+)mlir";
+
+class CoroElideTest : public ::testing::Test {
+protected:
+  CoroElideTest() { context.getOrLoadDialect<cir::CIRDialect>(); }
+
+  /// Runs the pass on the coroutines above followed by `caller`.
+  OwningOpRef<ModuleOp> runCoroElide(StringRef caller) {
+    std::string source =
+        ("module {" + StringRef(coroutineDecls) + caller + "}").str();
+    OwningOpRef<ModuleOp> module =
+        parseSourceString<ModuleOp>(source, &context);
+    if (!module)
+      return nullptr;
+    PassManager pm(&context);
+    pm.addPass(createCoroElidePass());
+    if (failed(pm.run(*module)))
+      return nullptr;
+    return module;
+  }
+
+  /// The callee of the only call in `@caller`.
+  static StringRef getCalleeOfCaller(ModuleOp module) {
+    StringRef callee;
+    module.lookupSymbol<cir::FuncOp>("caller").walk(
+        [&](cir::CallOp call) { callee = call.callee(); });
+    return callee;
+  }
+
+  MLIRContext context;
+};
+
+TEST_F(CoroElideTest, ElidesFrameOnlyReadByCaller) {
+  auto module = runCoroElide(R"mlir(
+    cir.func @caller() -> i8 {
+      %0 = cir.call @task() : () -> !cir.ptr<i8>
+      %1 = cir.load %0 : cir.ptr <i8>, i8
+      cir.return %1 : i8
+    }
+  )mlir");
+  ASSERT_TRUE(module);
+  EXPECT_EQ(getCalleeOfCaller(*module), "task.elided");
+
+  // The coroutine itself is left alone, the copy takes the frame storage.
+  auto task = module->lookupSymbol<cir::FuncOp>("task");
+  auto elided = module->lookupSymbol<cir::FuncOp>("task.elided");
+  ASSERT_TRUE(task && elided);
+  EXPECT_EQ(elided.linkage(), cir::GlobalLinkageKind::InternalLinkage);
+  EXPECT_EQ(elided.getNumArguments(), task.getNumArguments() + 1);
+  task.walk([](cir::CoroAllocFrameOp op) { EXPECT_FALSE(op.isElided()); });
+  elided.walk([](cir::CoroAllocFrameOp op) {
+    EXPECT_TRUE(op.isElided());
+    EXPECT_FALSE(op.alloc().empty());
+  });
+
+  unsigned numFrameAllocas = 0;
+  module->lookupSymbol<cir::FuncOp>("caller").walk([&](cir::AllocaOp alloca) {
+    if (alloca.name() == "coro.frame")
+      ++numFrameAllocas;
+  });
+  EXPECT_EQ(numFrameAllocas, 1u);
+}
+
+TEST_F(CoroElideTest, ElidesFrameReadByCallee) {
+  auto module = runCoroElide(R"mlir(
+    cir.func @caller() -> i8 {
+      %0 = cir.call @task() : () -> !cir.ptr<i8>
+      %1 = cir.call @peek(%0) : (!cir.ptr<i8>) -> i8
+      cir.return %1 : i8
+    }
+  )mlir");
+  ASSERT_TRUE(module);
+  EXPECT_TRUE(module->lookupSymbol("task.elided"));
+}
+
+TEST_F(CoroElideTest, ElidesFrameResumedByCaller) {
+  auto module = runCoroElide(R"mlir(
+    cir.func @caller() {
+      %0 = cir.call @task() : () -> !cir.ptr<i8>
+      cir.coro.resume %0 : !cir.ptr<i8>
+      cir.coro.destroy %0 : !cir.ptr<i8>
+      cir.return
+    }
+  )mlir");
+  ASSERT_TRUE(module);
+  EXPECT_EQ(getCalleeOfCaller(*module), "task.elided");
+}
+
+TEST_F(CoroElideTest, KeepsFrameReturnedByCaller) {
+  auto module = runCoroElide(R"mlir(
+    cir.func @caller() -> !cir.ptr<i8> {
+      %0 = cir.call @task() : () -> !cir.ptr<i8>
+      cir.return %0 : !cir.ptr<i8>
+    }
+  )mlir");
+  ASSERT_TRUE(module);
+  EXPECT_EQ(getCalleeOfCaller(*module), "task");
+  EXPECT_FALSE(module->lookupSymbol("task.elided"));
+}
+
+TEST_F(CoroElideTest, KeepsFrameStoredToGlobal) {
+  auto module = runCoroElide(R"mlir(
+    cir.func @caller() {
+      %0 = cir.call @task() : () -> !cir.ptr<i8>
+      %1 = cir.get_global @g : cir.ptr <!cir.ptr<i8>>
+      cir.store %0, %1 : !cir.ptr<i8>, cir.ptr <!cir.ptr<i8>>
+      cir.return
+    }
+  )mlir");
+  ASSERT_TRUE(module);
+  EXPECT_FALSE(module->lookupSymbol("task.elided"));
+}
+
+TEST_F(CoroElideTest, KeepsFramePassedToDeclaration) {
+  auto module = runCoroElide(R"mlir(
+    cir.func @caller() {
+      %0 = cir.call @task() : () -> !cir.ptr<i8>
+      cir.call @publish(%0) : (!cir.ptr<i8>) -> ()
+      cir.return
+    }
+  )mlir");
+  ASSERT_TRUE(module);
+  EXPECT_FALSE(module->lookupSymbol("task.elided"));
+}
+
+TEST_F(CoroElideTest, KeepsFrameEscapingFromCoroutine) {
+  auto module = runCoroElide(R"mlir(
+    cir.func @caller() -> i8 {
+      %0 = cir.call @leaky_task() : () -> !cir.ptr<i8>
+      %1 = cir.load %0 : cir.ptr <i8>, i8
+      cir.return %1 : i8
+    }
+  )mlir");
+  ASSERT_TRUE(module);
+  EXPECT_FALSE(module->lookupSymbol("leaky_task.elided"));
+}
+
+TEST_F(CoroElideTest, KeepsFramePunnedToInteger) {
+  // The handle is read back as an integer, which still holds the frame
+  // pointer.
+  auto module = runCoroElide(R"mlir(
+    cir.func @publish_int(i64) attributes {sym_visibility = "private"}
+    cir.func @caller() {
+      %slot = cir.alloca !cir.ptr<i8>, cir.ptr <!cir.ptr<i8>>, ["slot", cinit] {alignment = 8 : i64}
+      %0 = cir.call @task() : () -> !cir.ptr<i8>
+      cir.store %0, %slot : !cir.ptr<i8>, cir.ptr <!cir.ptr<i8>>
+      %1 = cir.cast(bitcast, %slot : !cir.ptr<!cir.ptr<i8>>), !cir.ptr<i64>
+      %2 = cir.load %1 : cir.ptr <i64>, i64
+      cir.call @publish_int(%2) : (i64) -> ()
+      cir.return
+    }
+  )mlir");
+  ASSERT_TRUE(module);
+  EXPECT_FALSE(module->lookupSymbol("task.elided"));
+}
+
+TEST_F(CoroElideTest, KeepsFrameRecoveredFromPromise) {
+  // The frame pointer only leaves the coroutine through its promise.
+  auto module = runCoroElide(R"mlir(
+    cir.func @promise_task() -> !cir.ptr<i8> attributes {coroutine} {
+      %promise = cir.alloca i32, cir.ptr <i32>, ["__promise", uninitialized] {alignment = 4 : i64, coro_promise}
+      %0 = cir.coro.alloc_frame : !cir.ptr<i8> alloc {
+      ^bb0(%size: i64):
+        %1 = cir.call @_Znwm(%size) : (i64) -> !cir.ptr<i8>
+        cir.yield %1 : !cir.ptr<i8>
+      }
+      %2 = cir.cast(bitcast, %promise : !cir.ptr<i32>), !cir.ptr<i8>
+      %3 = cir.coro.promise from_promise %2 : !cir.ptr<i8>, !cir.ptr<i8> {alignment = 4 : i64}
+      cir.call @publish(%3) : (!cir.ptr<i8>) -> ()
+      cir.return %0 : !cir.ptr<i8>
+    }
+    cir.func @caller() -> i8 {
+      %0 = cir.call @promise_task() : () -> !cir.ptr<i8>
+      %1 = cir.load %0 : cir.ptr <i8>, i8
+      cir.return %1 : i8
+    }
+  )mlir");
+  ASSERT_TRUE(module);
+  EXPECT_FALSE(module->lookupSymbol("promise_task.elided"));
+}
+
+TEST_F(CoroElideTest, KeepsFrameOfCallInLoop) {
+  // Each iteration starts a coroutine whose frame pointer outlives the
+  // iteration in %slot: the frames cannot share one storage.
+  auto module = runCoroElide(R"mlir(
+    cir.func @caller() -> i8 {
+      %slot = cir.alloca !cir.ptr<i8>, cir.ptr <!cir.ptr<i8>>, ["slot", cinit] {alignment = 8 : i64}
+      cir.loop while(cond : {
+        cir.yield continue
+      }, step : {
+        cir.yield
+      }) {
+        %0 = cir.call @task() : () -> !cir.ptr<i8>
+        cir.store %0, %slot : !cir.ptr<i8>, cir.ptr <!cir.ptr<i8>>
+        cir.yield
+      }
+      %1 = cir.load %slot : cir.ptr <!cir.ptr<i8>>, !cir.ptr<i8>
+      %2 = cir.load %1 : cir.ptr <i8>, i8
+      cir.return %2 : i8
+    }
+  )mlir");
+  ASSERT_TRUE(module);
+  EXPECT_EQ(getCalleeOfCaller(*module), "task");
+  EXPECT_FALSE(module->lookupSymbol("task.elided"));
+}
+
+TEST_F(CoroElideTest, KeepsFrameOfCallInCycle) {
+  auto module = runCoroElide(R"mlir(
+    cir.func @caller(%arg0: !cir.bool) -> i8 {
+      cir.br ^bb1
+    ^bb1:
+      %0 = cir.call @task() : () -> !cir.ptr<i8>
+      %1 = cir.load %0 : cir.ptr <i8>, i8
+      cir.brcond %arg0 ^bb1, ^bb2
+    ^bb2:
+      cir.return %1 : i8
+    }
+  )mlir");
+  ASSERT_TRUE(module);
+  EXPECT_FALSE(module->lookupSymbol("task.elided"));
+}
+
+} // namespace
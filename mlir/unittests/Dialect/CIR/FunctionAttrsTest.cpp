@@ -0,0 +1,186 @@
+//===- FunctionAttrsTest.cpp - unit tests for CIR effect attributes -------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Dialect/CIR/IR/CIRDialect.h"
+#include "mlir/Dialect/CIR/Passes.h"
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/Interfaces/SideEffectInterfaces.h"
+#include "mlir/Parser/Parser.h"
+#include "mlir/Pass/PassManager.h"
+#include "gtest/gtest.h"
+
+using namespace mlir;
+
+namespace {
+
+class FunctionAttrsTest : public ::testing::Test {
+protected:
+  FunctionAttrsTest() { context.getOrLoadDialect<cir::CIRDialect>(); }
+
+  OwningOpRef<ModuleOp> parse(StringRef source) {
+    return parseSourceString<ModuleOp>(source, &context);
+  }
+
+  /// Runs the inference on `source`.
+  OwningOpRef<ModuleOp> runFunctionAttrs(StringRef source) {
+    auto module = parse(source);
+    if (!module)
+      return nullptr;
+    PassManager pm(&context);
+    pm.addPass(createFunctionAttrsPass());
+    if (failed(pm.run(*module)))
+      return nullptr;
+    return module;
+  }
+
+  MLIRContext context;
+};
+
+TEST_F(FunctionAttrsTest, InfersNoneForLocalMemory) {
+  auto module = runFunctionAttrs(R"mlir(
+    cir.func @local(%arg0: i32) -> i32 {
+      %0 = cir.alloca i32, cir.ptr <i32>, ["x", cinit] {alignment = 4 : i64}
+      cir.store %arg0, %0 : i32, cir.ptr <i32>
+      %1 = cir.load %0 : cir.ptr <i32>, i32
+      cir.return %1 : i32
+    }
+  )mlir");
+  ASSERT_TRUE(module);
+  auto fn = module->lookupSymbol<cir::FuncOp>("local");
+  EXPECT_TRUE(fn.nothrow());
+  EXPECT_EQ(fn.memory_effects(), cir::FuncMemoryEffects::none);
+}
+
+TEST_F(FunctionAttrsTest, InfersReadForArgumentLoads) {
+  auto module = runFunctionAttrs(R"mlir(
+    cir.func @reader(%arg0: !cir.ptr<i32>) -> i32 {
+      %0 = cir.load %arg0 : cir.ptr <i32>, i32
+      cir.return %0 : i32
+    }
+  )mlir");
+  ASSERT_TRUE(module);
+  auto fn = module->lookupSymbol<cir::FuncOp>("reader");
+  EXPECT_TRUE(fn.nothrow());
+  EXPECT_EQ(fn.memory_effects(), cir::FuncMemoryEffects::read);
+}
+
+TEST_F(FunctionAttrsTest, KeepsWritesToArguments) {
+  auto module = runFunctionAttrs(R"mlir(
+    cir.func @writer(%arg0: !cir.ptr<i32>, %arg1: i32) {
+      cir.store %arg1, %arg0 : i32, cir.ptr <i32>
+      cir.return
+    }
+  )mlir");
+  ASSERT_TRUE(module);
+  auto fn = module->lookupSymbol<cir::FuncOp>("writer");
+  EXPECT_TRUE(fn.nothrow());
+  EXPECT_FALSE(fn.memory_effects());
+}
+
+TEST_F(FunctionAttrsTest, PropagatesFromCallees) {
+  auto module = runFunctionAttrs(R"mlir(
+    cir.func @unknown() attributes {sym_visibility = "private"}
+    cir.func @pure_decl() -> i32 attributes {
+      nothrow, memory_effects = 1 : i32, sym_visibility = "private"
+    }
+
+    cir.func @calls_pure() -> i32 {
+      %0 = cir.call @pure_decl() : () -> i32
+      cir.return %0 : i32
+    }
+    cir.func @calls_unknown() {
+      cir.call @unknown() : () -> ()
+      cir.return
+    }
+    cir.func @calls_calls_unknown() {
+      cir.call @calls_unknown() : () -> ()
+      cir.return
+    }
+  )mlir");
+  ASSERT_TRUE(module);
+  auto callsPure = module->lookupSymbol<cir::FuncOp>("calls_pure");
+  EXPECT_TRUE(callsPure.nothrow());
+  EXPECT_EQ(callsPure.memory_effects(), cir::FuncMemoryEffects::none);
+
+  for (StringRef name : {"calls_unknown", "calls_calls_unknown"}) {
+    auto fn = module->lookupSymbol<cir::FuncOp>(name);
+    EXPECT_FALSE(fn.nothrow()) << name.str();
+    EXPECT_FALSE(fn.memory_effects()) << name.str();
+  }
+}
+
+TEST_F(FunctionAttrsTest, KeepsRecursionMayNotReturn) {
+  auto module = runFunctionAttrs(R"mlir(
+    cir.func @ping(%arg0: i32) -> i32 {
+      %0 = cir.call @pong(%arg0) : (i32) -> i32
+      cir.return %0 : i32
+    }
+    cir.func @pong(%arg0: i32) -> i32 {
+      %0 = cir.call @ping(%arg0) : (i32) -> i32
+      cir.return %0 : i32
+    }
+  )mlir");
+  ASSERT_TRUE(module);
+  for (StringRef name : {"ping", "pong"}) {
+    auto fn = module->lookupSymbol<cir::FuncOp>(name);
+    EXPECT_TRUE(fn.nothrow()) << name.str();
+    EXPECT_FALSE(fn.memory_effects()) << name.str();
+  }
+}
+
+TEST_F(FunctionAttrsTest, SkipsInexactDefinitions) {
+  auto module = runFunctionAttrs(R"mlir(
+    cir.func weak @weak(%arg0: i32) -> i32 {
+      cir.return %arg0 : i32
+    }
+  )mlir");
+  ASSERT_TRUE(module);
+  auto fn = module->lookupSymbol<cir::FuncOp>("weak");
+  EXPECT_FALSE(fn.nothrow());
+  EXPECT_FALSE(fn.memory_effects());
+}
+
+TEST_F(FunctionAttrsTest, CallEffectsFollowCallee) {
+  auto module = parse(R"mlir(
+    cir.func @none() attributes {
+      nothrow, memory_effects = 1 : i32, sym_visibility = "private"
+    }
+    cir.func @read() attributes {
+      nothrow, memory_effects = 2 : i32, sym_visibility = "private"
+    }
+    cir.func @may_throw() attributes {
+      memory_effects = 1 : i32, sym_visibility = "private"
+    }
+    cir.func @caller() {
+      cir.call @none() : () -> ()
+      cir.call @read() : () -> ()
+      cir.call @may_throw() : () -> ()
+      cir.return
+    }
+  )mlir");
+  ASSERT_TRUE(module);
+
+  SmallVector<cir::CallOp> calls;
+  module->walk([&](cir::CallOp call) { calls.push_back(call); });
+  ASSERT_EQ(calls.size(), 3u);
+
+  auto getEffects = [](cir::CallOp call) {
+    return cast<MemoryEffectOpInterface>(call.getOperation());
+  };
+
+  EXPECT_TRUE(getEffects(calls[0]).hasNoEffect());
+
+  EXPECT_TRUE(getEffects(calls[1]).hasEffect<MemoryEffects::Read>());
+  EXPECT_FALSE(getEffects(calls[1]).hasEffect<MemoryEffects::Write>());
+
+  // A call that may unwind keeps every effect.
+  EXPECT_TRUE(getEffects(calls[2]).hasEffect<MemoryEffects::Read>());
+  EXPECT_TRUE(getEffects(calls[2]).hasEffect<MemoryEffects::Write>());
+}
+
+} // namespace
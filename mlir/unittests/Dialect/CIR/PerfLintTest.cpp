@@ -0,0 +1,265 @@
+//===- PerfLintTest.cpp - unit tests for the CIR performance lints --------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Dialect/CIR/IR/CIRDialect.h"
+#include "mlir/Dialect/CIR/Passes.h"
+#include "mlir/IR/Builders.h"
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/IR/Diagnostics.h"
+#include "mlir/Pass/PassManager.h"
+#include "gtest/gtest.h"
+
+using namespace mlir;
+
+namespace {
+
+class PerfLintTest : public ::testing::Test {
+protected:
+  PerfLintTest() : builder(&context) {
+    context.getOrLoadDialect<cir::CIRDialect>();
+    module = ModuleOp::create(builder.getUnknownLoc());
+    builder.setInsertionPointToEnd(module->getBody());
+    auto i64Ty = builder.getI64Type();
+    bigTy = cir::StructType::get(
+        &context, {cir::ArrayType::get(&context, i64Ty, 16)}, "Big");
+    bigPtrTy = cir::PointerType::get(&context, bigTy);
+  }
+
+  /// A function taking `numArgs` pointers to `Big`, the attributes in
+  /// `argAttrs` being set on the argument of the same index.
+  cir::FuncOp createFunc(StringRef name, unsigned numArgs,
+                         ArrayRef<StringRef> argAttrs = {}) {
+    OpBuilder::InsertionGuard guard(builder);
+    SmallVector<Type> argTys(numArgs, bigPtrTy);
+    auto func = builder.create<cir::FuncOp>(
+        builder.getUnknownLoc(), name, builder.getFunctionType(argTys, {}));
+    func.addEntryBlock();
+    for (auto attr : llvm::enumerate(argAttrs))
+      if (!attr.value().empty())
+        func.setArgAttr(attr.index(), attr.value(), builder.getUnitAttr());
+    return func;
+  }
+
+  /// A private declaration of `name`.
+  cir::FuncOp createDecl(StringRef name, ArrayRef<Type> argTys,
+                         ArrayRef<Type> resultTys = {}) {
+    OpBuilder::InsertionGuard guard(builder);
+    auto func = builder.create<cir::FuncOp>(
+        builder.getUnknownLoc(), name,
+        builder.getFunctionType(argTys, resultTys));
+    func.setPrivate();
+    return func;
+  }
+
+  /// Ends `func` with a `while (true)` loop whose body is built by
+  /// `bodyBuilder`.
+  void createLoop(cir::FuncOp func,
+                  function_ref<void(OpBuilder &, Location)> bodyBuilder) {
+    OpBuilder::InsertionGuard guard(builder);
+    auto loc = builder.getUnknownLoc();
+    builder.setInsertionPointToEnd(&func.getBody().front());
+    builder.create<cir::LoopOp>(
+        loc, cir::LoopOpKind::While,
+        /*condBuilder=*/
+        [](OpBuilder &b, Location loc) {
+          b.create<cir::YieldOp>(loc, cir::YieldOpKind::Continue);
+        },
+        /*bodyBuilder=*/
+        [&](OpBuilder &b, Location loc) {
+          bodyBuilder(b, loc);
+          b.create<cir::YieldOp>(loc);
+        },
+        /*stepBuilder=*/
+        [](OpBuilder &b, Location loc) { b.create<cir::YieldOp>(loc); });
+    builder.create<cir::ReturnOp>(loc);
+  }
+
+  /// Runs the pass and returns the warnings it emitted.
+  std::vector<std::string> runPerfLint() {
+    std::vector<std::string> warnings;
+    ScopedDiagnosticHandler handler(&context, [&](Diagnostic &diag) {
+      if (diag.getSeverity() == DiagnosticSeverity::Warning)
+        warnings.push_back(diag.str());
+      return success();
+    });
+    PassManager pm(&context);
+    pm.addPass(createPerfLintPass());
+    EXPECT_TRUE(succeeded(pm.run(*module)));
+    return warnings;
+  }
+
+  MLIRContext context;
+  OpBuilder builder;
+  OwningOpRef<ModuleOp> module;
+  Type bigTy;
+  Type bigPtrTy;
+};
+
+TEST_F(PerfLintTest, ReportsByValArgument) {
+  auto func =
+      createFunc("byval", 2, {"", cir::FuncOp::getByValArgAttrName()});
+  builder.setInsertionPointToEnd(&func.getBody().front());
+  builder.create<cir::ReturnOp>(builder.getUnknownLoc());
+
+  auto warnings = runPerfLint();
+  ASSERT_EQ(warnings.size(), 1u);
+  EXPECT_NE(warnings[0].find("parameter 2 of type 'Big' (128 bytes) is "
+                             "passed by value"),
+            std::string::npos);
+  EXPECT_NE(warnings[0].find("[large-by-value]"), std::string::npos);
+}
+
+TEST_F(PerfLintTest, DoesNotCountSRetAsParameter) {
+  auto func = createFunc("sret_byval", 2,
+                         {cir::FuncOp::getSRetArgAttrName(),
+                          cir::FuncOp::getByValArgAttrName()});
+  builder.setInsertionPointToEnd(&func.getBody().front());
+  builder.create<cir::ReturnOp>(builder.getUnknownLoc());
+
+  auto warnings = runPerfLint();
+  ASSERT_EQ(warnings.size(), 1u);
+  EXPECT_NE(warnings[0].find("parameter 1 of type 'Big'"), std::string::npos);
+}
+
+TEST_F(PerfLintTest, IgnoresReferenceArgument) {
+  auto func = createFunc("by_reference", 1);
+  builder.setInsertionPointToEnd(&func.getBody().front());
+  builder.create<cir::ReturnOp>(builder.getUnknownLoc());
+
+  EXPECT_TRUE(runPerfLint().empty());
+}
+
+TEST_F(PerfLintTest, ReportsCopyIntoSRet) {
+  auto func =
+      createFunc("copy_to_sret", 2, {cir::FuncOp::getSRetArgAttrName()});
+  auto loc = builder.getUnknownLoc();
+  builder.setInsertionPointToEnd(&func.getBody().front());
+  auto copy = builder.create<cir::LoadOp>(loc, bigTy, func.getArgument(1),
+                                          /*isDeref=*/false);
+  builder.create<cir::StoreOp>(loc, copy, func.getArgument(0));
+  builder.create<cir::ReturnOp>(loc);
+
+  auto warnings = runPerfLint();
+  ASSERT_EQ(warnings.size(), 1u);
+  EXPECT_NE(warnings[0].find("'Big' (128 bytes) is copied into the return "
+                             "value"),
+            std::string::npos);
+}
+
+TEST_F(PerfLintTest, IgnoresCopyIntoOtherArgument) {
+  auto func = createFunc("copy_to_arg", 2);
+  auto loc = builder.getUnknownLoc();
+  builder.setInsertionPointToEnd(&func.getBody().front());
+  auto copy = builder.create<cir::LoadOp>(loc, bigTy, func.getArgument(1),
+                                          /*isDeref=*/false);
+  builder.create<cir::StoreOp>(loc, copy, func.getArgument(0));
+  builder.create<cir::ReturnOp>(loc);
+
+  EXPECT_TRUE(runPerfLint().empty());
+}
+
+TEST_F(PerfLintTest, ReportsCopyConstructionInLoop) {
+  // Big::Big(Big const&)
+  auto ctor = createDecl("_ZN3BigC1ERKS_", {bigPtrTy, bigPtrTy});
+  auto func = createFunc("copy_in_loop", 2);
+  createLoop(func, [&](OpBuilder &b, Location loc) {
+    b.create<cir::CallOp>(loc, ctor,
+                          ValueRange{func.getArgument(0), func.getArgument(1)});
+  });
+
+  auto warnings = runPerfLint();
+  ASSERT_EQ(warnings.size(), 1u);
+  EXPECT_NE(warnings[0].find("'Big' is copied on every loop iteration"),
+            std::string::npos);
+  EXPECT_NE(warnings[0].find("[copy-in-loop]"), std::string::npos);
+}
+
+TEST_F(PerfLintTest, IgnoresMoveConstructionInLoop) {
+  // Big::Big(Big&&)
+  auto ctor = createDecl("_ZN3BigC1EOS_", {bigPtrTy, bigPtrTy});
+  auto func = createFunc("move_in_loop", 2);
+  createLoop(func, [&](OpBuilder &b, Location loc) {
+    b.create<cir::CallOp>(loc, ctor,
+                          ValueRange{func.getArgument(0), func.getArgument(1)});
+  });
+
+  EXPECT_TRUE(runPerfLint().empty());
+}
+
+TEST_F(PerfLintTest, ReportsAllocationInLoop) {
+  auto i64Ty = builder.getI64Type();
+  auto i8PtrTy = cir::PointerType::get(&context, builder.getI8Type());
+  // operator new(unsigned long)
+  auto allocFn = createDecl("_Znwm", {i64Ty}, {i8PtrTy});
+  auto func = createFunc("alloc_in_loop", 0);
+  createLoop(func, [&](OpBuilder &b, Location loc) {
+    auto size =
+        b.create<cir::ConstantOp>(loc, i64Ty, b.getI64IntegerAttr(128));
+    b.create<cir::CallOp>(loc, allocFn, ValueRange{size});
+  });
+
+  auto warnings = runPerfLint();
+  ASSERT_EQ(warnings.size(), 1u);
+  EXPECT_NE(warnings[0].find("heap allocation on every loop iteration"),
+            std::string::npos);
+  EXPECT_NE(warnings[0].find("[alloc-in-loop]"), std::string::npos);
+}
+
+TEST_F(PerfLintTest, IgnoresAllocationOutsideLoop) {
+  auto i64Ty = builder.getI64Type();
+  auto i8PtrTy = cir::PointerType::get(&context, builder.getI8Type());
+  auto allocFn = createDecl("_Znwm", {i64Ty}, {i8PtrTy});
+  auto func = createFunc("alloc", 0);
+  auto loc = builder.getUnknownLoc();
+  builder.setInsertionPointToEnd(&func.getBody().front());
+  auto size = builder.create<cir::ConstantOp>(loc, i64Ty,
+                                              builder.getI64IntegerAttr(128));
+  builder.create<cir::CallOp>(loc, allocFn, ValueRange{size});
+  builder.create<cir::ReturnOp>(loc);
+
+  EXPECT_TRUE(runPerfLint().empty());
+}
+
+TEST_F(PerfLintTest, ReportsStringConstructionInLoop) {
+  // The members of std::string do not matter to the check.
+  auto stringTy = cir::StructType::get(
+      &context, {builder.getI64Type()},
+      "std::__cxx11::basic_string<char, std::char_traits<char>, "
+      "std::allocator<char> >");
+  auto stringPtrTy = cir::PointerType::get(&context, stringTy);
+  auto charPtrTy = cir::PointerType::get(&context, builder.getI8Type());
+  // std::string::basic_string(char const*, std::allocator<char> const&)
+  auto ctor = createDecl(
+      "_ZNSt7__cxx1112basic_stringIcSt11char_traitsIcESaIcEEC1EPKcRKS3_",
+      {stringPtrTy, charPtrTy, charPtrTy});
+  auto func = createFunc("string_in_loop", 0);
+  auto loc = builder.getUnknownLoc();
+  builder.setInsertionPointToEnd(&func.getBody().front());
+  // As CIRGen does, the storage is allocated at the start of the function.
+  auto str = builder.create<cir::AllocaOp>(
+      loc, stringPtrTy, stringTy, "s", cir::InitStyle::cinit,
+      builder.getI64IntegerAttr(8));
+  auto chars = builder.create<cir::AllocaOp>(
+      loc, cir::PointerType::get(&context, charPtrTy), charPtrTy, "chars",
+      cir::InitStyle::cinit, builder.getI64IntegerAttr(8));
+  createLoop(func, [&](OpBuilder &b, Location loc) {
+    auto cstr =
+        b.create<cir::LoadOp>(loc, charPtrTy, chars, /*isDeref=*/false);
+    b.create<cir::CallOp>(loc, ctor, ValueRange{str, cstr, cstr});
+  });
+
+  auto warnings = runPerfLint();
+  ASSERT_EQ(warnings.size(), 1u);
+  EXPECT_NE(warnings[0].find("'std::__cxx11::basic_string<char, "
+                             "std::char_traits<char>, std::allocator<char> >' "
+                             "is constructed on every loop iteration"),
+            std::string::npos);
+  EXPECT_NE(warnings[0].find("[string-in-loop]"), std::string::npos);
+}
+
+} // namespace
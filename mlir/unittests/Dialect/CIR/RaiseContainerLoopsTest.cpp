@@ -0,0 +1,133 @@
+//===- RaiseContainerLoopsTest.cpp - unit tests for container loop raising ===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "mlir/Dialect/CIR/IR/CIRDialect.h"
+#include "mlir/Dialect/CIR/Passes.h"
+#include "mlir/IR/BuiltinOps.h"
+#include "mlir/Parser/Parser.h"
+#include "mlir/Pass/PassManager.h"
+#include "gtest/gtest.h"
+
+using namespace mlir;
+
+namespace {
+
+// The libstdc++ operations on std::vector<int>::iterator, as named by GCC.
+const char *const iteratorDecls = R"mlir(
+  !it = !cir.struct<"__gnu_cxx::__normal_iterator<int *, std::vector<int> >", !cir.ptr<i32>>
+
+  cir.func @_ZN9__gnu_cxxneIPiSt6vectorIiSaIiEEEEbRKNS_17__normal_iteratorIT_T0_EESA_(!cir.ptr<!it>, !cir.ptr<!it>) -> !cir.bool
+      attributes {sym_visibility = "private"}
+  cir.func @_ZN9__gnu_cxx17__normal_iteratorIPiSt6vectorIiSaIiEEEppEv(!cir.ptr<!it>) -> !cir.ptr<!it>
+      attributes {sym_visibility = "private"}
+  cir.func @_ZNK9__gnu_cxx17__normal_iteratorIPiSt6vectorIiSaIiEEEdeEv(!cir.ptr<!it>) -> !cir.ptr<i32>
+      attributes {sym_visibility = "private"}
+  cir.func @use(!cir.ptr<!it>) attributes {sym_visibility = "private"}
+)mlir";
+
+// Sums the elements between two iterators, `extra` being inserted in the
+// loop body.
+std::string getSumLoop(StringRef extra) {
+  return (R"mlir(
+  cir.func @sum(%arg0: !it, %arg1: !it) -> i32 {
+    %it = cir.alloca !it, cir.ptr <!it>, ["it", cinit] {alignment = 8 : i64}
+    %end = cir.alloca !it, cir.ptr <!it>, ["end", cinit] {alignment = 8 : i64}
+    %sum = cir.alloca i32, cir.ptr <i32>, ["sum", cinit] {alignment = 4 : i64}
+    cir.store %arg0, %it : !it, cir.ptr <!it>
+    cir.store %arg1, %end : !it, cir.ptr <!it>
+    %zero = cir.cst(0 : i32) : i32
+    cir.store %zero, %sum : i32, cir.ptr <i32>
+    cir.loop for(cond : {
+      %0 = cir.call @_ZN9__gnu_cxxneIPiSt6vectorIiSaIiEEEEbRKNS_17__normal_iteratorIT_T0_EESA_(%it, %end) : (!cir.ptr<!it>, !cir.ptr<!it>) -> !cir.bool
+      cir.brcond %0 ^bb1, ^bb2
+    ^bb1:
+      cir.yield continue
+    ^bb2:
+      cir.yield
+    }, step : {
+      %0 = cir.call @_ZN9__gnu_cxx17__normal_iteratorIPiSt6vectorIiSaIiEEEppEv(%it) : (!cir.ptr<!it>) -> !cir.ptr<!it>
+      cir.yield
+    }) {
+      %0 = cir.call @_ZNK9__gnu_cxx17__normal_iteratorIPiSt6vectorIiSaIiEEEdeEv(%it) : (!cir.ptr<!it>) -> !cir.ptr<i32>
+      %1 = cir.load %0 : cir.ptr <i32>, i32
+      %2 = cir.load %sum : cir.ptr <i32>, i32
+      %3 = cir.binop(add, %2, %1) : i32
+      cir.store %3, %sum : i32, cir.ptr <i32>
+)mlir" +
+          extra + R"mlir(
+      cir.yield
+    }
+    %4 = cir.load %sum : cir.ptr <i32>, i32
+    cir.return %4 : i32
+  }
+)mlir")
+      .str();
+}
+
+class RaiseContainerLoopsTest : public ::testing::Test {
+protected:
+  RaiseContainerLoopsTest() { context.getOrLoadDialect<cir::CIRDialect>(); }
+
+  OwningOpRef<ModuleOp> runRaiseContainerLoops(StringRef source) {
+    OwningOpRef<ModuleOp> module = parseSourceString<ModuleOp>(
+        (iteratorDecls + source).str(), &context);
+    if (!module)
+      return nullptr;
+    PassManager pm(&context);
+    pm.addPass(createRaiseContainerLoopsPass());
+    if (failed(pm.run(*module)))
+      return nullptr;
+    return module;
+  }
+
+  /// Names of the functions called from `@sum`.
+  static SmallVector<StringRef> getCallees(ModuleOp module) {
+    SmallVector<StringRef> callees;
+    module.lookupSymbol<cir::FuncOp>("sum").walk(
+        [&](cir::CallOp call) { callees.push_back(call.callee()); });
+    return callees;
+  }
+
+  MLIRContext context;
+};
+
+TEST_F(RaiseContainerLoopsTest, RaisesVectorIteratorLoop) {
+  auto module = runRaiseContainerLoops(getSumLoop(""));
+  ASSERT_TRUE(module);
+  EXPECT_TRUE(getCallees(*module).empty());
+
+  auto sum = module->lookupSymbol<cir::FuncOp>("sum");
+  unsigned numPtrAllocas = 0, numCmps = 0, numStrides = 0;
+  sum.walk([&](Operation *op) {
+    if (auto alloca = dyn_cast<cir::AllocaOp>(op))
+      numPtrAllocas += alloca.name() == "it.ptr";
+    numCmps += isa<cir::CmpOp>(op);
+    numStrides += isa<cir::PtrStrideOp>(op);
+  });
+  EXPECT_EQ(numPtrAllocas, 1u);
+  EXPECT_EQ(numCmps, 1u);
+  EXPECT_EQ(numStrides, 1u);
+}
+
+TEST_F(RaiseContainerLoopsTest, KeepsLoopWhenIteratorEscapes) {
+  auto module = runRaiseContainerLoops(getSumLoop(R"mlir(
+      cir.call @use(%it) : (!cir.ptr<!it>) -> ()
+)mlir"));
+  ASSERT_TRUE(module);
+  EXPECT_EQ(getCallees(*module).size(), 4u);
+}
+
+TEST_F(RaiseContainerLoopsTest, KeepsLoopWhenEndChanges) {
+  auto module = runRaiseContainerLoops(getSumLoop(R"mlir(
+      cir.store %arg0, %end : !it, cir.ptr <!it>
+)mlir"));
+  ASSERT_TRUE(module);
+  EXPECT_EQ(getCallees(*module).size(), 3u);
+}
+
+} // namespace
@@ -6,8 +6,13 @@
 //
 //===----------------------------------------------------------------------===//
 
+#include "mlir/IR/AsmState.h"
 #include "mlir/IR/BuiltinAttributes.h"
+#include "mlir/IR/BuiltinDialect.h"
 #include "mlir/IR/BuiltinTypes.h"
+#include "mlir/IR/DialectResourceBlobManager.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/FileUtilities.h"
 #include "gtest/gtest.h"
 
 using namespace mlir;
@@ -250,4 +255,142 @@ TEST(SparseElementsAttrTest, GetZero) {
   EXPECT_TRUE(zeroStringValue.getType() == stringTy);
 }
 
+
+//===----------------------------------------------------------------------===//
+// DenseResourceElementsAttr
+//===----------------------------------------------------------------------===//
+
+/// Return the data of `attr` as 64-bit integers.
+static ArrayRef<int64_t> getInt64Data(DenseResourceElementsAttr attr) {
+  Optional<ArrayRef<char>> data = attr.getData();
+  if (!data)
+    return {};
+  return ArrayRef<int64_t>(reinterpret_cast<const int64_t *>(data->data()),
+                           data->size() / sizeof(int64_t));
+}
+
+/// Return a heap allocated blob holding a copy of `values`.
+static AsmResourceBlob allocateInt64Blob(ArrayRef<int64_t> values) {
+  return HeapAsmResourceBlob::allocateAndCopy(values);
+}
+
+TEST(DenseResourceElementsAttrTest, InsertRenamesDuplicateKeys) {
+  MLIRContext context;
+  auto type = RankedTensorType::get({3}, IntegerType::get(&context, 64));
+
+  auto first = DenseResourceElementsAttr::get(type, "blob",
+                                             allocateInt64Blob({1, 2, 3}));
+  auto second = DenseResourceElementsAttr::get(type, "blob",
+                                              allocateInt64Blob({4, 5, 6}));
+  EXPECT_NE(first, second);
+  EXPECT_EQ(first.getRawHandle().getKey(), "blob");
+  EXPECT_EQ(second.getRawHandle().getKey(), "blob_1");
+  EXPECT_EQ(getInt64Data(first), llvm::makeArrayRef<int64_t>({1, 2, 3}));
+  EXPECT_EQ(getInt64Data(second), llvm::makeArrayRef<int64_t>({4, 5, 6}));
+
+  // Attributes are uniqued on the handle, not on the data.
+  EXPECT_EQ(DenseResourceElementsAttr::get(type, first.getRawHandle()), first);
+
+  DialectResourceBlobManager &manager =
+      DenseResourceElementsHandle::getManagerInterface(&context)
+          .getBlobManager();
+  DialectResourceBlobManager::BlobEntry *entry = manager.lookup("blob_1");
+  ASSERT_TRUE(entry);
+  EXPECT_EQ(entry->getKey(), "blob_1");
+  EXPECT_EQ(entry->getBlob(), second.getRawHandle().getBlob());
+  EXPECT_FALSE(manager.lookup("blob_2"));
+}
+
+TEST(DenseResourceElementsAttrTest, UpdateReplacesBlob) {
+  MLIRContext context;
+  auto type = RankedTensorType::get({3}, IntegerType::get(&context, 64));
+
+  // An entry inserted without a blob has no data yet.
+  auto &managerInterface =
+      DenseResourceElementsHandle::getManagerInterface(&context);
+  DenseResourceElementsHandle handle = managerInterface.insert("blob");
+  auto attr = DenseResourceElementsAttr::get(type, handle);
+  EXPECT_FALSE(attr.getData());
+
+  managerInterface.update("blob", allocateInt64Blob({1, 2, 3}));
+  EXPECT_EQ(getInt64Data(attr), llvm::makeArrayRef<int64_t>({1, 2, 3}));
+
+  managerInterface.update("blob", allocateInt64Blob({4, 5, 6}));
+  EXPECT_EQ(getInt64Data(attr), llvm::makeArrayRef<int64_t>({4, 5, 6}));
+  EXPECT_EQ(DenseResourceElementsAttr::get(type, handle), attr);
+}
+
+TEST(DenseResourceElementsAttrTest, UpdateReleasesPreviousBlob) {
+  // Blobs over static data, counting how many of them were released. The
+  // counter outlives the context, which releases the blobs it still holds.
+  static const int64_t first[] = {1, 2, 3};
+  static const int64_t second[] = {4, 5, 6};
+  unsigned numReleased = 0;
+  MLIRContext context;
+  auto &managerInterface =
+      DenseResourceElementsHandle::getManagerInterface(&context);
+  auto createBlob = [&](ArrayRef<int64_t> values) {
+    return AsmResourceBlob(
+        values, [&](const int64_t *, size_t) { ++numReleased; },
+        /*dataIsMutable=*/false);
+  };
+
+  managerInterface.insert("blob", createBlob(first));
+  EXPECT_EQ(numReleased, 0u);
+  managerInterface.update("blob", createBlob(second));
+  EXPECT_EQ(numReleased, 1u);
+
+  // Moving a blob into another one releases the data of the latter only.
+  AsmResourceBlob blob = createBlob(first);
+  blob = createBlob(second);
+  EXPECT_EQ(numReleased, 2u);
+  EXPECT_EQ(blob.getData().data(), reinterpret_cast<const char *>(second));
+}
+
+//===----------------------------------------------------------------------===//
+// FileAsmResourceBlob
+//===----------------------------------------------------------------------===//
+
+TEST(FileAsmResourceBlobTest, AlignedAndMisalignedSections) {
+  // Large enough for the sections to be mapped rather than read.
+  std::vector<int64_t> values(4096);
+  for (size_t i = 0, e = values.size(); i < e; ++i)
+    values[i] = i;
+  size_t sectionSize = values.size() * sizeof(int64_t);
+
+  // One aligned section at offset 0, one misaligned section right after a
+  // padding byte.
+  int fd;
+  SmallString<128> path;
+  ASSERT_FALSE(
+      llvm::sys::fs::createTemporaryFile("resource", "bin", fd, path));
+  llvm::FileRemover remover(path);
+  {
+    llvm::raw_fd_ostream os(fd, /*shouldClose=*/true);
+    os.write(reinterpret_cast<const char *>(values.data()), sectionSize);
+    os << '\0';
+    os.write(reinterpret_cast<const char *>(values.data()), sectionSize);
+  }
+
+  for (uint64_t offset : {uint64_t(0), uint64_t(sectionSize + 1)}) {
+    llvm::ErrorOr<AsmResourceBlob> blob = FileAsmResourceBlob::allocate(
+        path, offset, sectionSize, alignof(int64_t));
+    ASSERT_TRUE(blob) << "offset " << offset;
+    ArrayRef<char> data = blob->getData();
+    EXPECT_EQ(blob->getDataAlignment(), alignof(int64_t));
+    EXPECT_TRUE(llvm::isAddrAligned(llvm::Align(alignof(int64_t)), data.data()))
+        << "offset " << offset;
+    EXPECT_FALSE(blob->isMutable());
+    ASSERT_EQ(data.size(), sectionSize);
+    EXPECT_EQ(ArrayRef<int64_t>(reinterpret_cast<const int64_t *>(data.data()),
+                                values.size()),
+              llvm::makeArrayRef(values))
+        << "offset " << offset;
+  }
+
+  std::string missingPath = (path + ".missing").str();
+  EXPECT_FALSE(FileAsmResourceBlob::allocate(missingPath, 0, sectionSize,
+                                             alignof(int64_t)));
+}
+
 } // namespace
@@ -290,4 +290,145 @@ TEST(OperandStorageTest, PopulateDefaultAttrs) {
 
   op->destroy();
 }
+
+/// Returns the index of the inherent attribute `name` of `op`.
+static unsigned getInherentAttrIndex(Operation *op, StringRef name) {
+  ArrayRef<StringAttr> names = op->getName().getAttributeNames();
+  auto it = llvm::find_if(
+      names, [&](StringAttr attrName) { return attrName.getValue() == name; });
+  assert(it != names.end() && "not an inherent attribute");
+  return it - names.begin();
+}
+
+TEST(OperationAttrsTest, InherentAndDiscardableAttrs) {
+  MLIRContext context;
+  context.getOrLoadDialect<test::TestDialect>();
+  OpBuilder b(&context);
+  auto attr10 = b.getI32IntegerAttr(10);
+  auto attr20 = b.getI32IntegerAttr(20);
+  auto attr60 = b.getI32IntegerAttr(60);
+  Operation *op = b.create<test::OpAttrMatch1>(b.getUnknownLoc(), attr10,
+                                               nullptr, nullptr, attr60);
+  op->setAttr("discardable", b.getUnitAttr());
+
+  unsigned requiredIndex = getInherentAttrIndex(op, "required_attr");
+  unsigned moreIndex = getInherentAttrIndex(op, "more_attr");
+  EXPECT_EQ(op->getInherentAttr(requiredIndex), attr10);
+  EXPECT_EQ(op->getAttr("required_attr"), attr10);
+  EXPECT_EQ(op->getInherentAttr(getInherentAttrIndex(op, "optional_attr")),
+            nullptr);
+  EXPECT_TRUE(op->hasAttr("discardable"));
+
+  // The dictionary holds both kinds of attributes.
+  DictionaryAttr dict = op->getAttrDictionary();
+  EXPECT_EQ(dict.size(), 3u);
+  EXPECT_EQ(dict.get("required_attr"), attr10);
+  EXPECT_EQ(dict.get("more_attr"), attr60);
+  EXPECT_TRUE(dict.contains("discardable"));
+  EXPECT_EQ(op->getAttrDictionary(), dict);
+
+  // Changing an attribute of either kind updates the dictionary.
+  op->setInherentAttr(requiredIndex, attr20);
+  EXPECT_EQ(op->getAttr("required_attr"), attr20);
+  EXPECT_EQ(op->getAttrDictionary().get("required_attr"), attr20);
+
+  EXPECT_EQ(op->removeAttr("more_attr"), attr60);
+  EXPECT_EQ(op->getInherentAttr(moreIndex), nullptr);
+  EXPECT_FALSE(op->getAttrDictionary().contains("more_attr"));
+
+  op->removeAttr("discardable");
+  EXPECT_EQ(op->getAttrs().size(), 1u);
+
+  op->destroy();
+}
+
+TEST(OperationAttrsTest, SetAttrsRoundTrip) {
+  MLIRContext context;
+  context.getOrLoadDialect<test::TestDialect>();
+  OpBuilder b(&context);
+  auto attr10 = b.getI32IntegerAttr(10);
+  auto attr60 = b.getI32IntegerAttr(60);
+  Operation *op = b.create<test::OpAttrMatch1>(b.getUnknownLoc(), attr10,
+                                               nullptr, nullptr, attr60);
+
+  auto attr30 = b.getI32IntegerAttr(30);
+  DictionaryAttr newAttrs = b.getDictionaryAttr(
+      {b.getNamedAttr("required_attr", attr30),
+       b.getNamedAttr("optional_attr", attr10),
+       b.getNamedAttr("discardable", b.getUnitAttr())});
+  op->setAttrs(newAttrs);
+  EXPECT_EQ(op->getAttrDictionary(), newAttrs);
+  EXPECT_EQ(op->getInherentAttr(getInherentAttrIndex(op, "required_attr")),
+            attr30);
+  EXPECT_EQ(op->getInherentAttr(getInherentAttrIndex(op, "optional_attr")),
+            attr10);
+  // The attributes missing from the new dictionary are removed.
+  EXPECT_EQ(op->getInherentAttr(getInherentAttrIndex(op, "more_attr")),
+            nullptr);
+  EXPECT_TRUE(op->hasAttr("discardable"));
+
+  op->setAttrs(op->getAttrDictionary());
+  EXPECT_EQ(op->getAttrDictionary(), newAttrs);
+
+  op->destroy();
+}
+
+TEST(OperationAttrsTest, CloneCopiesAttrs) {
+  MLIRContext context;
+  context.getOrLoadDialect<test::TestDialect>();
+  OpBuilder b(&context);
+  auto attr10 = b.getI32IntegerAttr(10);
+  auto attr60 = b.getI32IntegerAttr(60);
+  Operation *op = b.create<test::OpAttrMatch1>(b.getUnknownLoc(), attr10,
+                                               nullptr, nullptr, attr60);
+  op->setAttr("discardable", b.getUnitAttr());
+
+  Operation *clone = op->clone();
+  EXPECT_EQ(clone->getAttrDictionary(), op->getAttrDictionary());
+
+  // The clone has its own inherent attributes.
+  unsigned requiredIndex = getInherentAttrIndex(op, "required_attr");
+  clone->setInherentAttr(requiredIndex, attr60);
+  EXPECT_EQ(op->getInherentAttr(requiredIndex), attr10);
+  EXPECT_EQ(clone->getInherentAttr(requiredIndex), attr60);
+
+  clone->destroy();
+  op->destroy();
+}
+
+TEST(OperationAttrsTest, OpCreatedBeforeDialectIsLoaded) {
+  MLIRContext context;
+  context.allowUnregisteredDialects();
+  Builder b(&context);
+  auto attr10 = b.getI32IntegerAttr(10);
+  auto attr60 = b.getI32IntegerAttr(60);
+
+  OperationState state(b.getUnknownLoc(), "test.match_op_attribute1");
+  state.addAttribute("required_attr", attr10);
+  state.addAttribute("discardable", b.getUnitAttr());
+  state.addTypes(b.getI32Type());
+  Operation *op = Operation::create(state);
+
+  // Once the dialect is loaded, the inherent attributes of the operation are
+  // found in its dictionary.
+  context.getOrLoadDialect<test::TestDialect>();
+  unsigned requiredIndex = getInherentAttrIndex(op, "required_attr");
+  unsigned moreIndex = getInherentAttrIndex(op, "more_attr");
+  EXPECT_EQ(op->getInherentAttr(requiredIndex), attr10);
+  EXPECT_EQ(op->getInherentAttr(moreIndex), nullptr);
+
+  op->setInherentAttr(moreIndex, attr60);
+  EXPECT_EQ(op->getAttr("more_attr"), attr60);
+  EXPECT_EQ(op->getAttrDictionary().size(), 3u);
+  EXPECT_EQ(op->removeInherentAttr(requiredIndex), attr10);
+  EXPECT_FALSE(op->hasAttr("required_attr"));
+
+  // Clones get the inline storage.
+  Operation *clone = op->clone();
+  EXPECT_EQ(clone->getAttrDictionary(), op->getAttrDictionary());
+  EXPECT_EQ(clone->getInherentAttr(moreIndex), attr60);
+
+  clone->destroy();
+  op->destroy();
+}
 } // namespace
@@ -8,6 +8,7 @@
 
 #include "../../test/lib/Dialect/Test/TestAttributes.h"
 #include "../../test/lib/Dialect/Test/TestDialect.h"
+#include "mlir/IR/BuiltinAttributes.h"
 #include "mlir/Parser/Parser.h"
 
 #include "gmock/gmock.h"
@@ -72,4 +73,56 @@ TEST(MLIRParser, ResourceKeyConflict) {
       "blob1_1: "
       "\"0x08000000040000000000000005000000000000000600000000000000\""));
 }
+
+TEST(MLIRParser, DenseResourceRoundTrip) {
+  std::string moduleStr = R"mlir(
+    "test.use1"() {attr = dense_resource<blob1> : tensor<3xi64> } : () -> ()
+
+    {-#
+      dialect_resources: {
+        builtin: {
+          blob1: "0x08000000010000000000000002000000000000000300000000000000"
+        }
+      }
+    #-}
+  )mlir";
+
+  auto getData = [](ModuleOp module) {
+    Operation &use = module.getBody()->front();
+    auto attr = use.getAttrOfType<DenseResourceElementsAttr>("attr");
+    EXPECT_TRUE(attr);
+    Optional<ArrayRef<char>> data = attr ? attr.getData() : llvm::None;
+    EXPECT_TRUE(data);
+    return data ? ArrayRef<int64_t>((const int64_t *)data->data(),
+                                    data->size() / sizeof(int64_t))
+                : ArrayRef<int64_t>();
+  };
+
+  MLIRContext context;
+  context.loadDialect<test::TestDialect>();
+  OwningOpRef<ModuleOp> module =
+      parseSourceString<ModuleOp>(moduleStr, &context);
+  ASSERT_TRUE(module);
+  EXPECT_EQ(getData(*module), llvm::makeArrayRef<int64_t>({1, 2, 3}));
+
+  // The data is printed back in the resource section.
+  std::string outputStr;
+  {
+    llvm::raw_string_ostream os(outputStr);
+    module->print(os);
+  }
+  StringRef output(outputStr);
+  EXPECT_TRUE(
+      output.contains("{attr = dense_resource<blob1> : tensor<3xi64>}"));
+  EXPECT_TRUE(output.contains(
+      "blob1: \"0x08000000010000000000000002000000000000000300000000000000\""));
+
+  // Parse the printed module into a new context.
+  MLIRContext newContext;
+  newContext.loadDialect<test::TestDialect>();
+  OwningOpRef<ModuleOp> newModule =
+      parseSourceString<ModuleOp>(outputStr, &newContext);
+  ASSERT_TRUE(newModule);
+  EXPECT_EQ(getData(*newModule), llvm::makeArrayRef<int64_t>({1, 2, 3}));
+}
 } // namespace
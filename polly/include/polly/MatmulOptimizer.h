@@ -21,7 +21,10 @@ class Dependences;
 /// Apply the BLIS matmul optimization pattern if possible.
 ///
 /// Make the loops containing the matrix multiplication be the innermost
-/// loops and apply the BLIS matmul optimization pattern. BLIS implements
+/// loops and apply the BLIS matmul optimization pattern. Tensor contractions,
+/// including batched matrix multiplications, are optimized as sequences of
+/// matrix multiplications of one free index of each operand and one
+/// contracted index (see -polly-tc-opt). BLIS implements
 /// gemm as three nested loops around a macro-kernel, plus two packing
 /// routines. The macro-kernel is implemented in terms of two additional
 /// loops around a micro-kernel. The micro-kernel is a loop around a rank-1
@@ -0,0 +1,60 @@
+//===------ ScheduleCache.h -------------------------------------*- C++ -*-===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// On-disk cache of the schedules computed by the isl scheduler.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef POLLY_SCHEDULECACHE_H
+#define POLLY_SCHEDULECACHE_H
+
+#include "llvm/ADT/StringRef.h"
+#include "isl/isl-noexceptions.h"
+#include <string>
+
+namespace polly {
+class Scop;
+
+/// Compute a schedule that respects the schedule constraints @p SC of the
+/// SCoP @p S, using the isl scheduler options currently set in the isl
+/// context of @p S.
+///
+/// If -polly-schedule-cache-dir is set, the schedule is looked up in the
+/// cache in this directory first. The key of a cache entry consists of the
+/// schedule constraints, i.e., the domain and the dependences of the SCoP,
+/// the scheduler options, and the isl version, so the same SCoP in another
+/// translation unit or another build reuses the schedule. Newly computed
+/// schedules are stored in the cache.
+///
+/// @param S  The SCoP to be scheduled.
+/// @param SC The schedule constraints of @p S.
+///
+/// @return The schedule, or NULL if the isl scheduler failed.
+isl::schedule computeScheduleWithCache(Scop &S, isl::schedule_constraints SC);
+
+/// Return the key of the cache entry of the schedule computed from @p SC with
+/// the isl scheduler options currently set in the isl context of @p SC.
+std::string getScheduleCacheKey(isl::schedule_constraints SC);
+
+/// Rebuild the schedule @p Cached, which has been read from the cache, with
+/// the ids of the parameters in @p ParamSpace and of the statements in
+/// @p Domain. Parameters and statements are identified by their names.
+///
+/// @return The schedule, or NULL if the names are not unique or the domain of
+///         @p Cached does not match @p Domain.
+isl::schedule rebindCachedSchedule(isl::space ParamSpace,
+                                   isl::union_set Domain, isl::schedule Cached);
+
+/// Prune the cache in the directory @p Dir according to @p Policy, which has
+/// the format of -thinlto-cache-policy.
+///
+/// @return Whether the cache has been pruned.
+bool pruneScheduleCache(llvm::StringRef Dir, llvm::StringRef Policy);
+} // namespace polly
+
+#endif /* POLLY_SCHEDULECACHE_H */
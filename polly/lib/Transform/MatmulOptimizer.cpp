@@ -16,6 +16,7 @@
 #include "polly/Support/ISLTools.h"
 #include "llvm/ADT/ArrayRef.h"
 #include "llvm/ADT/Optional.h"
+#include "llvm/ADT/STLExtras.h"
 #include "llvm/ADT/Sequence.h"
 #include "llvm/ADT/SmallVector.h"
 #include "llvm/ADT/StringRef.h"
@@ -126,6 +127,12 @@ static cl::opt<int> PollyPatternMatchingNcQuotient(
              "macro-kernel, by Nr, the parameter of the micro-kernel"),
     cl::Hidden, cl::init(256), cl::cat(PollyCategory));
 
+static cl::opt<bool>
+    PMBasedTCOpts("polly-tc-opt",
+                  cl::desc("Perform optimizations of tensor contractions based "
+                           "on pattern matching"),
+                  cl::Hidden, cl::init(true), cl::cat(PollyCategory));
+
 namespace {
 /// Parameters of the micro kernel.
 ///
@@ -160,6 +167,37 @@ struct MatMulInfoTy {
   int k = -1;
 };
 
+/// Parameters of the tensor contraction operands.
+///
+/// A tensor contraction has the form
+///
+///   C(shuffle(N, I, J)) += A(shuffle(N, I, P)) * B(shuffle(N, P, J))
+///
+/// where I and J are the bundles of free indices of A and B, P is the bundle
+/// of contracted indices, N is a possibly empty bundle of batch indices that
+/// are shared by all three tensors, and shuffle() is any permutation of the
+/// enclosed indices. The matrix multiplication is the tensor contraction
+/// whose bundles I, J, and P contain a single index each and whose bundle N
+/// is empty.
+///
+/// Each index is an input dimension of the SCoP statement. The indices of
+/// a bundle are sorted in increasing order, i.e., from the outermost to the
+/// innermost loop.
+struct TCInfoTy {
+  MemoryAccess *A = nullptr;
+  MemoryAccess *B = nullptr;
+  MemoryAccess *ReadFromC = nullptr;
+  MemoryAccess *WriteToC = nullptr;
+  SmallVector<int, 4> I;
+  SmallVector<int, 4> J;
+  SmallVector<int, 4> P;
+  SmallVector<int, 4> N;
+
+  /// The indices that are used as subscripts of C, in the order of the
+  /// subscripts.
+  SmallVector<int, 4> CSubscripts;
+};
+
 /// Create an isl::union_set, which describes the option of the form
 /// [isolate[] -> unroll[x]].
 ///
@@ -430,6 +468,195 @@ static bool containsMatrMult(isl::map PartialSchedule, const Dependences *D,
   return true;
 }
 
+/// Check the form of the access relation to an operand of a tensor
+/// contraction.
+///
+/// Check that the access relation @p AccMap has the form
+/// S(i0, ..., in) -> M(ip0, ..., ipm) on the whole @p Domain, where
+/// ip0, ..., ipm are pairwise different input dimensions.
+///
+/// @param Domain     The domain of the SCoP statement.
+/// @param AccMap     The access relation to be checked.
+/// @param Subscripts The input dimensions that are mapped to the output
+///                   dimensions of @p AccMap, in the order of the output
+///                   dimensions.
+/// @return           True in case @p AccMap has the expected form and false,
+///                   otherwise.
+static bool isTCOperandAcc(isl::set Domain, isl::map AccMap,
+                           SmallVectorImpl<int> &Subscripts) {
+  isl::space Space = AccMap.get_space();
+  unsigned InDimNum = unsignedFromIslSize(Space.dim(isl::dim::in));
+  unsigned OutDimNum = unsignedFromIslSize(Space.dim(isl::dim::out));
+  if (OutDimNum == 0 || OutDimNum > InDimNum)
+    return false;
+
+  AccMap = AccMap.intersect_domain(Domain);
+  isl::map Universe = isl::map::universe(Space).intersect_domain(Domain);
+  isl::map PossibleTCOperand = Universe;
+  Subscripts.clear();
+  for (unsigned Out = 0; Out < OutDimNum; Out++) {
+    int Subscript = -1;
+    for (unsigned In = 0; In < InDimNum; In++) {
+      if (!AccMap.is_subset(
+              Universe.equate(isl::dim::in, In, isl::dim::out, Out)))
+        continue;
+      // The domain makes several input dimensions equal. Give up rather than
+      // guess which one is the index.
+      if (Subscript != -1)
+        return false;
+      Subscript = In;
+    }
+    if (Subscript == -1 || is_contained(Subscripts, Subscript))
+      return false;
+    Subscripts.push_back(Subscript);
+    PossibleTCOperand =
+        PossibleTCOperand.equate(isl::dim::in, Subscript, isl::dim::out, Out);
+  }
+
+  // As in the case of the matrix multiplication, partial accesses are
+  // rejected.
+  return AccMap.is_equal(PossibleTCOperand);
+}
+
+/// Check for dependencies corresponding to the tensor contraction.
+///
+/// Check that all dependencies of the SCoP statement represented by
+/// @p Schedule have the form S(..., p, ...) -> S(..., p', ...), where only
+/// the contracted indices @p P may differ. In this case, the loops of all
+/// indices can be permuted as long as the contracted indices keep their
+/// relative order.
+///
+/// @param  Schedule The schedule of the SCoP statement.
+/// @param  D        The SCoP dependencies.
+/// @param  P        The contracted indices.
+/// @return True in case dependencies correspond to the tensor contraction
+///         and false, otherwise.
+static bool containsOnlyTCDep(isl::map Schedule, const Dependences *D,
+                              ArrayRef<int> P) {
+  isl::union_map Dep =
+      D->getDependences(Dependences::TYPE_RAW | Dependences::TYPE_WAR |
+                        Dependences::TYPE_WAW);
+  isl::union_map Red = D->getDependences(Dependences::TYPE_RED);
+  if (!Red.is_null())
+    Dep = Dep.unite(Red);
+  auto DomainSpace = Schedule.get_space().domain();
+  auto Space = DomainSpace.map_from_domain_and_range(DomainSpace);
+  isl::map PossibleTCDep = isl::map::universe(Space);
+  int DimNum = unsignedFromIslSize(DomainSpace.dim(isl::dim::set));
+  for (int Dim = 0; Dim < DimNum; Dim++)
+    if (!is_contained(P, Dim))
+      PossibleTCDep =
+          PossibleTCDep.equate(isl::dim::in, Dim, isl::dim::out, Dim);
+  return Dep.extract_map(Space).is_subset(PossibleTCDep);
+}
+
+/// Check that the memory access is invariant in all loops of the band
+/// described by @p PartialSchedule.
+static bool isTCInvariantAcc(MemoryAccess *MemAccess,
+                             isl::map PartialSchedule) {
+  unsigned OutDimNum = unsignedFromIslSize(PartialSchedule.range_tuple_dim());
+  for (unsigned Dim = 0; Dim < OutDimNum; Dim++)
+    if (!MemAccess->isStrideZero(permuteDimensions(
+            PartialSchedule, isl::dim::out, Dim, OutDimNum - 1)))
+      return false;
+  return true;
+}
+
+/// Check if the SCoP statement represents a tensor contraction.
+///
+/// containsTC tries to determine whether the following conditions are true:
+/// 1. The last memory access modeling an array, WriteToC, represents writing
+///    to memory and has the form described in isTCOperandAcc.
+/// 2. There is a read access ReadFromC with the same access relation, two
+///    read accesses A and B to other arrays that have the form described in
+///    isTCOperandAcc, and all other memory accesses modeling arrays are
+///    invariant in the loops of the band.
+/// 3. Each input dimension is a subscript of exactly two of the tensors A,
+///    B, and C, or of all three of them, and there is at least one free index
+///    of A, one free index of B and one contracted index.
+/// 4. The dependencies have the form described in containsOnlyTCDep.
+///
+/// @param PartialSchedule The PartialSchedule that contains a SCoP statement
+///        to check.
+/// @param D   The SCoP dependencies.
+/// @param TCI Parameters of the tensor contraction operands.
+static bool containsTC(isl::map PartialSchedule, const Dependences *D,
+                       TCInfoTy &TCI) {
+  auto InputDimsId = PartialSchedule.get_tuple_id(isl::dim::in);
+  auto *Stmt = static_cast<ScopStmt *>(InputDimsId.get_user());
+  if (Stmt->size() <= 1)
+    return false;
+
+  isl::set Domain = Stmt->getDomain();
+  auto Accesses = getAccessesInOrder(*Stmt);
+  for (auto *MemA = Accesses.end() - 1; MemA != Accesses.begin(); MemA--) {
+    auto *MemAccessPtr = *MemA;
+    if (!MemAccessPtr->isLatestArrayKind())
+      continue;
+    if (!MemAccessPtr->isWrite() ||
+        !isTCOperandAcc(Domain, MemAccessPtr->getLatestAccessRelation(),
+                        TCI.CSubscripts))
+      return false;
+    TCI.WriteToC = MemAccessPtr;
+    break;
+  }
+  if (!TCI.WriteToC)
+    return false;
+
+  const ScopArrayInfo *ArrayC = TCI.WriteToC->getLatestScopArrayInfo();
+  SmallVector<int, 4> ASubscripts;
+  SmallVector<int, 4> BSubscripts;
+  for (MemoryAccess *MemAccessPtr : Accesses) {
+    if (!MemAccessPtr->isLatestArrayKind() || MemAccessPtr == TCI.WriteToC)
+      continue;
+    SmallVector<int, 4> Subscripts;
+    if (MemAccessPtr->isRead() &&
+        isTCOperandAcc(Domain, MemAccessPtr->getLatestAccessRelation(),
+                       Subscripts)) {
+      bool IsArrayC = MemAccessPtr->getLatestScopArrayInfo() == ArrayC;
+      if (IsArrayC && !TCI.ReadFromC && Subscripts == TCI.CSubscripts) {
+        TCI.ReadFromC = MemAccessPtr;
+        continue;
+      }
+      if (!IsArrayC && !TCI.A) {
+        TCI.A = MemAccessPtr;
+        ASubscripts = Subscripts;
+        continue;
+      }
+      if (!IsArrayC && !TCI.B) {
+        TCI.B = MemAccessPtr;
+        BSubscripts = Subscripts;
+        continue;
+      }
+    }
+    if (!isTCInvariantAcc(MemAccessPtr, PartialSchedule))
+      return false;
+  }
+  if (!TCI.A || !TCI.B || !TCI.ReadFromC)
+    return false;
+
+  int DimNum = unsignedFromIslSize(Domain.tuple_dim());
+  for (int Dim = 0; Dim < DimNum; Dim++) {
+    bool InA = is_contained(ASubscripts, Dim);
+    bool InB = is_contained(BSubscripts, Dim);
+    bool InC = is_contained(TCI.CSubscripts, Dim);
+    if (InA && InB && InC)
+      TCI.N.push_back(Dim);
+    else if (InA && InB)
+      TCI.P.push_back(Dim);
+    else if (InA && InC)
+      TCI.I.push_back(Dim);
+    else if (InB && InC)
+      TCI.J.push_back(Dim);
+    else
+      return false;
+  }
+  if (TCI.I.empty() || TCI.J.empty() || TCI.P.empty())
+    return false;
+
+  return containsOnlyTCDep(PartialSchedule, D, TCI.P);
+}
+
 /// Permute two dimensions of the band node.
 ///
 /// Permute FirstDim and SecondDim dimensions of the Node.
@@ -655,12 +882,24 @@ getMacroKernelParams(const llvm::TargetTransformInfo *TTI,
   return {Mc, Nc, Kc};
 }
 
+/// Get the number of dimensions of @p MapOldIndVar that precede the nine
+/// dimensions produced by the creation of the BLIS kernels.
+///
+/// These are the dimensions of the loops that surround the matrix
+/// multiplication, e.g., the batch loops of a tensor contraction.
+static unsigned getMatMulOuterDimNum(isl::map MapOldIndVar) {
+  unsigned Dim = unsignedFromIslSize(MapOldIndVar.range_tuple_dim());
+  assert(Dim >= 9);
+  return Dim - 9;
+}
+
 /// Create an access relation that is specific to
 ///        the matrix multiplication pattern.
 ///
 /// Create an access relation of the following form:
 /// [O0, O1, O2, O3, O4, O5, O6, O7, O8] -> [OI, O5, OJ]
-/// where I is @p FirstDim, J is @p SecondDim.
+/// where I is @p FirstDim, J is @p SecondDim. The dimensions of the outer
+/// loops that precede O0 are ignored.
 ///
 /// It can be used, for example, to create relations that helps to consequently
 /// access elements of operands of a matrix multiplication after creation of
@@ -683,11 +922,14 @@ getMacroKernelParams(const llvm::TargetTransformInfo *TTI,
 /// @return The specified access relation.
 static isl::map getMatMulAccRel(isl::map MapOldIndVar, unsigned FirstDim,
                                 unsigned SecondDim) {
-  auto AccessRelSpace = isl::space(MapOldIndVar.ctx(), 0, 9, 3);
+  unsigned OuterDimNum = getMatMulOuterDimNum(MapOldIndVar);
+  auto AccessRelSpace = isl::space(MapOldIndVar.ctx(), 0, OuterDimNum + 9, 3);
   auto AccessRel = isl::map::universe(AccessRelSpace);
-  AccessRel = AccessRel.equate(isl::dim::in, FirstDim, isl::dim::out, 0);
-  AccessRel = AccessRel.equate(isl::dim::in, 5, isl::dim::out, 1);
-  AccessRel = AccessRel.equate(isl::dim::in, SecondDim, isl::dim::out, 2);
+  AccessRel = AccessRel.equate(isl::dim::in, OuterDimNum + FirstDim,
+                               isl::dim::out, 0);
+  AccessRel = AccessRel.equate(isl::dim::in, OuterDimNum + 5, isl::dim::out, 1);
+  AccessRel = AccessRel.equate(isl::dim::in, OuterDimNum + SecondDim,
+                               isl::dim::out, 2);
   return MapOldIndVar.apply_range(AccessRel);
 }
 
@@ -725,9 +967,10 @@ static isl::schedule_node optimizePackedB(isl::schedule_node Node,
   MMI.B->setNewAccessRelation(AccRelPackedB);
 
   unsigned Dim = unsignedFromIslSize(MapOldIndVar.range_tuple_dim());
-  assert(Dim >= 2);
+  unsigned OuterDimNum = getMatMulOuterDimNum(MapOldIndVar);
   // Insert into the schedule tree.
-  isl::map ExtMap = MapOldIndVar.project_out(isl::dim::out, 2, Dim - 2);
+  isl::map ExtMap = MapOldIndVar.project_out(isl::dim::out, OuterDimNum + 2,
+                                             Dim - OuterDimNum - 2);
   ExtMap = ExtMap.reverse();
   ExtMap = ExtMap.fix_si(isl::dim::out, MMI.i, 0);
   ExtMap = ExtMap.intersect_range(Domain);
@@ -763,13 +1006,16 @@ static isl::schedule_node optimizePackedA(isl::schedule_node Node, ScopStmt *,
 
   // Compute the domain for the copy statement.
   // Construct the copy statement domain out of the 3 outermost scatter
-  // dimensions (to match the 3 band nodes surrounding the extension node) and
-  // the array elements to copy (one statement instance per array element).
+  // dimensions of the kernels (to match the 3 band nodes surrounding the
+  // extension node), the scatter dimensions of the loops surrounding the
+  // kernels, if any, and the array elements to copy (one statement instance
+  // per array element).
   // { Scatter[] }
   isl::set ScatterDomain = MapOldIndVar.intersect_domain(Domain).range();
+  unsigned OuterDimNum = getMatMulOuterDimNum(MapOldIndVar);
   // { Scatter[] -> OutermostScatter[] }
-  isl::map OuterDomainMap =
-      makeIdentityMap(ScatterDomain, true).project_out(isl::dim::out, 3, 6);
+  isl::map OuterDomainMap = makeIdentityMap(ScatterDomain, true)
+                                .project_out(isl::dim::out, OuterDimNum + 3, 6);
   // { Scatter[] -> MemrefA[] }
   isl::map CopyFrom = MapOldIndVar.reverse().apply_range(AccRelA);
   // { Scatter[] -> CopyStmt[] }
@@ -791,7 +1037,9 @@ static isl::schedule_node optimizePackedA(isl::schedule_node Node, ScopStmt *,
   // Insert into the schedule tree.
   // { Scatter[] -> CopyStmt[] }
   isl::map ExtScatterCopy = makeIdentityMap(CopyStmt->getDomain(), true);
-  ExtScatterCopy = ExtScatterCopy.project_out(isl::dim::in, 3, 2);
+  ExtScatterCopy = ExtScatterCopy.project_out(
+      isl::dim::in, OuterDimNum + 3,
+      unsignedFromIslSize(AccRelA.range_tuple_dim()));
   return createExtensionNode(Node, ExtScatterCopy);
 }
 
@@ -852,6 +1100,10 @@ optimizeDataLayoutMatrMulPattern(isl::schedule_node Node, isl::map MapOldIndVar,
 /// Get a relation mapping induction variables produced by schedule
 /// transformations to the original ones.
 ///
+/// The range of the relation consists of the dimensions of the loops that
+/// surround the BLIS kernels, if any, followed by the nine dimensions of the
+/// kernels.
+///
 /// @param Node The schedule node produced as the result of creation
 ///        of the BLIS kernels.
 /// @param MicroKernelParams, MacroKernelParams Parameters of the BLIS kernel
@@ -867,11 +1119,7 @@ getInductionVariablesSubstitution(isl::schedule_node Node,
                                   MacroKernelParamsTy MacroKernelParams) {
   auto Child = Node.child(0);
   auto UnMapOldIndVar = Child.get_prefix_schedule_union_map();
-  auto MapOldIndVar = isl::map::from_union_map(UnMapOldIndVar);
-  unsigned Dim = unsignedFromIslSize(MapOldIndVar.range_tuple_dim());
-  if (Dim > 9u)
-    return MapOldIndVar.project_out(isl::dim::out, 0, Dim - 9);
-  return MapOldIndVar;
+  return isl::map::from_union_map(UnMapOldIndVar);
 }
 
 /// Isolate a set of partial tile prefixes and unroll the isolated part.
@@ -951,21 +1199,44 @@ getBandNodeWithOriginDimOrder(isl::schedule_node Node) {
   return Node.insert_partial_schedule(PartialScheduleMultiPwAff);
 }
 
-static isl::schedule_node optimizeMatMulPattern(isl::schedule_node Node,
-                                                const TargetTransformInfo *TTI,
-                                                MatMulInfoTy &MMI) {
-  assert(TTI && "The target transform info should be provided.");
+/// Recreate the band node with the dimensions of the iteration domain in the
+/// order given by @p DimOrder.
+///
+/// @param Node     The band node to be modified. It is required to represent
+///                 all the dimensions of the iteration domain.
+/// @param DimOrder The input dimensions in the order of the new band members.
+/// @return The modified schedule node.
+static isl::schedule_node getBandNodeWithDimOrder(isl::schedule_node Node,
+                                                  ArrayRef<int> DimOrder) {
+  assert(isl_schedule_node_get_type(Node.get()) == isl_schedule_node_band);
+  auto Domain = Node.get_universe_domain();
+  assert(isl_union_set_n_set(Domain.get()) == 1);
+  assert(unsignedFromIslSize(isl::set(Domain).tuple_dim()) == DimOrder.size());
+  Node = isl::manage(isl_schedule_node_delete(Node.copy()));
+  auto Identity = isl::multi_union_pw_aff(Domain.identity_union_pw_multi_aff())
+                      .reset_tuple_id(isl::dim::set);
+  auto PartialSchedule = Identity;
+  for (auto Pos : seq<unsigned>(0, DimOrder.size()))
+    PartialSchedule =
+        PartialSchedule.set_union_pw_aff(Pos, Identity.at(DimOrder[Pos]));
+  return Node.insert_partial_schedule(PartialSchedule);
+}
+
+/// Apply the BLIS kernels to the band node, whose three innermost dimensions
+/// represent the i, j, and k loops of the matrix multiplication.
+///
+/// In case the band node has more than three dimensions, its outer
+/// dimensions are split off into a separate band node that surrounds the
+/// kernels.
+static isl::schedule_node createMatMulKernels(isl::schedule_node Node,
+                                              const TargetTransformInfo *TTI,
+                                              MatMulInfoTy &MMI) {
   int DimOutNum = isl_schedule_node_band_n_member(Node.get());
-  assert(DimOutNum > 2 && "In case of the matrix multiplication the loop nest "
-                          "and, consequently, the corresponding scheduling "
-                          "functions have at least three dimensions.");
-  Node = getBandNodeWithOriginDimOrder(Node);
-  Node = permuteBandNodeDimensions(Node, MMI.i, DimOutNum - 3);
-  int NewJ = MMI.j == DimOutNum - 3 ? MMI.i : MMI.j;
-  int NewK = MMI.k == DimOutNum - 3 ? MMI.i : MMI.k;
-  Node = permuteBandNodeDimensions(Node, NewJ, DimOutNum - 2);
-  NewK = NewK == DimOutNum - 2 ? NewJ : NewK;
-  Node = permuteBandNodeDimensions(Node, NewK, DimOutNum - 1);
+  if (DimOutNum > 3) {
+    Node = isl::manage(
+        isl_schedule_node_band_split(Node.release(), DimOutNum - 3));
+    Node = Node.child(0);
+  }
   auto MicroKernelParams = getMicroKernelParams(TTI, MMI);
   auto MacroKernelParams = getMacroKernelParams(TTI, MicroKernelParams, MMI);
   Node = createMacroKernel(Node, MacroKernelParams);
@@ -983,6 +1254,85 @@ static isl::schedule_node optimizeMatMulPattern(isl::schedule_node Node,
                                           MacroKernelParams, MMI);
 }
 
+static isl::schedule_node optimizeMatMulPattern(isl::schedule_node Node,
+                                                const TargetTransformInfo *TTI,
+                                                MatMulInfoTy &MMI) {
+  assert(TTI && "The target transform info should be provided.");
+  int DimOutNum = isl_schedule_node_band_n_member(Node.get());
+  assert(DimOutNum > 2 && "In case of the matrix multiplication the loop nest "
+                          "and, consequently, the corresponding scheduling "
+                          "functions have at least three dimensions.");
+  Node = getBandNodeWithOriginDimOrder(Node);
+  Node = permuteBandNodeDimensions(Node, MMI.i, DimOutNum - 3);
+  int NewJ = MMI.j == DimOutNum - 3 ? MMI.i : MMI.j;
+  int NewK = MMI.k == DimOutNum - 3 ? MMI.i : MMI.k;
+  Node = permuteBandNodeDimensions(Node, NewJ, DimOutNum - 2);
+  NewK = NewK == DimOutNum - 2 ? NewJ : NewK;
+  Node = permuteBandNodeDimensions(Node, NewK, DimOutNum - 1);
+  return createMatMulKernels(Node, TTI, MMI);
+}
+
+/// Apply the BLIS matmul optimization pattern to a tensor contraction.
+///
+/// The tensor contraction is computed as a sequence of matrix
+/// multiplications. One free index of A, one free index of B, and the
+/// innermost contracted index become the i, j, and k loops of the matrix
+/// multiplication, to which the BLIS macro-kernel, micro-kernel, and packing
+/// are applied. The loops of all other indices surround the kernels in their
+/// original order. Since the contracted indices keep their relative order,
+/// each element of C is computed by the same sequence of updates as before
+/// the transformation.
+///
+/// The j loop should traverse C and the packed B in-stride. For this reason,
+/// the innermost subscript of C, which is not a batch index, is chosen as j,
+/// swapping the roles of A and B if necessary, and the innermost of the
+/// remaining subscripts of C is chosen as i.
+///
+/// @param Node The band node to be optimized. It is required to pass
+///             isTCPattern.
+/// @param TTI  Target Transform Info.
+/// @param TCI  Parameters of the tensor contraction operands.
+/// @return The optimized schedule node.
+static isl::schedule_node optimizeTCPattern(isl::schedule_node Node,
+                                            const TargetTransformInfo *TTI,
+                                            const TCInfoTy &TCI) {
+  assert(TTI && "The target transform info should be provided.");
+  MatMulInfoTy MMI;
+  MMI.A = TCI.A;
+  MMI.B = TCI.B;
+  MMI.ReadFromC = TCI.ReadFromC;
+  MMI.WriteToC = TCI.WriteToC;
+  ArrayRef<int> I = TCI.I;
+  ArrayRef<int> J = TCI.J;
+  auto InnermostSubscriptOfC = [&TCI](ArrayRef<int> Indices) {
+    for (int Subscript : reverse(TCI.CSubscripts))
+      if (is_contained(Indices, Subscript))
+        return Subscript;
+    llvm_unreachable("Free indices are subscripts of C");
+  };
+  auto IsFree = [&](int Subscript) {
+    return is_contained(I, Subscript) || is_contained(J, Subscript);
+  };
+  auto InnermostFree = find_if(reverse(TCI.CSubscripts), IsFree);
+  assert(InnermostFree != TCI.CSubscripts.rend());
+  if (is_contained(I, *InnermostFree)) {
+    std::swap(MMI.A, MMI.B);
+    std::swap(I, J);
+  }
+  MMI.i = InnermostSubscriptOfC(I);
+  MMI.j = InnermostSubscriptOfC(J);
+  MMI.k = TCI.P.back();
+
+  SmallVector<int, 8> DimOrder;
+  int DimNum = isl_schedule_node_band_n_member(Node.get());
+  for (int Dim = 0; Dim < DimNum; Dim++)
+    if (Dim != MMI.i && Dim != MMI.j && Dim != MMI.k)
+      DimOrder.push_back(Dim);
+  DimOrder.append({MMI.i, MMI.j, MMI.k});
+  Node = getBandNodeWithDimOrder(Node, DimOrder);
+  return createMatMulKernels(Node, TTI, MMI);
+}
+
 /// Check if this node contains a partial schedule that could
 ///        probably be optimized with analytical modeling.
 ///
@@ -1021,6 +1371,33 @@ static bool isMatrMultPattern(isl::schedule_node Node, const Dependences *D,
   return false;
 }
 
+/// Check if this node contains a partial schedule that represents a tensor
+/// contraction.
+///
+/// isTCPattern checks that the partial schedule contains only one statement,
+/// whose input dimensions are all represented by the band node, and that
+/// the statement is a tensor contraction as described in containsTC.
+///
+/// @param Node The node to check.
+/// @param D    The SCoP dependencies.
+/// @param TCI  Parameters of the tensor contraction operands.
+static bool isTCPattern(isl::schedule_node Node, const Dependences *D,
+                        TCInfoTy &TCI) {
+  auto PartialSchedule = isl::manage(
+      isl_schedule_node_band_get_partial_schedule_union_map(Node.get()));
+  if (isl_schedule_node_get_type(Node.child(0).get()) !=
+          isl_schedule_node_leaf ||
+      isl_schedule_node_band_n_member(Node.get()) < 3 ||
+      Node.get_schedule_depth().release() != 0 ||
+      isl_union_map_n_map(PartialSchedule.get()) != 1)
+    return false;
+  auto NewPartialSchedule = isl::map::from_union_map(PartialSchedule);
+  if (unsignedFromIslSize(NewPartialSchedule.domain_tuple_dim()) !=
+      unsignedFromIslSize(NewPartialSchedule.range_tuple_dim()))
+    return false;
+  return containsTC(NewPartialSchedule, D, TCI);
+}
+
 } // namespace
 
 isl::schedule_node
@@ -1032,5 +1409,10 @@ polly::tryOptimizeMatMulPattern(isl::schedule_node Node,
     LLVM_DEBUG(dbgs() << "The matrix multiplication pattern was detected\n");
     return optimizeMatMulPattern(Node, TTI, MMI);
   }
+  TCInfoTy TCI;
+  if (PMBasedTCOpts && isTCPattern(Node, D, TCI)) {
+    LLVM_DEBUG(dbgs() << "The tensor contraction pattern was detected\n");
+    return optimizeTCPattern(Node, TTI, TCI);
+  }
   return {};
 }
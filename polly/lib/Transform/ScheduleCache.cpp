@@ -0,0 +1,329 @@
+//===------ ScheduleCache.cpp ---------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+//
+// On-disk cache of the schedules computed by the isl scheduler.
+//
+// Computing a schedule is often the most expensive part of optimizing a SCoP.
+// The same SCoPs are however scheduled again and again, in incremental builds
+// and in inline functions from headers that are included by many translation
+// units. The cache stores each computed schedule in its string representation
+// under a key derived from the input of the isl scheduler. Since the isl ids
+// of parameters and statements carry pointers to LLVM objects, which are lost
+// in the string representation, the ids of a schedule read from the cache are
+// replaced by the ids of the SCoP with the same names.
+//
+//===----------------------------------------------------------------------===//
+
+#include "polly/ScheduleCache.h"
+#include "polly/Options.h"
+#include "polly/ScopInfo.h"
+#include "polly/Support/GICHelper.h"
+#include "polly/Support/ISLTools.h"
+#include "llvm/ADT/Statistic.h"
+#include "llvm/ADT/StringExtras.h"
+#include "llvm/ADT/StringMap.h"
+#include "llvm/Support/CachePruning.h"
+#include "llvm/Support/Caching.h"
+#include "llvm/Support/Debug.h"
+#include "llvm/Support/MemoryBuffer.h"
+#include "llvm/Support/SHA1.h"
+#include "isl/schedule.h"
+#include "isl/version.h"
+#include <atomic>
+
+#define DEBUG_TYPE "polly-schedule-cache"
+
+using namespace llvm;
+using namespace polly;
+
+static cl::opt<std::string> ScheduleCacheDir(
+    "polly-schedule-cache-dir",
+    cl::desc("Directory of an on-disk cache of the schedules computed by the "
+             "isl scheduler (disabled if empty)"),
+    cl::Hidden, cl::init(""), cl::cat(PollyCategory));
+
+static cl::opt<std::string> ScheduleCachePolicy(
+    "polly-schedule-cache-policy",
+    cl::desc("Pruning policy of the schedule cache, in the format of "
+             "-thinlto-cache-policy"),
+    cl::Hidden, cl::init(""), cl::cat(PollyCategory));
+
+STATISTIC(ScheduleCacheHits, "Number of schedules read from the cache");
+STATISTIC(ScheduleCacheMisses, "Number of schedules not found in the cache");
+
+/// Version of the format of cache entries and of their keys.
+static const char *const ScheduleCacheVersion = "polly-schedule-cache-v1";
+
+namespace {
+/// Replaces the ids of parameters and statements in isl objects that have
+/// been read from a string by the ids of the SCoP with the same names.
+class IdRebinder {
+  StringMap<isl::id> ParamIds;
+  StringMap<isl::id> StmtIds;
+  bool IsValid = true;
+
+  isl::id lookup(const StringMap<isl::id> &Ids, const char *Name) const {
+    if (!Name)
+      return {};
+    auto It = Ids.find(Name);
+    return It == Ids.end() ? isl::id() : It->second;
+  }
+
+public:
+  IdRebinder(isl::space ParamSpace, isl::union_set Domain) {
+    for (unsigned i : rangeIslSize(0, ParamSpace.dim(isl::dim::param))) {
+      isl::id Id = ParamSpace.get_dim_id(isl::dim::param, i);
+      IsValid &= ParamIds.try_emplace(Id.get_name(), Id).second;
+    }
+    for (isl::set Set : Domain.get_set_list()) {
+      isl::id Id = Set.get_tuple_id();
+      IsValid &= StmtIds.try_emplace(Id.get_name(), Id).second;
+    }
+  }
+
+  /// Return whether the names of the parameters and statements are unique,
+  /// which is required to identify them.
+  bool isValid() const { return IsValid; }
+
+  /// Rebind the parameters and the input tuple of @p Map. Return NULL if one
+  /// of them does not exist in the SCoP.
+  isl::map rebind(isl::map Map) const {
+    isl_map *Result = Map.release();
+    isl_size NumParams = isl_map_dim(Result, isl_dim_param);
+    for (isl_size i = 0; i < NumParams; i++) {
+      isl::id Id =
+          lookup(ParamIds, isl_map_get_dim_name(Result, isl_dim_param, i));
+      if (Id.is_null()) {
+        isl_map_free(Result);
+        return {};
+      }
+      Result = isl_map_set_dim_id(Result, isl_dim_param, i, Id.release());
+    }
+    isl::id Id = lookup(StmtIds, isl_map_get_tuple_name(Result, isl_dim_in));
+    if (Id.is_null()) {
+      isl_map_free(Result);
+      return {};
+    }
+    return isl::manage(isl_map_set_tuple_id(Result, isl_dim_in, Id.release()));
+  }
+
+  isl::union_map rebind(isl::union_map UMap) const {
+    isl::union_map Result = isl::union_map::empty(UMap.ctx());
+    for (isl::map Map : UMap.get_map_list()) {
+      Map = rebind(Map);
+      if (Map.is_null())
+        return {};
+      Result = Result.unite(Map);
+    }
+    return Result;
+  }
+
+  isl::union_set rebind(isl::union_set USet) const {
+    isl::union_map Result = rebind(isl::union_map::from_domain(USet));
+    return Result.is_null() ? isl::union_set() : Result.domain();
+  }
+
+  isl::multi_union_pw_aff rebind(isl::multi_union_pw_aff MUPA) const {
+    isl::union_map Result = rebind(isl::union_map::from(MUPA));
+    if (Result.is_null())
+      return {};
+    return isl::multi_union_pw_aff::from_union_map(Result);
+  }
+};
+} // namespace
+
+/// Rebuild the subtree rooted at @p Cached, which is part of a schedule read
+/// from the cache, in place of the leaf @p Node.
+///
+/// Only the kinds of nodes produced by the isl scheduler are supported.
+///
+/// @return The root of the rebuilt subtree, or NULL in case of an error.
+static isl::schedule_node rebuildSubtree(isl::schedule_node Node,
+                                         isl::schedule_node Cached,
+                                         const IdRebinder &Rebinder) {
+  switch (isl_schedule_node_get_type(Cached.get())) {
+  case isl_schedule_node_leaf:
+    return Node;
+  case isl_schedule_node_band: {
+    auto CachedBand = Cached.as<isl::schedule_node_band>();
+    isl::multi_union_pw_aff PartialSchedule =
+        Rebinder.rebind(CachedBand.get_partial_schedule());
+    if (PartialSchedule.is_null())
+      return {};
+    auto Band = Node.insert_partial_schedule(PartialSchedule)
+                    .as<isl::schedule_node_band>();
+    Band = Band.set_permutable(CachedBand.permutable().is_true());
+    for (unsigned i : rangeIslSize(0, CachedBand.n_member()))
+      Band = Band.member_set_coincident(
+          i, CachedBand.member_get_coincident(i).is_true());
+    isl::schedule_node Child =
+        rebuildSubtree(Band.child(0), Cached.child(0), Rebinder);
+    return Child.is_null() ? Child : Child.parent();
+  }
+  case isl_schedule_node_sequence:
+  case isl_schedule_node_set: {
+    int NumChildren = isl_schedule_node_n_children(Cached.get());
+    isl::union_set_list Filters(Node.ctx(), NumChildren);
+    for (int i = 0; i < NumChildren; i++) {
+      isl::union_set Filter = Rebinder.rebind(
+          Cached.child(i).as<isl::schedule_node_filter>().get_filter());
+      if (Filter.is_null())
+        return {};
+      Filters = Filters.add(Filter);
+    }
+    if (isl_schedule_node_get_type(Cached.get()) == isl_schedule_node_sequence)
+      Node = Node.insert_sequence(Filters);
+    else
+      Node = Node.insert_set(Filters);
+    for (int i = 0; i < NumChildren; i++) {
+      isl::schedule_node Child = rebuildSubtree(
+          Node.child(i).child(0), Cached.child(i).child(0), Rebinder);
+      if (Child.is_null())
+        return {};
+      Node = Child.parent().parent();
+    }
+    return Node;
+  }
+  default:
+    return {};
+  }
+}
+
+isl::schedule polly::rebindCachedSchedule(isl::space ParamSpace,
+                                          isl::union_set Domain,
+                                          isl::schedule Cached) {
+  IdRebinder Rebinder(ParamSpace, Domain);
+  if (!Rebinder.isValid())
+    return {};
+  isl::union_set CachedDomain = Rebinder.rebind(Cached.get_domain());
+  if (CachedDomain.is_null() || !CachedDomain.is_equal(Domain))
+    return {};
+  isl::schedule_node Root = isl::schedule::from_domain(Domain).get_root();
+  isl::schedule_node Node =
+      rebuildSubtree(Root.child(0), Cached.get_root().child(0), Rebinder);
+  return Node.is_null() ? isl::schedule() : Node.get_schedule();
+}
+
+std::string polly::getScheduleCacheKey(isl::schedule_constraints SC) {
+  isl_ctx *Ctx = SC.ctx().get();
+  std::string Key;
+  raw_string_ostream OS(Key);
+  OS << ScheduleCacheVersion << '\n' << isl_version() << '\n';
+  OS << isl_options_get_schedule_max_coefficient(Ctx) << ' '
+     << isl_options_get_schedule_max_constant_term(Ctx) << ' '
+     << isl_options_get_schedule_maximize_band_depth(Ctx) << ' '
+     << isl_options_get_schedule_maximize_coincidence(Ctx) << ' '
+     << isl_options_get_schedule_outer_coincidence(Ctx) << ' '
+     << isl_options_get_schedule_split_scaled(Ctx) << ' '
+     << isl_options_get_schedule_treat_coalescing(Ctx) << ' '
+     << isl_options_get_schedule_separate_components(Ctx) << ' '
+     << isl_options_get_schedule_serialize_sccs(Ctx) << ' '
+     << isl_options_get_schedule_whole_component(Ctx) << ' '
+     << isl_options_get_schedule_carry_self_first(Ctx) << '\n';
+  OS << stringFromIslObj(SC.get_domain()) << '\n'
+     << stringFromIslObj(SC.get_validity()) << '\n'
+     << stringFromIslObj(SC.get_coincidence()) << '\n'
+     << stringFromIslObj(SC.get_proximity()) << '\n'
+     << stringFromIslObj(SC.get_conditional_validity()) << '\n'
+     << stringFromIslObj(SC.get_conditional_validity_condition()) << '\n'
+     << stringFromIslObj(SC.get_context()) << '\n';
+  return Key;
+}
+
+// A cache entry consists of the length of the key on the first line, the key,
+// and the schedule.
+static std::string getScheduleCacheEntry(StringRef Key, StringRef Schedule) {
+  return (Twine(Key.size()) + "\n" + Key + Schedule).str();
+}
+
+static isl::schedule readScheduleCacheEntry(Scop &S, StringRef Key,
+                                            StringRef Entry) {
+  auto [KeySize, Rest] = Entry.split('\n');
+  size_t Size;
+  if (KeySize.getAsInteger(10, Size) || !Rest.startswith(Key) ||
+      Size != Key.size())
+    return {};
+  isl::schedule Cached(S.getIslCtx(), Rest.drop_front(Size).str());
+  if (Cached.is_null())
+    return {};
+  return rebindCachedSchedule(S.getFullParamSpace(), S.getDomains(), Cached);
+}
+
+bool polly::pruneScheduleCache(StringRef Dir, StringRef Policy) {
+  Expected<CachePruningPolicy> ParsedPolicy = parseCachePruningPolicy(Policy);
+  if (!ParsedPolicy) {
+    LLVM_DEBUG(dbgs() << "Invalid schedule cache policy: "
+                      << toString(ParsedPolicy.takeError()) << '\n');
+    return false;
+  }
+  return pruneCache(Dir, *ParsedPolicy);
+}
+
+isl::schedule polly::computeScheduleWithCache(Scop &S,
+                                              isl::schedule_constraints SC) {
+  if (ScheduleCacheDir.empty())
+    return SC.compute_schedule();
+
+  std::string Key = getScheduleCacheKey(SC);
+  std::string KeyHash = toHex(SHA1::hash(arrayRefFromStringRef(Key)));
+
+  std::unique_ptr<MemoryBuffer> CachedEntry;
+  Expected<FileCache> Cache = localCache(
+      "Polly schedule cache", "polly-schedule", ScheduleCacheDir,
+      [&](size_t Task, std::unique_ptr<MemoryBuffer> MB) {
+        CachedEntry = std::move(MB);
+      });
+  if (!Cache) {
+    LLVM_DEBUG(dbgs() << "Schedule cache unavailable: "
+                      << toString(Cache.takeError()) << '\n');
+    return SC.compute_schedule();
+  }
+  Expected<AddStreamFn> AddStream = (*Cache)(0, KeyHash);
+  if (!AddStream) {
+    LLVM_DEBUG(dbgs() << "Schedule cache lookup failed: "
+                      << toString(AddStream.takeError()) << '\n');
+    return SC.compute_schedule();
+  }
+
+  if (!*AddStream) {
+    isl::schedule Schedule =
+        readScheduleCacheEntry(S, Key, CachedEntry->getBuffer());
+    if (!Schedule.is_null()) {
+      ScheduleCacheHits++;
+      LLVM_DEBUG(dbgs() << "Schedule read from the cache entry " << KeyHash
+                        << '\n');
+      return Schedule;
+    }
+    // A corrupt entry or a collision of the hashes of two keys. The entry is
+    // kept since it cannot be replaced.
+    LLVM_DEBUG(dbgs() << "Ignoring the cache entry " << KeyHash << '\n');
+  }
+
+  ScheduleCacheMisses++;
+  isl::schedule Schedule = SC.compute_schedule();
+  if (Schedule.is_null() || !*AddStream)
+    return Schedule;
+
+  Expected<std::unique_ptr<CachedFileStream>> Stream = (*AddStream)(0);
+  if (!Stream) {
+    LLVM_DEBUG(dbgs() << "Schedule cache store failed: "
+                      << toString(Stream.takeError()) << '\n');
+    return Schedule;
+  }
+  *(*Stream)->OS << getScheduleCacheEntry(Key, stringFromIslObj(Schedule));
+  // The entry is committed when the stream is destroyed.
+  Stream->reset();
+
+  // Pruning walks the whole cache directory, so it is attempted at most once
+  // per process. pruneCache further limits it to once per prune interval
+  // across processes.
+  static std::atomic<bool> Pruned(false);
+  if (!Pruned.exchange(true))
+    pruneScheduleCache(ScheduleCacheDir, ScheduleCachePolicy);
+  return Schedule;
+}
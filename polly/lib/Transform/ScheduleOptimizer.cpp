@@ -51,6 +51,7 @@
 #include "polly/ManualOptimizer.h"
 #include "polly/MatmulOptimizer.h"
 #include "polly/Options.h"
+#include "polly/ScheduleCache.h"
 #include "polly/ScheduleTreeTransform.h"
 #include "polly/Support/ISLOStream.h"
 #include "polly/Support/ISLTools.h"
@@ -837,7 +838,7 @@ static void runIslScheduleOptimizer(
     SC = SC.set_proximity(Proximity);
     SC = SC.set_validity(Validity);
     SC = SC.set_coincidence(Validity);
-    Schedule = SC.compute_schedule();
+    Schedule = computeScheduleWithCache(S, SC);
     isl_options_set_on_error(Ctx, OnErrorStatus);
 
     ScopsRescheduled++;
@@ -0,0 +1,215 @@
+//===- MatmulOptimizerTest.cpp --------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "polly/MatmulOptimizer.h"
+#include "polly/DependenceInfo.h"
+#include "polly/ScopDetection.h"
+#include "polly/ScopInfo.h"
+#include "llvm/Analysis/TargetTransformInfo.h"
+#include "llvm/AsmParser/Parser.h"
+#include "llvm/IR/LLVMContext.h"
+#include "llvm/IR/Module.h"
+#include "llvm/Passes/PassBuilder.h"
+#include "llvm/Support/SourceMgr.h"
+#include "gtest/gtest.h"
+#include "isl/options.h"
+#include "isl/schedule_node.h"
+
+using namespace llvm;
+using namespace polly;
+
+namespace {
+
+/// Return a function with four nested loops of 16 iterations, whose
+/// induction variables are %l0 (outermost) to %l3 (innermost), around the
+/// statement C[...] += A[...] * B[...]. The arguments are the operands of
+/// the getelementptr instructions that compute the addresses of the
+/// elements.
+std::string getLoopNest(StringRef CIdx, StringRef AIdx, StringRef BIdx) {
+  return (R"(
+define void @f(ptr noalias %A, ptr noalias %B, ptr noalias %C) {
+entry:
+  br label %l0.header
+
+l0.header:
+  %l0 = phi i64 [ 0, %entry ], [ %l0.next, %l0.latch ]
+  br label %l1.header
+
+l1.header:
+  %l1 = phi i64 [ 0, %l0.header ], [ %l1.next, %l1.latch ]
+  br label %l2.header
+
+l2.header:
+  %l2 = phi i64 [ 0, %l1.header ], [ %l2.next, %l2.latch ]
+  br label %l3.body
+
+l3.body:
+  %l3 = phi i64 [ 0, %l2.header ], [ %l3.next, %l3.body ]
+  %A.ptr = getelementptr inbounds )" +
+          AIdx + R"(
+  %B.ptr = getelementptr inbounds )" +
+          BIdx + R"(
+  %C.ptr = getelementptr inbounds )" +
+          CIdx + R"(
+  %A.val = load double, ptr %A.ptr
+  %B.val = load double, ptr %B.ptr
+  %C.val = load double, ptr %C.ptr
+  %mul = fmul double %A.val, %B.val
+  %add = fadd double %C.val, %mul
+  store double %add, ptr %C.ptr
+  %l3.next = add nuw nsw i64 %l3, 1
+  %l3.cond = icmp ult i64 %l3.next, 16
+  br i1 %l3.cond, label %l3.body, label %l2.latch
+
+l2.latch:
+  %l2.next = add nuw nsw i64 %l2, 1
+  %l2.cond = icmp ult i64 %l2.next, 16
+  br i1 %l2.cond, label %l2.header, label %l1.latch
+
+l1.latch:
+  %l1.next = add nuw nsw i64 %l1, 1
+  %l1.cond = icmp ult i64 %l1.next, 16
+  br i1 %l1.cond, label %l1.header, label %l0.latch
+
+l0.latch:
+  %l0.next = add nuw nsw i64 %l0, 1
+  %l0.cond = icmp ult i64 %l0.next, 16
+  br i1 %l0.cond, label %l0.header, label %exit
+
+exit:
+  ret void
+}
+)")
+      .str();
+}
+
+/// Return the number of members of the band nodes from the root down to and
+/// including @p Band.
+std::vector<unsigned> getBandSizes(isl::schedule_node Band) {
+  std::vector<unsigned> Sizes;
+  for (isl::schedule_node Node = Band;; Node = Node.parent()) {
+    if (isl_schedule_node_get_type(Node.get()) == isl_schedule_node_band)
+      Sizes.insert(Sizes.begin(),
+                   isl_schedule_node_band_n_member(Node.get()));
+    if (!Node.has_parent())
+      break;
+  }
+  return Sizes;
+}
+
+class MatmulOptimizer : public ::testing::Test {
+protected:
+  LLVMContext Context;
+  std::unique_ptr<Module> M;
+
+  // Declared in this order to be destroyed in the reverse order.
+  LoopAnalysisManager LAM;
+  FunctionAnalysisManager FAM;
+  CGSCCAnalysisManager CGAM;
+  ModuleAnalysisManager MAM;
+
+  MatmulOptimizer() {
+    PassBuilder PB;
+    PB.registerModuleAnalyses(MAM);
+    PB.registerCGSCCAnalyses(CGAM);
+    PB.registerFunctionAnalyses(FAM);
+    PB.registerLoopAnalyses(LAM);
+    FAM.registerPass([] { return ScopAnalysis(); });
+    FAM.registerPass([] { return ScopInfoAnalysis(); });
+    PB.crossRegisterProxies(LAM, FAM, CGAM, MAM);
+  }
+
+  /// Build the SCoP of the single function in @p IR and run
+  /// tryOptimizeMatMulPattern on a band of all the loops around its
+  /// statement, in their original order.
+  isl::schedule_node optimize(const std::string &IR) {
+    SMDiagnostic Err;
+    M = parseAssemblyString(IR, Err, Context);
+    if (!M) {
+      ADD_FAILURE() << Err.getMessage().str();
+      return {};
+    }
+    Function &F = *M->begin();
+
+    Scop *S = nullptr;
+    for (auto &It : FAM.getResult<ScopInfoAnalysis>(F))
+      S = It.second.get();
+    if (!S) {
+      ADD_FAILURE() << "No SCoP was found";
+      return {};
+    }
+    // Polly computes the tile loops without scaling them by the tile size.
+    isl_options_set_tile_scale_tile_loops(S->getIslCtx().get(), 0);
+
+    isl::union_set Domain = S->getDomains();
+    auto Identity = isl::multi_union_pw_aff(Domain.identity_union_pw_multi_aff())
+                        .reset_tuple_id(isl::dim::set);
+    isl::schedule_node Band = isl::schedule::from_domain(Domain)
+                                  .get_root()
+                                  .child(0)
+                                  .insert_partial_schedule(Identity);
+
+    DependenceAnalysis::Result Deps{*S, {}};
+    const Dependences &D = Deps.getDependences(Dependences::AL_Statement);
+    const TargetTransformInfo &TTI = FAM.getResult<TargetIRAnalysis>(F);
+    return tryOptimizeMatMulPattern(Band, &TTI, &D);
+  }
+};
+
+TEST_F(MatmulOptimizer, BatchedMatMul) {
+  // C[b][i][j] += A[b][i][k] * B[b][k][j]
+  //
+  // The batch index b is a subscript of all three tensors. It is not a loop
+  // of a matrix multiplication, but the statement is a tensor contraction.
+  isl::schedule_node Node = optimize(getLoopNest(
+      "[16 x [16 x [16 x double]]], ptr %C, i64 0, i64 %l0, i64 %l1, i64 %l2",
+      "[16 x [16 x [16 x double]]], ptr %A, i64 0, i64 %l0, i64 %l1, i64 %l3",
+      "[16 x [16 x [16 x double]]], ptr %B, i64 0, i64 %l0, i64 %l3, i64 %l2"));
+  ASSERT_FALSE(Node.is_null());
+
+  // The batch loop is split off into a band that surrounds the kernels.
+  EXPECT_EQ(getBandSizes(Node).front(), 1u);
+}
+
+TEST_F(MatmulOptimizer, TwoContractedIndices) {
+  // C[i][j] += A[i][k][l] * B[k][l][j]
+  //
+  // The innermost contracted index l becomes the k loop of the matrix
+  // multiplication, the loop of the other one surrounds the kernels.
+  isl::schedule_node Node = optimize(getLoopNest(
+      "[16 x [16 x double]], ptr %C, i64 0, i64 %l0, i64 %l1",
+      "[16 x [16 x [16 x double]]], ptr %A, i64 0, i64 %l0, i64 %l2, i64 %l3",
+      "[16 x [16 x [16 x double]]], ptr %B, i64 0, i64 %l2, i64 %l3, i64 %l1"));
+  ASSERT_FALSE(Node.is_null());
+  EXPECT_EQ(getBandSizes(Node).front(), 1u);
+}
+
+TEST_F(MatmulOptimizer, IndexOnlyInC) {
+  // C[b][i][j] += A[i][k] * B[k][j]
+  //
+  // b is a subscript of C only, so the statement is not a tensor
+  // contraction and the schedule is left alone.
+  isl::schedule_node Node = optimize(getLoopNest(
+      "[16 x [16 x [16 x double]]], ptr %C, i64 0, i64 %l0, i64 %l1, i64 %l2",
+      "[16 x [16 x double]], ptr %A, i64 0, i64 %l1, i64 %l3",
+      "[16 x [16 x double]], ptr %B, i64 0, i64 %l3, i64 %l2"));
+  EXPECT_TRUE(Node.is_null());
+}
+
+TEST_F(MatmulOptimizer, NotAContraction) {
+  // C[i][j][k][l] += A[i][j] * B[k][l]
+  //
+  // An outer product has no contracted index.
+  isl::schedule_node Node = optimize(getLoopNest(
+      "[16 x [16 x [16 x [16 x double]]]], ptr %C, i64 0, i64 %l0, i64 %l1, "
+      "i64 %l2, i64 %l3",
+      "[16 x [16 x double]], ptr %A, i64 0, i64 %l0, i64 %l1",
+      "[16 x [16 x double]], ptr %B, i64 0, i64 %l2, i64 %l3"));
+  EXPECT_TRUE(Node.is_null());
+}
+} // anonymous namespace
@@ -0,0 +1,164 @@
+//===- ScheduleCacheTest.cpp ----------------------------------------------===//
+//
+// Part of the LLVM Project, under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+//===----------------------------------------------------------------------===//
+
+#include "polly/ScheduleCache.h"
+#include "polly/Support/GICHelper.h"
+#include "llvm/ADT/SmallString.h"
+#include "llvm/Support/FileSystem.h"
+#include "llvm/Support/Path.h"
+#include "llvm/Support/raw_ostream.h"
+#include "gtest/gtest.h"
+#include "isl/ctx.h"
+#include "isl/options.h"
+#include "isl/schedule.h"
+
+using namespace llvm;
+using namespace polly;
+
+namespace {
+
+isl::schedule_constraints getConstraints(isl::ctx Ctx, const char *Domain,
+                                         const char *Validity) {
+  auto SC = isl::schedule_constraints::on_domain(isl::union_set(Ctx, Domain));
+  isl::union_map Dep(Ctx, Validity);
+  return SC.set_validity(Dep).set_proximity(Dep);
+}
+
+/// Set the id of the single parameter of @p Set to @p Param and its tuple id to
+/// @p Tuple.
+isl::set bindIds(isl::set Set, isl::id Param, isl::id Tuple) {
+  isl_set *Result = isl_set_set_dim_id(Set.release(), isl_dim_param, 0,
+                                       Param.release());
+  return isl::manage(isl_set_set_tuple_id(Result, Tuple.release()));
+}
+
+/// Set the id of the single parameter of @p Map to @p Param and its tuple ids
+/// to @p In and @p Out.
+isl::map bindIds(isl::map Map, isl::id Param, isl::id In, isl::id Out) {
+  isl_map *Result = isl_map_set_dim_id(Map.release(), isl_dim_param, 0,
+                                       Param.release());
+  Result = isl_map_set_tuple_id(Result, isl_dim_in, In.release());
+  return isl::manage(isl_map_set_tuple_id(Result, isl_dim_out, Out.release()));
+}
+
+TEST(ScheduleCache, getScheduleCacheKey) {
+  isl_ctx *ctx = isl_ctx_alloc();
+  isl::ctx Ctx(ctx);
+  const char *Domain = "[N] -> { S[i] : 0 <= i < N }";
+  const char *Validity = "[N] -> { S[i] -> S[i + 1] : 0 <= i < N - 1 }";
+
+  // The key only depends on the schedule constraints, not on the isl objects
+  // holding them.
+  std::string Key = getScheduleCacheKey(getConstraints(Ctx, Domain, Validity));
+  EXPECT_EQ(Key,
+            getScheduleCacheKey(getConstraints(Ctx, Domain, Validity)));
+
+  // Other dependences give another key.
+  EXPECT_NE(Key, getScheduleCacheKey(getConstraints(
+                     Ctx, Domain, "[N] -> { S[i] -> S[i + 2] : 0 <= i < N - 2 }")));
+
+  // So do other scheduler options.
+  int MaximizeBandDepth = isl_options_get_schedule_maximize_band_depth(ctx);
+  isl_options_set_schedule_maximize_band_depth(ctx, !MaximizeBandDepth);
+  EXPECT_NE(Key, getScheduleCacheKey(getConstraints(Ctx, Domain, Validity)));
+  isl_options_set_schedule_maximize_band_depth(ctx, MaximizeBandDepth);
+  EXPECT_EQ(Key,
+            getScheduleCacheKey(getConstraints(Ctx, Domain, Validity)));
+
+  isl_ctx_free(ctx);
+}
+
+TEST(ScheduleCache, rebindCachedSchedule) {
+  isl_ctx *ctx = isl_ctx_alloc();
+  isl::ctx Ctx(ctx);
+
+  // Ids that carry user pointers, like the ids of a SCoP.
+  int Param, StmtA, StmtB;
+  isl::id N = isl::id::alloc(Ctx, "N", &Param);
+  isl::id A = isl::id::alloc(Ctx, "Stmt_A", &StmtA);
+  isl::id B = isl::id::alloc(Ctx, "Stmt_B", &StmtB);
+  isl::space ParamSpace = isl::manage(isl_space_set_dim_id(
+      isl_space_params_alloc(ctx, 1), isl_dim_param, 0, N.copy()));
+
+  isl::set DomainA = bindIds(isl::set(Ctx, "[N] -> { [i] : 0 <= i < N }"), N, A);
+  isl::set DomainB =
+      bindIds(isl::set(Ctx, "[N] -> { [i, j] : 0 <= i, j < N }"), N, B);
+  isl::union_set BoundDomain = isl::union_set(DomainA).unite(DomainB);
+  isl::union_map BoundDep = bindIds(
+      isl::map(Ctx, "[N] -> { [i] -> [i, j] : 0 <= i, j < N }"), N, A, B);
+
+  isl::schedule Schedule = isl::schedule_constraints::on_domain(BoundDomain)
+                               .set_validity(BoundDep)
+                               .set_proximity(BoundDep)
+                               .compute_schedule();
+  ASSERT_FALSE(Schedule.is_null());
+
+  // Reading the schedule back from its string loses the user pointers of the
+  // ids, which are restored by name.
+  isl::schedule Cached(Ctx, stringFromIslObj(Schedule));
+  ASSERT_FALSE(Cached.is_null());
+  EXPECT_FALSE(Cached.get_domain().is_equal(BoundDomain));
+
+  isl::schedule Rebound = rebindCachedSchedule(ParamSpace, BoundDomain, Cached);
+  ASSERT_FALSE(Rebound.is_null());
+  EXPECT_TRUE(Rebound.get_domain().is_equal(BoundDomain));
+  EXPECT_TRUE(Rebound.get_map().is_equal(Schedule.get_map()));
+
+  // A schedule of another domain is rejected.
+  EXPECT_TRUE(
+      rebindCachedSchedule(ParamSpace, isl::union_set(DomainB), Cached)
+          .is_null());
+
+  // So is a schedule that refers to a parameter that does not exist.
+  isl::space NoParams = isl::manage(isl_space_params_alloc(ctx, 0));
+  EXPECT_TRUE(rebindCachedSchedule(NoParams, BoundDomain, Cached).is_null());
+
+  isl_ctx_free(ctx);
+}
+
+TEST(ScheduleCache, pruneScheduleCache) {
+  SmallString<128> Dir;
+  ASSERT_FALSE(sys::fs::createUniqueDirectory("polly-schedule-cache", Dir));
+
+  auto CreateFile = [&](StringRef Name) {
+    SmallString<128> Path(Dir);
+    sys::path::append(Path, Name);
+    std::error_code EC;
+    raw_fd_ostream OS(Path, EC);
+    ASSERT_FALSE(EC);
+    OS << Name;
+  };
+  auto CountCacheEntries = [&]() {
+    unsigned Count = 0;
+    std::error_code EC;
+    for (sys::fs::directory_iterator It(Dir, EC), End; It != End && !EC;
+         It.increment(EC))
+      Count += sys::path::filename(It->path()).startswith("llvmcache-");
+    return Count;
+  };
+  CreateFile("llvmcache-a");
+  CreateFile("llvmcache-b");
+  CreateFile("llvmcache-c");
+  CreateFile("unrelated");
+
+  // An invalid policy does not prune.
+  EXPECT_FALSE(pruneScheduleCache(Dir, "cache_size_files=bogus"));
+  EXPECT_EQ(CountCacheEntries(), 3u);
+
+  EXPECT_TRUE(
+      pruneScheduleCache(Dir, "prune_interval=0s:cache_size_files=1"));
+  EXPECT_EQ(CountCacheEntries(), 1u);
+
+  // Files that are not cache entries are left alone.
+  SmallString<128> Unrelated(Dir);
+  sys::path::append(Unrelated, "unrelated");
+  EXPECT_TRUE(sys::fs::exists(Unrelated));
+
+  ASSERT_FALSE(sys::fs::remove_directories(Dir));
+}
+} // anonymous namespace